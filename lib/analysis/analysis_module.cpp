@@ -43,6 +43,7 @@ struct analysis_module_struct {
   analysis_free_ftype            * freef;
   analysis_alloc_ftype           * alloc;
   analysis_initX_ftype           * initX;
+  analysis_initX_block_ftype     * initX_block;
   analysis_updateA_ftype         * updateA;
   analysis_init_update_ftype     * init_update;
   analysis_complete_update_ftype * complete_update;
@@ -72,6 +73,7 @@ static analysis_module_type * analysis_module_alloc_empty( const char * symbol_t
 
   module->lib_handle      = NULL;
   module->initX           = NULL;
+  module->initX_block     = NULL;
   module->updateA         = NULL;
   module->set_int         = NULL;
   module->set_bool        = NULL;
@@ -127,6 +129,17 @@ static analysis_module_type * analysis_module_alloc__( const analysis_table_type
   module->get_double        = table->get_double;
   module->get_bool          = table->get_bool;
   module->get_ptr           = table->get_ptr;
+
+  /*
+    initX_block is the last member of the table, and was added after
+    the other members; an external module compiled against an older
+    analysis_table.hpp has a shorter table, and reading the member
+    would read past the end of its symbol. It is therefore only picked
+    up from the internal modules, external modules always get the
+    dense R.
+  */
+  if (lib_name == NULL)
+    module->initX_block = table->initX_block;
   analysis_module_set_name( module , table->name );
 
   if (module->alloc)
@@ -260,6 +273,22 @@ void analysis_module_initX(analysis_module_type * module ,
 }
 
 
+void analysis_module_initX_block(analysis_module_type * module ,
+                                 matrix_type * X ,
+                                 const matrix_type * S ,
+                                 const block_diag_matrix_type * R ,
+                                 const matrix_type * dObs ,
+                                 const matrix_type * E ,
+                                 const matrix_type * D,
+                                 rng_type * rng) {
+
+  if (module->initX_block == NULL)
+    util_abort("%s: module:%s does not support a block diagonal R\n",__func__ , module->user_name);
+
+  module->initX_block(module->module_data , X , S , R , dObs , E , D, rng);
+}
+
+
 void analysis_module_updateA(analysis_module_type * module ,
                              matrix_type * A ,
                              const matrix_type * S ,
@@ -406,6 +435,9 @@ bool analysis_module_set_var( analysis_module_type * module , const char * var_n
 
 
 bool analysis_module_check_option( const analysis_module_type * module , long flag) {
+  if ((flag & ANALYSIS_BLOCK_R) && (module->initX_block == NULL))
+    return false;
+
   if ((flag & module->get_options( module->module_data , flag )) == flag)
       return true;
   else
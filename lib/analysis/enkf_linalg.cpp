@@ -5,6 +5,8 @@
 #include <ert/res_util/matrix.hpp>
 #include <ert/res_util/matrix_lapack.hpp>
 #include <ert/res_util/matrix_blas.hpp>
+#include <ert/res_util/counter_rng.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 #include <ert/util/util.hpp>
 
 #include <ert/analysis/enkf_linalg.hpp>
@@ -134,11 +136,8 @@ int enkf_linalg_svd_truncation(const matrix_type * S ,
 }
 
 
-static int enkf_linalg_num_significant(int num_singular_values , const double * sig0 , double truncation ) {
+static int enkf_linalg_num_significant__(int num_singular_values , const double * sig0 , double total_sigma2 , double truncation ) {
   int num_significant  = 0;
-  double total_sigma2  = 0;
-  for (int i=0; i < num_singular_values; i++)
-    total_sigma2 += sig0[i] * sig0[i];
 
   /*
     Determine the number of singular values by enforcing that
@@ -160,6 +159,15 @@ static int enkf_linalg_num_significant(int num_singular_values , const double *
 }
 
 
+static int enkf_linalg_num_significant(int num_singular_values , const double * sig0 , double truncation ) {
+  double total_sigma2  = 0;
+  for (int i=0; i < num_singular_values; i++)
+    total_sigma2 += sig0[i] * sig0[i];
+
+  return enkf_linalg_num_significant__( num_singular_values , sig0 , total_sigma2 , truncation );
+}
+
+
 int enkf_linalg_svdS(const matrix_type * S ,
                     double truncation ,
                     int ncomp ,
@@ -204,6 +212,188 @@ int enkf_linalg_svdS(const matrix_type * S ,
 }
 
 
+/*
+  Randomized SVD, see Halko, Martinsson and Tropp: "Finding structure
+  with randomness", SIAM Review 53 (2011). An orthonormal basis Q for
+  the range of (S*S')^q * S * Omega is found with a random Gaussian
+  Omega of l columns; the SVD of the small (l x nrens) matrix Q'*S
+  then gives the leading l singular triplets of S. The cost is
+  O(nrobs * nrens * l * (2q + 2)) instead of O(nrobs * nrens^2) for the
+  full dgesvd().
+
+  Omega is generated from a fixed counter based seed, i.e. the result
+  is reproducible and does not consume numbers from any rng.
+*/
+
+#define ENKF_RSVD_SEED          0x9E3779B97F4A7C15ULL
+#define ENKF_RSVD_INITIAL_RANK  32
+
+
+static void enkf_linalg_orthonormalize( matrix_type * Y ) {
+  int columns  = matrix_get_columns( Y );
+  double * tau = (double*)util_calloc( columns , sizeof * tau );
+
+  matrix_dgeqrf( Y , tau );
+  matrix_dorgqr( Y , tau , columns );
+  free( tau );
+}
+
+
+static void enkf_linalg_rsvd__(const matrix_type * S , int power_iterations , double * sig , matrix_type * U , matrix_type * VT) {
+  const int nrobs = matrix_get_rows( S );
+  const int nrens = matrix_get_columns( S );
+  const int l     = matrix_get_columns( U );
+  matrix_type * Q = matrix_alloc( nrobs , l );
+
+  {
+    matrix_type * Omega = matrix_alloc( nrens , l );
+    double * column     = (double*)util_calloc( nrens , sizeof * column );
+
+    for (int j = 0; j < l; j++) {
+      counter_rng_fill_normal( ENKF_RSVD_SEED , j , 0 , nrens , column );
+      matrix_set_column( Omega , column , j );
+    }
+    matrix_matmul( Q , S , Omega );     /* Q = S * Omega */
+    enkf_linalg_orthonormalize( Q );
+
+    free( column );
+    matrix_free( Omega );
+  }
+
+  /* Power iterations with re-orthonormalization in both half steps. */
+  if (power_iterations > 0) {
+    matrix_type * Z = matrix_alloc( nrens , l );
+    for (int q = 0; q < power_iterations; q++) {
+      matrix_dgemm( Z , S , Q , true , false , 1.0 , 0.0 );   /* Z = S' * Q */
+      enkf_linalg_orthonormalize( Z );
+      matrix_matmul( Q , S , Z );                             /* Q = S * Z */
+      enkf_linalg_orthonormalize( Q );
+    }
+    matrix_free( Z );
+  }
+
+  {
+    matrix_type * B  = matrix_alloc( l , nrens );
+    matrix_type * UB = matrix_alloc( l , l );
+
+    matrix_dgemm( B , Q , S , true , false , 1.0 , 0.0 );     /* B = Q' * S */
+    matrix_dgesvd( DGESVD_MIN_RETURN , (VT == NULL) ? DGESVD_NONE : DGESVD_MIN_RETURN , B , sig , UB , VT );
+    matrix_matmul( U , Q , UB );
+
+    matrix_free( UB );
+    matrix_free( B );
+  }
+  matrix_free( Q );
+}
+
+
+/*
+  Drop-in alternative to enkf_linalg_svdS(): U0, V0T and inv_sig0 have
+  the same dimensions, the components beyond the truncation are zero.
+
+  With a fixed ncomp the rank of the sketch is ncomp + oversampling.
+  With a truncation the number of components is not known up front;
+  the total variance is the squared Frobenius norm of S, and the rank
+  of the sketch is doubled until the truncation is reached with at
+  least @oversampling components to spare - ultimately ending up with
+  the full rank.
+*/
+
+int enkf_linalg_rsvdS(const matrix_type * S ,
+                      double truncation ,
+                      int ncomp ,
+                      dgesvd_vector_enum store_V0T ,
+                      double * inv_sig0,
+                      matrix_type * U0 ,
+                      matrix_type * V0T ,
+                      int oversampling ,
+                      int power_iterations) {
+
+  const int nrobs = matrix_get_rows( S );
+  const int nrens = matrix_get_columns( S );
+  const int nrmin = util_int_min( nrobs , nrens );
+  int num_significant = 0;
+
+  if (!(((truncation > 0) && (ncomp < 0)) ||
+        ((truncation < 0) && (ncomp > 0))))
+    util_abort("%s:  truncation:%g  ncomp:%d  - invalid ambigous input.\n",__func__ , truncation , ncomp );
+
+  if (oversampling < 0)
+    util_abort("%s: invalid oversampling:%d \n",__func__ , oversampling );
+
+  {
+    double total_sigma2 = 0;
+    int rank = (ncomp > 0) ? ncomp : ENKF_RSVD_INITIAL_RANK;
+
+    if (ncomp < 0) {
+      for (int j = 0; j < nrens; j++)
+        total_sigma2 += matrix_column_column_dot_product( S , j , S , j );
+    }
+
+    while (true) {
+      int l = util_int_min( nrmin , rank + oversampling );
+      matrix_type * U  = matrix_alloc( nrobs , l );
+      matrix_type * VT = (store_V0T == DGESVD_NONE) ? NULL : matrix_alloc( l , nrens );
+      double * sig     = (double*)util_calloc( l , sizeof * sig );
+      bool complete;
+
+      enkf_linalg_rsvd__( S , power_iterations , sig , U , VT );
+      if (ncomp > 0) {
+        num_significant = util_int_min( ncomp , l );
+        complete = true;
+      } else {
+        num_significant = enkf_linalg_num_significant__( l , sig , total_sigma2 , truncation );
+        complete = (l == nrmin) || (num_significant + util_int_max( oversampling , 1 ) <= l);
+      }
+
+      if (complete) {
+        matrix_scalar_set( U0 , 0 );
+        matrix_copy_block( U0 , 0 , 0 , nrobs , l , U , 0 , 0 );
+        if (VT != NULL) {
+          matrix_scalar_set( V0T , 0 );
+          matrix_copy_block( V0T , 0 , 0 , l , nrens , VT , 0 , 0 );
+        }
+
+        for (int i = 0; i < num_significant; i++)
+          inv_sig0[i] = 1.0 / sig[i];
+
+        for (int i = num_significant; i < nrmin; i++)
+          inv_sig0[i] = 0;
+      }
+
+      free( sig );
+      if (VT != NULL)
+        matrix_free( VT );
+      matrix_free( U );
+
+      if (complete)
+        break;
+
+      rank *= 2;
+    }
+  }
+
+  return num_significant;
+}
+
+
+static int enkf_linalg_svdS__(const matrix_type * S ,
+                              double truncation ,
+                              int ncomp ,
+                              dgesvd_vector_enum store_V0T ,
+                              double * inv_sig0,
+                              matrix_type * U0 ,
+                              matrix_type * V0T ,
+                              bool randomized ,
+                              int oversampling ,
+                              int power_iterations) {
+  if (randomized)
+    return enkf_linalg_rsvdS( S , truncation , ncomp , store_V0T , inv_sig0 , U0 , V0T , oversampling , power_iterations );
+  else
+    return enkf_linalg_svdS( S , truncation , ncomp , store_V0T , inv_sig0 , U0 , V0T );
+}
+
+
 int enkf_linalg_num_PC(const matrix_type * S , double truncation ) {
   int num_singular_values = util_int_min( matrix_get_rows( S ) , matrix_get_columns( S ));
   int num_significant;
@@ -227,12 +417,15 @@ int enkf_linalg_num_PC(const matrix_type * S , double truncation ) {
  Routine computes X1 and eig corresponding to Eqs 14.54-14.55
  Geir Evensen
 */
-void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
-                          const matrix_type * E , /* (nrobs x nrens) */
-                          matrix_type * W       , /* (nrobs x nrmin) Corresponding to X1 from Eqs. 14.54-14.55 */
-                          double * eig          , /* (nrmin)         Corresponding to 1 / (1 + Lambda1^2) (14.54) */
-                          double truncation     ,
-                          int    ncomp) {
+static void enkf_linalg_lowrankE__(const matrix_type * S ,
+                                   const matrix_type * E ,
+                                   matrix_type * W       ,
+                                   double * eig          ,
+                                   double truncation     ,
+                                   int    ncomp          ,
+                                   bool   randomized     ,
+                                   int    oversampling   ,
+                                   int    power_iterations) {
 
 
    const int nrobs = matrix_get_rows( S );
@@ -251,7 +444,7 @@ void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
 
 
 /* Compute SVD of S=HA`  ->  U0, invsig0=sig0^(-1) */
-   enkf_linalg_svdS(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL);
+   enkf_linalg_svdS__(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL , randomized , oversampling , power_iterations);
 
 /* X0(nrmin x nrens) =  Sigma0^(+) * U0'* E  (14.51)  */
    matrix_dgemm(X0 , U0 , E  , true  , false , 1.0 , 0.0);  /*  X0 = U0^T * E  (14.51) */
@@ -291,17 +484,32 @@ void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
 }
 
 
+void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
+                          const matrix_type * E , /* (nrobs x nrens) */
+                          matrix_type * W       , /* (nrobs x nrmin) Corresponding to X1 from Eqs. 14.54-14.55 */
+                          double * eig          , /* (nrmin)         Corresponding to 1 / (1 + Lambda1^2) (14.54) */
+                          double truncation     ,
+                          int    ncomp) {
+  enkf_linalg_lowrankE__( S , E , W , eig , truncation , ncomp , false , 0 , 0 );
+}
+
+
+/* As enkf_linalg_lowrankE(), but with the randomized SVD of S. */
+void enkf_linalg_lowrankE_rsvd(const matrix_type * S ,
+                               const matrix_type * E ,
+                               matrix_type * W       ,
+                               double * eig          ,
+                               double truncation     ,
+                               int    ncomp          ,
+                               int    oversampling   ,
+                               int    power_iterations) {
+  enkf_linalg_lowrankE__( S , E , W , eig , truncation , ncomp , true , oversampling , power_iterations );
+}
 
 
-void enkf_linalg_Cee(matrix_type * B, int nrens , const matrix_type * R , const matrix_type * U0 , const double * inv_sig0) {
-  const int nrmin = matrix_get_rows( B );
-  {
-    matrix_type * X0 = matrix_alloc( nrmin , matrix_get_rows( R ));
-    matrix_dgemm(X0 , U0 , R  , true  , false , 1.0 , 0.0);  /* X0 = U0^T * R */
-    matrix_dgemm(B  , X0 , U0 , false , false , 1.0 , 0.0);  /* B = X0 * U0 */
-    matrix_free( X0 );
-  }
 
+
+static void enkf_linalg_Cee_scale__(matrix_type * B, int nrens , const double * inv_sig0) {
   {
     int i ,j;
 
@@ -322,16 +530,83 @@ void enkf_linalg_Cee(matrix_type * B, int nrens , const matrix_type * R , const
 }
 
 
+/*
+  As enkf_linalg_Cee() with R in block diagonal form; R * U0 is formed
+  block by block, so R is never expanded to a dense nrobs x nrobs
+  matrix.
+*/
 
+void enkf_linalg_Cee_block(matrix_type * B, int nrens , const block_diag_matrix_type * R , const matrix_type * U0 , const double * inv_sig0) {
+  {
+    matrix_type * RU0 = matrix_alloc( matrix_get_rows( U0 ) , matrix_get_columns( U0 ));
+    block_diag_matrix_matmul( RU0 , R , U0 );                 /* RU0 = R * U0 */
+    matrix_dgemm(B , U0 , RU0 , true , false , 1.0 , 0.0);   /* B = U0^T * RU0 */
+    matrix_free( RU0 );
+  }
+  enkf_linalg_Cee_scale__( B , nrens , inv_sig0 );
+}
 
-void enkf_linalg_lowrankCinv__(const matrix_type * S ,
-                               const matrix_type * R ,
-                               matrix_type * V0T ,
-                               matrix_type * Z,
-                               double * eig ,
-                               matrix_type * U0,
-                               double truncation,
-                               int ncomp) {
+
+static bool enkf_linalg_is_diagonal( const matrix_type * R ) {
+  const int size = matrix_get_rows( R );
+  if (matrix_get_columns( R ) != size)
+    return false;
+
+  for (int j = 0; j < size; j++)
+    for (int i = 0; i < size; i++)
+      if ((i != j) && (matrix_iget( R , i , j ) != 0))
+        return false;
+
+  return true;
+}
+
+
+/*
+  A dense R which is in fact diagonal - uncorrelated observation
+  errors - is checked for with one pass over R, and then takes the
+  O(nrobs * nrmin) diagonal path instead of the O(nrobs^2 * nrmin)
+  dgemm() with R.
+*/
+
+void enkf_linalg_Cee(matrix_type * B, int nrens , const matrix_type * R , const matrix_type * U0 , const double * inv_sig0) {
+  const int nrmin = matrix_get_rows( B );
+
+  if (enkf_linalg_is_diagonal( R )) {
+    const int nrobs = matrix_get_rows( R );
+    block_diag_matrix_type * block_R = block_diag_matrix_alloc( );
+    double * diag = (double*)util_calloc( util_int_max( 1 , nrobs ) , sizeof * diag );
+
+    for (int i = 0; i < nrobs; i++)
+      diag[i] = matrix_iget( R , i , i );
+    block_diag_matrix_append_diag( block_R , nrobs , diag );
+    enkf_linalg_Cee_block( B , nrens , block_R , U0 , inv_sig0 );
+
+    free( diag );
+    block_diag_matrix_free( block_R );
+  } else {
+    matrix_type * X0 = matrix_alloc( nrmin , matrix_get_rows( R ));
+    matrix_dgemm(X0 , U0 , R  , true  , false , 1.0 , 0.0);  /* X0 = U0^T * R */
+    matrix_dgemm(B  , X0 , U0 , false , false , 1.0 , 0.0);  /* B = X0 * U0 */
+    matrix_free( X0 );
+    enkf_linalg_Cee_scale__( B , nrens , inv_sig0 );
+  }
+}
+
+
+
+
+static void enkf_linalg_lowrankCinv___(const matrix_type * S ,
+                                       const matrix_type * R ,
+                                       const block_diag_matrix_type * block_R ,
+                                       matrix_type * V0T ,
+                                       matrix_type * Z,
+                                       double * eig ,
+                                       matrix_type * U0,
+                                       double truncation,
+                                       int ncomp,
+                                       bool randomized,
+                                       int oversampling,
+                                       int power_iterations) {
 
   const int nrobs = matrix_get_rows( S );
   const int nrens = matrix_get_columns( S );
@@ -340,13 +615,16 @@ void enkf_linalg_lowrankCinv__(const matrix_type * S ,
   double * inv_sig0      = (double*)util_calloc( nrmin , sizeof * inv_sig0);
 
   if (V0T != NULL)
-    enkf_linalg_svdS(S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig0 , U0 , V0T );
+    enkf_linalg_svdS__(S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig0 , U0 , V0T , randomized , oversampling , power_iterations);
   else
-    enkf_linalg_svdS(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL);
+    enkf_linalg_svdS__(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL , randomized , oversampling , power_iterations);
 
   {
     matrix_type * B    = matrix_alloc( nrmin , nrmin );
-    enkf_linalg_Cee( B , nrens , R , U0 , inv_sig0);          /* B = Xo = (N-1) * Sigma0^(+) * U0'* Cee * U0 * Sigma0^(+')  (14.26)*/
+    if (block_R != NULL)
+      enkf_linalg_Cee_block( B , nrens , block_R , U0 , inv_sig0);
+    else
+      enkf_linalg_Cee( B , nrens , R , U0 , inv_sig0);          /* B = Xo = (N-1) * Sigma0^(+) * U0'* Cee * U0 * Sigma0^(+')  (14.26)*/
     matrix_dgesvd(DGESVD_MIN_RETURN , DGESVD_NONE, B , eig, Z , NULL);
     matrix_free( B );
   }
@@ -366,12 +644,28 @@ void enkf_linalg_lowrankCinv__(const matrix_type * S ,
 }
 
 
-void enkf_linalg_lowrankCinv(const matrix_type * S ,
-                             const matrix_type * R ,
-                             matrix_type * W       , /* Corresponding to X1 from Eq. 14.29 */
-                             double * eig          , /* Corresponding to 1 / (1 + Lambda_1) (14.29) */
-                             double truncation     ,
-                             int    ncomp) {
+void enkf_linalg_lowrankCinv__(const matrix_type * S ,
+                               const matrix_type * R ,
+                               matrix_type * V0T ,
+                               matrix_type * Z,
+                               double * eig ,
+                               matrix_type * U0,
+                               double truncation,
+                               int ncomp) {
+  enkf_linalg_lowrankCinv___( S , R , NULL , V0T , Z , eig , U0 , truncation , ncomp , false , 0 , 0 );
+}
+
+
+static void enkf_linalg_lowrankCinv_svd__(const matrix_type * S ,
+                                          const matrix_type * R ,
+                                          const block_diag_matrix_type * block_R ,
+                                          matrix_type * W       ,
+                                          double * eig          ,
+                                          double truncation     ,
+                                          int    ncomp          ,
+                                          bool   randomized     ,
+                                          int    oversampling   ,
+                                          int    power_iterations) {
 
   const int nrobs = matrix_get_rows( S );
   const int nrens = matrix_get_columns( S );
@@ -380,7 +674,7 @@ void enkf_linalg_lowrankCinv(const matrix_type * S ,
   matrix_type * U0   = matrix_alloc( nrobs , nrmin );
   matrix_type * Z    = matrix_alloc( nrmin , nrmin );
 
-  enkf_linalg_lowrankCinv__( S , R , NULL , Z , eig , U0 , truncation , ncomp);
+  enkf_linalg_lowrankCinv___( S , R , block_R , NULL , Z , eig , U0 , truncation , ncomp , randomized , oversampling , power_iterations);
   matrix_matmul(W , U0 , Z); /* X1 = W = U0 * Z2 = U0 * Sigma0^(+') * Z    */
 
   matrix_free( U0 );
@@ -388,6 +682,40 @@ void enkf_linalg_lowrankCinv(const matrix_type * S ,
 }
 
 
+void enkf_linalg_lowrankCinv(const matrix_type * S ,
+                             const matrix_type * R ,
+                             matrix_type * W       , /* Corresponding to X1 from Eq. 14.29 */
+                             double * eig          , /* Corresponding to 1 / (1 + Lambda_1) (14.29) */
+                             double truncation     ,
+                             int    ncomp) {
+  enkf_linalg_lowrankCinv_svd__( S , R , NULL , W , eig , truncation , ncomp , false , 0 , 0 );
+}
+
+
+/* As enkf_linalg_lowrankCinv(), with R in block diagonal form. */
+void enkf_linalg_lowrankCinv_block(const matrix_type * S ,
+                                   const block_diag_matrix_type * R ,
+                                   matrix_type * W       ,
+                                   double * eig          ,
+                                   double truncation     ,
+                                   int    ncomp) {
+  enkf_linalg_lowrankCinv_svd__( S , NULL , R , W , eig , truncation , ncomp , false , 0 , 0 );
+}
+
+
+/* As enkf_linalg_lowrankCinv(), but with the randomized SVD of S. */
+void enkf_linalg_lowrankCinv_rsvd(const matrix_type * S ,
+                                  const matrix_type * R ,
+                                  matrix_type * W       ,
+                                  double * eig          ,
+                                  double truncation     ,
+                                  int    ncomp          ,
+                                  int    oversampling   ,
+                                  int    power_iterations) {
+  enkf_linalg_lowrankCinv_svd__( S , R , NULL , W , eig , truncation , ncomp , true , oversampling , power_iterations );
+}
+
+
 void enkf_linalg_meanX5(const matrix_type * S ,
                         const matrix_type * W ,
                         const double * eig    ,
@@ -565,9 +893,16 @@ void enkf_linalg_set_randrot( matrix_type * Q  , rng_type * rng) {
   double      * tau  = (double*)util_calloc( ens_size , sizeof * tau );
   int         * sign = (int*)util_calloc( ens_size , sizeof * sign);
 
-  for (int i = 0; i < ens_size; i++)
-    for (int j = 0; j < ens_size; j++)
-      matrix_iset(Q , i , j , rng_std_normal( rng ));
+  {
+    /* One counter based stream per column; see counter_rng.hpp. */
+    uint64_t seed  = counter_rng_draw_seed( rng );
+    double * column = (double*)util_calloc( ens_size , sizeof * column );
+    for (int j = 0; j < ens_size; j++) {
+      counter_rng_fill_normal( seed , j , 0 , ens_size , column );
+      matrix_set_column( Q , column , j );
+    }
+    free( column );
+  }
 
   matrix_dgeqrf( Q , tau );  /* QR factorization */
   for (int i=0; i  < ens_size; i++) {
@@ -612,7 +947,16 @@ matrix_type * enkf_linalg_alloc_mp_randrot(int ens_size , rng_type * rng) {
     {
       int k,j;
       matrix_type * R   = matrix_alloc( ens_size , ens_size );
-      matrix_random_init( B , rng);   /* B is filled up with U(0,1) numbers. */
+      {
+        /* B is filled up with U(0,1) numbers, one counter based stream per column. */
+        uint64_t seed  = counter_rng_draw_seed( rng );
+        double * column = (double*)util_calloc( ens_size , sizeof * column );
+        for (j = 0; j < ens_size; j++) {
+          counter_rng_fill_uniform( seed , j , 0 , ens_size , column );
+          matrix_set_column( B , column , j );
+        }
+        free( column );
+      }
       matrix_set_const_column( B , 1.0 / sqrt( ens_size ) , 0 );
 
       /* modified_gram_schmidt is used to create the orthonormal basis in B.*/
@@ -18,11 +18,13 @@
 
 
 #include <math.h>
+#include <errno.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 #include <time.h>
+#include <unistd.h>
 
 #include <ert/util/util.hpp>
 #include <ert/util/type_macros.hpp>
@@ -102,9 +104,16 @@ void ies_enkf_linalg_store_active_W(ies_enkf_data_type * data,
                                     bool dbg);
 
 void ies_enkf_linalg_extract_active_A0(const ies_enkf_data_type * data,
+                                       const matrix_type * A0_block,
                                        matrix_type * A0,
                                        FILE * log_fp,
                                        bool dbg);
+
+void ies_enkf_linalg_update_A(const ies_enkf_data_type * data,
+                              matrix_type * A,
+                              const matrix_type * X,
+                              FILE * log_fp,
+                              bool dbg);
 /***************************************************************************************************************/
 
 #ifdef __cplusplus
@@ -124,6 +133,9 @@ void ies_enkf_linalg_extract_active_A0(const ies_enkf_data_type * data,
 #define IES_LOGFILE_KEY                  "IES_LOGFILE"
 #define IES_DEBUG_KEY                    "IES_DEBUG"
 #define IES_AAPROJECTION_KEY             "IES_AAPROJECTION"
+#define IES_ROW_BLOCK_SIZE_KEY           "IES_ROW_BLOCK_SIZE"
+#define IES_CHECKPOINT_KEY               "IES_CHECKPOINT"
+#define IES_SPILL_PATH_KEY               "IES_SPILL_PATH"
 
 
 #include "tecplot.c"
@@ -142,6 +154,48 @@ static void printf_mask(FILE * log_fp, const char * name, const bool_vector_type
 }
 
 
+/***************************************************************************************************************
+*  Checkpointing of the iteration state
+*
+*  When IES_CHECKPOINT is set the iteration state is written to that file after each update. A new
+*  process which is told - through the ITER variable - to resume from the stored iteration will read
+*  the state back before the masks for the next update are registered.
+****************************************************************************************************************/
+static void ies_enkf_load_checkpoint(ies_enkf_data_type * data) {
+  const char * checkpoint = ies_enkf_config_get_ies_checkpoint( ies_enkf_data_get_config( data ));
+  int iteration_nr = ies_enkf_data_get_iteration_nr( data );
+
+  if (checkpoint && iteration_nr > 0 && !ies_enkf_data_getW( data ) && util_file_exists( checkpoint )) {
+    FILE * stream = util_fopen( checkpoint , "r");
+    util_fread_int( stream );
+    if (util_fread_int( stream ) == iteration_nr) {
+      rewind( stream );
+      ies_enkf_data_fread_state( data , stream );
+    } else
+      fprintf(stderr,"** Warning: the checkpoint:%s is not from iteration:%d - ignored\n", checkpoint , iteration_nr);
+    fclose( stream );
+  }
+}
+
+
+static void ies_enkf_save_checkpoint(const ies_enkf_data_type * data) {
+  const char * checkpoint = ies_enkf_config_get_ies_checkpoint( ies_enkf_data_get_config( data ));
+
+  if (checkpoint) {
+    char * tmp_file = util_alloc_sprintf("%s.tmp", checkpoint);
+    FILE * stream = util_mkdir_fopen( tmp_file , "w");
+    ies_enkf_data_fwrite_state( data , stream );
+    /* The state must be on disk before the rename makes it visible as the checkpoint. */
+    if (fflush( stream ) != 0 || fsync( fileno( stream )) != 0)
+      util_abort("%s: failed to flush %s to disk - %s \n",__func__ , tmp_file , strerror( errno ));
+    fclose( stream );
+    if (rename( tmp_file , checkpoint ) != 0)
+      util_abort("%s: failed to move %s -> %s \n",__func__ , tmp_file , checkpoint);
+    free( tmp_file );
+  }
+}
+
+
 /***************************************************************************************************************
 *  Set / Get iteration number
 ****************************************************************************************************************/
@@ -162,6 +216,9 @@ void ies_enkf_init_update(void * arg ,
                           rng_type * rng) {
   ies_enkf_data_type * module_data = ies_enkf_data_safe_cast( arg );
 
+/* Resume from a stored iteration state */
+  ies_enkf_load_checkpoint(module_data);
+
 /* Store current ens_mask in module_data->ens_mask for each iteration */
   ies_enkf_data_update_ens_mask(module_data, ens_mask);
 
@@ -289,7 +346,6 @@ void ies_enkf_updateA( void * module_data,
 /* Add old measurement perturbations */
    matrix_inplace_add(D,E);          
 
-   matrix_type * A0  = matrix_alloc( state_size, ens_size );  // Temporary ensemble matrix
    matrix_type * W0  = matrix_alloc( ens_size , ens_size  );  // Coefficient matrix
    matrix_type * W   = matrix_alloc( ens_size , ens_size  );  // Coefficient matrix
    matrix_type * H   = matrix_alloc( nrobs_inp, ens_size  );  // Innovation vector "H= S*W+D-Y"
@@ -389,8 +445,7 @@ void ies_enkf_updateA( void * module_data,
 /***************************************************************************************************************
 *  COMPUTE NEW ENSEMBLE SOLUTION FOR CURRENT ITERATION  Ei=A0*X                              (Line 11)   */
    matrix_pretty_fprint_submat(A,"A^f","%11.5f",log_fp,0,m_state_size,0,m_ens_size);
-   ies_enkf_linalg_extract_active_A0(data, A0, log_fp, dbg);
-   matrix_matmul(A,A0,X);
+   ies_enkf_linalg_update_A(data, A, X, log_fp, dbg);
    matrix_pretty_fprint_submat(A,"A^a","%11.5f",log_fp,0,m_state_size,0,m_ens_size);
 
 /***************************************************************************************************************
@@ -400,6 +455,8 @@ void ies_enkf_updateA( void * module_data,
    teclog(W,D,DW,"iesteclog.dat",ens_size,iteration_nr, rcond, nrsing, nrobs_inp);
    teccost(W,D,"costf.dat",ens_size,iteration_nr);
 
+   ies_enkf_save_checkpoint(data);
+
 /* DONE *********************************************************************************************************/
 
    ies_enkf_data_fclose_log(data);
@@ -408,7 +465,6 @@ void ies_enkf_updateA( void * module_data,
    matrix_free( D  );
    matrix_free( E  );
    matrix_free( R  );
-   matrix_free( A0 );
    matrix_free( W0 );
    matrix_free( W );
    matrix_free( DW );
@@ -740,31 +796,65 @@ void ies_enkf_linalg_store_active_W(ies_enkf_data_type * data,
 }
 
 /*
-* Extract active realizations from the initially stored ensemble.
+* Extract active realizations from one block of rows of the initially stored ensemble.
 */
 void ies_enkf_linalg_extract_active_A0(const ies_enkf_data_type * data,
+                                       const matrix_type * A0_block,
                                        matrix_type * A0,
                                        FILE * log_fp,
                                        bool dbg){
    int ens_size_msk  = ies_enkf_data_get_ens_mask_size(data);
-   int ens_size      = matrix_get_columns( A0 );            
+   int ens_size      = matrix_get_columns( A0 );
    int state_size    = matrix_get_rows( A0 );
    int m_ens_size    = util_int_min(ens_size  -1,16);
    int m_state_size = util_int_min(state_size-1,3);
    int i=-1;
    const bool_vector_type * ens_mask = ies_enkf_data_get_ens_mask(data);
-   const matrix_type * dataA0 = ies_enkf_data_getA0(data);
-   matrix_pretty_fprint_submat(dataA0,"data->A0","%11.5f",log_fp,0,m_state_size,0,m_ens_size);
+   if (dbg) matrix_pretty_fprint_submat(A0_block,"data->A0","%11.5f",log_fp,0,m_state_size,0,m_ens_size);
    for (int iens=0; iens < ens_size_msk; iens++){
       if ( bool_vector_iget(ens_mask,iens) ){
          i=i+1;
-         matrix_copy_column(A0,dataA0,i,iens);
+         matrix_copy_column(A0,A0_block,i,iens);
       }
    }
+}
 
-   if (ens_size_msk == ens_size){
-     fprintf(log_fp,"data->A0 copied exactly to A0: %d\n",matrix_equal(dataA0,A0)) ;
+
+/*
+* COMPUTE NEW ENSEMBLE SOLUTION Ei=A0*X one block of rows at a time. Only one block of the stored
+* prior ensemble is in memory, and the product is written directly into the corresponding rows of A.
+*/
+void ies_enkf_linalg_update_A(const ies_enkf_data_type * data,
+                              matrix_type * A,
+                              const matrix_type * X,
+                              FILE * log_fp,
+                              bool dbg){
+   int ens_size      = matrix_get_columns( A );
+   int state_size    = matrix_get_rows( A );
+   int block_size    = ies_enkf_data_get_A0_block_size(data);
+   int num_blocks    = ies_enkf_data_get_A0_block_count(data);
+   matrix_type * A0_block = matrix_alloc( 1 , 1 );
+   matrix_type * A0       = matrix_alloc( 1 , ens_size );
+
+   if (ies_enkf_data_get_state_size(data) != state_size)
+      util_abort("%s: the stored prior ensemble has %d rows - current state_size:%d \n",__func__ , ies_enkf_data_get_state_size(data), state_size);
+
+   fprintf(log_fp,"Computing A=A0*X in %d blocks of %d rows\n", num_blocks, block_size);
+   for (int iblock=0; iblock < num_blocks; iblock++){
+      int row0 = iblock * block_size;
+      int rows = util_int_min( block_size , state_size - row0 );
+      matrix_type * A_block = matrix_alloc_shared( A , row0 , 0 , rows , ens_size );
+
+      ies_enkf_data_iget_A0_block(data, iblock, A0_block);
+      matrix_resize( A0 , rows , ens_size , false );
+      ies_enkf_linalg_extract_active_A0(data, A0_block, A0, log_fp, dbg && (iblock == 0));
+      matrix_matmul(A_block,A0,X);
+
+      matrix_free( A_block );
    }
+
+   matrix_free( A0 );
+   matrix_free( A0_block );
 }
 
 
@@ -784,6 +874,8 @@ bool ies_enkf_set_int( void * arg , const char * var_name , int value) {
       ies_enkf_data_set_iteration_nr( module_data , value );
     else if (strcmp( var_name , IES_INVERSION_KEY) == 0)  // This should probably translate string value - now it goes directly on the value of the ies_inversion_type enum.
       ies_enkf_config_set_ies_inversion( config , value );
+    else if (strcmp( var_name , IES_ROW_BLOCK_SIZE_KEY) == 0)
+      ies_enkf_config_set_ies_row_block_size( config , value );
     else
       name_recognized = false;
 
@@ -801,6 +893,8 @@ int ies_enkf_get_int( const void * arg, const char * var_name) {
       return ies_enkf_config_get_enkf_subspace_dimension(ies_config);
     else if (strcmp(var_name , IES_INVERSION_KEY) == 0)
       return ies_enkf_config_get_ies_inversion(ies_config);
+    else if (strcmp(var_name , IES_ROW_BLOCK_SIZE_KEY) == 0)
+      return ies_enkf_config_get_ies_row_block_size(ies_config);
     else
       return -1;
   }
@@ -814,6 +908,10 @@ bool ies_enkf_set_string( void * arg , const char * var_name , const char * valu
 
     if (strcmp( var_name , IES_LOGFILE_KEY) == 0)
       ies_enkf_config_set_ies_logfile( ies_config , value );
+    else if (strcmp( var_name , IES_CHECKPOINT_KEY) == 0)
+      ies_enkf_config_set_ies_checkpoint( ies_config , value );
+    else if (strcmp( var_name , IES_SPILL_PATH_KEY) == 0)
+      ies_enkf_config_set_ies_spill_path( ies_config , value );
     else
       name_recognized = false;
 
@@ -827,6 +925,10 @@ const char* ies_enkf_get_string( void * arg , const char * var_name ) {
   {
     if (strcmp( var_name , IES_LOGFILE_KEY) == 0)
       return ies_enkf_config_get_ies_logfile( ies_config );
+    else if (strcmp( var_name , IES_CHECKPOINT_KEY) == 0)
+      return ies_enkf_config_get_ies_checkpoint( ies_config );
+    else if (strcmp( var_name , IES_SPILL_PATH_KEY) == 0)
+      return ies_enkf_config_get_ies_spill_path( ies_config );
     else
        return NULL;
   }
@@ -935,6 +1037,12 @@ bool ies_enkf_has_var( const void * arg, const char * var_name) {
       return true;
     else if (strcmp(var_name , IES_AAPROJECTION_KEY) == 0)
       return true;
+    else if (strcmp(var_name , IES_ROW_BLOCK_SIZE_KEY) == 0)
+      return true;
+    else if (strcmp(var_name , IES_CHECKPOINT_KEY) == 0)
+      return true;
+    else if (strcmp(var_name , IES_SPILL_PATH_KEY) == 0)
+      return true;
     else if (strcmp(var_name , ENKF_TRUNCATION_KEY) == 0)
       return true;
     else if (strcmp(var_name , ENKF_SUBSPACE_DIMENSION_KEY) == 0)
@@ -950,6 +1058,10 @@ void * ies_enkf_get_ptr( const void * arg , const char * var_name ) {
   {
     if (strcmp(var_name , IES_LOGFILE_KEY) == 0)
       return (void *) ies_enkf_config_get_ies_logfile( ies_config );
+    else if (strcmp(var_name , IES_CHECKPOINT_KEY) == 0)
+      return (void *) ies_enkf_config_get_ies_checkpoint( ies_config );
+    else if (strcmp(var_name , IES_SPILL_PATH_KEY) == 0)
+      return (void *) ies_enkf_config_get_ies_spill_path( ies_config );
     else
       return NULL;
   }
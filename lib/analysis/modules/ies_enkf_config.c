@@ -41,6 +41,9 @@
 #define DEFAULT_IES_LOGFILE            "ies.log"
 #define DEFAULT_IES_DEBUG              true
 #define DEFAULT_IES_AAPROJECTION       false
+#define DEFAULT_IES_ROW_BLOCK_SIZE     10000
+#define DEFAULT_IES_CHECKPOINT         NULL
+#define DEFAULT_IES_SPILL_PATH         NULL
 
 
 
@@ -59,6 +62,9 @@ struct ies_enkf_config_struct {
   char    * ies_logfile;           // Controlled by config key: DEFAULT_IES_LOGFILE
   bool      ies_debug;             // Controlled by config key: DEFAULT_IES_DEBUG
   bool      ies_aaprojection;      // Controlled by config key: DEFAULT_IES_AAPROJECTION
+  int       ies_row_block_size;    // Controlled by config key: DEFAULT_IES_ROW_BLOCK_SIZE
+  char    * ies_checkpoint;        // Controlled by config key: DEFAULT_IES_CHECKPOINT
+  char    * ies_spill_path;        // Controlled by config key: DEFAULT_IES_SPILL_PATH
 };
 
 
@@ -66,6 +72,8 @@ ies_enkf_config_type * ies_enkf_config_alloc() {
   ies_enkf_config_type * config = util_malloc( sizeof * config );
   UTIL_TYPE_ID_INIT( config , IES_ENKF_CONFIG_TYPE_ID );
   config->ies_logfile = NULL;
+  config->ies_checkpoint = NULL;
+  config->ies_spill_path = NULL;
   ies_enkf_config_set_truncation( config , DEFAULT_ENKF_TRUNCATION);
   ies_enkf_config_set_enkf_subspace_dimension( config , DEFAULT_ENKF_SUBSPACE_DIMENSION);
   ies_enkf_config_set_option_flags( config , ANALYSIS_NEED_ED + ANALYSIS_UPDATE_A + ANALYSIS_ITERABLE + ANALYSIS_SCALE_DATA);
@@ -77,6 +85,9 @@ ies_enkf_config_type * ies_enkf_config_alloc() {
   ies_enkf_config_set_ies_logfile( config , DEFAULT_IES_LOGFILE );
   ies_enkf_config_set_ies_debug( config , DEFAULT_IES_DEBUG );
   ies_enkf_config_set_ies_aaprojection( config , DEFAULT_IES_AAPROJECTION );
+  ies_enkf_config_set_ies_row_block_size( config , DEFAULT_IES_ROW_BLOCK_SIZE );
+  ies_enkf_config_set_ies_checkpoint( config , DEFAULT_IES_CHECKPOINT );
+  ies_enkf_config_set_ies_spill_path( config , DEFAULT_IES_SPILL_PATH );
 
   return config;
 }
@@ -188,8 +199,39 @@ void ies_enkf_config_set_ies_logfile( ies_enkf_config_type * config , const char
    config->ies_logfile = util_realloc_string_copy( config->ies_logfile , ies_logfile );
 }
 
+/*------------------------------------------------------------------------------------------------*/
+/* IES_ROW_BLOCK_SIZE */
+int ies_enkf_config_get_ies_row_block_size( const ies_enkf_config_type * config ) {
+   return config->ies_row_block_size;
+}
+void ies_enkf_config_set_ies_row_block_size( ies_enkf_config_type * config , int ies_row_block_size ) {
+   if (ies_row_block_size > 0)
+      config->ies_row_block_size = ies_row_block_size;
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/* IES_CHECKPOINT    */
+const char * ies_enkf_config_get_ies_checkpoint( const ies_enkf_config_type * config ) {
+   return config->ies_checkpoint;
+}
+void ies_enkf_config_set_ies_checkpoint( ies_enkf_config_type * config , const char * ies_checkpoint ) {
+   config->ies_checkpoint = util_realloc_string_copy( config->ies_checkpoint , ies_checkpoint );
+}
+
+/*------------------------------------------------------------------------------------------------*/
+/* IES_SPILL_PATH    */
+const char * ies_enkf_config_get_ies_spill_path( const ies_enkf_config_type * config ) {
+   return config->ies_spill_path;
+}
+void ies_enkf_config_set_ies_spill_path( ies_enkf_config_type * config , const char * ies_spill_path ) {
+   config->ies_spill_path = util_realloc_string_copy( config->ies_spill_path , ies_spill_path );
+}
+
 /*------------------------------------------------------------------------------------------------*/
 /* FREE_CONFIG */
 void ies_enkf_config_free(ies_enkf_config_type * config) {
+  free( config->ies_logfile );
+  free( config->ies_checkpoint );
+  free( config->ies_spill_path );
   free( config );
 }
@@ -79,6 +79,15 @@ typedef struct ies_enkf_config_struct ies_enkf_config_type;
   char * ies_enkf_config_get_ies_logfile( const ies_enkf_config_type * config ) ;
   void   ies_enkf_config_set_ies_logfile( ies_enkf_config_type * config , const char * ies_logfile ) ;
 
+  int    ies_enkf_config_get_ies_row_block_size( const ies_enkf_config_type * config ) ;
+  void   ies_enkf_config_set_ies_row_block_size( ies_enkf_config_type * config , int ies_row_block_size ) ;
+
+  const char * ies_enkf_config_get_ies_checkpoint( const ies_enkf_config_type * config ) ;
+  void   ies_enkf_config_set_ies_checkpoint( ies_enkf_config_type * config , const char * ies_checkpoint ) ;
+
+  const char * ies_enkf_config_get_ies_spill_path( const ies_enkf_config_type * config ) ;
+  void   ies_enkf_config_set_ies_spill_path( ies_enkf_config_type * config , const char * ies_spill_path ) ;
+
 
 #ifdef __cplusplus
 }
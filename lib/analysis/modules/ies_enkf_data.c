@@ -1,3 +1,8 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #include "ies_enkf_config.h"
 #include "ies_enkf_data.h"
 
@@ -44,7 +49,10 @@ struct ies_enkf_data_struct {
    bool_vector_type * obs_mask0;      // Initial observation mask for active measurements
    bool_vector_type * obs_mask;       // Current observation mask
    matrix_type * W;                   // Coefficient matrix used to compute Omega = I + W (I -11'/N)/sqrt(N-1)
-   matrix_type * A0;                  // Prior ensemble used in Ei=A0 Omega_i
+   FILE        * A0_stream;           // Prior ensemble used in Ei=A0 Omega_i; stored on disk in blocks of rows
+   int           A0_rows;             // Number of rows (state_size) in the stored prior
+   int           A0_columns;          // Number of realizations in the stored prior
+   int           A0_block_size;       // Number of rows in each stored block - the last block can be smaller
    matrix_type * E;                   // Prior ensemble of measurement perturations (should be the same for all iterations)
    bool      converged;               // GN has converged
    ies_enkf_config_type * config;     // This I don't understand but I assume I include data from the ies_enkf_config_type defined in ies_enkf_config.c
@@ -69,7 +77,10 @@ void * ies_enkf_data_alloc( rng_type * rng) {
   data->obs_mask0            = NULL;
   data->obs_mask             = NULL;
   data->W                    = NULL;
-  data->A0                   = NULL;
+  data->A0_stream            = NULL;
+  data->A0_rows              = 0;
+  data->A0_columns           = 0;
+  data->A0_block_size        = 0;
   data->E                    = NULL;
   data->converged            = false;
   data->config               = ies_enkf_config_alloc();
@@ -79,6 +90,18 @@ void * ies_enkf_data_alloc( rng_type * rng) {
 
 void ies_enkf_data_free( void * arg ) {
   ies_enkf_data_type * data = ies_enkf_data_safe_cast( arg );
+  if (data->A0_stream)
+    fclose( data->A0_stream );
+  if (data->W)
+    matrix_free( data->W );
+  if (data->E)
+    matrix_free( data->E );
+  if (data->ens_mask)
+    bool_vector_free( data->ens_mask );
+  if (data->obs_mask0)
+    bool_vector_free( data->obs_mask0 );
+  if (data->obs_mask)
+    bool_vector_free( data->obs_mask );
   ies_enkf_config_free( data->config );
   free( data );
 }
@@ -149,6 +172,10 @@ void ies_enkf_data_update_state_size(ies_enkf_data_type * data, int state_size)
     data->state_size = state_size;
 }
 
+int ies_enkf_data_get_state_size(const ies_enkf_data_type * data) {
+  return data->state_size;
+}
+
 FILE * ies_enkf_data_open_log(ies_enkf_data_type * data) {
   const char * ies_logfile = ies_enkf_config_get_ies_logfile( data->config );
   FILE * fp;
@@ -230,19 +257,234 @@ void ies_enkf_data_augment_initialE(ies_enkf_data_type * data, const matrix_type
   }
 }
 
+/*
+  The prior ensemble is only needed in the final update equation A = A0*X (Line 11). To keep the
+  memory footprint independent of the number of parameters it is not held in memory, instead it is
+  written to an unlinked temporary file as consecutive blocks of at most A0_block_size rows, and
+  ies_enkf_data_iget_A0_block() is used to load one block at a time.
+
+  The file is created in the IES_SPILL_PATH directory; if that is not set it is created next to the
+  IES_CHECKPOINT file, and only when neither is set is tmpfile() used. The default temporary
+  directory is often a memory backed tmpfs, where spilling the prior would not save any memory.
+*/
+
+static char * ies_enkf_data_alloc_spill_path(const ies_enkf_data_type * data) {
+  const char * spill_path = ies_enkf_config_get_ies_spill_path( data->config );
+  const char * checkpoint = ies_enkf_config_get_ies_checkpoint( data->config );
+
+  if (spill_path)
+    return util_alloc_string_copy( spill_path );
+
+  if (checkpoint) {
+    char * path = util_split_alloc_dirname( checkpoint );
+    return path ? path : util_alloc_string_copy( "." );
+  }
+
+  return NULL;
+}
+
+
+static FILE * ies_enkf_data_fopen_spill_file(const char * spill_path) {
+  char * spill_file = util_alloc_sprintf( "%s/.ies_A0_XXXXXX" , spill_path );
+  FILE * stream = NULL;
+  int fd;
+
+  util_make_path( spill_path );
+  fd = mkstemp( spill_file );
+  if (fd == -1)
+    util_abort("%s: failed to create temporary file in %s - %s \n",__func__ , spill_path , strerror( errno ));
+
+  stream = fdopen( fd , "w+");
+  if (!stream)
+    util_abort("%s: failed to open %s - %s \n",__func__ , spill_file , strerror( errno ));
+
+  unlink( spill_file );
+  free( spill_file );
+  return stream;
+}
+
+
+static void ies_enkf_data_alloc_A0_stream(ies_enkf_data_type * data, int rows, int columns, int block_size) {
+  char * spill_path = ies_enkf_data_alloc_spill_path( data );
+
+  if (spill_path)
+    data->A0_stream = ies_enkf_data_fopen_spill_file( spill_path );
+  else
+    data->A0_stream = tmpfile();
+
+  if (!data->A0_stream)
+    util_abort("%s: failed to create temporary file for the prior ensemble \n",__func__);
+
+  data->A0_rows       = rows;
+  data->A0_columns    = columns;
+  data->A0_block_size = block_size;
+  free( spill_path );
+}
+
+
 void ies_enkf_data_store_initialA(ies_enkf_data_type * data, const matrix_type * A) {
-  if (!data->A0){
+  if (!data->A0_stream){
     // We store the initial ensemble to use it in final update equation                     (Line 11)
     bool dbg = ies_enkf_config_get_ies_debug( data->config ) ;
     int m_state_size = util_int_min(matrix_get_rows( A )-1, 50);
     int m_ens_size   = util_int_min(matrix_get_columns( A )-1, 16);
-    fprintf(data->log_fp,"Allocating and assigning data->A0 \n");
-    data->A0 = matrix_alloc_copy(A);
+    int block_size   = ies_enkf_config_get_ies_row_block_size( data->config );
+    fprintf(data->log_fp,"Storing data->A0 in blocks of %d rows\n", block_size);
+    ies_enkf_data_alloc_A0_stream( data , matrix_get_rows( A ) , matrix_get_columns( A ) , block_size );
+
+    for (int iblock = 0; iblock < ies_enkf_data_get_A0_block_count( data ); iblock++) {
+      int row0 = iblock * block_size;
+      int rows = util_int_min( block_size , data->A0_rows - row0 );
+      matrix_type * A0_block = matrix_alloc_shared( A , row0 , 0 , rows , data->A0_columns );
+      matrix_fwrite( A0_block , data->A0_stream );
+      matrix_free( A0_block );
+    }
     if (dbg)
-      matrix_pretty_fprint_submat(data->A0,"Ini data->A0","%11.5f",data->log_fp,0,m_state_size,0,m_ens_size);
+      matrix_pretty_fprint_submat(A,"Ini data->A0","%11.5f",data->log_fp,0,m_state_size,0,m_ens_size);
+  }
+}
+
+
+bool ies_enkf_data_has_initialA(const ies_enkf_data_type * data) {
+  return (data->A0_stream != NULL);
+}
+
+
+int ies_enkf_data_get_A0_block_count(const ies_enkf_data_type * data) {
+  if (data->A0_block_size == 0)
+    return 0;
+  return (data->A0_rows + data->A0_block_size - 1) / data->A0_block_size;
+}
+
+
+int ies_enkf_data_get_A0_block_size(const ies_enkf_data_type * data) {
+  return data->A0_block_size;
+}
+
+
+/*
+  All blocks except the last one have the same size, so the file offset of a block can be
+  computed directly; the matrix_fwrite() header is two ints.
+*/
+void ies_enkf_data_iget_A0_block(const ies_enkf_data_type * data, int iblock, matrix_type * A0_block) {
+  if (iblock < 0 || iblock >= ies_enkf_data_get_A0_block_count( data ))
+    util_abort("%s: invalid block:%d - valid range: [0,%d) \n",__func__ , iblock , ies_enkf_data_get_A0_block_count( data ));
+  {
+    long block_bytes = 2 * sizeof(int) + ((long) data->A0_block_size) * data->A0_columns * sizeof(double);
+    util_fseek( data->A0_stream , iblock * block_bytes , SEEK_SET );
+    matrix_fread( A0_block , data->A0_stream );
+  }
+}
+
+
+/*
+  Checkpointing of the iteration state. The file contains the iteration number, the masks, W, the
+  stored observation perturbations E and the prior ensemble; the prior is copied one block at a
+  time so writing and reading the checkpoint is also memory bounded.
+*/
+
+static void ies_enkf_data_fwrite_matrix(const matrix_type * m, FILE * stream) {
+  util_fwrite_bool( m != NULL , stream );
+  if (m)
+    matrix_fwrite( m , stream );
+}
+
+static matrix_type * ies_enkf_data_fread_alloc_matrix(FILE * stream) {
+  if (util_fread_bool( stream ))
+    return matrix_fread_alloc( stream );
+  return NULL;
+}
+
+static void ies_enkf_data_fwrite_mask(const bool_vector_type * mask, FILE * stream) {
+  util_fwrite_bool( mask != NULL , stream );
+  if (mask)
+    bool_vector_fwrite( mask , stream );
+}
+
+static bool_vector_type * ies_enkf_data_fread_alloc_mask(FILE * stream) {
+  if (util_fread_bool( stream ))
+    return bool_vector_fread_alloc( stream );
+  return NULL;
+}
+
+
+void ies_enkf_data_fwrite_state(const ies_enkf_data_type * data, FILE * stream) {
+  util_fwrite_int( IES_ENKF_DATA_TYPE_ID , stream );
+  util_fwrite_int( data->iteration_nr , stream );
+  util_fwrite_int( data->state_size , stream );
+  ies_enkf_data_fwrite_mask( data->ens_mask , stream );
+  ies_enkf_data_fwrite_mask( data->obs_mask0 , stream );
+  ies_enkf_data_fwrite_mask( data->obs_mask , stream );
+  ies_enkf_data_fwrite_matrix( data->W , stream );
+  ies_enkf_data_fwrite_matrix( data->E , stream );
+
+  util_fwrite_int( data->A0_rows , stream );
+  util_fwrite_int( data->A0_columns , stream );
+  util_fwrite_int( data->A0_block_size , stream );
+  if (data->A0_stream) {
+    matrix_type * A0_block = matrix_alloc( 1 , 1 );
+    for (int iblock = 0; iblock < ies_enkf_data_get_A0_block_count( data ); iblock++) {
+      ies_enkf_data_iget_A0_block( data , iblock , A0_block );
+      matrix_fwrite( A0_block , stream );
+    }
+    matrix_free( A0_block );
   }
 }
 
+
+/*
+  Will replace the current iteration state of the data instance with the state stored in
+  stream; the configuration is not touched.
+*/
+void ies_enkf_data_fread_state(ies_enkf_data_type * data, FILE * stream) {
+  if (util_fread_int( stream ) != IES_ENKF_DATA_TYPE_ID)
+    util_abort("%s: stream does not contain a stored ies_enkf state \n",__func__);
+
+  data->iteration_nr = util_fread_int( stream );
+  data->state_size   = util_fread_int( stream );
+
+  if (data->ens_mask)
+    bool_vector_free( data->ens_mask );
+  if (data->obs_mask0)
+    bool_vector_free( data->obs_mask0 );
+  if (data->obs_mask)
+    bool_vector_free( data->obs_mask );
+  data->ens_mask  = ies_enkf_data_fread_alloc_mask( stream );
+  data->obs_mask0 = ies_enkf_data_fread_alloc_mask( stream );
+  data->obs_mask  = ies_enkf_data_fread_alloc_mask( stream );
+
+  if (data->W)
+    matrix_free( data->W );
+  if (data->E)
+    matrix_free( data->E );
+  data->W = ies_enkf_data_fread_alloc_matrix( stream );
+  data->E = ies_enkf_data_fread_alloc_matrix( stream );
+
+  if (data->A0_stream) {
+    fclose( data->A0_stream );
+    data->A0_stream = NULL;
+  }
+  {
+    int rows       = util_fread_int( stream );
+    int columns    = util_fread_int( stream );
+    int block_size = util_fread_int( stream );
+
+    data->A0_rows       = 0;
+    data->A0_columns    = 0;
+    data->A0_block_size = 0;
+    if (block_size > 0) {
+      matrix_type * A0_block = matrix_alloc( 1 , 1 );
+      ies_enkf_data_alloc_A0_stream( data , rows , columns , block_size );
+      for (int iblock = 0; iblock < ies_enkf_data_get_A0_block_count( data ); iblock++) {
+        matrix_fread( A0_block , stream );
+        matrix_fwrite( A0_block , data->A0_stream );
+      }
+      matrix_free( A0_block );
+    }
+  }
+}
+
+
 void ies_enkf_data_allocateW(ies_enkf_data_type * data, int ens_size) {
   if (!data->W){
     // We initialize data-W which will store W for use in next iteration                    (Line 9)
@@ -277,7 +519,3 @@ const matrix_type * ies_enkf_data_getE(const ies_enkf_data_type * data) {
 matrix_type * ies_enkf_data_getW(const ies_enkf_data_type * data) {
   return data->W;
 }
-
-const matrix_type * ies_enkf_data_getA0(const ies_enkf_data_type * data) {
-  return data->A0;
-}
@@ -27,6 +27,7 @@ void ies_enkf_data_update_ens_mask(ies_enkf_data_type * data, const bool_vector_
 void ies_enkf_store_initial_obs_mask(ies_enkf_data_type * data, const bool_vector_type * obs_mask);
 void ies_enkf_update_obs_mask(ies_enkf_data_type * data, const bool_vector_type * obs_mask);
 void ies_enkf_data_update_state_size( ies_enkf_data_type * data, int state_size);
+int ies_enkf_data_get_state_size(const ies_enkf_data_type * data);
 
 int ies_enkf_data_get_obs_mask_size(const ies_enkf_data_type * data);
 int ies_enkf_data_get_ens_mask_size(const ies_enkf_data_type * data);
@@ -43,10 +44,16 @@ void ies_enkf_data_allocateW(ies_enkf_data_type * data, int ens_size);
 void ies_enkf_data_store_initialE(ies_enkf_data_type * data, const matrix_type * E0);
 void ies_enkf_data_augment_initialE(ies_enkf_data_type * data, const matrix_type * E0);
 void ies_enkf_data_store_initialA(ies_enkf_data_type * data, const matrix_type * A);
+bool ies_enkf_data_has_initialA(const ies_enkf_data_type * data);
+int  ies_enkf_data_get_A0_block_count(const ies_enkf_data_type * data);
+int  ies_enkf_data_get_A0_block_size(const ies_enkf_data_type * data);
+void ies_enkf_data_iget_A0_block(const ies_enkf_data_type * data, int iblock, matrix_type * A0_block);
 const matrix_type * ies_enkf_data_getE(const ies_enkf_data_type * data);
-const matrix_type * ies_enkf_data_getA0(const ies_enkf_data_type * data);
 matrix_type * ies_enkf_data_getW(const ies_enkf_data_type * data);
 
+void ies_enkf_data_fwrite_state(const ies_enkf_data_type * data, FILE * stream);
+void ies_enkf_data_fread_state(ies_enkf_data_type * data, FILE * stream);
+
 UTIL_SAFE_CAST_HEADER(ies_enkf_data);
 UTIL_SAFE_CAST_HEADER_CONST(ies_enkf_data);
 
@@ -10,6 +10,19 @@ void test_create() {
   ies_enkf_config_free(config);
 }
 
+void test_spill_path() {
+  ies_enkf_config_type * config = ies_enkf_config_alloc();
+
+  test_assert_NULL(ies_enkf_config_get_ies_spill_path(config));
+  ies_enkf_config_set_ies_spill_path(config, "/scratch/ies");
+  test_assert_string_equal("/scratch/ies", ies_enkf_config_get_ies_spill_path(config));
+  ies_enkf_config_set_ies_spill_path(config, NULL);
+  test_assert_NULL(ies_enkf_config_get_ies_spill_path(config));
+
+  ies_enkf_config_free(config);
+}
+
 int main(int argc, char ** argv) {
   test_create();
+  test_spill_path();
 }
@@ -1,7 +1,14 @@
+#include <dirent.h>
+#include <string.h>
+
 #include <ert/util/test_util.hpp>
+#include <ert/util/util.hpp>
+#include <ert/util/test_work_area.hpp>
 
 #include <ert/util/rng.h>
 
+#include <ert/res_util/matrix.hpp>
+
 #include "ies_enkf_data.h"
 #include "ies_enkf_config.h"
 
@@ -15,6 +22,148 @@ void test_create() {
 }
 
 
+static matrix_type * alloc_A(int state_size, int ens_size) {
+  matrix_type * A = matrix_alloc(state_size, ens_size);
+  for (int j = 0; j < ens_size; j++)
+    for (int i = 0; i < state_size; i++)
+      matrix_iset(A, i, j, i + 0.01 * j);
+  return A;
+}
+
+
+static void assert_A0_equal(const ies_enkf_data_type * data, const matrix_type * A) {
+  matrix_type * A0_block = matrix_alloc(1,1);
+  int block_size = ies_enkf_data_get_A0_block_size(data);
+
+  for (int iblock = 0; iblock < ies_enkf_data_get_A0_block_count(data); iblock++) {
+    ies_enkf_data_iget_A0_block(data, iblock, A0_block);
+    test_assert_int_equal(matrix_get_columns(A0_block), matrix_get_columns(A));
+    for (int j = 0; j < matrix_get_columns(A0_block); j++)
+      for (int i = 0; i < matrix_get_rows(A0_block); i++)
+        test_assert_true(matrix_iget(A0_block, i, j) == matrix_iget(A, iblock * block_size + i, j));
+  }
+  matrix_free(A0_block);
+}
+
+
+void test_store_initialA() {
+  rng_type * rng = rng_alloc( MZRAN, INIT_DEFAULT );
+  ies_enkf_data_type * data = (ies_enkf_data_type *) ies_enkf_data_alloc(rng);
+  ies_enkf_config_type * config = ies_enkf_data_get_config(data);
+  matrix_type * A = alloc_A(10, 5);
+  ecl::util::TestArea ta("store_initialA");
+
+  ies_enkf_data_open_log(data);
+  ies_enkf_config_set_ies_row_block_size(config, 4);
+  test_assert_false(ies_enkf_data_has_initialA(data));
+  ies_enkf_data_store_initialA(data, A);
+  test_assert_true(ies_enkf_data_has_initialA(data));
+  test_assert_int_equal(3, ies_enkf_data_get_A0_block_count(data));
+  assert_A0_equal(data, A);
+  ies_enkf_data_fclose_log(data);
+
+  matrix_free(A);
+  ies_enkf_data_free( data );
+  rng_free( rng );
+}
+
+
+/*
+  The spilled prior is unlinked immediately, so the spill directory is
+  created but stays empty.
+*/
+
+void test_store_initialA_spill_path() {
+  rng_type * rng = rng_alloc( MZRAN, INIT_DEFAULT );
+  ies_enkf_data_type * data = (ies_enkf_data_type *) ies_enkf_data_alloc(rng);
+  ies_enkf_config_type * config = ies_enkf_data_get_config(data);
+  matrix_type * A = alloc_A(10, 5);
+  ecl::util::TestArea ta("store_initialA_spill_path");
+
+  ies_enkf_data_open_log(data);
+  ies_enkf_config_set_ies_row_block_size(config, 4);
+  ies_enkf_config_set_ies_spill_path(config, "spill/A0");
+  ies_enkf_data_store_initialA(data, A);
+  test_assert_true(util_is_directory("spill/A0"));
+  test_assert_int_equal(3, ies_enkf_data_get_A0_block_count(data));
+  assert_A0_equal(data, A);
+  ies_enkf_data_fclose_log(data);
+  {
+    DIR * dir = opendir("spill/A0");
+    struct dirent * entry;
+    int count = 0;
+    while ((entry = readdir(dir)) != NULL)
+      if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+        count++;
+    closedir(dir);
+    test_assert_int_equal(0, count);
+  }
+
+  matrix_free(A);
+  ies_enkf_data_free( data );
+  rng_free( rng );
+}
+
+
+void test_checkpoint() {
+  rng_type * rng = rng_alloc( MZRAN, INIT_DEFAULT );
+  ies_enkf_data_type * data1 = (ies_enkf_data_type *) ies_enkf_data_alloc(rng);
+  ies_enkf_data_type * data2 = (ies_enkf_data_type *) ies_enkf_data_alloc(rng);
+  bool_vector_type * ens_mask = bool_vector_alloc(5, true);
+  bool_vector_type * obs_mask = bool_vector_alloc(3, true);
+  matrix_type * A = alloc_A(7, 5);
+  matrix_type * E = alloc_A(3, 5);
+  ecl::util::TestArea ta("checkpoint");
+
+  bool_vector_iset(obs_mask, 1, false);
+  ies_enkf_config_set_ies_row_block_size(ies_enkf_data_get_config(data1), 3);
+  ies_enkf_data_update_ens_mask(data1, ens_mask);
+  ies_enkf_store_initial_obs_mask(data1, obs_mask);
+  ies_enkf_update_obs_mask(data1, obs_mask);
+  ies_enkf_data_update_state_size(data1, 7);
+  ies_enkf_data_set_iteration_nr(data1, 3);
+
+  ies_enkf_data_open_log(data1);
+  ies_enkf_data_allocateW(data1, 5);
+  matrix_iset(ies_enkf_data_getW(data1), 2, 3, 0.25);
+  ies_enkf_data_store_initialE(data1, E);
+  ies_enkf_data_store_initialA(data1, A);
+  ies_enkf_data_fclose_log(data1);
+
+  {
+    FILE * stream = fopen("ies_state", "w");
+    ies_enkf_data_fwrite_state(data1, stream);
+    fclose(stream);
+  }
+  {
+    FILE * stream = fopen("ies_state", "r");
+    ies_enkf_data_fread_state(data2, stream);
+    fclose(stream);
+  }
+
+  test_assert_int_equal(3, ies_enkf_data_get_iteration_nr(data2));
+  test_assert_int_equal(7, ies_enkf_data_get_state_size(data2));
+  test_assert_true(bool_vector_equal(ens_mask, ies_enkf_data_get_ens_mask(data2)));
+  test_assert_true(bool_vector_equal(obs_mask, ies_enkf_data_get_obs_mask0(data2)));
+  test_assert_true(bool_vector_equal(obs_mask, ies_enkf_data_get_obs_mask(data2)));
+  test_assert_true(matrix_equal(ies_enkf_data_getW(data1), ies_enkf_data_getW(data2)));
+  test_assert_true(matrix_equal(ies_enkf_data_getE(data1), ies_enkf_data_getE(data2)));
+  test_assert_int_equal(3, ies_enkf_data_get_A0_block_count(data2));
+  assert_A0_equal(data2, A);
+
+  matrix_free(E);
+  matrix_free(A);
+  bool_vector_free(obs_mask);
+  bool_vector_free(ens_mask);
+  ies_enkf_data_free( data2 );
+  ies_enkf_data_free( data1 );
+  rng_free( rng );
+}
+
+
 int main(int argc, char ** argv) {
   test_create();
+  test_store_initialA();
+  test_store_initialA_spill_path();
+  test_checkpoint();
 }
@@ -1,5 +1,7 @@
 #include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
 #include <ert/util/rng.h>
+#include <ert/util/util.h>
 
 #include <ert/res_util/es_testdata.hpp>
 
@@ -122,8 +124,80 @@ void test_consistency_scheme_inversions(const res::es_testdata& testdata) {
 }
 
 
+/*
+  The final update A = A0*X is computed one block of rows of the stored prior at a time; the result
+  should not depend on the block size.
+*/
+
+void test_row_block_size(const res::es_testdata& testdata) {
+  rng_type * rng = rng_alloc( MZRAN, INIT_DEFAULT );
+  matrix_type * A1 = testdata.alloc_state("prior");
+  matrix_type * A2 = testdata.alloc_state("prior");
+
+  ies_enkf_data_type * ies_data1 = static_cast<ies_enkf_data_type*>(ies_enkf_data_alloc(rng));
+  ies_enkf_data_type * ies_data2 = static_cast<ies_enkf_data_type*>(ies_enkf_data_alloc(rng));
+  ies_enkf_config_set_ies_row_block_size(ies_enkf_data_get_config(ies_data2), 1);
+
+  for (int iter = 0; iter < 2; iter++) {
+    update_exact_scheme_subspace_no_truncation_diagR(testdata, ies_data1, A1, rng);
+    update_exact_scheme_subspace_no_truncation_diagR(testdata, ies_data2, A2, rng);
+  }
+  test_assert_int_equal(matrix_get_rows(A2), ies_enkf_data_get_A0_block_count(ies_data2));
+  test_assert_true( matrix_similar(A1, A2, 1e-10));
+
+  matrix_free(A1);
+  matrix_free(A2);
+  ies_enkf_data_free(ies_data1);
+  ies_enkf_data_free(ies_data2);
+  rng_free( rng );
+}
+
+
+/*
+  Two iterations with the same data instance should give the same result as one iteration in an
+  instance which writes a checkpoint, and the second iteration in a new instance which is told to
+  resume from the first iteration.
+*/
+
+void test_checkpoint(const res::es_testdata& testdata) {
+  ecl::util::TestArea ta("ies_checkpoint");
+  rng_type * rng = rng_alloc( MZRAN, INIT_DEFAULT );
+  matrix_type * A1 = testdata.alloc_state("prior");
+  matrix_type * A2 = testdata.alloc_state("prior");
+
+  ies_enkf_data_type * ies_data1 = static_cast<ies_enkf_data_type*>(ies_enkf_data_alloc(rng));
+  for (int iter = 0; iter < 2; iter++)
+    update_exact_scheme_subspace_no_truncation_diagR(testdata, ies_data1, A1, rng);
+
+  {
+    ies_enkf_data_type * ies_data2 = static_cast<ies_enkf_data_type*>(ies_enkf_data_alloc(rng));
+    ies_enkf_config_set_ies_checkpoint(ies_enkf_data_get_config(ies_data2), "ies.checkpoint");
+    update_exact_scheme_subspace_no_truncation_diagR(testdata, ies_data2, A2, rng);
+    ies_enkf_data_free(ies_data2);
+  }
+  test_assert_true( util_file_exists("ies.checkpoint"));
+
+  {
+    ies_enkf_data_type * ies_data3 = static_cast<ies_enkf_data_type*>(ies_enkf_data_alloc(rng));
+    ies_enkf_config_set_ies_checkpoint(ies_enkf_data_get_config(ies_data3), "ies.checkpoint");
+    ies_enkf_data_set_iteration_nr(ies_data3, 1);
+    update_exact_scheme_subspace_no_truncation_diagR(testdata, ies_data3, A2, rng);
+    test_assert_int_equal(2, ies_enkf_data_get_iteration_nr(ies_data3));
+    ies_enkf_data_free(ies_data3);
+  }
+  test_assert_true( matrix_similar(A1, A2, 1e-10));
+
+  matrix_free(A1);
+  matrix_free(A2);
+  ies_enkf_data_free(ies_data1);
+  rng_free( rng );
+}
+
+
 int main(int argc, char ** argv) {
   res::es_testdata testdata(argv[1]);
   test_consistency_exact_scheme_subspace_no_truncation_diagR(testdata);
   test_consistency_scheme_inversions(testdata);
+  test_row_block_size(testdata);
+  test_checkpoint(testdata);
 }
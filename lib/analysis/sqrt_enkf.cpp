@@ -99,6 +99,22 @@ bool sqrt_enkf_set_int( void * arg , const char * var_name , int value) {
 }
 
 
+/*
+  Of the bool variables of std_enkf only USE_RSVD applies to the
+  square root scheme; USE_EE and USE_GE are not supported.
+*/
+
+bool sqrt_enkf_set_bool( void * arg , const char * var_name , bool value) {
+  sqrt_enkf_data_type * module_data = sqrt_enkf_data_safe_cast( arg );
+  {
+    if (strcmp( var_name , USE_RSVD_KEY_) == 0)
+      return std_enkf_set_bool( module_data->std_data , var_name , value );
+    else
+      return false;
+  }
+}
+
+
 
 
 
@@ -124,7 +140,12 @@ void sqrt_enkf_initX(void * module_data ,
     double      * eig = (double*)util_calloc( nrmin , sizeof * eig );
 
     matrix_subtract_row_mean( S );   /* Shift away the mean */
-    enkf_linalg_lowrankCinv( S , R , W , eig , truncation , ncomp);
+    if (std_enkf_get_bool( data->std_data , USE_RSVD_KEY_ ))
+      enkf_linalg_lowrankCinv_rsvd( S , R , W , eig , truncation , ncomp ,
+                                    std_enkf_get_int( data->std_data , RSVD_OVERSAMPLING_KEY_ ) ,
+                                    std_enkf_get_int( data->std_data , RSVD_POWER_ITER_KEY_ ));
+    else
+      enkf_linalg_lowrankCinv( S , R , W , eig , truncation , ncomp);
     enkf_linalg_init_sqrtX( X , S , data->randrot , dObs , W , eig , false);
     matrix_free( W );
     free( eig );
@@ -192,6 +213,13 @@ int sqrt_enkf_get_int( const void * arg, const char * var_name) {
     }
 }
 
+bool sqrt_enkf_get_bool( const void * arg, const char * var_name) {
+    const sqrt_enkf_data_type * module_data = sqrt_enkf_data_safe_cast_const( arg );
+    {
+      return std_enkf_get_bool( module_data->std_data , var_name);
+    }
+}
+
 
 
 /*****************************************************************/
@@ -215,13 +243,13 @@ analysis_table_type LINK_NAME = {
 
   .set_int         = sqrt_enkf_set_int ,
   .set_double      = sqrt_enkf_set_double ,
-  .set_bool        = NULL ,
+  .set_bool        = sqrt_enkf_set_bool ,
   .set_string      = NULL ,
   .get_options     = sqrt_enkf_get_options,
 
   .has_var         = sqrt_enkf_has_var,
   .get_int         = sqrt_enkf_get_int,
   .get_double      = sqrt_enkf_get_double,
-  .get_bool        = NULL,
+  .get_bool        = sqrt_enkf_get_bool,
   .get_ptr         = NULL
 };
@@ -53,6 +53,9 @@
 #define DEFAULT_USE_EE              false
 #define DEFAULT_USE_GE              false
 #define DEFAULT_ANALYSIS_SCALE_DATA true
+#define DEFAULT_USE_RSVD            false
+#define DEFAULT_RSVD_OVERSAMPLING   10
+#define DEFAULT_RSVD_POWER_ITER     2
 
 
 
@@ -88,6 +91,9 @@ struct std_enkf_data_struct {
   bool      use_EE;
   bool      use_GE;
   bool      analysis_scale_data;
+  bool      use_rsvd;              // Randomized SVD of S instead of the full dgesvd()
+  int       rsvd_oversampling;
+  int       rsvd_power_iter;
 };
 
 static UTIL_SAFE_CAST_FUNCTION_CONST( std_enkf_data , STD_ENKF_TYPE_ID )
@@ -136,6 +142,9 @@ void * std_enkf_data_alloc( ) {
   data->use_EE = DEFAULT_USE_EE;
   data->use_GE = DEFAULT_USE_GE;
   data->analysis_scale_data = DEFAULT_ANALYSIS_SCALE_DATA;
+  data->use_rsvd = DEFAULT_USE_RSVD;
+  data->rsvd_oversampling = DEFAULT_RSVD_OVERSAMPLING;
+  data->rsvd_power_iter = DEFAULT_RSVD_POWER_ITER;
   return data;
 }
 
@@ -150,13 +159,17 @@ void std_enkf_data_free( void * data ) {
 static void std_enkf_initX__( matrix_type * X ,
                               const matrix_type * S0 ,
                               const matrix_type * R ,
+                              const block_diag_matrix_type * block_R ,
                               const matrix_type * E ,
                               const matrix_type * D ,
                               double truncation,
                               int    ncomp,
                               bool   bootstrap ,
                               bool   use_EE ,
-                              bool   use_GE) {
+                              bool   use_GE ,
+                              bool   use_rsvd ,
+                              int    rsvd_oversampling ,
+                              int    rsvd_power_iter) {
 
   matrix_type * S   = matrix_alloc_copy(S0);
   int nrobs         = matrix_get_rows( S );
@@ -170,14 +183,20 @@ static void std_enkf_initX__( matrix_type * X ,
 
   if (use_EE) {
      if (use_GE) {
-       enkf_linalg_lowrankE( S , E , W , eig , truncation , ncomp);
+       if (use_rsvd)
+         enkf_linalg_lowrankE_rsvd( S , E , W , eig , truncation , ncomp , rsvd_oversampling , rsvd_power_iter);
+       else
+         enkf_linalg_lowrankE( S , E , W , eig , truncation , ncomp);
      }
      else {
        matrix_type * Et = matrix_alloc_transpose( E );
        matrix_type * Cee = matrix_alloc_matmul( E , Et );
        matrix_scale( Cee , 1.0 / (ens_size - 1));
 
-       enkf_linalg_lowrankCinv( S , Cee , W , eig , truncation , ncomp);
+       if (use_rsvd)
+         enkf_linalg_lowrankCinv_rsvd( S , Cee , W , eig , truncation , ncomp , rsvd_oversampling , rsvd_power_iter);
+       else
+         enkf_linalg_lowrankCinv( S , Cee , W , eig , truncation , ncomp);
 
        matrix_free( Et );
        matrix_free( Cee );
@@ -185,7 +204,12 @@ static void std_enkf_initX__( matrix_type * X ,
 
   }
   else {
-    enkf_linalg_lowrankCinv( S , R , W , eig , truncation , ncomp);
+    if (block_R)
+      enkf_linalg_lowrankCinv_block( S , block_R , W , eig , truncation , ncomp);
+    else if (use_rsvd)
+      enkf_linalg_lowrankCinv_rsvd( S , R , W , eig , truncation , ncomp , rsvd_oversampling , rsvd_power_iter);
+    else
+      enkf_linalg_lowrankCinv( S , R , W , eig , truncation , ncomp);
   }
 
   enkf_linalg_init_stdX( X , S , D , W , eig , bootstrap);
@@ -216,7 +240,32 @@ void std_enkf_initX(void * module_data ,
     int ncomp         = data->subspace_dimension;
     double truncation = data->truncation;
 
-    std_enkf_initX__(X,S,R,E,D,truncation,ncomp,false,data->use_EE,data->use_GE);
+    std_enkf_initX__(X,S,R,NULL,E,D,truncation,ncomp,false,data->use_EE,data->use_GE,
+                     data->use_rsvd,data->rsvd_oversampling,data->rsvd_power_iter);
+  }
+}
+
+
+/*
+  Only called when the ANALYSIS_BLOCK_R option is set, i.e. without
+  USE_EE and USE_RSVD.
+*/
+void std_enkf_initX_block(void * module_data ,
+                          matrix_type * X ,
+                          const matrix_type * S ,
+                          const block_diag_matrix_type * R ,
+                          const matrix_type * dObs ,
+                          const matrix_type * E ,
+                          const matrix_type * D,
+                          rng_type * rng) {
+
+  std_enkf_data_type * data = std_enkf_data_safe_cast( module_data );
+  {
+    int ncomp         = data->subspace_dimension;
+    double truncation = data->truncation;
+
+    std_enkf_initX__(X,S,NULL,R,E,D,truncation,ncomp,false,false,false,
+                     false,0,0);
   }
 }
 
@@ -248,6 +297,10 @@ bool std_enkf_set_int( void * arg , const char * var_name , int value) {
 
     if (strcmp( var_name , ENKF_NCOMP_KEY_) == 0)
       std_enkf_set_subspace_dimension( module_data , value );
+    else if (strcmp( var_name , RSVD_OVERSAMPLING_KEY_) == 0)
+      module_data->rsvd_oversampling = value;
+    else if (strcmp( var_name , RSVD_POWER_ITER_KEY_) == 0)
+      module_data->rsvd_power_iter = value;
     else
       name_recognized = false;
 
@@ -267,6 +320,8 @@ bool std_enkf_set_bool( void * arg , const char * var_name , bool value) {
       module_data->use_GE = value;
     else if (strcmp( var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       module_data->analysis_scale_data = value;
+    else if (strcmp( var_name , USE_RSVD_KEY_) == 0)
+      module_data->use_rsvd = value;
     else
       name_recognized = false;
 
@@ -279,7 +334,8 @@ bool std_enkf_set_bool( void * arg , const char * var_name , bool value) {
 long std_enkf_get_options( void * arg , long flag ) {
   std_enkf_data_type * module_data = std_enkf_data_safe_cast( arg );
   int scale_option = (module_data->analysis_scale_data) ? ANALYSIS_SCALE_DATA : 0;
-  return module_data->option_flags + scale_option;
+  int block_option = (module_data->use_EE || module_data->use_rsvd) ? 0 : ANALYSIS_BLOCK_R;
+  return module_data->option_flags + scale_option + block_option;
 }
 
 bool std_enkf_has_var( const void * arg, const char * var_name) {
@@ -294,6 +350,12 @@ bool std_enkf_has_var( const void * arg, const char * var_name) {
       return true;
     else if (strcmp(var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       return true;
+    else if (strcmp(var_name , USE_RSVD_KEY_) == 0)
+      return true;
+    else if (strcmp(var_name , RSVD_OVERSAMPLING_KEY_) == 0)
+      return true;
+    else if (strcmp(var_name , RSVD_POWER_ITER_KEY_) == 0)
+      return true;
     else
       return false;
   }
@@ -314,6 +376,10 @@ int std_enkf_get_int( const void * arg, const char * var_name) {
   {
     if (strcmp(var_name , ENKF_NCOMP_KEY_) == 0)
       return module_data->subspace_dimension;
+    else if (strcmp(var_name , RSVD_OVERSAMPLING_KEY_) == 0)
+      return module_data->rsvd_oversampling;
+    else if (strcmp(var_name , RSVD_POWER_ITER_KEY_) == 0)
+      return module_data->rsvd_power_iter;
     else
       return -1;
   }
@@ -329,6 +395,8 @@ bool std_enkf_get_bool( const void * arg, const char * var_name) {
       return module_data->use_GE;
     else if (strcmp(var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       return module_data->analysis_scale_data;
+    else if (strcmp(var_name , USE_RSVD_KEY_) == 0)
+      return module_data->use_rsvd;
     else
       return false;
   }
@@ -369,5 +437,6 @@ analysis_table_type LINK_NAME = {
     .get_double      = std_enkf_get_double,
     .get_bool        = std_enkf_get_bool,
     .get_ptr         = NULL,
+    .initX_block     = std_enkf_initX_block ,
 };
 
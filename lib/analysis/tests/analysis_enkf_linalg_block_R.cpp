@@ -0,0 +1,154 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'analysis_enkf_linalg_block_R.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <cmath>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
+#include <ert/res_util/counter_rng.hpp>
+#include <ert/analysis/enkf_linalg.hpp>
+#include <ert/analysis/analysis_module.hpp>
+#include <ert/analysis/std_enkf.hpp>
+
+
+static matrix_type * alloc_S( int nrobs , int nrens ) {
+  matrix_type * S = matrix_alloc( nrobs , nrens );
+  double * column = (double *) util_calloc( nrobs , sizeof * column );
+
+  for (int j = 0; j < nrens; j++) {
+    counter_rng_fill_normal( 5 , j , 0 , nrobs , column );
+    matrix_set_column( S , column , j );
+  }
+  matrix_subtract_row_mean( S );
+
+  free( column );
+  return S;
+}
+
+
+/*
+  Observation blocks of size 30 (uncorrelated), 20 (exponential
+  correlation) and 50 (uncorrelated).
+*/
+
+static block_diag_matrix_type * alloc_R( bool correlated ) {
+  block_diag_matrix_type * R = block_diag_matrix_alloc( );
+  double var[50];
+
+  for (int i = 0; i < 50; i++)
+    var[i] = 0.5 + 0.01 * i;
+
+  block_diag_matrix_append_diag( R , 30 , var );
+  if (correlated) {
+    matrix_type * block = matrix_alloc( 20 , 20 );
+    for (int j = 0; j < 20; j++)
+      for (int i = 0; i < 20; i++)
+        matrix_iset( block , i , j , exp( -fabs( i - j ) / 3.0 ));
+    block_diag_matrix_append_dense( R , block );
+    matrix_free( block );
+  } else
+    block_diag_matrix_append_diag( R , 20 , var );
+  block_diag_matrix_append_diag( R , 50 , var );
+
+  return R;
+}
+
+
+static void test_lowrankCinv( bool correlated ) {
+  const int nrobs = 100;
+  const int nrens = 25;
+  matrix_type * S = alloc_S( nrobs , nrens );
+  block_diag_matrix_type * block_R = alloc_R( correlated );
+  matrix_type * R  = block_diag_matrix_alloc_dense( block_R );
+  matrix_type * W0 = matrix_alloc( nrobs , nrens );
+  matrix_type * W1 = matrix_alloc( nrobs , nrens );
+  double eig0[nrens];
+  double eig1[nrens];
+
+  enkf_linalg_lowrankCinv( S , R , W0 , eig0 , 0.99 , -1 );
+  enkf_linalg_lowrankCinv_block( S , block_R , W1 , eig1 , 0.99 , -1 );
+
+  for (int i = 0; i < nrens; i++)
+    test_assert_true( fabs( eig0[i] - eig1[i] ) < 1e-10 );
+
+  /* W*diag(eig)*W' is invariant under the sign of the singular vectors. */
+  for (int j = 0; j < nrobs; j++)
+    for (int i = 0; i < nrobs; i++) {
+      double x0 = 0;
+      double x1 = 0;
+      for (int k = 0; k < nrens; k++) {
+        x0 += matrix_iget( W0 , i , k ) * eig0[k] * matrix_iget( W0 , j , k );
+        x1 += matrix_iget( W1 , i , k ) * eig1[k] * matrix_iget( W1 , j , k );
+      }
+      test_assert_true( fabs( x0 - x1 ) < 1e-10 );
+    }
+
+  matrix_free( W1 );
+  matrix_free( W0 );
+  matrix_free( R );
+  block_diag_matrix_free( block_R );
+  matrix_free( S );
+}
+
+
+/*
+  The STD_ENKF module creates the same X matrix from the block R as
+  from the dense R; and only offers the block R path without USE_EE.
+*/
+
+static void test_std_enkf_initX( ) {
+  const int nrobs = 100;
+  const int nrens = 25;
+  matrix_type * S = alloc_S( nrobs , nrens );
+  matrix_type * D = alloc_S( nrobs , nrens );
+  block_diag_matrix_type * block_R = alloc_R( true );
+  matrix_type * R  = block_diag_matrix_alloc_dense( block_R );
+  matrix_type * X0 = matrix_alloc( nrens , nrens );
+  matrix_type * X1 = matrix_alloc( nrens , nrens );
+  void * std_data = std_enkf_data_alloc( );
+
+  test_assert_true( std_enkf_get_options( std_data , ANALYSIS_BLOCK_R ) & ANALYSIS_BLOCK_R );
+  std_enkf_initX( std_data , X0 , NULL , S , R , NULL , NULL , D , NULL );
+  std_enkf_initX_block( std_data , X1 , S , block_R , NULL , NULL , D , NULL );
+
+  for (int j = 0; j < nrens; j++)
+    for (int i = 0; i < nrens; i++)
+      test_assert_true( fabs( matrix_iget( X0 , i , j ) - matrix_iget( X1 , i , j )) < 1e-10 );
+
+  std_enkf_set_bool( std_data , USE_EE_KEY_ , true );
+  test_assert_false( std_enkf_get_options( std_data , ANALYSIS_BLOCK_R ) & ANALYSIS_BLOCK_R );
+
+  std_enkf_data_free( std_data );
+  matrix_free( X1 );
+  matrix_free( X0 );
+  matrix_free( R );
+  block_diag_matrix_free( block_R );
+  matrix_free( D );
+  matrix_free( S );
+}
+
+
+int main(int argc , char ** argv) {
+  test_lowrankCinv( false );
+  test_lowrankCinv( true );
+  test_std_enkf_initX( );
+  exit(0);
+}
@@ -0,0 +1,170 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'analysis_enkf_linalg_rsvd.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <cmath>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/matrix_blas.hpp>
+#include <ert/res_util/counter_rng.hpp>
+#include <ert/analysis/enkf_linalg.hpp>
+
+
+/*
+  S = sum_k sig[k] * u_k * v_k' with random Gaussian vectors u_k, v_k;
+  the rank of S is the number of nonzero sig values.
+*/
+
+static matrix_type * alloc_S( int nrobs , int nrens , int rank , double decay ) {
+  matrix_type * S = matrix_alloc( nrobs , nrens );
+  double * u = (double *) util_calloc( nrobs , sizeof * u );
+  double * v = (double *) util_calloc( nrens , sizeof * v );
+  double sig = 1.0;
+
+  matrix_scalar_set( S , 0 );
+  for (int k = 0; k < rank; k++) {
+    counter_rng_fill_normal( 1 , 2*k , 0 , nrobs , u );
+    counter_rng_fill_normal( 1 , 2*k + 1 , 0 , nrens , v );
+    for (int j = 0; j < nrens; j++)
+      for (int i = 0; i < nrobs; i++)
+        matrix_iadd( S , i , j , sig * u[i] * v[j] );
+    sig *= decay;
+  }
+
+  free( v );
+  free( u );
+  return S;
+}
+
+
+static void test_svdS( const matrix_type * S , double truncation , int ncomp , int oversampling , int power_iter , double tol) {
+  int nrobs = matrix_get_rows( S );
+  int nrens = matrix_get_columns( S );
+  int nrmin = util_int_min( nrobs , nrens );
+  matrix_type * U0 = matrix_alloc( nrobs , nrmin );
+  matrix_type * U1 = matrix_alloc( nrobs , nrmin );
+  matrix_type * V0T = matrix_alloc( nrmin , nrens );
+  matrix_type * V1T = matrix_alloc( nrmin , nrens );
+  double * inv_sig0 = (double *) util_calloc( nrmin , sizeof * inv_sig0 );
+  double * inv_sig1 = (double *) util_calloc( nrmin , sizeof * inv_sig1 );
+
+  int num0 = enkf_linalg_svdS( S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig0 , U0 , V0T );
+  int num1 = enkf_linalg_rsvdS( S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig1 , U1 , V1T , oversampling , power_iter );
+
+  test_assert_int_equal( num0 , num1 );
+  for (int i = 0; i < num0; i++) {
+    test_assert_true( fabs( inv_sig1[i] / inv_sig0[i] - 1 ) < tol );
+    /* The singular vectors are only determined up to the sign. */
+    test_assert_true( fabs( fabs( matrix_column_column_dot_product( U0 , i , U1 , i )) - 1 ) < tol );
+  }
+  for (int i = num0; i < nrmin; i++)
+    test_assert_true( inv_sig1[i] == 0 );
+
+  free( inv_sig1 );
+  free( inv_sig0 );
+  matrix_free( V1T );
+  matrix_free( V0T );
+  matrix_free( U1 );
+  matrix_free( U0 );
+}
+
+
+/*
+  The update only depends on W * diag(eig) * W', which is invariant
+  under the sign ambiguity of the singular vectors.
+*/
+
+static matrix_type * alloc_WeigW( const matrix_type * W , const double * eig ) {
+  matrix_type * We = matrix_alloc_copy( W );
+  matrix_type * WeigW = matrix_alloc( matrix_get_rows( W ) , matrix_get_rows( W ));
+
+  for (int j = 0; j < matrix_get_columns( We ); j++)
+    matrix_scale_column( We , j , eig[j] );
+  matrix_dgemm( WeigW , We , W , false , true , 1.0 , 0.0 );
+  matrix_free( We );
+  return WeigW;
+}
+
+
+static void test_lowrankCinv( const matrix_type * S , int ncomp ) {
+  int nrobs = matrix_get_rows( S );
+  int nrens = matrix_get_columns( S );
+  int nrmin = util_int_min( nrobs , nrens );
+  matrix_type * R  = matrix_alloc_identity( nrobs );
+  matrix_type * W0 = matrix_alloc( nrobs , nrmin );
+  matrix_type * W1 = matrix_alloc( nrobs , nrmin );
+  double * eig0 = (double *) util_calloc( nrmin , sizeof * eig0 );
+  double * eig1 = (double *) util_calloc( nrmin , sizeof * eig1 );
+
+  matrix_scale( R , 0.01 );
+  enkf_linalg_lowrankCinv( S , R , W0 , eig0 , -1 , ncomp );
+  enkf_linalg_lowrankCinv_rsvd( S , R , W1 , eig1 , -1 , ncomp , 10 , 1 );
+  {
+    matrix_type * X0 = alloc_WeigW( W0 , eig0 );
+    matrix_type * X1 = alloc_WeigW( W1 , eig1 );
+    double scale = 0;
+    double diff  = 0;
+
+    for (int j = 0; j < nrobs; j++)
+      for (int i = 0; i < nrobs; i++) {
+        scale = util_double_max( scale , fabs( matrix_iget( X0 , i , j )));
+        diff  = util_double_max( diff , fabs( matrix_iget( X0 , i , j ) - matrix_iget( X1 , i , j )));
+      }
+    test_assert_true( diff < 1e-8 * scale );
+
+    matrix_free( X1 );
+    matrix_free( X0 );
+  }
+
+  free( eig1 );
+  free( eig0 );
+  matrix_free( W1 );
+  matrix_free( W0 );
+  matrix_free( R );
+}
+
+
+int main(int argc , char ** argv) {
+  {
+    /* Exact low rank: the sketch captures the full range of S. */
+    matrix_type * S = alloc_S( 400 , 60 , 15 , 0.8 );
+    test_svdS( S , -1 , 10 , 5 , 0 , 1e-8 );
+    test_svdS( S , 0.99 , -1 , 5 , 0 , 1e-8 );
+    test_lowrankCinv( S , 12 );
+    matrix_free( S );
+  }
+
+  {
+    /* Full rank with decaying spectrum: needs the power iterations. */
+    matrix_type * S = alloc_S( 300 , 100 , 100 , 0.7 );
+    test_svdS( S , -1 , 8 , 10 , 2 , 1e-6 );
+    test_svdS( S , 0.99 , -1 , 10 , 2 , 1e-6 );
+    matrix_free( S );
+  }
+
+  {
+    /* More members than observations. */
+    matrix_type * S = alloc_S( 40 , 100 , 40 , 0.9 );
+    test_svdS( S , 0.95 , -1 , 10 , 2 , 1e-6 );
+    matrix_free( S );
+  }
+
+  exit(0);
+}
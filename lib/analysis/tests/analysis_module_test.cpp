@@ -83,6 +83,32 @@ void test_invalid_mask_size() {
 
 
 
+/*
+  SQRT_ENKF accepts the randomized SVD variables of STD_ENKF, and uses
+  them in initX(); the other bool variables of STD_ENKF are rejected.
+*/
+
+void test_sqrt_rsvd_vars() {
+  analysis_module_type * module = analysis_module_alloc_internal("SQRT_ENKF");
+
+  test_assert_true( analysis_module_has_var( module , "USE_RSVD" ));
+  test_assert_false( analysis_module_get_bool( module , "USE_RSVD" ));
+  test_assert_true( analysis_module_set_var( module , "USE_RSVD" , "True" ));
+  test_assert_true( analysis_module_get_bool( module , "USE_RSVD" ));
+
+  test_assert_true( analysis_module_set_var( module , "RSVD_OVERSAMPLING" , "5" ));
+  test_assert_int_equal( 5 , analysis_module_get_int( module , "RSVD_OVERSAMPLING" ));
+  test_assert_true( analysis_module_set_var( module , "RSVD_POWER_ITER" , "1" ));
+  test_assert_int_equal( 1 , analysis_module_get_int( module , "RSVD_POWER_ITER" ));
+
+  test_assert_false( analysis_module_set_var( module , "USE_EE" , "True" ));
+
+  analysis_module_free( module );
+}
+
+
+
 int main(int argc, char **argv) {
   test_invalid_mask_size();
+  test_sqrt_rsvd_vars();
 }
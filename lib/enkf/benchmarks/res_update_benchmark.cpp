@@ -0,0 +1,700 @@
+/*
+   Copyright (C) 2019  Equinor ASA, Norway.
+
+   The file 'res_update_benchmark.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+/*
+  Benchmark driver for the analysis update. The program generates
+  synthetic ensembles and times the stages of the update separately:
+
+    linalg      : init_update() + initX()/updateA() for the STD_ENKF,
+                  SQRT_ENKF, IES_ENKF and RML_ENKF modules; STD_ENKF and
+                  SQRT_ENKF are also run with USE_RSVD, reported as the
+                  STD_ENKF_RSVD and SQRT_ENKF_RSVD variants.
+    matmul      : matrix_inplace_matmul_mt2() of A (nparam x nens) with X.
+    serialize   : enkf_node_serialize() of a GEN_KW parameter for all
+                  realizations into A, threaded over realizations in the
+                  same way as enkf_main.
+                  The enkf_node_deserialize() of A back to storage is
+                  reported as the deserialize stage.
+    update      : enkf_main_smoother_update() against a temporary
+                  block_fs case.
+
+  The parameter count, observation count, ensemble size and thread
+  count are swept over the cartesian product of the comma separated
+  lists given on the commandline:
+
+     res_update_benchmark [--nparam 1000,10000] [--nobs 100] [--nens 100]
+                          [--threads 1,4] [--repeat 3] [--stages linalg,matmul]
+                          [--output results.csv] [--testdata path]
+                          [--save-testdata path] [--ies lib] [--rml lib]
+
+  Each line in the output is one (stage, variant, size) combination:
+
+     stage,variant,nparam,nobs,nens,threads,repeat,min_seconds,mean_seconds
+
+  where threads is zero for the stages which do not take a thread
+  count. With --testdata the S, E, R, D and dObs matrices are loaded
+  with res::es_testdata instead of being generated, and --save-testdata
+  stores the generated matrices so a run can be reproduced; the linalg
+  stage is the only one using these matrices.
+*/
+
+#define HAVE_THREAD_POOL 1
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/bool_vector.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/thread_pool.hpp>
+#include <ert/res_util/counter_rng.hpp>
+#include <ert/res_util/es_testdata.hpp>
+
+#include <ert/analysis/analysis_module.hpp>
+
+#include <ert/enkf/enkf_types.hpp>
+#include <ert/enkf/enkf_node.hpp>
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_main.hpp>
+#include <ert/enkf/res_config.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/active_list.hpp>
+#include <ert/enkf/ensemble_config.hpp>
+#include <ert/enkf/forward_load_context.hpp>
+#include <ert/enkf/gen_data.hpp>
+
+#ifndef IES_LIB
+#define IES_LIB "ies.so"
+#endif
+
+#ifndef RML_LIB
+#define RML_LIB "rml_enkf.so"
+#endif
+
+#define BENCHMARK_SEED   1234
+#define PARAM_KEY        "PARAMS"
+#define RESPONSE_KEY     "RESPONSE"
+
+
+namespace {
+
+struct benchmark_config {
+  std::vector<int> nparam      = {10000};
+  std::vector<int> nobs        = {100};
+  std::vector<int> nens        = {100};
+  std::vector<int> threads     = {1};
+  std::vector<std::string> stages = {"linalg", "matmul", "serialize", "update"};
+  int repeat                   = 3;
+  std::string output;
+  std::string testdata;
+  std::string save_testdata;
+  std::string ies_lib          = IES_LIB;
+  std::string rml_lib          = RML_LIB;
+};
+
+
+std::vector<int> parse_int_list(const char * arg) {
+  std::vector<int> values;
+  char * copy = util_alloc_string_copy( arg );
+  for (char * token = strtok(copy, ","); token; token = strtok(NULL, ",")) {
+    int value;
+    if (!util_sscanf_int(token, &value) || value <= 0)
+      util_abort("%s: could not interpret: %s as a positive integer \n",__func__ , token);
+    values.push_back(value);
+  }
+  free( copy );
+  return values;
+}
+
+
+std::vector<std::string> parse_string_list(const char * arg) {
+  std::vector<std::string> values;
+  char * copy = util_alloc_string_copy( arg );
+  for (char * token = strtok(copy, ","); token; token = strtok(NULL, ","))
+    values.push_back(token);
+  free( copy );
+  return values;
+}
+
+
+benchmark_config parse_args(int argc, char ** argv) {
+  benchmark_config config;
+  for (int iarg = 1; iarg < argc; iarg += 2) {
+    std::string key = argv[iarg];
+    if (iarg + 1 == argc)
+      util_exit("Missing value for argument: %s\n", argv[iarg]);
+
+    const char * value = argv[iarg + 1];
+    if (key == "--nparam")
+      config.nparam = parse_int_list(value);
+    else if (key == "--nobs")
+      config.nobs = parse_int_list(value);
+    else if (key == "--nens")
+      config.nens = parse_int_list(value);
+    else if (key == "--threads")
+      config.threads = parse_int_list(value);
+    else if (key == "--repeat")
+      config.repeat = parse_int_list(value)[0];
+    else if (key == "--stages")
+      config.stages = parse_string_list(value);
+    else if (key == "--output")
+      config.output = value;
+    else if (key == "--testdata")
+      config.testdata = value;
+    else if (key == "--save-testdata")
+      config.save_testdata = value;
+    else if (key == "--ies")
+      config.ies_lib = value;
+    else if (key == "--rml")
+      config.rml_lib = value;
+    else
+      util_exit("Unrecognized argument: %s\n", argv[iarg]);
+  }
+  return config;
+}
+
+
+std::string abs_path(const std::string& path) {
+  if (path.empty())
+    return path;
+
+  char * tmp = util_alloc_abs_path(path.c_str());
+  std::string result = tmp;
+  free(tmp);
+  return result;
+}
+
+
+bool has_stage(const benchmark_config& config, const std::string& stage) {
+  for (const auto& s : config.stages)
+    if (s == stage)
+      return true;
+  return false;
+}
+
+
+class result_writer {
+public:
+  explicit result_writer(const std::string& filename) {
+    if (filename.empty())
+      this->stream = stdout;
+    else
+      this->stream = util_mkdir_fopen(filename.c_str(), "w");
+    fprintf(this->stream, "stage,variant,nparam,nobs,nens,threads,repeat,min_seconds,mean_seconds\n");
+    fflush(this->stream);
+  }
+
+  ~result_writer() {
+    if (this->stream != stdout)
+      fclose(this->stream);
+  }
+
+  void add(const char * stage, const char * variant, int nparam, int nobs, int nens, int threads, const std::vector<double>& timing) {
+    double min_time = timing[0];
+    double sum_time = 0;
+    for (double t : timing) {
+      min_time = util_double_min(min_time, t);
+      sum_time += t;
+    }
+    fprintf(this->stream, "%s,%s,%d,%d,%d,%d,%d,%.6f,%.6f\n",
+            stage, variant, nparam, nobs, nens, threads, (int) timing.size(), min_time, sum_time / timing.size());
+    fflush(this->stream);
+  }
+
+private:
+  FILE * stream;
+};
+
+
+/*
+  The setup function is called before each repetition and is not
+  timed; the run function is timed.
+*/
+std::vector<double> time_repeat(int repeat, const std::function<void()>& setup, const std::function<void()>& run) {
+  std::vector<double> timing;
+  for (int i = 0; i < repeat; i++) {
+    setup();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    timing.push_back(elapsed.count());
+  }
+  return timing;
+}
+
+
+matrix_type * alloc_normal_matrix(int rows, int columns, uint64_t stream) {
+  matrix_type * m = matrix_alloc(rows, columns);
+  double * column = (double *) util_calloc(rows, sizeof * column);
+  for (int j = 0; j < columns; j++) {
+    counter_rng_fill_normal(BENCHMARK_SEED, (stream << 32) | j, 0, rows, column);
+    matrix_set_column(m, column, j);
+  }
+  free(column);
+  return m;
+}
+
+
+/*
+  Synthetic observation side matrices with unit observation error;
+  the predicted responses S are standard normal and the observed
+  values are drawn from the same distribution.
+*/
+res::es_testdata * alloc_testdata(int nobs, int nens) {
+  matrix_type * S    = alloc_normal_matrix(nobs, nens, 1);
+  matrix_type * E    = alloc_normal_matrix(nobs, nens, 2);
+  matrix_type * obs  = alloc_normal_matrix(nobs, 1, 3);
+  matrix_type * R    = matrix_alloc_identity(nobs);
+  matrix_type * dObs = matrix_alloc(nobs, 2);
+  matrix_type * D    = matrix_alloc(nobs, nens);
+
+  for (int i = 0; i < nobs; i++) {
+    matrix_iset(dObs, i, 0, matrix_iget(obs, i, 0));
+    matrix_iset(dObs, i, 1, 1.0);
+  }
+
+  for (int j = 0; j < nens; j++)
+    for (int i = 0; i < nobs; i++)
+      matrix_iset(D, i, j, matrix_iget(dObs, i, 0) + matrix_iget(E, i, j) - matrix_iget(S, i, j));
+
+  res::es_testdata * testdata = new res::es_testdata(S, R, dObs, D, E);
+
+  matrix_free(D);
+  matrix_free(dObs);
+  matrix_free(R);
+  matrix_free(obs);
+  matrix_free(E);
+  matrix_free(S);
+  return testdata;
+}
+
+
+analysis_module_type * alloc_module(const benchmark_config& config, const char * name) {
+  analysis_module_load_status_enum load_status;
+  analysis_module_type * module;
+
+  if (strcmp(name, "IES_ENKF") == 0)
+    module = analysis_module_alloc_external__(config.ies_lib.c_str(), false, &load_status);
+  else if (strcmp(name, "RML_ENKF") == 0)
+    module = analysis_module_alloc_external__(config.rml_lib.c_str(), false, &load_status);
+  else
+    module = analysis_module_alloc_internal__(name, false, &load_status);
+
+  if (load_status != LOAD_OK)
+    return NULL;
+
+  return module;
+}
+
+
+/*
+  The update as it is called from enkf_main_analysis_update() for one
+  dataset with no localisation, i.e. for the modules which do not
+  update A themselves the final matmul is included.
+*/
+void run_module(analysis_module_type * module, const res::es_testdata& testdata, matrix_type * A, matrix_type * X, thread_pool_type * tp, rng_type * rng) {
+  analysis_module_init_update(module, testdata.ens_mask, testdata.obs_mask, testdata.S, testdata.R, testdata.dObs, testdata.E, testdata.D, rng);
+  if (analysis_module_check_option(module, ANALYSIS_UPDATE_A))
+    analysis_module_updateA(module, A, testdata.S, testdata.R, testdata.dObs, testdata.E, testdata.D, NULL, rng);
+  else {
+    const matrix_type * localA = analysis_module_check_option(module, ANALYSIS_USE_A) ? A : NULL;
+    analysis_module_initX(module, X, localA, testdata.S, testdata.R, testdata.dObs, testdata.E, testdata.D, rng);
+    matrix_inplace_matmul_mt2(A, X, tp);
+  }
+  analysis_module_complete_update(module);
+}
+
+
+/*
+  One variant of the linalg stage: an analysis module, optionally with
+  the randomized SVD (USE_RSVD) instead of the full SVD of S.
+*/
+struct linalg_variant {
+  const char * name;
+  const char * module_name;
+  bool use_rsvd;
+};
+
+
+analysis_module_type * alloc_variant_module(const benchmark_config& config, const linalg_variant& variant) {
+  analysis_module_type * module = alloc_module(config, variant.module_name);
+  if (module && variant.use_rsvd) {
+    if (!analysis_module_set_var(module, "USE_RSVD", "True")) {
+      analysis_module_free(module);
+      return NULL;
+    }
+  }
+  return module;
+}
+
+
+void benchmark_linalg(const benchmark_config& config, result_writer& writer, const res::es_testdata& testdata, int nparam) {
+  const linalg_variant variants[] = {{"STD_ENKF",       "STD_ENKF",  false},
+                                     {"STD_ENKF_RSVD",  "STD_ENKF",  true},
+                                     {"SQRT_ENKF",      "SQRT_ENKF", false},
+                                     {"SQRT_ENKF_RSVD", "SQRT_ENKF", true},
+                                     {"IES_ENKF",       "IES_ENKF",  false},
+                                     {"RML_ENKF",       "RML_ENKF",  false}};
+  int nobs = testdata.active_obs_size;
+  int nens = testdata.active_ens_size;
+  rng_type * rng = rng_alloc(MZRAN, INIT_DEFAULT);
+  matrix_type * A0 = alloc_normal_matrix(nparam, nens, 4);
+  matrix_type * A  = matrix_alloc(nparam, nens);
+  matrix_type * X  = matrix_alloc(nens, nens);
+  thread_pool_type * tp = thread_pool_alloc(1, false);
+
+  for (const auto& variant : variants) {
+    analysis_module_type * module = alloc_variant_module(config, variant);
+    if (!module) {
+      fprintf(stderr, "** Warning: failed to load analysis module: %s - skipped\n", variant.name);
+      continue;
+    }
+
+    /* A new module instance for every repetition, the IES module keeps state between updates. */
+    std::vector<double> timing = time_repeat(config.repeat,
+                                             [&]() {
+                                               analysis_module_free(module);
+                                               module = alloc_variant_module(config, variant);
+                                               matrix_assign(A, A0);
+                                             },
+                                             [&]() { run_module(module, testdata, A, X, tp, rng); });
+    writer.add("linalg", variant.name, nparam, nobs, nens, 0, timing);
+    analysis_module_free(module);
+  }
+
+  thread_pool_free(tp);
+  matrix_free(X);
+  matrix_free(A);
+  matrix_free(A0);
+  rng_free(rng);
+}
+
+
+void benchmark_matmul(const benchmark_config& config, result_writer& writer, int nparam, int nobs, int nens) {
+  matrix_type * A0 = alloc_normal_matrix(nparam, nens, 5);
+  matrix_type * X  = alloc_normal_matrix(nens, nens, 6);
+  matrix_type * A  = matrix_alloc(nparam, nens);
+
+  for (int threads : config.threads) {
+    thread_pool_type * tp = thread_pool_alloc(threads, false);
+    std::vector<double> timing = time_repeat(config.repeat,
+                                             [&]() { matrix_assign(A, A0); },
+                                             [&]() { matrix_inplace_matmul_mt2(A, X, tp); });
+    writer.add("matmul", "matrix_inplace_matmul_mt2", nparam, nobs, nens, threads, timing);
+    thread_pool_free(tp);
+  }
+
+  matrix_free(A);
+  matrix_free(X);
+  matrix_free(A0);
+}
+
+
+/*****************************************************************/
+
+/*
+  A minimal case with one GEN_KW parameter with nparam standard normal
+  coefficients, and one GEN_DATA response with nobs elements which are
+  all observed with unit error. The case is stored in a temporary
+  directory which is removed when the instance goes out of scope.
+*/
+class benchmark_case {
+public:
+  benchmark_case(int nparam, int nobs, int nens) :
+    nparam(nparam), nobs(nobs), nens(nens)
+  {
+    char tmp_path[] = "/tmp/res_update_benchmark_XXXXXX";
+    if (!mkdtemp(tmp_path))
+      util_abort("%s: failed to create temporary directory \n",__func__);
+    this->path = tmp_path;
+
+    this->write_config();
+    this->res_config = res_config_alloc_load((this->path + "/config.ert").c_str());
+    this->enkf_main = enkf_main_alloc(this->res_config, true, false);
+    this->populate();
+  }
+
+  ~benchmark_case() {
+    enkf_main_free(this->enkf_main);
+    res_config_free(this->res_config);
+    util_clear_directory(this->path.c_str(), false, true);
+  }
+
+  enkf_main_type * get_enkf_main() { return this->enkf_main; }
+  const enkf_config_node_type * get_param_config() const { return ensemble_config_get_node(enkf_main_get_ensemble_config(this->enkf_main), PARAM_KEY); }
+  int get_nparam() const { return this->nparam; }
+  int get_nens() const { return this->nens; }
+
+private:
+  std::string path;
+  int nparam;
+  int nobs;
+  int nens;
+  res_config_type * res_config;
+  enkf_main_type * enkf_main;
+
+  void write_file(const std::string& name, const std::function<void(FILE *)>& write) const {
+    FILE * stream = util_fopen((this->path + "/" + name).c_str(), "w");
+    write(stream);
+    fclose(stream);
+  }
+
+  void write_config() const {
+    matrix_type * obs = alloc_normal_matrix(this->nobs, 1, 7);
+
+    this->write_file("config.ert", [&](FILE * stream) {
+        fprintf(stream, "NUM_REALIZATIONS %d\n", this->nens);
+        fprintf(stream, "MIN_REALIZATIONS 1\n");
+        fprintf(stream, "ENSPATH storage\n");
+        fprintf(stream, "RUNPATH simulations/real_%%d/iter_%%d\n");
+        fprintf(stream, "TIME_MAP time_map\n");
+        fprintf(stream, "OBS_CONFIG observations\n");
+        fprintf(stream, "GEN_KW %s params.tmpl params.txt params.priors\n", PARAM_KEY);
+        fprintf(stream, "GEN_DATA %s RESULT_FILE:response_%%d.txt REPORT_STEPS:0 INPUT_FORMAT:ASCII\n", RESPONSE_KEY);
+      });
+
+    this->write_file("time_map", [&](FILE * stream) {
+        fprintf(stream, "1/1/2000\n");
+      });
+
+    this->write_file("params.tmpl", [&](FILE * stream) {
+        for (int i = 0; i < this->nparam; i++)
+          fprintf(stream, "<P%d>\n", i);
+      });
+
+    this->write_file("params.priors", [&](FILE * stream) {
+        for (int i = 0; i < this->nparam; i++)
+          fprintf(stream, "P%d NORMAL 0 1\n", i);
+      });
+
+    this->write_file("obs_data.txt", [&](FILE * stream) {
+        for (int i = 0; i < this->nobs; i++)
+          fprintf(stream, "%g 1.0\n", matrix_iget(obs, i, 0));
+      });
+
+    this->write_file("observations", [&](FILE * stream) {
+        fprintf(stream, "GENERAL_OBSERVATION OBS {\n");
+        fprintf(stream, "   DATA     = %s;\n", RESPONSE_KEY);
+        fprintf(stream, "   RESTART  = 0;\n");
+        fprintf(stream, "   OBS_FILE = obs_data.txt;\n");
+        fprintf(stream, "};\n");
+      });
+
+    matrix_free(obs);
+  }
+
+
+  /*
+    Initializes the parameters from the prior and loads synthetic
+    responses for all realizations into the current case, and marks
+    the realizations as having data.
+  */
+  void populate() {
+    ensemble_config_type * ensemble_config = enkf_main_get_ensemble_config(this->enkf_main);
+    enkf_fs_type * fs = enkf_main_get_fs(this->enkf_main);
+    state_map_type * state_map = enkf_fs_get_state_map(fs);
+    rng_type * rng = rng_alloc(MZRAN, INIT_DEFAULT);
+    forward_load_context_type * load_context = forward_load_context_alloc(NULL, false, NULL, NULL);
+    enkf_node_type * param_node = enkf_node_alloc(ensemble_config_get_node(ensemble_config, PARAM_KEY));
+    enkf_node_type * response_node = enkf_node_alloc(ensemble_config_get_node(ensemble_config, RESPONSE_KEY));
+    double * response = (double *) util_calloc(this->nobs, sizeof * response);
+    std::string response_file = this->path + "/response.txt";
+
+    forward_load_context_select_step(load_context, 0);
+    for (int iens = 0; iens < this->nens; iens++) {
+      node_id_type node_id = {.report_step = 0, .iens = iens};
+
+      enkf_node_initialize(param_node, iens, rng);
+      enkf_node_store(param_node, fs, false, node_id);
+
+      counter_rng_fill_normal(BENCHMARK_SEED, (8ULL << 32) | iens, 0, this->nobs, response);
+      this->write_file("response.txt", [&](FILE * stream) {
+          for (int i = 0; i < this->nobs; i++)
+            fprintf(stream, "%g\n", response[i]);
+        });
+      gen_data_fload_with_report_step((gen_data_type *) enkf_node_value_ptr(response_node), response_file.c_str(), load_context);
+      enkf_node_store(response_node, fs, false, node_id);
+
+      state_map_iset(state_map, iens, STATE_HAS_DATA);
+    }
+    enkf_fs_fsync(fs);
+
+    free(response);
+    enkf_node_free(response_node);
+    enkf_node_free(param_node);
+    forward_load_context_free(load_context);
+    rng_free(rng);
+  }
+};
+
+
+struct serialize_job {
+  enkf_fs_type * fs;
+  const enkf_config_node_type * config_node;
+  const active_list_type * active_list;
+  matrix_type * A;
+  int iens1;
+  int iens2;
+  bool serialize;
+};
+
+
+void * serialize_range(void * arg) {
+  serialize_job * job = (serialize_job *) arg;
+  enkf_node_type * node = enkf_node_alloc(job->config_node);
+
+  for (int iens = job->iens1; iens < job->iens2; iens++) {
+    node_id_type node_id = {.report_step = 0, .iens = iens};
+    if (job->serialize)
+      enkf_node_serialize(node, job->fs, node_id, job->active_list, job->A, 0, iens);
+    else
+      enkf_node_deserialize(node, job->fs, node_id, job->active_list, job->A, 0, iens);
+  }
+
+  enkf_node_free(node);
+  return NULL;
+}
+
+
+void run_serialize(benchmark_case& bcase, enkf_fs_type * fs, matrix_type * A, int threads, bool serialize) {
+  int nens = bcase.get_nens();
+  active_list_type * active_list = active_list_alloc();
+  thread_pool_type * tp = thread_pool_alloc(threads, true);
+  std::vector<serialize_job> jobs(threads);
+
+  for (int ithread = 0; ithread < threads; ithread++) {
+    jobs[ithread] = {fs, bcase.get_param_config(), active_list, A,
+                     (ithread * nens) / threads, ((ithread + 1) * nens) / threads, serialize};
+    thread_pool_add_job(tp, serialize_range, &jobs[ithread]);
+  }
+  thread_pool_join(tp);
+
+  thread_pool_free(tp);
+  active_list_free(active_list);
+}
+
+
+void benchmark_serialize(const benchmark_config& config, result_writer& writer, benchmark_case& bcase, int nobs) {
+  enkf_main_type * enkf_main = bcase.get_enkf_main();
+  enkf_fs_type * source_fs = enkf_main_get_fs(enkf_main);
+  enkf_fs_type * target_fs = enkf_main_mount_alt_fs(enkf_main, "serialize_target", true);
+  matrix_type * A = matrix_alloc(bcase.get_nparam(), bcase.get_nens());
+
+  for (int threads : config.threads) {
+    std::vector<double> timing = time_repeat(config.repeat,
+                                             [&]() { },
+                                             [&]() { run_serialize(bcase, source_fs, A, threads, true); });
+    writer.add("serialize", "GEN_KW", bcase.get_nparam(), nobs, bcase.get_nens(), threads, timing);
+
+    timing = time_repeat(config.repeat,
+                         [&]() { },
+                         [&]() { run_serialize(bcase, target_fs, A, threads, false); });
+    writer.add("deserialize", "GEN_KW", bcase.get_nparam(), nobs, bcase.get_nens(), threads, timing);
+  }
+
+  matrix_free(A);
+  enkf_fs_decref(target_fs);
+}
+
+
+void benchmark_update(const benchmark_config& config, result_writer& writer, benchmark_case& bcase, int nobs) {
+  enkf_main_type * enkf_main = bcase.get_enkf_main();
+  enkf_fs_type * source_fs = enkf_main_get_fs(enkf_main);
+  enkf_fs_type * target_fs = enkf_main_mount_alt_fs(enkf_main, "update_target", true);
+
+  std::vector<double> timing = time_repeat(config.repeat,
+                                           [&]() { },
+                                           [&]() {
+                                             if (!enkf_main_smoother_update(enkf_main, source_fs, target_fs))
+                                               util_abort("%s: the smoother update failed \n",__func__);
+                                           });
+  writer.add("update", "enkf_main_smoother_update", bcase.get_nparam(), nobs, bcase.get_nens(), 0, timing);
+  enkf_fs_decref(target_fs);
+}
+
+}
+
+
+int main(int argc, char ** argv) {
+  benchmark_config config = parse_args(argc, argv);
+  result_writer writer(config.output);
+  char * cwd = util_alloc_cwd();
+
+  config.testdata = abs_path(config.testdata);
+  config.save_testdata = abs_path(config.save_testdata);
+
+  /*
+    The IES module writes its log file to the current working
+    directory, the benchmark is therefore run in a temporary directory.
+  */
+  char work_path[] = "/tmp/res_update_benchmark_XXXXXX";
+  if (!mkdtemp(work_path))
+    util_abort("%s: failed to create temporary directory \n",__func__);
+  util_chdir(work_path);
+
+  if (!config.testdata.empty()) {
+    res::es_testdata testdata(config.testdata.c_str());
+    for (int nparam : config.nparam)
+      benchmark_linalg(config, writer, testdata, nparam);
+  } else {
+    for (int nens : config.nens) {
+      for (int nobs : config.nobs) {
+        res::es_testdata * testdata = alloc_testdata(nobs, nens);
+        if (!config.save_testdata.empty()) {
+          std::string save_path = config.save_testdata + "/" + std::to_string(nobs) + "x" + std::to_string(nens);
+          util_make_path(save_path.c_str());
+          testdata->save(save_path);
+        }
+
+        for (int nparam : config.nparam) {
+          if (has_stage(config, "linalg"))
+            benchmark_linalg(config, writer, *testdata, nparam);
+
+          if (has_stage(config, "matmul"))
+            benchmark_matmul(config, writer, nparam, nobs, nens);
+
+          if (has_stage(config, "serialize") || has_stage(config, "update")) {
+            benchmark_case bcase(nparam, nobs, nens);
+
+            if (has_stage(config, "serialize"))
+              benchmark_serialize(config, writer, bcase, nobs);
+
+            if (has_stage(config, "update"))
+              benchmark_update(config, writer, bcase, nobs);
+          }
+        }
+        delete testdata;
+      }
+    }
+  }
+
+  util_chdir(cwd);
+  util_clear_directory(work_path, false, true);
+  free(cwd);
+  exit(0);
+}
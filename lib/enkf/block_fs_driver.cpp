@@ -306,6 +306,26 @@ static void block_fs_driver_save_vector(void * _driver , const char * node_key ,
   }
 }
 
+/*
+  All the vectors of one realization live in the same block_fs
+  instance, so they can be written with one block_fs call.
+*/
+
+static void block_fs_driver_save_vectors(void * _driver , const stringlist_type * node_keys , int iens , const vector_type * buffers) {
+  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
+  block_fs_driver_assert_cast(driver);
+  {
+    stringlist_type * keys = stringlist_alloc_new();
+    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
+
+    for (int i=0; i < stringlist_get_size( node_keys ); i++)
+      stringlist_append_owned_ref( keys , block_fs_driver_alloc_vector_key( driver , stringlist_iget( node_keys , i ) , iens ));
+
+    block_fs_fwrite_buffers( bfs->block_fs , keys , buffers );
+    stringlist_free( keys );
+  }
+}
+
 /*****************************************************************/
 
 void block_fs_driver_unlink_node(void * _driver , const char * node_key , int report_step , int iens ) {
@@ -414,6 +434,7 @@ static block_fs_driver_type * block_fs_driver_alloc(int num_fs) {
   driver->save_vector   = block_fs_driver_save_vector;
   driver->unlink_vector = block_fs_driver_unlink_vector;
   driver->has_vector    = block_fs_driver_has_vector;
+  driver->save_vectors  = block_fs_driver_save_vectors;
 
   driver->free_driver   = block_fs_driver_free;
   driver->fsync_driver  = block_fs_driver_fsync;
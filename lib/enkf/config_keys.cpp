@@ -331,6 +331,22 @@ const char * config_keys_get_gen_kw_export_name_key() {
   return GEN_KW_EXPORT_NAME_KEY;
 }
 
+const char * config_keys_get_lazy_summary_load_key() {
+  return LAZY_SUMMARY_LOAD_KEY;
+}
+
+const char * config_keys_get_columnar_summary_storage_key() {
+  return COLUMNAR_SUMMARY_STORAGE_KEY;
+}
+
+const char * config_keys_get_load_read_threads_key() {
+  return LOAD_READ_THREADS_KEY;
+}
+
+const char * config_keys_get_load_store_threads_key() {
+  return LOAD_STORE_THREADS_KEY;
+}
+
 const char * config_keys_get_history_source_key() {
   return HISTORY_SOURCE_KEY;
 }
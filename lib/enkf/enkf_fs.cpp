@@ -18,6 +18,7 @@
 
 #include <sys/types.h>
 #include <string.h>
+#include <time.h>
 #include <errno.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -30,6 +31,8 @@
 #include <ert/util/type_macros.h>
 #include <ert/res_util/arg_pack.hpp>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+#include <ert/util/bool_vector.h>
 #include <ert/res_util/arg_pack.hpp>
 
 #include <ert/res_util/path_fmt.hpp>
@@ -45,7 +48,12 @@
 #include <ert/enkf/time_map.hpp>
 #include <ert/enkf/state_map.hpp>
 #include <ert/enkf/summary_key_set.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_ref.hpp>
+#include <ert/enkf/summary_block.hpp>
+#include <ert/enkf/enkf_util.hpp>
 #include <ert/enkf/misfit_ensemble.hpp>
+#include <ert/enkf/ensemble_stats.hpp>
 #include <ert/enkf/cases_config.hpp>
 #include <ert/enkf/custom_kw_config_set.hpp>
 
@@ -211,8 +219,13 @@
 #define TIME_MAP_FILE             "time-map"
 #define STATE_MAP_FILE            "state-map"
 #define MISFIT_ENSEMBLE_FILE      "misfit-ensemble"
+#define ENSEMBLE_STATS_FILE       "ensemble-stats"
 #define CASE_CONFIG_FILE          "case_config"
 #define CUSTOM_KW_CONFIG_SET_FILE "custom_kw_config_set"
+#define SUMMARY_REF_FILE          "summary-ref"
+#define SUMMARY_BLOCK_KEYS_FILE   "summary-block-keys"
+#define SUMMARY_BLOCK_NODE_KEY    "__SUMMARY_BLOCK__"
+#define SUMMARY_BLOCK_CACHE_SIZE  64
 
 struct enkf_fs_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -233,7 +246,38 @@ struct enkf_fs_struct {
   state_map_type            * state_map;
   summary_key_set_type      * summary_key_set;
   misfit_ensemble_type      * misfit_ensemble;
+  ensemble_stats_type       * ensemble_stats;
   custom_kw_config_set_type * custom_kw_config_set;
+
+  /*
+     Summary references for the realizations which have been loaded with
+     LAZY_SUMMARY_LOAD, see summary_ref.cpp; they are read from disk on
+     first use. Replaced references are kept in summary_ref_storage
+     until the filesystem is unmounted, because another thread might
+     still be reading from them.
+  */
+  pthread_mutex_t             summary_ref_mutex;
+  vector_type               * summary_refs;
+  bool_vector_type          * summary_ref_loaded;
+  vector_type               * summary_ref_storage;
+
+  /*
+     Columnar summary storage, see summary_block.cpp. The index of a
+     realization is read from the dynamic driver on first use, and the
+     most recently read blocks are kept in a small cache. Everything is
+     protected by summary_block_mutex. The key dictionary has its own
+     lock for lookups, but keys are only added - and the dictionary
+     file written - with summary_block_mutex held. The generation of
+     a realization is incremented every time its index is changed.
+  */
+  summary_block_keys_type   * summary_block_keys;
+  pthread_mutex_t             summary_block_mutex;
+  vector_type               * summary_block_indices;
+  bool_vector_type          * summary_block_index_loaded;
+  vector_type               * summary_block_cache;
+  int_vector_type           * summary_block_cache_iens;
+  int_vector_type           * summary_block_cache_id;
+  int_vector_type           * summary_block_generation;
   /*
      The variables below here are for storing arbitrary files within
      the enkf_fs storage directory, but not as serialized enkf_nodes.
@@ -302,6 +346,19 @@ static enkf_fs_type * enkf_fs_alloc_empty( const char * mount_point ) {
   fs->summary_key_set        = summary_key_set_alloc();
   fs->custom_kw_config_set   = custom_kw_config_set_alloc();
   fs->misfit_ensemble        = misfit_ensemble_alloc();
+  fs->ensemble_stats         = ensemble_stats_alloc();
+  fs->summary_refs           = vector_alloc_new();
+  fs->summary_ref_loaded     = bool_vector_alloc( 0 , false );
+  fs->summary_ref_storage    = vector_alloc_new();
+  pthread_mutex_init( &fs->summary_ref_mutex , NULL );
+  fs->summary_block_keys          = summary_block_keys_alloc();
+  fs->summary_block_indices       = vector_alloc_new();
+  fs->summary_block_index_loaded  = bool_vector_alloc( 0 , false );
+  fs->summary_block_cache         = vector_alloc_new();
+  fs->summary_block_cache_iens    = int_vector_alloc( 0 , 0 );
+  fs->summary_block_cache_id      = int_vector_alloc( 0 , 0 );
+  fs->summary_block_generation    = int_vector_alloc( 0 , 0 );
+  pthread_mutex_init( &fs->summary_block_mutex , NULL );
   fs->index                  = NULL;
   fs->parameter              = NULL;
   fs->dynamic_forecast       = NULL;
@@ -606,12 +663,61 @@ static void enkf_fs_fread_misfit( enkf_fs_type * fs ) {
 static void enkf_fs_fwrite_misfit( enkf_fs_type * fs ) {
   if (misfit_ensemble_initialized( fs->misfit_ensemble )) {
     FILE * stream = enkf_fs_open_case_file( fs , MISFIT_ENSEMBLE_FILE , "w");
+    misfit_ensemble_mark_changed( fs->misfit_ensemble , fs->state_map );
     misfit_ensemble_fwrite( fs->misfit_ensemble , stream );
     fclose( stream );
   }
 }
 
 
+static void enkf_fs_fread_summary_block_keys( enkf_fs_type * fs ) {
+  FILE * stream = enkf_fs_open_excase_file( fs , SUMMARY_BLOCK_KEYS_FILE );
+  if (stream != NULL) {
+    summary_block_keys_fread( fs->summary_block_keys , stream );
+    fclose( stream );
+  }
+}
+
+
+/*
+  The dictionary is written to a temporary file which is renamed into
+  place, so a reader never sees a partially written file. Must be
+  called with the summary_block_mutex held.
+*/
+
+static void enkf_fs_fwrite_summary_block_keys( enkf_fs_type * fs ) {
+  char * filename = enkf_fs_alloc_case_filename( fs , SUMMARY_BLOCK_KEYS_FILE );
+  char * tmp_file = util_alloc_sprintf( "%s.tmp" , filename );
+  FILE * stream = util_mkdir_fopen( tmp_file , "w");
+
+  summary_block_keys_fwrite( fs->summary_block_keys , stream );
+  fclose( stream );
+  if (rename( tmp_file , filename ) != 0)
+    util_abort("%s: failed to rename %s -> %s \n",__func__ , tmp_file , filename );
+
+  free( tmp_file );
+  free( filename );
+}
+
+
+static void enkf_fs_fread_ensemble_stats( enkf_fs_type * fs ) {
+  FILE * stream = enkf_fs_open_excase_file( fs , ENSEMBLE_STATS_FILE );
+  if (stream != NULL) {
+    ensemble_stats_fread( fs->ensemble_stats , stream );
+    fclose( stream );
+  }
+}
+
+
+static void enkf_fs_fwrite_ensemble_stats( enkf_fs_type * fs ) {
+  if (ensemble_stats_is_dirty( fs->ensemble_stats )) {
+    FILE * stream = enkf_fs_open_case_file( fs , ENSEMBLE_STATS_FILE , "w");
+    ensemble_stats_fwrite( fs->ensemble_stats , stream );
+    fclose( stream );
+  }
+}
+
+
 
 int enkf_fs_disk_version(const char * mount_point ) {
   int disk_version = -1;
@@ -675,6 +781,8 @@ enkf_fs_type * enkf_fs_mount(const char * mount_point) {
   enkf_fs_fread_summary_key_set(fs);
   enkf_fs_fread_custom_kw_config_set(fs);
   enkf_fs_fread_misfit(fs);
+  enkf_fs_fread_ensemble_stats(fs);
+  enkf_fs_fread_summary_block_keys(fs);
 
   enkf_fs_get_ref(fs);
   return fs;
@@ -709,6 +817,7 @@ static void enkf_fs_umount(enkf_fs_type * fs) {
   if (!fs->read_only) {
     enkf_fs_fsync(fs);
     enkf_fs_fwrite_misfit(fs);
+    enkf_fs_fwrite_ensemble_stats(fs);
   }
 
   int refcount = fs->refcount;
@@ -743,6 +852,19 @@ static void enkf_fs_umount(enkf_fs_type * fs) {
   time_map_free(fs->time_map);
   cases_config_free(fs->cases_config);
   misfit_ensemble_free(fs->misfit_ensemble);
+  ensemble_stats_free(fs->ensemble_stats);
+  vector_free(fs->summary_refs);
+  vector_free(fs->summary_ref_storage);
+  bool_vector_free(fs->summary_ref_loaded);
+  pthread_mutex_destroy(&fs->summary_ref_mutex);
+  summary_block_keys_free(fs->summary_block_keys);
+  vector_free(fs->summary_block_indices);
+  bool_vector_free(fs->summary_block_index_loaded);
+  vector_free(fs->summary_block_cache);
+  int_vector_free(fs->summary_block_cache_iens);
+  int_vector_free(fs->summary_block_cache_id);
+  int_vector_free(fs->summary_block_generation);
+  pthread_mutex_destroy(&fs->summary_block_mutex);
   free(fs);
 }
 
@@ -812,15 +934,513 @@ void enkf_fs_fread_node(enkf_fs_type * enkf_fs , buffer_type * buffer ,
 }
 
 
-void enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
+static summary_ref_type * enkf_fs_get_summary_ref( enkf_fs_type * fs , int iens ) {
+  summary_ref_type * summary_ref;
+
+  pthread_mutex_lock( &fs->summary_ref_mutex );
+  if (!bool_vector_safe_iget( fs->summary_ref_loaded , iens )) {
+    char * filename = enkf_fs_alloc_case_member_filename( fs , iens , SUMMARY_REF_FILE );
+
+    if (util_file_exists( filename )) {
+      summary_ref = summary_ref_fread_alloc( filename );
+      vector_append_owned_ref( fs->summary_ref_storage , summary_ref , summary_ref_free__ );
+      if (vector_get_size( fs->summary_refs ) <= iens)
+        vector_grow_NULL( fs->summary_refs , iens + 1 );
+      vector_iset_ref( fs->summary_refs , iens , summary_ref );
+    }
+    bool_vector_iset( fs->summary_ref_loaded , iens , true );
+    free( filename );
+  }
+  summary_ref = (summary_ref_type *) vector_safe_iget( fs->summary_refs , iens );
+  pthread_mutex_unlock( &fs->summary_ref_mutex );
+
+  return summary_ref;
+}
+
+
+/*
+  Only summary vectors, i.e. vectors of DYNAMIC_RESULT type, can be
+  found through a summary reference; the reference takes precedence
+  over anything stored by the driver.
+*/
+
+static summary_ref_type * enkf_fs_get_vector_summary_ref( enkf_fs_type * fs , const char * node_key , enkf_var_type var_type , int iens ) {
+  if (var_type == DYNAMIC_RESULT) {
+    summary_ref_type * summary_ref = enkf_fs_get_summary_ref( fs , iens );
+    if (summary_ref && summary_ref_has_key( summary_ref , node_key ))
+      return summary_ref;
+  }
+  return NULL;
+}
+
+
+/*
+  Stores a summary reference for realization @iens; the filesystem
+  takes ownership of @summary_ref. A NULL @summary_ref will remove the
+  current reference - that should be done when the summary vectors
+  of the realization are stored in the normal way.
+*/
+
+void enkf_fs_set_summary_ref( enkf_fs_type * fs , int iens , summary_ref_type * summary_ref ) {
+  if (fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , fs->mount_point);
+
+  if (!summary_ref && !enkf_fs_get_summary_ref( fs , iens ))
+    return;
+
+  {
+    char * filename = enkf_fs_alloc_case_member_filename( fs , iens , SUMMARY_REF_FILE );
+
+    pthread_mutex_lock( &fs->summary_ref_mutex );
+    if (summary_ref) {
+      summary_ref_fwrite( summary_ref , filename );
+      vector_append_owned_ref( fs->summary_ref_storage , summary_ref , summary_ref_free__ );
+    } else
+      util_unlink_existing( filename );
+
+    if (vector_get_size( fs->summary_refs ) <= iens)
+      vector_grow_NULL( fs->summary_refs , iens + 1 );
+    vector_iset_ref( fs->summary_refs , iens , summary_ref );
+    bool_vector_iset( fs->summary_ref_loaded , iens , true );
+    pthread_mutex_unlock( &fs->summary_ref_mutex );
+
+    free( filename );
+  }
+
+  /* The keys found through the reference are not known here. */
+  ensemble_stats_clear( fs->ensemble_stats );
+}
+
+
+/*****************************************************************/
+/* Columnar summary storage - see summary_block.cpp. */
+
+static char * enkf_fs_alloc_summary_block_key( int block_id ) {
+  return util_alloc_sprintf( "%s:%d" , SUMMARY_BLOCK_NODE_KEY , block_id );
+}
+
+
+/*
+  Returns the block index of realization @iens, or NULL if nothing has
+  been stored for this realization with the columnar storage. Must be
+  called with the summary_block_mutex held.
+*/
+
+static summary_block_index_type * enkf_fs_get_summary_block_index__( enkf_fs_type * fs , int iens ) {
+  if (!bool_vector_safe_iget( fs->summary_block_index_loaded , iens )) {
+    fs_driver_type * driver = fs->dynamic_forecast;
+    if (driver->has_vector( driver , SUMMARY_BLOCK_NODE_KEY , iens )) {
+      buffer_type * buffer = buffer_alloc( 1024 );
+      driver->load_vector( driver , SUMMARY_BLOCK_NODE_KEY , iens , buffer );
+      buffer_rewind( buffer );
+      {
+        summary_block_index_type * index = summary_block_index_fread_alloc( buffer );
+        if (vector_get_size( fs->summary_block_indices ) <= iens)
+          vector_grow_NULL( fs->summary_block_indices , iens + 1 );
+        vector_iset_owned_ref( fs->summary_block_indices , iens , index , summary_block_index_free__ );
+      }
+      buffer_free( buffer );
+    }
+    bool_vector_iset( fs->summary_block_index_loaded , iens , true );
+  }
+  return (summary_block_index_type *) vector_safe_iget( fs->summary_block_indices , iens );
+}
+
+
+static void enkf_fs_fwrite_summary_block_index__( enkf_fs_type * fs , const summary_block_index_type * index , int iens ) {
+  fs_driver_type * driver = fs->dynamic_forecast;
+  buffer_type * buffer = buffer_alloc( 1024 );
+  summary_block_index_fwrite( index , buffer );
+  driver->save_vector( driver , SUMMARY_BLOCK_NODE_KEY , iens , buffer );
+  buffer_free( buffer );
+}
+
+
+static void enkf_fs_drop_cached_summary_block__( enkf_fs_type * fs , int iens , int block_id ) {
+  for (int i = 0; i < vector_get_size( fs->summary_block_cache ); i++) {
+    if ((int_vector_iget( fs->summary_block_cache_iens , i ) == iens) && (int_vector_iget( fs->summary_block_cache_id , i ) == block_id)) {
+      vector_idel( fs->summary_block_cache , i );
+      int_vector_idel( fs->summary_block_cache_iens , i );
+      int_vector_idel( fs->summary_block_cache_id , i );
+      return;
+    }
+  }
+}
+
+
+/*
+  Removes the blobs of the blocks in @released, and stores the index.
+  Must be called with the summary_block_mutex held, and after every
+  change of the index; the generation tells readers which have located
+  a block before the change that the block id can have been reused.
+*/
+
+static void enkf_fs_release_summary_blocks__( enkf_fs_type * fs , const summary_block_index_type * index , const int_vector_type * released , int iens ) {
+  fs_driver_type * driver = fs->dynamic_forecast;
+  enkf_fs_fwrite_summary_block_index__( fs , index , iens );
+  int_vector_iset( fs->summary_block_generation , iens , int_vector_safe_iget( fs->summary_block_generation , iens ) + 1 );
+
+  for (int i = 0; i < int_vector_size( released ); i++) {
+    int block_id = int_vector_iget( released , i );
+    enkf_fs_drop_cached_summary_block__( fs , iens , block_id );
+    if (driver->unlink_vector) {
+      char * block_key = enkf_fs_alloc_summary_block_key( block_id );
+      driver->unlink_vector( driver , block_key , iens );
+      free( block_key );
+    }
+  }
+}
+
+
+/*
+  Keys which are stored as separate vectors are removed from the
+  columnar storage, otherwise the stale value in the block would
+  shadow the new vector.
+*/
+
+static void enkf_fs_remove_summary_block_keys( enkf_fs_type * fs , const stringlist_type * node_keys , enkf_var_type var_type , int iens ) {
+  if (var_type != DYNAMIC_RESULT)
+    return;
+
+  if (summary_block_keys_get_size( fs->summary_block_keys ) == 0)
+    return;
+
+  pthread_mutex_lock( &fs->summary_block_mutex );
+  {
+    summary_block_index_type * index = enkf_fs_get_summary_block_index__( fs , iens );
+    if (index) {
+      int_vector_type * released = int_vector_alloc( 0 , 0 );
+      bool removed = false;
+
+      for (int i = 0; i < stringlist_get_size( node_keys ); i++) {
+        int key_id = summary_block_keys_get_id( fs->summary_block_keys , stringlist_iget( node_keys , i ));
+        if ((key_id >= 0) && summary_block_index_remove_key( index , key_id , released ))
+          removed = true;
+      }
+
+      if (removed)
+        enkf_fs_release_summary_blocks__( fs , index , released , iens );
+
+      int_vector_free( released );
+    }
+  }
+  pthread_mutex_unlock( &fs->summary_block_mutex );
+}
+
+
+/*
+  Finds the block and column of the key @key_id in the index of
+  realization @iens. Must be called with the summary_block_mutex held.
+*/
+
+static bool enkf_fs_locate_summary_block_key__( enkf_fs_type * fs , int key_id , int iens , int * block_id , int * column ) {
+  summary_block_index_type * index = enkf_fs_get_summary_block_index__( fs , iens );
+  if (index)
+    return summary_block_index_get( index , key_id , block_id , column );
+
+  return false;
+}
+
+
+static bool enkf_fs_locate_summary_block_key( enkf_fs_type * fs , const char * node_key , enkf_var_type var_type , int iens , int * block_id , int * column ) {
+  bool found = false;
+  if (var_type != DYNAMIC_RESULT)
+    return false;
+
+  {
+    int key_id = summary_block_keys_get_id( fs->summary_block_keys , node_key );
+    if (key_id < 0)
+      return false;
+
+    pthread_mutex_lock( &fs->summary_block_mutex );
+    found = enkf_fs_locate_summary_block_key__( fs , key_id , iens , block_id , column );
+    pthread_mutex_unlock( &fs->summary_block_mutex );
+  }
+  return found;
+}
+
+
+static const summary_block_type * enkf_fs_get_cached_summary_block__( const enkf_fs_type * fs , int iens , int block_id ) {
+  for (int i = 0; i < vector_get_size( fs->summary_block_cache ); i++) {
+    if ((int_vector_iget( fs->summary_block_cache_iens , i ) == iens) && (int_vector_iget( fs->summary_block_cache_id , i ) == block_id))
+      return (const summary_block_type *) vector_iget_const( fs->summary_block_cache , i );
+  }
+  return NULL;
+}
+
+
+static summary_block_type * enkf_fs_fread_summary_block__( enkf_fs_type * fs , int iens , int block_id ) {
+  fs_driver_type * driver = fs->dynamic_forecast;
+  char * block_key = enkf_fs_alloc_summary_block_key( block_id );
+  buffer_type * buffer = buffer_alloc( 1024 );
+  summary_block_type * block;
+
+  driver->load_vector( driver , block_key , iens , buffer );
+  buffer_rewind( buffer );
+  block = summary_block_fread_alloc( buffer );
+  buffer_free( buffer );
+  free( block_key );
+  return block;
+}
+
+
+/*
+  Returns the block holding @node_key for realization @iens, from the
+  cache if possible, and the column of the key in @column; returns
+  NULL if the key is not in the columnar storage. When a block is
+  returned the summary_block_mutex is locked, and the caller must
+  unlock it when it is done with the block; the block is owned by the
+  cache.
+
+  The blob is read without holding the lock, so that several threads
+  can read blocks at the same time. If the index of the realization has
+  changed in the meantime the block id can have been reused for other
+  keys; the key is then located again, and the block read with the lock
+  held.
+*/
+
+static const summary_block_type * enkf_fs_lock_summary_block( enkf_fs_type * fs , const char * node_key , enkf_var_type var_type , int iens , int * column ) {
+  const summary_block_type * cached_block;
+  summary_block_type * block;
+  int block_id;
+  int generation;
+  int key_id;
+
+  if (var_type != DYNAMIC_RESULT)
+    return NULL;
+
+  key_id = summary_block_keys_get_id( fs->summary_block_keys , node_key );
+  if (key_id < 0)
+    return NULL;
+
+  pthread_mutex_lock( &fs->summary_block_mutex );
+  if (!enkf_fs_locate_summary_block_key__( fs , key_id , iens , &block_id , column )) {
+    pthread_mutex_unlock( &fs->summary_block_mutex );
+    return NULL;
+  }
+
+  cached_block = enkf_fs_get_cached_summary_block__( fs , iens , block_id );
+  if (cached_block)
+    return cached_block;
+
+  generation = int_vector_safe_iget( fs->summary_block_generation , iens );
+  pthread_mutex_unlock( &fs->summary_block_mutex );
+  block = enkf_fs_fread_summary_block__( fs , iens , block_id );
+  pthread_mutex_lock( &fs->summary_block_mutex );
+
+  if (generation != int_vector_safe_iget( fs->summary_block_generation , iens )) {
+    summary_block_free( block );
+    if (!enkf_fs_locate_summary_block_key__( fs , key_id , iens , &block_id , column )) {
+      pthread_mutex_unlock( &fs->summary_block_mutex );
+      return NULL;
+    }
+
+    cached_block = enkf_fs_get_cached_summary_block__( fs , iens , block_id );
+    if (cached_block)
+      return cached_block;
+
+    block = enkf_fs_fread_summary_block__( fs , iens , block_id );
+  } else {
+    cached_block = enkf_fs_get_cached_summary_block__( fs , iens , block_id );
+    if (cached_block) {
+      /* Another thread has read the same block in the meantime. */
+      summary_block_free( block );
+      return cached_block;
+    }
+  }
+
+  if (vector_get_size( fs->summary_block_cache ) == SUMMARY_BLOCK_CACHE_SIZE) {
+    vector_idel( fs->summary_block_cache , 0 );
+    int_vector_idel( fs->summary_block_cache_iens , 0 );
+    int_vector_idel( fs->summary_block_cache_id , 0 );
+  }
+  vector_append_owned_ref( fs->summary_block_cache , block , summary_block_free__ );
+  int_vector_append( fs->summary_block_cache_iens , iens );
+  int_vector_append( fs->summary_block_cache_id , block_id );
+  return block;
+}
+
+
+static bool enkf_fs_fread_summary_block_vector( enkf_fs_type * fs , buffer_type * buffer , const char * node_key , enkf_var_type var_type , int iens ) {
+  int column;
+  const summary_block_type * block = enkf_fs_lock_summary_block( fs , node_key , var_type , iens , &column );
+  if (!block)
+    return false;
+
+  summary_block_fwrite_column( block , column , buffer );
+  pthread_mutex_unlock( &fs->summary_block_mutex );
+  return true;
+}
+
+
+/*
+  Stores the summary vectors in @data_vectors - double_vector
+  instances - with the columnar storage; the vectors are split in
+  blocks of SUMMARY_BLOCK_CHUNK_SIZE keys. Vectors which are already
+  stored for this realization are replaced.
+*/
+
+void enkf_fs_fwrite_summary_block( enkf_fs_type * fs , const stringlist_type * node_keys , const vector_type * data_vectors , int iens ) {
+  int num_keys = stringlist_get_size( node_keys );
+  if (fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , fs->mount_point);
+
+  if (num_keys != vector_get_size( data_vectors ))
+    util_abort("%s: internal error - size mismatch between keys and vectors\n",__func__);
+
+  if (num_keys == 0)
+    return;
+
+  {
+    int_vector_type * key_ids = int_vector_alloc( 0 , 0 );
+
+    pthread_mutex_lock( &fs->summary_block_mutex );
+    {
+      int num_known_keys = summary_block_keys_get_size( fs->summary_block_keys );
+      for (int i = 0; i < num_keys; i++)
+        int_vector_append( key_ids , summary_block_keys_add_key( fs->summary_block_keys , stringlist_iget( node_keys , i )));
+
+      /*
+        The dictionary must be on disk before any index refers to the
+        new keys; adding the keys and writing the file under the same
+        lock ensures that the newest dictionary is the one on disk.
+      */
+      if (summary_block_keys_get_size( fs->summary_block_keys ) != num_known_keys)
+        enkf_fs_fwrite_summary_block_keys( fs );
+    }
+    {
+      fs_driver_type * driver = fs->dynamic_forecast;
+      summary_block_index_type * index = enkf_fs_get_summary_block_index__( fs , iens );
+      int_vector_type * released = int_vector_alloc( 0 , 0 );
+      int_vector_type * block_key_ids = int_vector_alloc( 0 , 0 );
+      buffer_type * buffer = buffer_alloc( 1024 );
+      time_t write_time = time( NULL );
+
+      if (!index) {
+        index = summary_block_index_alloc( );
+        if (vector_get_size( fs->summary_block_indices ) <= iens)
+          vector_grow_NULL( fs->summary_block_indices , iens + 1 );
+        vector_iset_owned_ref( fs->summary_block_indices , iens , index , summary_block_index_free__ );
+      }
+
+      for (int offset = 0; offset < num_keys; offset += SUMMARY_BLOCK_CHUNK_SIZE) {
+        int num_columns = util_int_min( SUMMARY_BLOCK_CHUNK_SIZE , num_keys - offset );
+        int block_id = summary_block_index_alloc_block_id( index , released );
+        summary_block_type * block = summary_block_alloc( data_vectors , offset , num_columns , write_time );
+        char * block_key = enkf_fs_alloc_summary_block_key( block_id );
+
+        buffer_clear( buffer );
+        summary_block_fwrite( block , buffer );
+        driver->save_vector( driver , block_key , iens , buffer );
+        enkf_fs_drop_cached_summary_block__( fs , iens , block_id );
+
+        int_vector_reset( block_key_ids );
+        for (int column = 0; column < num_columns; column++)
+          int_vector_append( block_key_ids , int_vector_iget( key_ids , offset + column ));
+        summary_block_index_add_block( index , block_id , block_key_ids , released );
+
+        free( block_key );
+        summary_block_free( block );
+      }
+      enkf_fs_release_summary_blocks__( fs , index , released , iens );
+
+      buffer_free( buffer );
+      int_vector_free( block_key_ids );
+      int_vector_free( released );
+    }
+    pthread_mutex_unlock( &fs->summary_block_mutex );
+    int_vector_free( key_ids );
+  }
+  ensemble_stats_invalidate_keys( fs->ensemble_stats , node_keys );
+}
+
+
+/*
+  Reads the value at @report_step of all the summary vectors in
+  @node_keys for realization @iens into @values; each block is read
+  only once. Vectors which are not found in the columnar storage are
+  read separately. Returns false if one of the vectors is missing.
+*/
+
+bool enkf_fs_fread_summary_step( enkf_fs_type * fs , const stringlist_type * node_keys , int iens , int report_step , double_vector_type * values ) {
+  bool complete = true;
+  buffer_type * buffer = NULL;
+  double_vector_reset( values );
+
+  for (int i = 0; i < stringlist_get_size( node_keys ); i++) {
+    const char * node_key = stringlist_iget( node_keys , i );
+    const summary_block_type * block;
+    int column;
+    double value = SUMMARY_UNDEF;
+
+    block = enkf_fs_lock_summary_block( fs , node_key , DYNAMIC_RESULT , iens , &column );
+    if (block) {
+      value = summary_block_iget( block , report_step , column );
+      pthread_mutex_unlock( &fs->summary_block_mutex );
+    } else if (enkf_fs_has_vector( fs , node_key , DYNAMIC_RESULT , iens )) {
+      if (!buffer)
+        buffer = buffer_alloc( 1024 );
+
+      if (!enkf_fs_fread_vector( fs , buffer , node_key , DYNAMIC_RESULT , iens ))
+        complete = false;
+      else {
+        buffer_fskip_time_t( buffer );
+        enkf_util_assert_buffer_type( buffer , SUMMARY );
+        {
+          int size = buffer_fread_int( buffer );
+          double default_value = buffer_fread_double( buffer );
+          if (report_step < size) {
+            buffer_fseek( buffer , report_step * sizeof(double) , SEEK_CUR );
+            value = buffer_fread_double( buffer );
+          } else
+            value = default_value;
+        }
+      }
+    } else
+      complete = false;
+
+    double_vector_iset( values , i , value );
+  }
+
+  if (buffer)
+    buffer_free( buffer );
+  return complete;
+}
+
+
+
+/*
+  Returns false if the vector is read through a summary reference and
+  the UNSMRY file can no longer be read, e.g. because it has been
+  rewritten by a rerun of the realization; the vector should then be
+  treated as missing. The other storage paths abort on failure.
+*/
+
+bool enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
                           const char * node_key ,
                           enkf_var_type var_type ,
                           int iens) {
 
-  fs_driver_type * driver = (fs_driver_type * ) enkf_fs_select_driver(enkf_fs , var_type , node_key );
+  summary_ref_type * summary_ref = enkf_fs_get_vector_summary_ref( enkf_fs , node_key , var_type , iens );
+  if (summary_ref) {
+    if (!summary_ref_fread_buffer( summary_ref , node_key , buffer )) {
+      res_log_fwarning("Failed to load vector:%s for iens:%d from %s",node_key , iens ,
+                       summary_ref_get_unsmry_file( summary_ref ));
+      return false;
+    }
+    return true;
+  }
 
-  buffer_rewind( buffer );
-  driver->load_vector(driver , node_key ,  iens , buffer);
+  if (enkf_fs_fread_summary_block_vector( enkf_fs , buffer , node_key , var_type , iens ))
+    return true;
+
+  {
+    fs_driver_type * driver = (fs_driver_type * ) enkf_fs_select_driver(enkf_fs , var_type , node_key );
+
+    buffer_rewind( buffer );
+    driver->load_vector(driver , node_key ,  iens , buffer);
+  }
+  return true;
 }
 
 
@@ -832,8 +1452,18 @@ bool enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_
 
 
 bool enkf_fs_has_vector(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int iens ) {
-  fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type ,  node_key));
-  return driver->has_vector(driver , node_key , iens );
+  summary_ref_type * summary_ref = enkf_fs_get_vector_summary_ref( enkf_fs , node_key , var_type , iens );
+  if (summary_ref)
+    return summary_ref_is_valid( summary_ref );
+  {
+    int block_id , column;
+    if (enkf_fs_locate_summary_block_key( enkf_fs , node_key , var_type , iens , &block_id , &column ))
+      return true;
+  }
+  {
+    fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type ,  node_key));
+    return driver->has_vector(driver , node_key , iens );
+  }
 }
 
 void enkf_fs_fwrite_node(enkf_fs_type * enkf_fs , buffer_type * buffer , const char * node_key, enkf_var_type var_type,
@@ -851,6 +1481,23 @@ void enkf_fs_fwrite_node(enkf_fs_type * enkf_fs , buffer_type * buffer , const c
       driver->save_node(driver , node_key , report_step , iens , buffer);
     }
   }
+  ensemble_stats_invalidate( enkf_fs->ensemble_stats , node_key );
+}
+
+
+/*
+  Copies the stored blob of a node from one case to another, without
+  decoding it into an enkf_node instance. The buffer is used as
+  scratch space, and can be reused between calls. Observe that the
+  blob is copied verbatim, so this should only be used for node types
+  where the stored data does not depend on the report step, see
+  enkf_node_copy().
+*/
+
+void enkf_fs_copy_node(enkf_fs_type * src_fs , enkf_fs_type * target_fs , buffer_type * buffer , const char * node_key , enkf_var_type var_type,
+                       int src_step , int src_iens , int target_step , int target_iens ) {
+  enkf_fs_fread_node( src_fs , buffer , node_key , var_type , src_step , src_iens );
+  enkf_fs_fwrite_node( target_fs , buffer , node_key , var_type , target_step , target_iens );
 }
 
 
@@ -865,6 +1512,40 @@ void enkf_fs_fwrite_vector(enkf_fs_type * enkf_fs , buffer_type * buffer , const
       driver->save_vector(driver , node_key  , iens , buffer);
     }
   }
+  {
+    stringlist_type * node_keys = stringlist_alloc_new( );
+    stringlist_append_copy( node_keys , node_key );
+    enkf_fs_remove_summary_block_keys( enkf_fs , node_keys , var_type , iens );
+    stringlist_free( node_keys );
+  }
+  ensemble_stats_invalidate( enkf_fs->ensemble_stats , node_key );
+}
+
+
+/*
+  Stores the vectors of many nodes for one realization; the drivers
+  which implement save_vectors() can do this in one operation,
+  otherwise the vectors are written one at a time.
+*/
+
+void enkf_fs_fwrite_vectors(enkf_fs_type * enkf_fs , const vector_type * buffers , const stringlist_type * node_keys, enkf_var_type var_type,
+                            int iens ) {
+  if (enkf_fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , enkf_fs->mount_point);
+
+  if (stringlist_get_size( node_keys ) == 0)
+    return;
+  {
+    fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type , stringlist_iget( node_keys , 0 )));
+    if (driver->save_vectors)
+      driver->save_vectors(driver , node_keys , iens , buffers);
+    else {
+      for (int i=0; i < stringlist_get_size( node_keys ); i++)
+        driver->save_vector(driver , stringlist_iget( node_keys , i ) , iens , (buffer_type *) vector_iget( buffers , i ));
+    }
+  }
+  enkf_fs_remove_summary_block_keys( enkf_fs , node_keys , var_type , iens );
+  ensemble_stats_invalidate_keys( enkf_fs->ensemble_stats , node_keys );
 }
 
 
@@ -992,6 +1673,10 @@ misfit_ensemble_type * enkf_fs_get_misfit_ensemble( const enkf_fs_type * fs ) {
   return fs->misfit_ensemble;
 }
 
+ensemble_stats_type * enkf_fs_get_ensemble_stats( const enkf_fs_type * fs ) {
+  return fs->ensemble_stats;
+}
+
 void enkf_fs_increase_run_count(enkf_fs_type * fs) {
   fs->runcount = fs->runcount + 1;
 }
@@ -110,6 +110,7 @@
 #include <ert/enkf/ert_run_context.hpp>
 #include <ert/enkf/run_arg.hpp>
 #include <ert/enkf/callback_arg.hpp>
+#include <ert/enkf/load_timing.hpp>
 
 
 /**/
@@ -160,6 +161,7 @@ struct enkf_main_struct {
   enkf_state_type       ** ensemble;         /* The ensemble ... */
   int                      ens_size;         /* The size of the ensemble */
   bool                     verbose;
+  load_timing_type       * load_timing;      /* Timing of the last load from the forward model. */
 };
 
 
@@ -311,6 +313,7 @@ void enkf_main_free(enkf_main_type * enkf_main){
     enkf_obs_free(enkf_main->obs);
 
   ranking_table_free( enkf_main->ranking_table );
+  load_timing_free( enkf_main->load_timing );
   enkf_main_free_ensemble( enkf_main );
   enkf_main_close_fs( enkf_main );
   res_log_close();
@@ -905,6 +908,88 @@ static FILE * enkf_main_log_step_list(enkf_main_type * enkf_main, const int_vect
 }
 
 
+static void * enkf_main_copy_nodes_mt( void * arg ) {
+  arg_pack_type * arg_pack                      = arg_pack_safe_cast( arg );
+  const ensemble_config_type * ensemble_config  = (const ensemble_config_type *) arg_pack_iget_const_ptr( arg_pack , 0 );
+  const stringlist_type * node_list             = (const stringlist_type *) arg_pack_iget_const_ptr( arg_pack , 1 );
+  enkf_fs_type * source_fs                      = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 2 );
+  enkf_fs_type * target_fs                      = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 3 );
+  int source_step                               = arg_pack_iget_int( arg_pack , 4 );
+  int target_step                               = arg_pack_iget_int( arg_pack , 5 );
+  const int_vector_type * source_list           = (const int_vector_type *) arg_pack_iget_const_ptr( arg_pack , 6 );
+  const int_vector_type * target_list           = (const int_vector_type *) arg_pack_iget_const_ptr( arg_pack , 7 );
+  int index1                                    = arg_pack_iget_int( arg_pack , 8 );
+  int index2                                    = arg_pack_iget_int( arg_pack , 9 );
+
+  for (int index = index1; index < index2; index++) {
+    node_id_type src_id    = {.report_step = source_step , .iens = int_vector_iget( source_list , index ) };
+    node_id_type target_id = {.report_step = target_step , .iens = int_vector_iget( target_list , index ) };
+
+    for (int inode = 0; inode < stringlist_get_size( node_list ); inode++) {
+      const enkf_config_node_type * config_node = ensemble_config_get_node( ensemble_config , stringlist_iget( node_list , inode ));
+
+      /* The copy is careful ... */
+      if (enkf_config_node_has_node( config_node , source_fs , src_id ))
+        enkf_node_copy( config_node , source_fs , target_fs , src_id , target_id );
+    }
+  }
+  return NULL;
+}
+
+
+/*
+  Copies the nodes in node_list for realization source_list[i] in
+  source_fs to realization target_list[i] in target_fs. Nodes which
+  are not present in the source case are skipped. The realizations
+  are copied concurrently; most of the node types are copied as raw
+  blobs, see enkf_node_copy().
+*/
+
+static void enkf_main_copy_nodes( const enkf_main_type * enkf_main,
+                                  const stringlist_type * node_list,
+                                  enkf_fs_type * source_fs,
+                                  int source_step,
+                                  const int_vector_type * source_list,
+                                  enkf_fs_type * target_fs,
+                                  int target_step,
+                                  const int_vector_type * target_list) {
+
+  int num_realizations = int_vector_size( source_list );
+  if (num_realizations == 0 || stringlist_get_size( node_list ) == 0)
+    return;
+  {
+    int num_threads = util_int_max( 1 , util_int_min( (int) std::thread::hardware_concurrency() , num_realizations ));
+    int step_size = num_realizations / num_threads;
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( num_threads , sizeof * arg_list );
+
+    for (int i = 0; i < num_threads; i++) {
+      int index1 = i * step_size;
+      int index2 = (i == num_threads - 1) ? num_realizations : index1 + step_size;
+
+      arg_list[i] = arg_pack_alloc();
+      arg_pack_append_const_ptr( arg_list[i] , enkf_main_get_ensemble_config( enkf_main ));
+      arg_pack_append_const_ptr( arg_list[i] , node_list );
+      arg_pack_append_ptr( arg_list[i] , source_fs );
+      arg_pack_append_ptr( arg_list[i] , target_fs );
+      arg_pack_append_int( arg_list[i] , source_step );
+      arg_pack_append_int( arg_list[i] , target_step );
+      arg_pack_append_const_ptr( arg_list[i] , source_list );
+      arg_pack_append_const_ptr( arg_list[i] , target_list );
+      arg_pack_append_int( arg_list[i] , index1 );
+      arg_pack_append_int( arg_list[i] , index2 );
+      thread_pool_add_job( tp , enkf_main_copy_nodes_mt , arg_list[i] );
+    }
+
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+    for (int i = 0; i < num_threads; i++)
+      arg_pack_free( arg_list[i] );
+    free( arg_list );
+  }
+}
+
+
 /**
  * This is THE ENKF update function.  It should only be called from enkf_main_UPDATE.
  */
@@ -942,20 +1027,9 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
     if (target_fs != source_fs) {
       const ensemble_config_type * ensemble_config = enkf_main_get_ensemble_config(enkf_main);
       stringlist_type * param_keys = ensemble_config_alloc_keylist_from_var_type(ensemble_config, PARAMETER);
-      for (int i = 0; i < stringlist_get_size(param_keys); i++) {
-        const char * key = stringlist_iget(param_keys, i);
-        enkf_config_node_type * config_node = ensemble_config_get_node(ensemble_config, key);
-        enkf_node_type * data_node = enkf_node_alloc(config_node);
-        for (int j = 0; j < int_vector_size(ens_active_list); j++) {
-          node_id_type node_id;
-          node_id.iens = int_vector_iget(ens_active_list, j);
-          node_id.report_step = 0;
-
-          enkf_node_load(data_node, source_fs, node_id);
-          enkf_node_store(data_node, target_fs, false, node_id);
-        }
-        enkf_node_free(data_node);
-      }
+      enkf_main_copy_nodes(enkf_main, param_keys,
+                           source_fs, 0, ens_active_list,
+                           target_fs, 0, ens_active_list);
       stringlist_free(param_keys);
     }
 
@@ -1040,6 +1114,23 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
 }
 
 
+static void enkf_main_initX( analysis_module_type * module ,
+                             matrix_type * X ,
+                             const matrix_type * A ,
+                             const matrix_type * S ,
+                             const matrix_type * R ,
+                             const block_diag_matrix_type * block_R ,
+                             const matrix_type * dObs ,
+                             const matrix_type * E ,
+                             const matrix_type * D ,
+                             rng_type * rng) {
+  if (block_R)
+    analysis_module_initX_block( module , X , S , block_R , dObs , E , D , rng );
+  else
+    analysis_module_initX( module , X , A , S , R , dObs , E , D , rng );
+}
+
+
 static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                        enkf_fs_type * target_fs ,
                                        const bool_vector_type * ens_mask ,
@@ -1059,7 +1150,8 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   int active_size       = obs_data_get_active_size( obs_data );
   matrix_type * X       = matrix_alloc( active_ens_size , active_ens_size );
   matrix_type * S       = meas_data_allocS( forecast );
-  matrix_type * R       = obs_data_allocR( obs_data );
+  matrix_type * R       = NULL;
+  block_diag_matrix_type * block_R = NULL;
   matrix_type * dObs    = obs_data_allocdObs( obs_data );
   matrix_type * A       = matrix_alloc( matrix_start_size , active_ens_size );
   matrix_type * E       = NULL;
@@ -1073,9 +1165,20 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   if ( local_ministep_has_analysis_module (ministep))
     module = local_ministep_get_analysis_module (ministep);
 
+  /*
+    Modules which can work with R in block diagonal form get one block
+    per observation; the dense active_size x active_size R is only
+    assembled for the modules which need it.
+  */
+  if (analysis_module_check_option( module , ANALYSIS_BLOCK_R))
+    block_R = obs_data_alloc_block_R( obs_data );
+  else {
+    R = obs_data_allocR( obs_data );
+    assert_matrix_size(R , "R" , active_size , active_size);
+  }
+
   assert_matrix_size(X , "X" , active_ens_size , active_ens_size);
   assert_matrix_size(S , "S" , active_size , active_ens_size);
-  assert_matrix_size(R , "R" , active_size , active_size);
   assert_size_equal( enkf_main_get_ensemble_size( enkf_main ) , ens_mask );
 
   if (analysis_module_check_option( module , ANALYSIS_NEED_ED)) {
@@ -1086,8 +1189,11 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
     assert_matrix_size( D , "D" , active_size , active_ens_size);
   }
 
-  if (analysis_module_check_option( module , ANALYSIS_SCALE_DATA))
+  if (analysis_module_check_option( module , ANALYSIS_SCALE_DATA)) {
     obs_data_scale( obs_data , S , E , D , R , dObs );
+    if (block_R)
+      obs_data_scale_block_R( obs_data , block_R );
+  }
 
   if (analysis_module_check_option( module , ANALYSIS_USE_A) || analysis_module_check_option(module , ANALYSIS_UPDATE_A))
     localA = A;
@@ -1135,7 +1241,7 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
     }
 
     if (localA == NULL)
-      analysis_module_initX( module , X , NULL , S , R , dObs , E , D, enkf_main->shared_rng);
+      enkf_main_initX( module , X , NULL , S , R , block_R , dObs , E , D, enkf_main->shared_rng);
 
 
     while (!hash_iter_is_complete( dataset_iter )) {
@@ -1161,7 +1267,7 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
         }
         else {
           if (analysis_module_check_option( module , ANALYSIS_USE_A)){
-            analysis_module_initX( module , X , localA , S , R , dObs , E , D, enkf_main->shared_rng);
+            enkf_main_initX( module , X , localA , S , R , block_R , dObs , E , D, enkf_main->shared_rng);
           }
 
           matrix_inplace_matmul_mt2( A , X , tp );
@@ -1189,7 +1295,9 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   matrix_safe_free( E );
   matrix_safe_free( D );
   matrix_free( S );
-  matrix_free( R );
+  matrix_safe_free( R );
+  if (block_R)
+    block_diag_matrix_free( block_R );
   matrix_free( dObs );
   matrix_free( X );
   matrix_free( A );
@@ -1862,6 +1970,7 @@ static enkf_main_type * enkf_main_alloc_empty( ) {
   enkf_main->ranking_table      = ranking_table_alloc( 0 );
   enkf_main->obs                = NULL;
   enkf_main->local_config       = local_config_alloc( );
+  enkf_main->load_timing        = load_timing_alloc( );
 
   enkf_main_set_verbose( enkf_main, false );
   enkf_main_init_fs( enkf_main );
@@ -2221,6 +2330,109 @@ int enkf_main_load_from_run_context_from_gui(enkf_main_type* enkf_main, ert_run_
    return loaded;
 }
 
+/*
+  The results are loaded in a pipeline of two stages. The reading
+  threads run the forward init and open and parse the ECLIPSE files
+  of one realization at a time, and queue the resulting load context.
+  The storing threads pick the load contexts from the queue, and
+  internalize and store the results. The stages have separate thread
+  counts (LOAD_READ_THREADS and LOAD_STORE_THREADS), and the number of
+  queued load contexts is bounded, since every one of them holds the
+  complete summary of a realization in memory.
+
+  The time every realization spends in the different stages is
+  recorded in the load_timing object of the enkf_main instance.
+*/
+
+typedef struct {
+  pthread_mutex_t              mutex;
+  pthread_cond_t               cond;
+  int_vector_type            * pending;          /* Realizations which have been read; waiting to be stored. */
+  int                          max_pending;
+  int                          num_remaining;    /* Realizations which have not yet been picked by a storing thread. */
+  forward_load_context_type ** load_context;
+  enkf_main_type             * enkf_main;
+  ert_run_context_type       * run_context;
+  stringlist_type           ** msg_list;
+  int                        * result;
+} enkf_main_load_pipeline_type;
+
+
+static int enkf_main_get_load_threads( int config_threads , int num_jobs ) {
+  int num_threads = config_threads;
+  if (num_threads == 0)
+    num_threads = std::thread::hardware_concurrency();
+  return util_int_max( 1 , util_int_min( num_threads , num_jobs ));
+}
+
+
+static void * enkf_main_load_read_mt( void * arg ) {
+  arg_pack_type * arg_pack                 = arg_pack_safe_cast( arg );
+  enkf_main_load_pipeline_type * pipeline  = (enkf_main_load_pipeline_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  int iens                                 = arg_pack_iget_int( arg_pack , 1 );
+  enkf_state_type * enkf_state             = enkf_main_iget_state( pipeline->enkf_main , iens );
+  double start_time                        = load_timing_now();
+  forward_load_context_type * load_context = enkf_state_open_forward_model( enkf_state ,
+                                                                            ert_run_context_iget_arg( pipeline->run_context , iens ),
+                                                                            pipeline->msg_list[iens],
+                                                                            true );
+
+  load_timing_iset( pipeline->enkf_main->load_timing , iens , LOAD_STAGE_READ , load_timing_now() - start_time );
+
+  pthread_mutex_lock( &pipeline->mutex );
+  while (int_vector_size( pipeline->pending ) >= pipeline->max_pending)
+    pthread_cond_wait( &pipeline->cond , &pipeline->mutex );
+
+  pipeline->load_context[iens] = load_context;
+  int_vector_append( pipeline->pending , iens );
+  pthread_cond_broadcast( &pipeline->cond );
+  pthread_mutex_unlock( &pipeline->mutex );
+  return NULL;
+}
+
+
+static void * enkf_main_load_store_mt( void * arg ) {
+  arg_pack_type * arg_pack                = arg_pack_safe_cast( arg );
+  enkf_main_load_pipeline_type * pipeline = (enkf_main_load_pipeline_type *) arg_pack_iget_ptr( arg_pack , 0 );
+
+  while (true) {
+    forward_load_context_type * load_context;
+    int iens;
+
+    pthread_mutex_lock( &pipeline->mutex );
+    while (pipeline->num_remaining > 0 && int_vector_size( pipeline->pending ) == 0)
+      pthread_cond_wait( &pipeline->cond , &pipeline->mutex );
+
+    if (pipeline->num_remaining == 0) {
+      pthread_mutex_unlock( &pipeline->mutex );
+      break;
+    }
+
+    iens = int_vector_iget( pipeline->pending , 0 );
+    int_vector_idel( pipeline->pending , 0 );
+    pipeline->num_remaining--;
+    load_context = pipeline->load_context[iens];
+    pipeline->load_context[iens] = NULL;
+    pthread_cond_broadcast( &pipeline->cond );
+    pthread_mutex_unlock( &pipeline->mutex );
+
+    {
+      enkf_state_type * enkf_state = enkf_main_iget_state( pipeline->enkf_main , iens );
+      double start_time = load_timing_now();
+      double elapsed, store_time;
+
+      pipeline->result[iens] = enkf_state_internalize_forward_model( enkf_state , load_context );
+      elapsed = load_timing_now() - start_time;
+      store_time = forward_load_context_get_store_time( load_context );
+      load_timing_iset( pipeline->enkf_main->load_timing , iens , LOAD_STAGE_PARSE , util_double_max( 0 , elapsed - store_time ));
+      load_timing_iset( pipeline->enkf_main->load_timing , iens , LOAD_STAGE_STORE , store_time );
+      forward_load_context_free( load_context );
+    }
+  }
+  return NULL;
+}
+
+
 int enkf_main_load_from_run_context(
       enkf_main_type * enkf_main,
       ert_run_context_type * run_context,
@@ -2228,29 +2440,73 @@ int enkf_main_load_from_run_context(
       enkf_fs_type * fs) {
    auto const ens_size = enkf_main_get_ensemble_size( enkf_main );
    auto const * iactive = ert_run_context_get_iactive(run_context);
+   const model_config_type * model_config = enkf_main_get_model_config( enkf_main );
+   double start_time = load_timing_now();
+   int num_active = 0;
 
    int result[ens_size];
+   enkf_main_load_pipeline_type pipeline;
    arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( ens_size , sizeof * arg_list ); // CXX_CAST_ERROR
-   thread_pool_type * tp     = thread_pool_alloc( std::thread::hardware_concurrency() , true );
 
    for (int iens = 0; iens < ens_size; ++iens) {
      result[iens] = 0;
-     arg_pack_type * arg_pack = arg_pack_alloc();
-     arg_list[iens] = arg_pack;
-
-     if (bool_vector_iget(iactive, iens)) {
-       enkf_state_type * enkf_state = enkf_main_iget_state( enkf_main , iens );
-       arg_pack_append_ptr( arg_pack , enkf_state);                                         /* 0: enkf_state*/
-       arg_pack_append_ptr( arg_pack , ert_run_context_iget_arg( run_context , iens ));     /* 1: run_arg */
-       arg_pack_append_ptr(arg_pack, realizations_msg_list[iens]);                          /* 2: List of interactive mode messages. */
-       arg_pack_append_bool( arg_pack, true );                                              /* 3: Manual load */
-       arg_pack_append_ptr(arg_pack, &result[iens]);                                        /* 4: Result */
-       thread_pool_add_job( tp , enkf_state_load_from_forward_model_mt , arg_pack);
-     }
+     if (bool_vector_iget(iactive, iens))
+       num_active++;
    }
+   load_timing_clear( enkf_main->load_timing );
+
+   {
+     int read_threads  = enkf_main_get_load_threads( model_config_get_load_read_threads( model_config ) , num_active );
+     int store_threads = enkf_main_get_load_threads( model_config_get_load_store_threads( model_config ) , num_active );
+     thread_pool_type * read_pool  = thread_pool_alloc( read_threads , true );
+     thread_pool_type * store_pool = thread_pool_alloc( store_threads , true );
+     arg_pack_type * store_arg = arg_pack_alloc();
+
+     pthread_mutex_init( &pipeline.mutex , NULL );
+     pthread_cond_init( &pipeline.cond , NULL );
+     pipeline.pending       = int_vector_alloc( 0 , 0 );
+     pipeline.max_pending   = 2 * store_threads;
+     pipeline.num_remaining = num_active;
+     pipeline.load_context  = (forward_load_context_type **) util_calloc( ens_size , sizeof * pipeline.load_context );
+     pipeline.enkf_main     = enkf_main;
+     pipeline.run_context   = run_context;
+     pipeline.msg_list      = realizations_msg_list;
+     pipeline.result        = result;
+
+     arg_pack_append_ptr( store_arg , &pipeline );
+     for (int i = 0; i < store_threads; i++)
+       thread_pool_add_job( store_pool , enkf_main_load_store_mt , store_arg );
+
+     for (int iens = 0; iens < ens_size; ++iens) {
+       arg_pack_type * arg_pack = arg_pack_alloc();
+       arg_list[iens] = arg_pack;
+
+       if (bool_vector_iget(iactive, iens)) {
+         arg_pack_append_ptr( arg_pack , &pipeline );
+         arg_pack_append_int( arg_pack , iens );
+         thread_pool_add_job( read_pool , enkf_main_load_read_mt , arg_pack);
+       }
+     }
 
-   thread_pool_join( tp );
-   thread_pool_free( tp );
+     thread_pool_join( read_pool );
+     thread_pool_join( store_pool );
+     thread_pool_free( read_pool );
+     thread_pool_free( store_pool );
+
+     arg_pack_free( store_arg );
+     free( pipeline.load_context );
+     int_vector_free( pipeline.pending );
+     pthread_cond_destroy( &pipeline.cond );
+     pthread_mutex_destroy( &pipeline.mutex );
+
+     load_timing_set_wall_time( enkf_main->load_timing , load_timing_now() - start_time );
+     res_log_finfo("Loaded %d realizations in %.3f seconds with %d reading and %d storing threads; "
+                   "read: %.3f  parse: %.3f  store: %.3f seconds in total.",
+                   num_active, load_timing_get_wall_time( enkf_main->load_timing ), read_threads, store_threads,
+                   load_timing_get_total( enkf_main->load_timing , LOAD_STAGE_READ ),
+                   load_timing_get_total( enkf_main->load_timing , LOAD_STAGE_PARSE ),
+                   load_timing_get_total( enkf_main->load_timing , LOAD_STAGE_STORE ));
+   }
 
    int loaded = 0;
    for (int iens = 0; iens < ens_size; ++iens) {
@@ -2269,6 +2525,15 @@ int enkf_main_load_from_run_context(
 }
 
 
+/*
+  The timing of the most recent load from the forward model.
+*/
+
+const load_timing_type * enkf_main_get_load_timing( const enkf_main_type * enkf_main ) {
+  return enkf_main->load_timing;
+}
+
+
 bool enkf_main_export_field(const enkf_main_type * enkf_main,
                             const char * kw,
                             const char * path,
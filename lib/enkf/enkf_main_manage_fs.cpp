@@ -114,28 +114,58 @@ static void * enkf_main_initialize_from_scratch_mt(void * void_arg) {
   enkf_state_type * state            = enkf_main_iget_state( enkf_main , iens);
   rng_type * rng                     = rng_manager_iget( enkf_main->rng_manager, iens );
 
-  enkf_state_initialize( state , rng, init_fs , param_list , init_mode);
+  enkf_state_initialize_nodes( state , rng, init_fs , param_list , init_mode);
   return NULL;
 }
 
+
+/*
+  The realizations are sampled concurrently. Every realization draws
+  from its own rng from the rng_manager, so the result does not depend
+  on the number of threads or the order the realizations are
+  processed in. The rng instances are all created up front, and the
+  storage is synced once when all the realizations are done.
+*/
+
 void enkf_main_initialize_from_scratch(enkf_main_type * enkf_main ,
                                        const stringlist_type * param_list ,
                                        const ert_run_context_type * run_context) {
   int ens_size               = enkf_main_get_ensemble_size( enkf_main );
   arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( ens_size , sizeof * arg_list );
+  enkf_fs_type * init_fs     = ert_run_context_get_sim_fs(run_context);
+  int num_active             = 0;
 
-  for (int iens = 0; iens < ens_size; iens++) {
-    arg_list[iens] = arg_pack_alloc();
-    if (ert_run_context_iactive(run_context, iens)) {
-      arg_pack_append_ptr( arg_list[iens] , enkf_main );
-      arg_pack_append_ptr( arg_list[iens] , ert_run_context_get_sim_fs(run_context));
-      arg_pack_append_const_ptr( arg_list[iens] , param_list );
-      arg_pack_append_int( arg_list[iens] , iens );
-      arg_pack_append_int( arg_list[iens] ,ert_run_context_get_init_mode(run_context));
+  for (int iens = 0; iens < ens_size; iens++)
+    if (ert_run_context_iactive(run_context, iens))
+      num_active++;
 
-      enkf_main_initialize_from_scratch_mt(arg_list[iens]);
+  if (ens_size > 0)
+    rng_manager_iget( enkf_main->rng_manager, ens_size - 1 );
+
+  {
+    int num_threads = util_int_max( 1 , util_int_min( (int) std::thread::hardware_concurrency() , num_active ));
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+
+    for (int iens = 0; iens < ens_size; iens++) {
+      arg_list[iens] = arg_pack_alloc();
+      if (ert_run_context_iactive(run_context, iens)) {
+        arg_pack_append_ptr( arg_list[iens] , enkf_main );
+        arg_pack_append_ptr( arg_list[iens] , init_fs );
+        arg_pack_append_const_ptr( arg_list[iens] , param_list );
+        arg_pack_append_int( arg_list[iens] , iens );
+        arg_pack_append_int( arg_list[iens] ,ert_run_context_get_init_mode(run_context));
+
+        thread_pool_add_job( tp , enkf_main_initialize_from_scratch_mt , arg_list[iens] );
+      }
     }
+
+    thread_pool_join( tp );
+    thread_pool_free( tp );
   }
+
+  if (num_active > 0 && ert_run_context_get_init_mode(run_context) != INIT_NONE)
+    enkf_fs_fsync( init_fs );
+
   for (int iens = 0; iens < ens_size; iens++){
     arg_pack_free( arg_list[iens] );
   }
@@ -159,7 +189,9 @@ static void enkf_main_copy_ensemble( const enkf_main_type * enkf_main,
 
   {
     int * ranking_permutation;
-    int inode , src_iens;
+    int src_iens;
+    int_vector_type * source_list = int_vector_alloc( 0 , 0 );
+    int_vector_type * target_list = int_vector_alloc( 0 , 0 );
 
     if (ranking_key != NULL) {
       ranking_table_type * ranking_table = enkf_main_get_ranking_table( enkf_main );
@@ -170,27 +202,25 @@ static void enkf_main_copy_ensemble( const enkf_main_type * enkf_main,
         ranking_permutation[src_iens] = src_iens;
     }
 
-    for (inode =0; inode < stringlist_get_size( node_list ); inode++) {
-      enkf_config_node_type * config_node = ensemble_config_get_node( enkf_main_get_ensemble_config(enkf_main) , stringlist_iget( node_list , inode ));
-      for (src_iens = 0; src_iens < enkf_main_get_ensemble_size( enkf_main ); src_iens++) {
-        if (bool_vector_safe_iget(iens_mask , src_iens)) {
-          int target_iens = ranking_permutation[src_iens];
-          node_id_type src_id    = {.report_step = source_report_step , .iens = src_iens    };
-          node_id_type target_id = {.report_step = target_report_step , .iens = target_iens };
-
-          /* The copy is careful ... */
-          if (enkf_config_node_has_node( config_node , source_case_fs , src_id))
-            enkf_node_copy( config_node ,
-                            source_case_fs , target_case_fs ,
-                            src_id , target_id );
-
-          if (0 == target_report_step)
-            state_map_iset(target_state_map, target_iens, STATE_INITIALIZED);
-        }
+    for (src_iens = 0; src_iens < ens_size; src_iens++) {
+      if (bool_vector_safe_iget(iens_mask , src_iens)) {
+        int_vector_append( source_list , src_iens );
+        int_vector_append( target_list , ranking_permutation[src_iens] );
       }
     }
 
-    if (ranking_permutation == NULL)
+    enkf_main_copy_nodes( enkf_main , node_list ,
+                          source_case_fs , source_report_step , source_list ,
+                          target_case_fs , target_report_step , target_list );
+
+    if ((0 == target_report_step) && (stringlist_get_size( node_list ) > 0)) {
+      for (int i = 0; i < int_vector_size( target_list ); i++)
+        state_map_iset(target_state_map, int_vector_iget( target_list , i ), STATE_INITIALIZED);
+    }
+
+    int_vector_free( target_list );
+    int_vector_free( source_list );
+    if (ranking_key == NULL)
       free( ranking_permutation );
   }
 }
@@ -25,6 +25,7 @@
 #include <ert/util/buffer.h>
 #include <ert/util/rng.h>
 #include <ert/util/vector.h>
+#include <ert/util/stringlist.h>
 #include <ert/util/type_macros.h>
 
 #include <ert/res_util/path_fmt.hpp>
@@ -461,6 +462,63 @@ bool enkf_node_store_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int
 }
 
 
+static void enkf_node_flush_vectors( enkf_fs_type * fs , vector_type * buffers , stringlist_type * keys , enkf_var_type var_type , int iens) {
+  if (stringlist_get_size( keys ) > 0)
+    enkf_fs_fwrite_vectors( fs , buffers , keys , var_type , iens );
+
+  for (int i=0; i < vector_get_size( buffers ); i++)
+    buffer_free( (buffer_type *) vector_iget( buffers , i ));
+
+  vector_clear( buffers );
+  stringlist_clear( keys );
+}
+
+
+/*
+  Stores the vectors of all the enkf_node instances in @node_list
+  for realization @iens; this is equivalent to calling
+  enkf_node_store_vector() for each node, but consecutive nodes with
+  the same var_type are handed to the fs layer as one batch.
+*/
+
+bool enkf_node_store_vectors(const vector_type * node_list , enkf_fs_type * fs , int iens ) {
+  bool all_written = true;
+  vector_type * buffers = vector_alloc_new();
+  stringlist_type * keys = stringlist_alloc_new();
+  enkf_var_type batch_var_type = INVALID_VAR;
+
+  for (int i=0; i < vector_get_size( node_list ); i++) {
+    enkf_node_type * enkf_node = (enkf_node_type *) vector_iget_const( node_list , i );
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
+    enkf_var_type var_type = enkf_config_node_get_var_type( config_node );
+    buffer_type * buffer;
+
+    FUNC_ASSERT(enkf_node->write_to_buffer);
+    if (!enkf_node->vector_storage)
+      util_abort("%s: internal error - function should only be called by nodes with vector storage.\n",__func__);
+
+    if (var_type != batch_var_type)
+      enkf_node_flush_vectors( fs , buffers , keys , batch_var_type , iens );
+    batch_var_type = var_type;
+
+    buffer = buffer_alloc( 100 );
+    buffer_fwrite_time_t( buffer , time(NULL));
+    if (enkf_node->write_to_buffer(enkf_node->data , buffer , -1 )) {
+      vector_append_ref( buffers , buffer );
+      stringlist_append_copy( keys , enkf_config_node_get_key( config_node ));
+    } else {
+      buffer_free( buffer );
+      all_written = false;
+    }
+  }
+  enkf_node_flush_vectors( fs , buffers , keys , batch_var_type , iens );
+
+  stringlist_free( keys );
+  vector_free( buffers );
+  return all_written;
+}
+
+
 
 bool enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force_vectors , node_id_type node_id) {
   if (enkf_node->vector_storage) {
@@ -492,69 +550,83 @@ bool enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force
 */
 
 bool enkf_node_try_load(enkf_node_type *enkf_node , enkf_fs_type * fs , node_id_type node_id) {
-  if (enkf_node_has_data( enkf_node , fs , node_id)) {
-    enkf_node_load( enkf_node , fs , node_id);
-    return true;
-  } else
+  if (enkf_node_has_data( enkf_node , fs , node_id))
+    return enkf_node_load( enkf_node , fs , node_id);
+  else
     return false;
 }
 
 
-static void enkf_node_buffer_load( enkf_node_type * enkf_node , enkf_fs_type * fs , int report_step , int iens) {
+/*
+  Returns false if a vector could not be read, see
+  enkf_fs_fread_vector(); the node is then left unchanged.
+*/
+
+static bool enkf_node_buffer_load( enkf_node_type * enkf_node , enkf_fs_type * fs , int report_step , int iens) {
   FUNC_ASSERT(enkf_node->read_from_buffer);
   {
+    bool loaded = true;
     buffer_type * buffer                      = buffer_alloc( 100 );
     const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
     const char * node_key                     = enkf_config_node_get_key( config_node );
     enkf_var_type var_type                    = enkf_config_node_get_var_type( config_node );
 
     if (enkf_node->vector_storage)
-      enkf_fs_fread_vector( fs , buffer , node_key , var_type , iens );
+      loaded = enkf_fs_fread_vector( fs , buffer , node_key , var_type , iens );
     else
       enkf_fs_fread_node( fs , buffer , node_key , var_type , report_step , iens );
 
-    buffer_fskip_time_t( buffer );
-
-    enkf_node->read_from_buffer(enkf_node->data , buffer , fs , report_step );
+    if (loaded) {
+      buffer_fskip_time_t( buffer );
+      enkf_node->read_from_buffer(enkf_node->data , buffer , fs , report_step );
+    }
     buffer_free( buffer );
+    return loaded;
   }
 }
 
 
 
 
-void enkf_node_load_vector( enkf_node_type * enkf_node , enkf_fs_type * fs , int iens ) {
-  enkf_node_buffer_load( enkf_node , fs , -1 , iens );
+bool enkf_node_load_vector( enkf_node_type * enkf_node , enkf_fs_type * fs , int iens ) {
+  return enkf_node_buffer_load( enkf_node , fs , -1 , iens );
 }
 
 
 
-static void enkf_node_load_container( enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id ) {
+static bool enkf_node_load_container( enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id ) {
+  bool loaded = true;
   for (int inode=0; inode < vector_get_size( enkf_node->container_nodes ); inode++) {
     enkf_node_type * child_node = (enkf_node_type *)vector_iget( enkf_node->container_nodes , inode );
-    enkf_node_load( child_node , fs , node_id );
+    if (!enkf_node_load( child_node , fs , node_id ))
+      loaded = false;
   }
+  return loaded;
 }
 
 
-void enkf_node_load(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id) {
+/*
+  Returns false if the node has vector storage and the vector could
+  not be read; the caller should treat that as a missing vector.
+*/
+
+bool enkf_node_load(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id) {
   if (enkf_node_get_impl_type(enkf_node) == CONTAINER)
-    enkf_node_load_container( enkf_node , fs , node_id );
+    return enkf_node_load_container( enkf_node , fs , node_id );
   else {
     if (enkf_node->vector_storage)
-      enkf_node_load_vector( enkf_node , fs , node_id.iens );
+      return enkf_node_load_vector( enkf_node , fs , node_id.iens );
     else
       /* Normal load path */
-      enkf_node_buffer_load( enkf_node , fs , node_id.report_step, node_id.iens );
+      return enkf_node_buffer_load( enkf_node , fs , node_id.report_step, node_id.iens );
   }
 }
 
 
 bool enkf_node_try_load_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens ) {
-  if (enkf_config_node_has_vector( enkf_node->config , fs , iens)) {
-    enkf_node_load_vector( enkf_node , fs , iens );
-    return true;
-  } else
+  if (enkf_config_node_has_vector( enkf_node->config , fs , iens))
+    return enkf_node_load_vector( enkf_node , fs , iens );
+  else
     return false;
 }
 
@@ -571,13 +643,14 @@ enkf_node_type * enkf_node_load_alloc( const enkf_config_node_type * config_node
   if (enkf_config_node_vector_storage( config_node )) {
     if (enkf_config_node_has_vector( config_node , fs , node_id.iens)) {
       enkf_node_type * node = enkf_node_alloc( config_node );
-      enkf_node_load( node , fs , node_id );
-      return node;
-    } else {
-      util_abort("%s: could not load vector:%s from iens:%d\n",__func__ , enkf_config_node_get_key( config_node ),
-                 node_id.iens );
-      return NULL;
+      if (enkf_node_load( node , fs , node_id ))
+        return node;
+
+      enkf_node_free( node );
     }
+    util_abort("%s: could not load vector:%s from iens:%d\n",__func__ , enkf_config_node_get_key( config_node ),
+               node_id.iens );
+    return NULL;
   } else {
     if (enkf_config_node_has_node( config_node , fs , node_id)) {
       enkf_node_type * node = enkf_node_alloc( config_node );
@@ -595,12 +668,52 @@ enkf_node_type * enkf_node_load_alloc( const enkf_config_node_type * config_node
 
 
 
+/*
+  Most node types are copied as a raw blob, without being decoded into
+  an enkf_node instance. The GEN_DATA nodes must be decoded, since the
+  size of the data is registered per report step in the config, and
+  the nodes with vector storage have their own storage paths.
+*/
+
+static bool enkf_node_copy_raw(const enkf_config_node_type * config_node ,
+                               enkf_fs_type * src_case,
+                               enkf_fs_type * target_case,
+                               node_id_type src_id ,
+                               node_id_type target_id) {
+
+  if (enkf_config_node_vector_storage( config_node ))
+    return false;
+
+  if (enkf_config_node_get_impl_type( config_node ) == GEN_DATA)
+    return false;
+
+  if (!enkf_config_node_has_node( config_node , src_case , src_id ))
+    util_abort("%s: Could not load node: key:%s  iens:%d  report:%d \n",
+               __func__ ,
+               enkf_config_node_get_key( config_node ) ,
+               src_id.iens , src_id.report_step );
+  {
+    buffer_type * buffer = buffer_alloc( 100 );
+    enkf_fs_copy_node( src_case , target_case , buffer ,
+                       enkf_config_node_get_key( config_node ) ,
+                       enkf_config_node_get_var_type( config_node ) ,
+                       src_id.report_step , src_id.iens ,
+                       target_id.report_step , target_id.iens );
+    buffer_free( buffer );
+  }
+  return true;
+}
+
+
 void enkf_node_copy(const enkf_config_node_type * config_node ,
                     enkf_fs_type * src_case,
                     enkf_fs_type * target_case,
                     node_id_type src_id ,
                     node_id_type target_id) {
 
+  if (enkf_node_copy_raw( config_node , src_case , target_case , src_id , target_id ))
+    return;
+
   enkf_node_type * enkf_node = enkf_node_load_alloc(config_node, src_case , src_id);
 
 
@@ -643,6 +756,18 @@ bool enkf_node_has_data( enkf_node_type * enkf_node , enkf_fs_type * fs , node_i
 }
 
 
+/*
+  For a node with vector storage which has already been loaded with
+  enkf_node_try_load_vector(): check whether the loaded vector has
+  data for @report_step - without going to the filesystem again.
+*/
+
+bool enkf_node_vector_has_data( const enkf_node_type * enkf_node , int report_step ) {
+  FUNC_ASSERT(enkf_node->has_data);
+  return enkf_node->has_data( enkf_node->data , report_step );
+}
+
+
 void enkf_node_serialize(enkf_node_type *enkf_node , enkf_fs_type * fs, node_id_type node_id ,
                          const active_list_type * active_list , matrix_type * A , int row_offset , int column) {
 
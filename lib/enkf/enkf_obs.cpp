@@ -18,6 +18,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <pthread.h>
 #include <cmath>
 
 #include <ert/util/hash.h>
@@ -196,6 +197,7 @@ struct enkf_obs_struct {
   const ecl_grid_type  * grid;
   time_map_type        * external_time_map;
   ensemble_config_type * ensemble_config;
+  long                   revision;     /* Changed whenever observations are added or removed, or the std is scaled. */
 };
 
 
@@ -204,6 +206,35 @@ struct enkf_obs_struct {
 //////////////////////////////////////////////////////////////////////////////////////
 
 
+/*
+  The revision numbers are drawn from one counter shared by all
+  enkf_obs instances; a new instance allocated at the address of a
+  freed one will therefore never have the revision of the old one.
+*/
+
+static pthread_mutex_t enkf_obs_revision_lock = PTHREAD_MUTEX_INITIALIZER;
+static long            enkf_obs_revision_counter = 0;
+
+static void enkf_obs_update_revision( enkf_obs_type * enkf_obs ) {
+  pthread_mutex_lock( &enkf_obs_revision_lock );
+  enkf_obs_revision_counter++;
+  enkf_obs->revision = enkf_obs_revision_counter;
+  pthread_mutex_unlock( &enkf_obs_revision_lock );
+}
+
+
+/*
+  The revision changes when observations are added or removed, and
+  when the standard deviations are scaled through enkf_obs; it can be
+  used to cache values computed from the observations. Changes made
+  directly on the observation nodes are not seen.
+*/
+
+long enkf_obs_get_revision( const enkf_obs_type * enkf_obs ) {
+  return enkf_obs->revision;
+}
+
+
 static void enkf_obs_iset_obs_time(enkf_obs_type * enkf_obs , int report_step, time_t obs_time) {
   time_map_update( enkf_obs->obs_time , report_step , obs_time);
 }
@@ -233,6 +264,7 @@ enkf_obs_type * enkf_obs_alloc( const history_type * history ,
   enkf_obs->ensemble_config = ensemble_config;
   enkf_obs->external_time_map = external_time_map;
   enkf_obs->valid             = false;
+  enkf_obs_update_revision( enkf_obs );
 
   /* Initialize obs time: */
   {
@@ -305,6 +337,7 @@ void enkf_obs_add_obs_vector(enkf_obs_type       * enkf_obs,
 
     hash_insert_ref(enkf_obs->obs_hash , obs_key , vector );
     vector_append_owned_ref( enkf_obs->obs_vector , vector , obs_vector_free__);
+    enkf_obs_update_revision( enkf_obs );
   }
 }
 
@@ -395,7 +428,14 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
           const int iens = int_vector_iget( ens_active_list , iens_index );
           node_id_type node_id = {.report_step = step,
                                   .iens        = iens};
-          enkf_node_load( work_node , fs , node_id );
+          if (!enkf_node_load( work_node , fs , node_id )) {
+            // the simulated vector could not be read - treat it as missing
+            char * msg = util_alloc_sprintf("simulated vector could not be loaded for realization: %d", iens);
+            meas_block_deactivate(meas_block , active_count);
+            obs_block_deactivate(obs_block , active_count, true, msg);
+            free( msg );
+            break;
+          }
 
           int smlength   = summary_length( (const summary_type * ) enkf_node_value_ptr( work_node ) );
           if (step >= smlength) {
@@ -505,6 +545,7 @@ void enkf_obs_clear( enkf_obs_type * enkf_obs ) {
   hash_clear( enkf_obs->obs_hash );
   vector_clear( enkf_obs->obs_vector );
   ensemble_config_clear_obs_keys(enkf_obs->ensemble_config);
+  enkf_obs_update_revision( enkf_obs );
 }
 
 
@@ -1152,7 +1193,7 @@ void enkf_obs_scale_std(enkf_obs_type * enkf_obs, double scale_factor) {
 }
 
 
-void enkf_obs_local_scale_std( const enkf_obs_type * enkf_obs , const local_obsdata_type * local_obsdata, double scale_factor) {
+void enkf_obs_local_scale_std( enkf_obs_type * enkf_obs , const local_obsdata_type * local_obsdata, double scale_factor) {
   int num_nodes = local_obsdata_get_size( local_obsdata );
   int node_nr;
   for (node_nr = 0; node_nr < num_nodes; node_nr++) {
@@ -1160,10 +1201,11 @@ void enkf_obs_local_scale_std( const enkf_obs_type * enkf_obs , const local_obsd
     obs_vector_type * obs_vector = enkf_obs_get_vector( enkf_obs , local_obsdata_node_get_key( node ));
     obs_vector_scale_std( obs_vector , node , scale_factor );
   }
+  enkf_obs_update_revision( enkf_obs );
 }
 
 
-double enkf_obs_scale_correlated_std(const enkf_obs_type * enkf_obs,
+double enkf_obs_scale_correlated_std(enkf_obs_type * enkf_obs,
                                      enkf_fs_type * fs,
                                      const int_vector_type * ens_active_list,
                                      const local_obsdata_type * local_obsdata,
@@ -0,0 +1,409 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_plot_batch.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <time.h>
+#include <stdbool.h>
+
+#include <thread>
+
+#include <ert/util/util.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/vector.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_node.hpp>
+#include <ert/enkf/enkf_plot_batch.hpp>
+#include <ert/enkf/enkf_plot_tvector.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/time_map.hpp>
+
+/*
+  The enkf_plot_batch loads the plot data for a list of keys in one
+  pass over the ensemble. The realizations are split in one contiguous
+  range per thread, and each thread loads all the keys for one
+  realization before moving on to the next; the work nodes are
+  allocated once per thread and key.
+
+  For every key the data is stored in two contiguous ens_size x
+  num_steps matrices, values and active flags, with one row per
+  realization. The plot vectors returned by enkf_plot_batch_iget() are
+  views into these rows; they are owned by the batch. When the batch is
+  loaded again the views are pointed to the new data, so a plot vector
+  stays valid as long as the batch, unless the ensemble has shrunk and
+  the realization is gone.
+*/
+
+#define ENKF_PLOT_BATCH_TYPE_ID 6617205
+
+typedef struct {
+  const enkf_config_node_type * config_node;
+  char                        * index_key;
+  bool                          summary_mode;
+  double                      * data;      /* ens_size x num_steps */
+  bool                        * active;    /* ens_size x num_steps */
+  int                         * size;      /* Number of loaded steps for each realization. */
+  enkf_plot_tvector_type     ** views;
+  int                           num_views;
+} plot_batch_key_type;
+
+
+struct enkf_plot_batch_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  vector_type * keys;
+  int           ens_size;
+  int           num_steps;
+  time_t      * time;
+};
+
+
+static plot_batch_key_type * plot_batch_key_alloc( const enkf_config_node_type * config_node , const char * index_key ) {
+  plot_batch_key_type * key = (plot_batch_key_type *)util_malloc( sizeof * key );
+  key->config_node  = config_node;
+  key->index_key    = util_alloc_string_copy( index_key );
+  key->summary_mode = (enkf_config_node_get_impl_type( config_node ) == SUMMARY);
+  key->data         = NULL;
+  key->active       = NULL;
+  key->size         = NULL;
+  key->views        = NULL;
+  key->num_views    = 0;
+  return key;
+}
+
+
+/*
+  Frees the loaded data; the views are kept, and are pointed to the new
+  data by plot_batch_key_update_views().
+*/
+
+static void plot_batch_key_clear( plot_batch_key_type * key ) {
+  free( key->size );
+  free( key->active );
+  free( key->data );
+
+  key->data   = NULL;
+  key->active = NULL;
+  key->size   = NULL;
+}
+
+
+static void plot_batch_key_free( plot_batch_key_type * key ) {
+  plot_batch_key_clear( key );
+  for (int iens = 0; iens < key->num_views; iens++)
+    enkf_plot_tvector_free( key->views[iens] );
+  free( key->views );
+  free( key->index_key );
+  free( key );
+}
+
+
+static void plot_batch_key_alloc_storage( plot_batch_key_type * key , int ens_size , int num_steps ) {
+  size_t elements = util_size_t_max( (size_t) ens_size * num_steps , 1 );
+  key->data   = (double *) util_calloc( elements , sizeof * key->data );
+  key->active = (bool *)   util_calloc( elements , sizeof * key->active );
+  key->size   = (int *)    util_calloc( util_int_max( ens_size , 1 ) , sizeof * key->size );
+}
+
+
+static void plot_batch_key_update_views( plot_batch_key_type * key , int ens_size , int num_steps , const time_t * time ) {
+  for (int iens = ens_size; iens < key->num_views; iens++)
+    enkf_plot_tvector_free( key->views[iens] );
+
+  key->views = (enkf_plot_tvector_type **) util_realloc( key->views , util_int_max( ens_size , 1 ) * sizeof * key->views );
+  for (int iens = 0; iens < ens_size; iens++) {
+    size_t offset = (size_t) iens * num_steps;
+    if (iens < key->num_views)
+      enkf_plot_tvector_set_view( key->views[iens] ,
+                                  key->size[iens] ,
+                                  time ,
+                                  &key->data[offset] ,
+                                  &key->active[offset] );
+    else
+      key->views[iens] = enkf_plot_tvector_alloc_view( key->config_node ,
+                                                       iens ,
+                                                       key->size[iens] ,
+                                                       time ,
+                                                       &key->data[offset] ,
+                                                       &key->active[offset] );
+  }
+  key->num_views = ens_size;
+}
+
+
+/*
+  Loads one key for one realization into row iens of the key matrices.
+  Mirrors enkf_plot_tvector_load(): the row size is the number of steps
+  up to and including the last step with data, and for summary keys the
+  holes in the vector storage are flagged as inactive; the value of a
+  hole is the SUMMARY_UNDEF sentinel from the storage.
+*/
+
+static void plot_batch_key_load( plot_batch_key_type * key ,
+                                 enkf_node_type * work_node ,
+                                 double_vector_type * work ,
+                                 enkf_fs_type * fs ,
+                                 int iens ,
+                                 int num_steps ) {
+  size_t offset  = (size_t) iens * num_steps;
+  double * data  = &key->data[offset];
+  bool * active  = &key->active[offset];
+  int size = 0;
+
+  if (enkf_node_vector_storage( work_node )) {
+    if (enkf_node_user_get_vector( work_node , fs , key->index_key , iens , work )) {
+      const double * values = double_vector_get_ptr( work );
+      size = util_int_min( double_vector_size( work ) , num_steps );
+
+      for (int step = 0; step < size; step++) {
+        data[step] = values[step];
+        active[step] = !key->summary_mode || summary_active_value( values[step] );
+      }
+    }
+  } else {
+    node_id_type node_id = { .report_step = 0 ,
+                             .iens        = iens };
+
+    for (int step = 0; step < num_steps; step++) {
+      double value;
+      node_id.report_step = step;
+
+      if (enkf_node_user_get( work_node , fs , key->index_key , node_id , &value )) {
+        data[step] = value;
+        active[step] = true;
+        size = step + 1;
+      }
+    }
+  }
+
+  key->size[iens] = size;
+}
+
+
+static void * enkf_plot_batch_load_range__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  enkf_plot_batch_type * batch = (enkf_plot_batch_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  enkf_fs_type * fs = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 1 );
+  const int_vector_type * active_list = (const int_vector_type *) arg_pack_iget_const_ptr( arg_pack , 2 );
+  int index1 = arg_pack_iget_int( arg_pack , 3 );
+  int index2 = arg_pack_iget_int( arg_pack , 4 );
+
+  int num_keys = vector_get_size( batch->keys );
+  enkf_node_type ** work_nodes = (enkf_node_type **) util_calloc( num_keys , sizeof * work_nodes );
+  double_vector_type * work = double_vector_alloc( 0 , 0 );
+
+  for (int key_index = 0; key_index < num_keys; key_index++) {
+    const plot_batch_key_type * key = (const plot_batch_key_type *) vector_iget_const( batch->keys , key_index );
+    work_nodes[key_index] = enkf_node_alloc( key->config_node );
+  }
+
+  for (int index = index1; index < index2; index++) {
+    int iens = int_vector_iget( active_list , index );
+    for (int key_index = 0; key_index < num_keys; key_index++) {
+      plot_batch_key_type * key = (plot_batch_key_type *) vector_iget( batch->keys , key_index );
+      plot_batch_key_load( key , work_nodes[key_index] , work , fs , iens , batch->num_steps );
+    }
+  }
+
+  for (int key_index = 0; key_index < num_keys; key_index++)
+    enkf_node_free( work_nodes[key_index] );
+  free( work_nodes );
+  double_vector_free( work );
+  return NULL;
+}
+
+
+UTIL_IS_INSTANCE_FUNCTION( enkf_plot_batch , ENKF_PLOT_BATCH_TYPE_ID )
+
+
+enkf_plot_batch_type * enkf_plot_batch_alloc( ) {
+  enkf_plot_batch_type * batch = (enkf_plot_batch_type *)util_malloc( sizeof * batch );
+  UTIL_TYPE_ID_INIT( batch , ENKF_PLOT_BATCH_TYPE_ID );
+  batch->keys      = vector_alloc_new( );
+  batch->ens_size  = 0;
+  batch->num_steps = 0;
+  batch->time      = NULL;
+  return batch;
+}
+
+
+void enkf_plot_batch_free( enkf_plot_batch_type * batch ) {
+  for (int key_index = 0; key_index < vector_get_size( batch->keys ); key_index++)
+    plot_batch_key_free( (plot_batch_key_type *) vector_iget( batch->keys , key_index ));
+
+  vector_free( batch->keys );
+  free( batch->time );
+  free( batch );
+}
+
+
+/*
+  The index_key is passed on to enkf_node_user_get() / user_get_vector()
+  and can be NULL for keys which do not need it, e.g. SUMMARY. Returns
+  the key_index used to look up the loaded data.
+*/
+
+int enkf_plot_batch_add_key( enkf_plot_batch_type * batch , const enkf_config_node_type * config_node , const char * index_key) {
+  vector_append_ref( batch->keys , plot_batch_key_alloc( config_node , index_key ));
+  return vector_get_size( batch->keys ) - 1;
+}
+
+
+/*
+  Changes the index_key of an existing key; the new data is loaded by
+  the next enkf_plot_batch_load(), and the plot vectors of the key are
+  kept, i.e. they will then view the data of the new index_key.
+*/
+
+void enkf_plot_batch_iset_index_key( enkf_plot_batch_type * batch , int key_index , const char * index_key) {
+  if ((key_index < 0) || (key_index >= vector_get_size( batch->keys )))
+    util_abort("%s: key index:%d invalid. Valid interval: [0,%d>.\n", __func__ , key_index , vector_get_size( batch->keys ));
+
+  {
+    plot_batch_key_type * key = (plot_batch_key_type *) vector_iget( batch->keys , key_index );
+    key->index_key = util_realloc_string_copy( key->index_key , index_key );
+  }
+}
+
+
+int enkf_plot_batch_get_num_keys( const enkf_plot_batch_type * batch ) {
+  return vector_get_size( batch->keys );
+}
+
+
+int enkf_plot_batch_get_ens_size( const enkf_plot_batch_type * batch ) {
+  return batch->ens_size;
+}
+
+
+int enkf_plot_batch_get_num_steps( const enkf_plot_batch_type * batch ) {
+  return batch->num_steps;
+}
+
+
+const time_t * enkf_plot_batch_get_time( const enkf_plot_batch_type * batch ) {
+  return batch->time;
+}
+
+
+static const plot_batch_key_type * enkf_plot_batch_iget_loaded_key( const enkf_plot_batch_type * batch , int key_index , const char * caller) {
+  if ((key_index < 0) || (key_index >= vector_get_size( batch->keys )))
+    util_abort("%s: key index:%d invalid. Valid interval: [0,%d>.\n", caller , key_index , vector_get_size( batch->keys ));
+
+  const plot_batch_key_type * key = (const plot_batch_key_type *) vector_iget_const( batch->keys , key_index );
+  if (key->views == NULL)
+    util_abort("%s: key:%s has not been loaded.\n", caller , enkf_config_node_get_key( key->config_node ));
+
+  return key;
+}
+
+
+const double * enkf_plot_batch_iget_data( const enkf_plot_batch_type * batch , int key_index ) {
+  return enkf_plot_batch_iget_loaded_key( batch , key_index , __func__ )->data;
+}
+
+
+const bool * enkf_plot_batch_iget_active( const enkf_plot_batch_type * batch , int key_index ) {
+  return enkf_plot_batch_iget_loaded_key( batch , key_index , __func__ )->active;
+}
+
+
+enkf_plot_tvector_type * enkf_plot_batch_iget( const enkf_plot_batch_type * batch , int key_index , int iens) {
+  const plot_batch_key_type * key = enkf_plot_batch_iget_loaded_key( batch , key_index , __func__ );
+  if ((iens < 0) || (iens >= batch->ens_size))
+    util_abort("%s: index:%d invalid. Valid interval: [0,%d>.\n",__func__ , iens , batch->ens_size);
+
+  return key->views[iens];
+}
+
+
+/*
+  The realizations which are loaded are those selected in input_mask,
+  in addition to all realizations which have data according to the
+  state map; this is the same selection as enkf_plot_data_load().
+  Realizations which are not loaded get an empty plot vector.
+*/
+
+void enkf_plot_batch_load( enkf_plot_batch_type * batch , enkf_fs_type * fs , const bool_vector_type * input_mask) {
+  state_map_type * state_map = enkf_fs_get_state_map( fs );
+  time_map_type * time_map = enkf_fs_get_time_map( fs );
+  int num_keys = vector_get_size( batch->keys );
+  bool_vector_type * mask;
+  int_vector_type * active_list;
+
+  for (int key_index = 0; key_index < num_keys; key_index++)
+    plot_batch_key_clear( (plot_batch_key_type *) vector_iget( batch->keys , key_index ));
+  free( batch->time );
+
+  batch->ens_size = state_map_get_size( state_map );
+  batch->num_steps = time_map_get_size( time_map );
+  batch->time = (time_t *) util_calloc( util_int_max( batch->num_steps , 1 ) , sizeof * batch->time );
+  for (int step = 0; step < batch->num_steps; step++)
+    batch->time[step] = time_map_iget( time_map , step );
+
+  if (input_mask)
+    mask = bool_vector_alloc_copy( input_mask );
+  else
+    mask = bool_vector_alloc( batch->ens_size , false );
+  state_map_select_matching( state_map , mask , STATE_HAS_DATA );
+
+  active_list = int_vector_alloc( 0 , 0 );
+  for (int iens = 0; iens < batch->ens_size; iens++) {
+    if (bool_vector_safe_iget( mask , iens ))
+      int_vector_append( active_list , iens );
+  }
+
+  for (int key_index = 0; key_index < num_keys; key_index++)
+    plot_batch_key_alloc_storage( (plot_batch_key_type *) vector_iget( batch->keys , key_index ) , batch->ens_size , batch->num_steps );
+
+  if ((num_keys > 0) && (int_vector_size( active_list ) > 0)) {
+    int num_active = int_vector_size( active_list );
+    int num_threads = util_int_max( 1 , util_int_min( (int) std::thread::hardware_concurrency() , num_active ));
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( num_threads , sizeof * arg_list );
+
+    for (int ithread = 0; ithread < num_threads; ithread++) {
+      int index1 = (ithread * num_active) / num_threads;
+      int index2 = ((ithread + 1) * num_active) / num_threads;
+
+      arg_list[ithread] = arg_pack_alloc( );
+      arg_pack_append_ptr( arg_list[ithread] , batch );
+      arg_pack_append_ptr( arg_list[ithread] , fs );
+      arg_pack_append_const_ptr( arg_list[ithread] , active_list );
+      arg_pack_append_int( arg_list[ithread] , index1 );
+      arg_pack_append_int( arg_list[ithread] , index2 );
+
+      thread_pool_add_job( tp , enkf_plot_batch_load_range__ , arg_list[ithread] );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+
+    for (int ithread = 0; ithread < num_threads; ithread++)
+      arg_pack_free( arg_list[ithread] );
+    free( arg_list );
+  }
+
+  for (int key_index = 0; key_index < num_keys; key_index++)
+    plot_batch_key_update_views( (plot_batch_key_type *) vector_iget( batch->keys , key_index ) , batch->ens_size , batch->num_steps , batch->time );
+
+  int_vector_free( active_list );
+  bool_vector_free( mask );
+}
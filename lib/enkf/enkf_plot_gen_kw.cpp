@@ -19,10 +19,16 @@
 #include <stdbool.h>
 #include <time.h>
 
+#include <thread>
+
 #include <ert/util/bool_vector.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
 #include <ert/util/type_macros.h>
 
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
+
 #include <ert/enkf/enkf_config_node.hpp>
 #include <ert/enkf/enkf_fs.hpp>
 #include <ert/enkf/enkf_plot_gen_kw.hpp>
@@ -102,6 +108,29 @@ static void enkf_plot_gen_kw_resize( enkf_plot_gen_kw_type * plot_gen_kw , int n
 
 
 
+static void * enkf_plot_gen_kw_load_range__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  enkf_plot_gen_kw_type * plot_gen_kw = (enkf_plot_gen_kw_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  enkf_fs_type * fs = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 1 );
+  const int_vector_type * active_list = (const int_vector_type *) arg_pack_iget_const_ptr( arg_pack , 2 );
+  bool transform_data = arg_pack_iget_bool( arg_pack , 3 );
+  int report_step = arg_pack_iget_int( arg_pack , 4 );
+  int index1 = arg_pack_iget_int( arg_pack , 5 );
+  int index2 = arg_pack_iget_int( arg_pack , 6 );
+
+  for (int index = index1; index < index2; index++) {
+    enkf_plot_gen_kw_vector_type * vector = enkf_plot_gen_kw_iget( plot_gen_kw , int_vector_iget( active_list , index ));
+    enkf_plot_gen_kw_vector_load( vector , fs , transform_data , report_step );
+  }
+  return NULL;
+}
+
+
+/*
+  The realizations are loaded in parallel, with one contiguous range of
+  realizations for each thread.
+*/
+
 void enkf_plot_gen_kw_load( enkf_plot_gen_kw_type  * plot_gen_kw,
                             enkf_fs_type           * fs,
                             bool                     transform_data ,
@@ -110,23 +139,40 @@ void enkf_plot_gen_kw_load( enkf_plot_gen_kw_type  * plot_gen_kw,
 
   state_map_type * state_map = enkf_fs_get_state_map( fs );
   int ens_size = state_map_get_size( state_map );
-  bool_vector_type * mask;
-
-  if (input_mask)
-    mask = bool_vector_alloc_copy( input_mask );
-  else
-    mask = bool_vector_alloc( ens_size , true );
+  int_vector_type * active_list = int_vector_alloc( 0 , 0 );
 
   enkf_plot_gen_kw_resize( plot_gen_kw , ens_size );
-  {
-    int iens;
-    for (iens = 0; iens < ens_size; ++iens) {
-      if (bool_vector_iget( mask , iens)) {
-        enkf_plot_gen_kw_vector_type * vector = enkf_plot_gen_kw_iget( plot_gen_kw , iens );
-        enkf_plot_gen_kw_vector_load( vector , fs , transform_data , report_step );
-      }
+  for (int iens = 0; iens < ens_size; ++iens) {
+    if (!input_mask || bool_vector_iget( input_mask , iens))
+      int_vector_append( active_list , iens );
+  }
+
+  if (int_vector_size( active_list ) > 0) {
+    int num_active = int_vector_size( active_list );
+    int num_threads = util_int_max( 1 , util_int_min( (int) std::thread::hardware_concurrency() , num_active ));
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( num_threads , sizeof * arg_list );
+
+    for (int ithread = 0; ithread < num_threads; ithread++) {
+      arg_list[ithread] = arg_pack_alloc( );
+      arg_pack_append_ptr( arg_list[ithread] , plot_gen_kw );
+      arg_pack_append_ptr( arg_list[ithread] , fs );
+      arg_pack_append_const_ptr( arg_list[ithread] , active_list );
+      arg_pack_append_bool( arg_list[ithread] , transform_data );
+      arg_pack_append_int( arg_list[ithread] , report_step );
+      arg_pack_append_int( arg_list[ithread] , (ithread * num_active) / num_threads );
+      arg_pack_append_int( arg_list[ithread] , ((ithread + 1) * num_active) / num_threads );
+
+      thread_pool_add_job( tp , enkf_plot_gen_kw_load_range__ , arg_list[ithread] );
     }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+
+    for (int ithread = 0; ithread < num_threads; ithread++)
+      arg_pack_free( arg_list[ithread] );
+    free( arg_list );
   }
+  int_vector_free( active_list );
 }
 
 
@@ -36,6 +36,16 @@ struct enkf_plot_tvector_struct {
   const enkf_config_node_type * config_node;
   int  iens;
   bool summary_mode;
+
+  /*
+    A view does not own any storage; it refers to one row of the
+    ensemble x time matrices held by an enkf_plot_batch instance.
+  */
+  bool           view;
+  int            view_size;
+  const double * view_data;
+  const bool   * view_mask;
+  const time_t * view_time;
 };
 
 
@@ -45,7 +55,20 @@ UTIL_IS_INSTANCE_FUNCTION( enkf_plot_tvector , ENKF_PLOT_TVECTOR_ID )
 
 
 
+static void enkf_plot_tvector_assert_owner( const enkf_plot_tvector_type * plot_tvector , const char * caller) {
+  if (plot_tvector->view)
+    util_abort("%s: can not modify a plot vector view.\n", caller);
+}
+
+
+static void enkf_plot_tvector_assert_view_index( const enkf_plot_tvector_type * plot_tvector , int index , const char * caller) {
+  if ((index < 0) || (index >= plot_tvector->view_size))
+    util_abort("%s: index:%d invalid. Valid interval: [0,%d>.\n", caller , index , plot_tvector->view_size);
+}
+
+
 void enkf_plot_tvector_reset( enkf_plot_tvector_type * plot_tvector ) {
+  enkf_plot_tvector_assert_owner( plot_tvector , __func__ );
   double_vector_reset( plot_tvector->data );
   time_t_vector_reset( plot_tvector->time );
   bool_vector_reset( plot_tvector->mask );
@@ -62,6 +85,12 @@ enkf_plot_tvector_type * enkf_plot_tvector_alloc( const enkf_config_node_type *
   plot_tvector->work = double_vector_alloc(0,0);
   plot_tvector->iens = iens;
 
+  plot_tvector->view      = false;
+  plot_tvector->view_size = 0;
+  plot_tvector->view_data = NULL;
+  plot_tvector->view_mask = NULL;
+  plot_tvector->view_time = NULL;
+
   plot_tvector->config_node = config_node;
   if (enkf_config_node_get_impl_type( config_node ) == SUMMARY)
     plot_tvector->summary_mode = true;
@@ -72,29 +101,94 @@ enkf_plot_tvector_type * enkf_plot_tvector_alloc( const enkf_config_node_type *
 }
 
 
+/*
+  Allocates a read-only plot vector which refers directly to size
+  elements of externally owned data, mask and time arrays. The arrays
+  must outlive the view.
+*/
+
+enkf_plot_tvector_type * enkf_plot_tvector_alloc_view( const enkf_config_node_type * config_node ,
+                                                       int iens ,
+                                                       int size ,
+                                                       const time_t * time ,
+                                                       const double * data ,
+                                                       const bool * mask) {
+  enkf_plot_tvector_type * plot_tvector = (enkf_plot_tvector_type *)util_malloc( sizeof * plot_tvector);
+  UTIL_TYPE_ID_INIT( plot_tvector , ENKF_PLOT_TVECTOR_ID );
+
+  plot_tvector->data = NULL;
+  plot_tvector->time = NULL;
+  plot_tvector->mask = NULL;
+  plot_tvector->work = NULL;
+  plot_tvector->iens = iens;
+
+  plot_tvector->view      = true;
+  plot_tvector->view_size = size;
+  plot_tvector->view_data = data;
+  plot_tvector->view_mask = mask;
+  plot_tvector->view_time = time;
+
+  plot_tvector->config_node = config_node;
+  plot_tvector->summary_mode = (enkf_config_node_get_impl_type( config_node ) == SUMMARY);
+  return plot_tvector;
+}
+
+
+/*
+  Points an existing view to new storage; used by the owner of the
+  storage to keep the view valid when the data is reloaded.
+*/
+
+void enkf_plot_tvector_set_view( enkf_plot_tvector_type * plot_tvector ,
+                                 int size ,
+                                 const time_t * time ,
+                                 const double * data ,
+                                 const bool * mask) {
+  if (!plot_tvector->view)
+    util_abort("%s: plot vector is not a view.\n",__func__);
+
+  plot_tvector->view_size = size;
+  plot_tvector->view_data = data;
+  plot_tvector->view_mask = mask;
+  plot_tvector->view_time = time;
+}
+
+
 void enkf_plot_tvector_free( enkf_plot_tvector_type * plot_tvector ) {
-  double_vector_free( plot_tvector->data );
-  double_vector_free( plot_tvector->work );
-  time_t_vector_free( plot_tvector->time );
-  bool_vector_free( plot_tvector->mask );
+  if (!plot_tvector->view) {
+    double_vector_free( plot_tvector->data );
+    double_vector_free( plot_tvector->work );
+    time_t_vector_free( plot_tvector->time );
+    bool_vector_free( plot_tvector->mask );
+  }
+  free( plot_tvector );
+}
+
+
+bool enkf_plot_tvector_is_view( const enkf_plot_tvector_type * plot_tvector ) {
+  return plot_tvector->view;
 }
 
 
 bool enkf_plot_tvector_all_active( const enkf_plot_tvector_type * plot_tvector ) {
   bool all_active = true;
-  for (int i=0; i < bool_vector_size( plot_tvector->mask ); i++)
-    all_active = all_active && bool_vector_iget(plot_tvector->mask , i );
+  for (int i=0; i < enkf_plot_tvector_size( plot_tvector ); i++)
+    all_active = all_active && enkf_plot_tvector_iget_active(plot_tvector , i );
 
   return all_active;
 }
 
 
 int enkf_plot_tvector_size( const enkf_plot_tvector_type * plot_tvector ) {
+  if (plot_tvector->view)
+    return plot_tvector->view_size;
+
   return bool_vector_size( plot_tvector->mask );
 }
 
 
 void enkf_plot_tvector_iset( enkf_plot_tvector_type * plot_tvector , int index , time_t time , double value) {
+  enkf_plot_tvector_assert_owner( plot_tvector , __func__ );
   time_t_vector_iset( plot_tvector->time , index , time );
   bool active_value = true;
 
@@ -113,14 +207,26 @@ void enkf_plot_tvector_iset( enkf_plot_tvector_type * plot_tvector , int index ,
 
 
 double enkf_plot_tvector_iget_value( const enkf_plot_tvector_type * plot_tvector , int index) {
+  if (plot_tvector->view) {
+    enkf_plot_tvector_assert_view_index( plot_tvector , index , __func__ );
+    return plot_tvector->view_data[index];
+  }
   return double_vector_iget( plot_tvector->data , index);
 }
 
 time_t enkf_plot_tvector_iget_time( const enkf_plot_tvector_type * plot_tvector , int index) {
+  if (plot_tvector->view) {
+    enkf_plot_tvector_assert_view_index( plot_tvector , index , __func__ );
+    return plot_tvector->view_time[index];
+  }
   return time_t_vector_iget( plot_tvector->time , index);
 }
 
 bool enkf_plot_tvector_iget_active( const enkf_plot_tvector_type * plot_tvector , int index) {
+  if (plot_tvector->view) {
+    enkf_plot_tvector_assert_view_index( plot_tvector , index , __func__ );
+    return plot_tvector->view_mask[index];
+  }
   return bool_vector_iget( plot_tvector->mask , index );
 }
 
@@ -133,6 +239,7 @@ void enkf_plot_tvector_load( enkf_plot_tvector_type * plot_tvector ,
                              enkf_fs_type * fs ,
                              const char * index_key) {
 
+  enkf_plot_tvector_assert_owner( plot_tvector , __func__ );
   time_map_type * time_map = enkf_fs_get_time_map( fs );
   int step1 = 0;
   int step2 = time_map_get_last_step( time_map );
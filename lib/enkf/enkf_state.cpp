@@ -71,12 +71,20 @@
 #include <ert/res_util/res_log.hpp>
 #include <ert/enkf/run_arg.hpp>
 #include <ert/enkf/summary_key_matcher.hpp>
+#include <ert/enkf/summary_ref.hpp>
 #include <ert/enkf/forward_load_context.hpp>
 #include <ert/enkf/enkf_config_node.hpp>
 #include <ert/enkf/callback_arg.hpp>
+#include <ert/enkf/load_timing.hpp>
 
 #define  ENKF_STATE_TYPE_ID 78132
 
+/*
+  The number of summary vectors which are kept in memory and written
+  to storage as one batch when internalizing the summary results.
+*/
+#define  SUMMARY_STORE_BATCH_SIZE 1024
+
 
 
 
@@ -153,14 +161,20 @@ static void shared_info_free(shared_info_type * shared_info) {
 
 /*
   This function does not acces the nodes of the enkf_state object.
+
+  Samples and stores the parameters of one realization, without
+  syncing the storage. Several realizations can be initialized
+  concurrently with this function, provided they use separate rng
+  instances; enkf_fs_fsync() must be called when they are all done.
 */
-void enkf_state_initialize(enkf_state_type * enkf_state , rng_type * rng, enkf_fs_type * fs , const stringlist_type * param_list, init_mode_type init_mode) {
+
+bool enkf_state_initialize_nodes(enkf_state_type * enkf_state , rng_type * rng, enkf_fs_type * fs , const stringlist_type * param_list, init_mode_type init_mode) {
   if (init_mode != INIT_NONE) {
     int iens = enkf_state_get_iens( enkf_state );
     state_map_type * state_map = enkf_fs_get_state_map( fs );
     realisation_state_enum current_state = state_map_iget(state_map, iens);
     if ((current_state == STATE_PARENT_FAILURE) && (init_mode != INIT_FORCE))
-      return;
+      return false;
     else {
       const ensemble_config_type * ensemble_config = enkf_state->ensemble_config;
       for (int ip = 0; ip < stringlist_get_size(param_list); ip++) {
@@ -177,9 +191,16 @@ void enkf_state_initialize(enkf_state_type * enkf_state , rng_type * rng, enkf_f
         enkf_node_free( param_node );
       }
       state_map_update_matching(state_map , iens , STATE_UNDEFINED | STATE_LOAD_FAILURE , STATE_INITIALIZED);
-      enkf_fs_fsync(fs);
+      return true;
     }
   }
+  return false;
+}
+
+
+void enkf_state_initialize(enkf_state_type * enkf_state , rng_type * rng, enkf_fs_type * fs , const stringlist_type * param_list, init_mode_type init_mode) {
+  if (enkf_state_initialize_nodes( enkf_state , rng , fs , param_list , init_mode ))
+    enkf_fs_fsync(fs);
 }
 
 
@@ -368,6 +389,75 @@ static void enkf_state_check_for_missing_eclipse_summary_data(const ensemble_con
   stringlist_free(keys);
 }
 
+
+/*
+  With LAZY_SUMMARY_LOAD the summary vectors which are not observed
+  are not stored, instead a reference to the unified summary file is
+  stored, see summary_ref.cpp. Returns NULL - i.e. all the vectors
+  should be stored - if lazy loading has not been enabled, if the
+  vectors should be merged with existing vectors from a restarted
+  simulation, or if the summary has not been loaded from one
+  unformatted unified summary file.
+*/
+
+static summary_ref_type * enkf_state_alloc_summary_ref(const forward_load_context_type * load_context,
+                                                       const model_config_type * model_config,
+                                                       const int_vector_type * ministep_index,
+                                                       bool merge_existing) {
+  const char * unsmry_file = forward_load_context_get_unified_summary_file( load_context );
+
+  if (!model_config_get_lazy_summary_load( model_config ) || merge_existing || !unsmry_file)
+    return NULL;
+
+  {
+    const ecl_sum_type * summary = forward_load_context_get_ecl_sum( load_context );
+    summary_ref_type * summary_ref = summary_ref_alloc( unsmry_file,
+                                                        ecl_smspec_get_params_size( ecl_sum_get_smspec( summary )),
+                                                        ecl_sum_get_data_length( summary ),
+                                                        ministep_index );
+    if (!summary_ref)
+      res_log_fwarning("Can not use %s for lazy summary load - all the summary vectors will be stored.", unsmry_file);
+
+    return summary_ref;
+  }
+}
+
+
+/*
+  Stores a batch of summary nodes for one realization; with
+  COLUMNAR_SUMMARY_STORAGE the vectors are stored in blocks of keys,
+  see summary_block.cpp, otherwise every vector is stored separately.
+*/
+
+static void enkf_state_store_summary_nodes(forward_load_context_type * load_context,
+                                           const vector_type * node_list,
+                                           enkf_fs_type * fs,
+                                           int iens,
+                                           bool columnar_storage) {
+  double start_time = load_timing_now();
+  if (!columnar_storage)
+    enkf_node_store_vectors( node_list , fs , iens );
+  else {
+    stringlist_type * keys = stringlist_alloc_new();
+    vector_type * data_vectors = vector_alloc_new();
+
+    for (int i = 0; i < vector_get_size( node_list ); i++) {
+      const enkf_node_type * node = (const enkf_node_type *) vector_iget_const( node_list , i );
+      double_vector_type * data_vector = double_vector_alloc( 0 , SUMMARY_UNDEF );
+
+      summary_user_get_vector( summary_safe_cast_const( enkf_node_value_ptr( node )) , NULL , data_vector );
+      stringlist_append_copy( keys , enkf_node_get_key( node ));
+      vector_append_owned_ref( data_vectors , data_vector , double_vector_free__ );
+    }
+    enkf_fs_fwrite_summary_block( fs , keys , data_vectors , iens );
+
+    vector_free( data_vectors );
+    stringlist_free( keys );
+  }
+  forward_load_context_add_store_time( load_context , load_timing_now() - start_time );
+}
+
+
 static bool enkf_state_internalize_dynamic_eclipse_results(ensemble_config_type * ens_config,
                                                            forward_load_context_type * load_context ,
                                                            const model_config_type * model_config) {
@@ -380,6 +470,7 @@ static bool enkf_state_internalize_dynamic_eclipse_results(ensemble_config_type
 
   if (load_summary || matcher_size > 0 || summary) {
     int load_start = run_arg_get_load_start( run_arg );
+    bool merge_existing = (load_start > 0);  /* A restarted simulation only provides the tail of the vectors. */
 
     if (load_start == 0) { /* Do not attempt to load the "S0000" summary results. */
       load_start++;
@@ -411,26 +502,64 @@ static bool enkf_state_internalize_dynamic_eclipse_results(ensemble_config_type
         int_vector_resize( time_index , step2 + 1, -1);
 
         const ecl_smspec_type * smspec = ecl_sum_get_smspec(summary);
+        int_vector_type * matches = summary_key_matcher_alloc_smspec_matches(matcher, smspec);
+        int_vector_type * ministep_index = summary_alloc_ministep_index(summary, time_index);
+        summary_ref_type * summary_ref = enkf_state_alloc_summary_ref(load_context, model_config, ministep_index, merge_existing);
+        bool columnar_storage = model_config_get_columnar_summary_storage( model_config );
+        summary_key_set_type * key_set = enkf_fs_get_summary_key_set(sim_fs);
+        vector_type * node_list = vector_alloc_new();
+        vector_type * config_nodes = vector_alloc_new();
+        stringlist_type * keys = stringlist_alloc_new();
 
-        for(int i = 0; i < ecl_smspec_num_nodes(smspec); i++) {
-          const ecl::smspec_node& smspec_node = ecl_smspec_iget_node_w_node_index(smspec, i);
-          const char * key = smspec_node.get_gen_key1();
+        /*
+          All the config nodes are looked up - and created if needed -
+          before loading, so that the shared ensemble configuration and
+          key set are only locked once per realization.
+        */
+        for(int m = 0; m < int_vector_size(matches); m++) {
+          const ecl::smspec_node& smspec_node = ecl_smspec_iget_node_w_node_index(smspec, int_vector_iget(matches, m));
+          stringlist_append_copy( keys , smspec_node.get_gen_key1() );
+        }
+        summary_key_set_add_summary_keys(key_set, keys);
+        ensemble_config_get_or_create_summary_nodes(ens_config, keys, config_nodes);
 
-          if(summary_key_matcher_match_summary_key(matcher, key)) {
-            summary_key_set_type * key_set = enkf_fs_get_summary_key_set(sim_fs);
-            summary_key_set_add_summary_key(key_set, key);
+        for(int m = 0; m < vector_get_size(config_nodes); m++) {
+          enkf_config_node_type * config_node = (enkf_config_node_type *) vector_iget( config_nodes , m );
+          const char * key = enkf_config_node_get_key( config_node );
 
-            enkf_config_node_type * config_node = ensemble_config_get_or_create_summary_node(ens_config, key);
-            enkf_node_type * node = enkf_node_alloc( config_node );
+          if (summary_ref && !summary_key_matcher_summary_key_is_required( matcher , key )) {
+            const ecl::smspec_node& smspec_node = ecl_smspec_iget_node_w_node_index(smspec, int_vector_iget(matches, m));
+            summary_ref_add_key( summary_ref , key , smspec_node.get_params_index() );
+            continue;
+          }
 
+          enkf_node_type * node = enkf_node_alloc( config_node );
+
+          if (merge_existing)
             enkf_node_try_load_vector( node , sim_fs , iens );  // Ensure that what is currently on file is loaded before we update.
 
+          if (!summary_forward_load_ministeps( summary_safe_cast( enkf_node_value_ptr( node )) , summary , ministep_index ))
             enkf_node_forward_load_vector( node , load_context , time_index);
-            enkf_node_store_vector( node , sim_fs , iens );
-            enkf_node_free( node );
+
+          vector_append_owned_ref( node_list , node , enkf_node_free__ );
+          if (vector_get_size( node_list ) == SUMMARY_STORE_BATCH_SIZE) {
+            enkf_state_store_summary_nodes( load_context , node_list , sim_fs , iens , columnar_storage );
+            vector_clear( node_list );
           }
         }
+        enkf_state_store_summary_nodes( load_context , node_list , sim_fs , iens , columnar_storage );
 
+        if (summary_ref && summary_ref_get_size( summary_ref ) == 0) {
+          summary_ref_free( summary_ref );
+          summary_ref = NULL;
+        }
+        enkf_fs_set_summary_ref( sim_fs , iens , summary_ref );
+
+        vector_free( node_list );
+        vector_free( config_nodes );
+        stringlist_free( keys );
+        int_vector_free( ministep_index );
+        int_vector_free( matches );
         int_vector_free( time_index );
 
         /*
@@ -480,8 +609,10 @@ static void enkf_state_internalize_custom_kw(const ensemble_config_type * ens_co
     if (enkf_node_internalize(node, report_step) && enkf_node_has_func(node, forward_load_func)) {
       if (enkf_node_forward_load(node, load_context)) {
         node_id_type node_id = {.report_step = report_step, .iens = iens };
+        double start_time = load_timing_now();
 
         enkf_node_store(node, sim_fs, false, node_id);
+        forward_load_context_add_store_time(load_context, load_timing_now() - start_time);
 
         const enkf_config_node_type * config_node = enkf_node_get_config(node);
         const custom_kw_config_type * custom_kw_config = (const custom_kw_config_type *)(custom_kw_config_type*) enkf_config_node_get_ref(config_node);
@@ -524,8 +655,10 @@ static void enkf_state_load_gen_data_node(
     if (enkf_node_forward_load(node, load_context)) {
       node_id_type node_id = {.report_step = report_step,
                               .iens = iens };
+      double start_time = load_timing_now();
 
       enkf_node_store(node, sim_fs, false, node_id);
+      forward_load_context_add_store_time(load_context, load_timing_now() - start_time);
       enkf_state_log_GEN_DATA_load(node, report_step, load_context);
     } else {
       forward_load_context_update_result(load_context, LOAD_FAILURE);
@@ -624,11 +757,9 @@ static forward_load_context_type * enkf_state_alloc_load_context(const ensemble_
 */
 static int enkf_state_internalize_results(ensemble_config_type * ens_config,
                                           model_config_type * model_config,
-                                          const ecl_config_type * ecl_config,
-                                          const run_arg_type * run_arg,
-                                          stringlist_type * msg_list) {
+                                          forward_load_context_type * load_context) {
 
-  forward_load_context_type * load_context = enkf_state_alloc_load_context( ens_config, ecl_config, run_arg, msg_list);
+  const run_arg_type * run_arg = forward_load_context_get_run_arg( load_context );
   /*
     The timing information - i.e. mainly what is the last report step
     in these results are inferred from the loading of summary results,
@@ -651,27 +782,46 @@ static int enkf_state_internalize_results(ensemble_config_type * ens_config,
   enkf_state_internalize_GEN_DATA(ens_config , load_context , model_config , last_report);
   enkf_state_internalize_custom_kw(ens_config, load_context , model_config);
 
-  int result = forward_load_context_get_result(load_context);
-  forward_load_context_free( load_context );
-  return result;
+  return forward_load_context_get_result(load_context);
 }
 
 
 
 
 
-static int enkf_state_load_from_forward_model__(ensemble_config_type * ens_config,
-                                                model_config_type * model_config,
-                                                const ecl_config_type * ecl_config,
-                                                const run_arg_type * run_arg ,
-                                                stringlist_type * msg_list) {
+/*
+  The loading of results is done in two steps: first the forward
+  init parameters are loaded and the ECLIPSE summary files are opened
+  and parsed, then the results are internalized and stored. The first
+  step is mainly IO against the runpath, the second step is mainly
+  computation and IO against the storage; they are exposed
+  separately so that the two steps of different realizations can run
+  concurrently, see enkf_main_load_from_run_context().
+*/
+
+static forward_load_context_type * enkf_state_open_forward_model__(ensemble_config_type * ens_config,
+                                                                  const ecl_config_type * ecl_config,
+                                                                  const run_arg_type * run_arg ,
+                                                                  stringlist_type * msg_list) {
 
+  forward_load_context_type * load_context;
   int result = 0;
 
   if (ensemble_config_have_forward_init( ens_config ))
     result |= ensemble_config_forward_init( ens_config , run_arg );
 
-  result |= enkf_state_internalize_results( ens_config, model_config, ecl_config, run_arg , msg_list );
+  load_context = enkf_state_alloc_load_context( ens_config, ecl_config, run_arg, msg_list);
+  forward_load_context_update_result( load_context , result );
+  return load_context;
+}
+
+
+static int enkf_state_internalize_forward_model__(ensemble_config_type * ens_config,
+                                                  model_config_type * model_config,
+                                                  forward_load_context_type * load_context) {
+
+  const run_arg_type * run_arg = forward_load_context_get_run_arg( load_context );
+  int result = enkf_state_internalize_results( ens_config, model_config, load_context );
   state_map_type * state_map = enkf_fs_get_state_map( run_arg_get_sim_fs( run_arg ) );
   int iens = run_arg_get_iens( run_arg );
   if (result & LOAD_FAILURE)
@@ -682,6 +832,54 @@ static int enkf_state_load_from_forward_model__(ensemble_config_type * ens_confi
   return result;
 }
 
+
+static int enkf_state_load_from_forward_model__(ensemble_config_type * ens_config,
+                                                model_config_type * model_config,
+                                                const ecl_config_type * ecl_config,
+                                                const run_arg_type * run_arg ,
+                                                stringlist_type * msg_list) {
+
+  forward_load_context_type * load_context = enkf_state_open_forward_model__( ens_config, ecl_config, run_arg, msg_list );
+  int result = enkf_state_internalize_forward_model__( ens_config, model_config, load_context );
+  forward_load_context_free( load_context );
+  return result;
+}
+
+
+forward_load_context_type * enkf_state_open_forward_model(enkf_state_type * enkf_state ,
+                                                          run_arg_type * run_arg ,
+                                                          stringlist_type * msg_list ,
+                                                          bool manual_load) {
+
+  if (manual_load)
+    state_map_update_undefined(enkf_fs_get_state_map( run_arg_get_sim_fs(run_arg) ) , run_arg_get_iens( run_arg ) , STATE_INITIALIZED);
+
+  return enkf_state_open_forward_model__( enkf_state->ensemble_config,
+                                          enkf_state->shared_info->ecl_config,
+                                          run_arg,
+                                          msg_list);
+}
+
+
+/*
+  Observe that the REPORT_STEP_INCOMPATIBLE flag is cleared from the
+  return value, as in enkf_state_load_from_forward_model_mt().
+*/
+
+int enkf_state_internalize_forward_model(enkf_state_type * enkf_state ,
+                                         forward_load_context_type * load_context) {
+
+  int result = enkf_state_internalize_forward_model__( enkf_state->ensemble_config,
+                                                       enkf_state->shared_info->model_config,
+                                                       load_context );
+  if (result & REPORT_STEP_INCOMPATIBLE) {
+    fprintf(stderr,"** Warning the timesteps in refcase and current simulation are not in accordance - something wrong with schedule file?\n");
+    result -= REPORT_STEP_INCOMPATIBLE;
+  }
+  return result;
+}
+
+
 int enkf_state_load_from_forward_model(enkf_state_type * enkf_state ,
                                        run_arg_type * run_arg ,
                                        stringlist_type * msg_list) {
@@ -32,6 +32,7 @@
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
 #include <ert/util/type_macros.h>
 
 #include <ert/ecl/ecl_grid.h>
@@ -107,7 +108,7 @@ namespace {
 
 struct ensemble_config_struct {
   UTIL_TYPE_ID_DECLARATION;
-  pthread_mutex_t                                mutex;
+  mutable pthread_rwlock_t                       config_lock;            /* summary nodes are added to config_nodes while the realizations are loaded in parallel. */
   char                                         * gen_kw_format_string;   /* format string used when creating gen_kw search/replace strings. */
   std::unordered_map<std::string,enkf_config_node_type*>   config_nodes;           /* a hash of enkf_config_node instances - which again conatin pointers to e.g. field_config objects.  */
   field_trans_table_type                       * field_trans_table;      /* a table of the transformations which are available to apply on fields. */
@@ -177,7 +178,7 @@ static ensemble_config_type * ensemble_config_alloc_empty(void) {
   ensemble_config->gen_kw_format_string  = util_alloc_string_copy( DEFAULT_GEN_KW_TAG_FORMAT );
   ensemble_config->have_forward_init     = false;
   ensemble_config->summary_key_matcher   = summary_key_matcher_alloc();
-  pthread_mutex_init( &ensemble_config->mutex , NULL);
+  pthread_rwlock_init( &ensemble_config->config_lock , NULL);
 
   return ensemble_config;
 }
@@ -188,7 +189,6 @@ ensemble_config_type * ensemble_config_alloc_full(const char * gen_kw_format_str
   ensemble_config->field_trans_table     = field_trans_table_alloc();
   ensemble_config_set_gen_kw_format( ensemble_config , gen_kw_format_string);
   ensemble_config->summary_key_matcher   = summary_key_matcher_alloc();
-  pthread_mutex_init( &ensemble_config->mutex , NULL);
   return ensemble_config;
 }
 
@@ -227,46 +227,119 @@ void ensemble_config_free(ensemble_config_type * ensemble_config) {
   for(auto& config_pair : ensemble_config->config_nodes)
     enkf_config_node_free( config_pair.second );
 
+  pthread_rwlock_destroy( &ensemble_config->config_lock );
   delete ensemble_config;
 }
 
 
+/*
+  The config_nodes map is protected by the config_lock; the functions
+  with a trailing '__' assume that the caller already holds the lock.
+*/
+
+static enkf_config_node_type * ensemble_config_find_node__(const ensemble_config_type * ensemble_config, const char * key) {
+  const auto node_it = ensemble_config->config_nodes.find(key);
+  if (node_it != ensemble_config->config_nodes.end())
+    return node_it->second;
+  else
+    return NULL;
+}
+
+static enkf_config_node_type * ensemble_config_add_summary__(ensemble_config_type * ensemble_config , const char * key , load_fail_type load_fail);
+
+
 bool ensemble_config_has_key(const ensemble_config_type * ensemble_config , const char * key) {
-  return ensemble_config->config_nodes.count(key) > 0;
+  bool has_key;
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
+  has_key = (ensemble_config_find_node__(ensemble_config, key) != NULL);
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+  return has_key;
 }
 
 
 
 enkf_config_node_type * ensemble_config_get_node(const ensemble_config_type * ensemble_config, const char * key) {
-  const auto node_it = ensemble_config->config_nodes.find(key);
-  if (node_it != ensemble_config->config_nodes.end()) {
-    enkf_config_node_type * node = node_it->second;
-    return node;
-  } else {
+  enkf_config_node_type * node;
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
+  node = ensemble_config_find_node__(ensemble_config, key);
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+
+  if (!node)
     util_abort("%s: ens node:\"%s\" does not exist \n",__func__ , key);
-    return NULL; /* compiler shut up */
-  }
+
+  return node;
 }
 
 enkf_config_node_type * ensemble_config_get_or_create_summary_node(ensemble_config_type * ensemble_config, const char * key) {
-  if (ensemble_config->config_nodes.count(key) == 0)
-    ensemble_config_add_summary(ensemble_config, key, LOAD_FAIL_SILENT);
+  enkf_config_node_type * node;
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
+  node = ensemble_config_find_node__(ensemble_config, key);
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+
+  if (!node)
+    node = ensemble_config_add_summary(ensemble_config, key, LOAD_FAIL_SILENT);
+
+  return node;
+}
+
+
+/*
+  Will look up the summary config nodes for all the keys in @keys and
+  append them to @config_nodes, in the same order as the keys. Nodes
+  which do not exist are created with LOAD_FAIL_SILENT, as in
+  ensemble_config_get_or_create_summary_node().
+
+  All the lookups are done with one read lock, and all the missing
+  nodes are created with one write lock. When the realizations are
+  loaded in parallel the first realization to be loaded will create
+  the nodes for the whole SMSPEC in one go, and the remaining
+  realizations only need to share the read lock once each.
+*/
+
+void ensemble_config_get_or_create_summary_nodes(ensemble_config_type * ensemble_config, const stringlist_type * keys, vector_type * config_nodes) {
+  int offset  = vector_get_size( config_nodes );
+  int missing = 0;
 
-  return ensemble_config_get_node(ensemble_config, key);
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
+  for (int i = 0; i < stringlist_get_size( keys ); i++) {
+    enkf_config_node_type * node = ensemble_config_find_node__(ensemble_config, stringlist_iget( keys , i ));
+    vector_append_ref( config_nodes , node );
+    if (!node)
+      missing++;
+  }
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+
+  if (missing > 0) {
+    pthread_rwlock_wrlock( &ensemble_config->config_lock );
+    for (int i = 0; i < stringlist_get_size( keys ); i++) {
+      if (vector_iget( config_nodes , offset + i ) == NULL) {
+        enkf_config_node_type * node = ensemble_config_add_summary__(ensemble_config, stringlist_iget( keys , i ), LOAD_FAIL_SILENT);
+        vector_iset_ref( config_nodes , offset + i , node );
+      }
+    }
+    pthread_rwlock_unlock( &ensemble_config->config_lock );
+  }
 }
 
 bool ensemble_config_have_forward_init( const ensemble_config_type * ensemble_config ) {
   return ensemble_config->have_forward_init;
 }
 
+static void ensemble_config_add_node__( ensemble_config_type * ensemble_config , enkf_config_node_type * node) {
+  const char * key = enkf_config_node_get_key( node );
+  if (ensemble_config_find_node__(ensemble_config , key))
+    util_abort("%s: a configuration object:%s has already been added - aborting \n",__func__ , key);
+
+  ensemble_config->config_nodes[key] = node;
+  ensemble_config->have_forward_init |= enkf_config_node_use_forward_init( node );
+}
+
+
 void ensemble_config_add_node( ensemble_config_type * ensemble_config , enkf_config_node_type * node) {
   if (node) {
-    const char * key = enkf_config_node_get_key( node );
-    if (ensemble_config_has_key(ensemble_config , key))
-      util_abort("%s: a configuration object:%s has already been added - aborting \n",__func__ , key);
-
-    ensemble_config->config_nodes[key] = node;
-    ensemble_config->have_forward_init |= enkf_config_node_use_forward_init( node );
+    pthread_rwlock_wrlock( &ensemble_config->config_lock );
+    ensemble_config_add_node__( ensemble_config , node );
+    pthread_rwlock_unlock( &ensemble_config->config_lock );
   } else
     util_abort("%s: internal error - tried to add NULL node to ensemble configuration \n",__func__);
 }
@@ -276,16 +349,18 @@ void ensemble_config_add_node( ensemble_config_type * ensemble_config , enkf_con
 
 
 void ensemble_config_add_obs_key(ensemble_config_type * ensemble_config , const char * key, const char * obs_key) {
-  enkf_config_node_type * node = ensemble_config->config_nodes.at(key);
+  enkf_config_node_type * node = ensemble_config_get_node(ensemble_config , key);
   enkf_config_node_add_obs_key(node , obs_key);
 }
 
 
 void ensemble_config_clear_obs_keys(ensemble_config_type * ensemble_config) {
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
   for (auto& config_pair : ensemble_config->config_nodes) {
     enkf_config_node_type * config_node = config_pair.second;
     enkf_config_node_clear_obs_keys( config_node );
   }
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
 }
 
 
@@ -741,8 +816,10 @@ const enkf_config_node_type * ensemble_config_user_get_node(const ensemble_confi
 
 stringlist_type * ensemble_config_alloc_keylist(const ensemble_config_type * config) {
   stringlist_type * s = stringlist_alloc_new();
+  pthread_rwlock_rdlock( &config->config_lock );
   for (const auto& config_pair : config->config_nodes)
     stringlist_append_copy( s, config_pair.first.c_str());
+  pthread_rwlock_unlock( &config->config_lock );
   return s;
 }
 
@@ -760,6 +837,7 @@ stringlist_type * ensemble_config_alloc_keylist(const ensemble_config_type * con
 stringlist_type * ensemble_config_alloc_keylist_from_var_type(const ensemble_config_type * config , int var_mask) {
   stringlist_type * key_list = stringlist_alloc_new();
 
+  pthread_rwlock_rdlock( &config->config_lock );
   for (const auto& config_pair : config->config_nodes) {
     const char * key       = config_pair.first.c_str();
     enkf_var_type var_type = enkf_config_node_get_var_type( config_pair.second );
@@ -767,6 +845,7 @@ stringlist_type * ensemble_config_alloc_keylist_from_var_type(const ensemble_con
     if (var_type & var_mask)
       stringlist_append_copy( key_list , key );
   }
+  pthread_rwlock_unlock( &config->config_lock );
 
   return key_list;
 }
@@ -776,24 +855,32 @@ stringlist_type * ensemble_config_alloc_keylist_from_var_type(const ensemble_con
 stringlist_type * ensemble_config_alloc_keylist_from_impl_type(const ensemble_config_type * config , ert_impl_type impl_type) {
   stringlist_type * key_list = stringlist_alloc_new();
 
+  pthread_rwlock_rdlock( &config->config_lock );
   for (const auto& config_pair : config->config_nodes) {
     const char * key       = config_pair.first.c_str();
     if (impl_type == enkf_config_node_get_impl_type( config_pair.second ))
       stringlist_append_copy( key_list , key );
 
   }
+  pthread_rwlock_unlock( &config->config_lock );
 
   return key_list;
 }
 
 
 bool ensemble_config_has_impl_type(const  ensemble_config_type * config, const ert_impl_type impl_type) {
+  bool has_impl_type = false;
+
+  pthread_rwlock_rdlock( &config->config_lock );
   for (const auto& config_pair : config->config_nodes) {
-    if (impl_type == enkf_config_node_get_impl_type( config_pair.second ))
-      return true;
+    if (impl_type == enkf_config_node_get_impl_type( config_pair.second )) {
+      has_impl_type = true;
+      break;
+    }
   }
+  pthread_rwlock_unlock( &config->config_lock );
 
-  return false;
+  return has_impl_type;
 }
 
 bool ensemble_config_require_summary(const  ensemble_config_type * ens_config) {
@@ -890,12 +977,10 @@ void ensemble_config_update_custom_kw_config(ensemble_config_type * config, cust
    NULL.
 */
 
-enkf_config_node_type * ensemble_config_add_summary(ensemble_config_type * ensemble_config , const char * key , load_fail_type load_fail) {
-  enkf_config_node_type * config_node = NULL;
+static enkf_config_node_type * ensemble_config_add_summary__(ensemble_config_type * ensemble_config , const char * key , load_fail_type load_fail) {
+  enkf_config_node_type * config_node = ensemble_config_find_node__(ensemble_config , key);
 
-  const auto node_it = ensemble_config->config_nodes.find(key);
-  if (node_it != ensemble_config->config_nodes.end()) {
-    config_node = node_it->second;
+  if (config_node) {
     if (enkf_config_node_get_impl_type( config_node ) != SUMMARY) {
       util_abort("%s: ensemble key:%s already exists - but it is not of summary type\n",__func__ , key);
     }
@@ -905,12 +990,21 @@ enkf_config_node_type * ensemble_config_add_summary(ensemble_config_type * ensem
 
   } else {
     config_node = enkf_config_node_alloc_summary( key , load_fail);
-    ensemble_config_add_node(ensemble_config , config_node );
+    ensemble_config_add_node__(ensemble_config , config_node );
   }
 
   return config_node;
 }
 
+
+enkf_config_node_type * ensemble_config_add_summary(ensemble_config_type * ensemble_config , const char * key , load_fail_type load_fail) {
+  enkf_config_node_type * config_node;
+  pthread_rwlock_wrlock( &ensemble_config->config_lock );
+  config_node = ensemble_config_add_summary__( ensemble_config , key , load_fail );
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+  return config_node;
+}
+
 enkf_config_node_type * ensemble_config_add_summary_observation(ensemble_config_type * ensemble_config , const char * key , load_fail_type load_fail) {
     enkf_config_node_type * config_node = ensemble_config_add_summary(ensemble_config, key, load_fail);
 
@@ -956,7 +1050,11 @@ const summary_key_matcher_type * ensemble_config_get_summary_key_matcher(const e
 /*****************************************************************/
 
 int ensemble_config_get_size(const ensemble_config_type * ensemble_config ) {
-  return ensemble_config->config_nodes.size();
+  int size;
+  pthread_rwlock_rdlock( &ensemble_config->config_lock );
+  size = ensemble_config->config_nodes.size();
+  pthread_rwlock_unlock( &ensemble_config->config_lock );
+  return size;
 }
 
 
@@ -966,9 +1064,19 @@ int ensemble_config_forward_init(const ensemble_config_type * ens_config,
   int result = 0;
   if (run_arg_get_step1(run_arg) == 0) {
     int iens = run_arg_get_iens( run_arg );
+    vector_type * init_nodes = vector_alloc_new();
+
+    /* The nodes are collected first, the lock is not held while loading. */
+    pthread_rwlock_rdlock( &ens_config->config_lock );
     for( auto& config_pair : ens_config->config_nodes) {
-      enkf_config_node_type * config_node = config_pair.second;
-      if (enkf_config_node_use_forward_init(config_node)) {
+      if (enkf_config_node_use_forward_init(config_pair.second))
+        vector_append_ref( init_nodes , config_pair.second );
+    }
+    pthread_rwlock_unlock( &ens_config->config_lock );
+
+    for (int i = 0; i < vector_get_size( init_nodes ); i++) {
+      enkf_config_node_type * config_node = (enkf_config_node_type *) vector_iget( init_nodes , i );
+      {
         enkf_node_type * node = enkf_node_alloc( config_node );
         enkf_fs_type * sim_fs = run_arg_get_sim_fs( run_arg );
         node_id_type node_id = {.report_step = 0 ,
@@ -999,6 +1107,7 @@ int ensemble_config_forward_init(const ensemble_config_type * ens_config,
         enkf_node_free( node );
       }
     }
+    vector_free( init_nodes );
   }
   return result;
 }
@@ -0,0 +1,516 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'ensemble_stats.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <ert/util/util.h>
+#include <ert/util/hash.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/bool_vector.h>
+#include <ert/util/statistics.h>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_plot_batch.hpp>
+#include <ert/enkf/ensemble_stats.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/time_map.hpp>
+
+/*
+  The ensemble_stats object is a per case cache of ensemble statistics;
+  for every (node_key, index_key) pair which has been requested it holds
+  the mean, std, min, max and P10/P50/P90 quantiles for each report
+  step, computed over all realizations with data.
+
+  The statistics are computed on first request, using one
+  enkf_plot_batch load for all the keys which are missing, and are
+  persisted in the case directory when the filesystem is unmounted. The
+  filesystem invalidates all statistics for a node_key when data for
+  that node is written, and a cached entry is also considered stale if
+  the set of realizations with data, or the length of the time map, has
+  changed since it was computed.
+
+  All the values for one step are in memory at the same time, so the
+  quantiles are the exact empirical quantiles, with the same
+  definition as statistics_empirical_quantile().
+*/
+
+#define ENSEMBLE_STATS_TYPE_ID  7713590
+#define KEY_STATS_TYPE_ID       7713591
+
+struct key_stats_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int_vector_type    * realizations;      /* The realizations the statistics were computed from. */
+  int_vector_type    * count;             /* The number of active values at each step. */
+  double_vector_type * stats[ENSEMBLE_STAT_COUNT];
+};
+
+
+struct ensemble_stats_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  pthread_mutex_t   mutex;
+  hash_type       * nodes;                /* node_key -> hash of index_key -> key_stats */
+  long              generation;           /* Incremented by every invalidation. */
+  bool              dirty;
+};
+
+
+static UTIL_SAFE_CAST_FUNCTION( key_stats , KEY_STATS_TYPE_ID )
+
+
+static key_stats_type * key_stats_alloc_empty( ) {
+  key_stats_type * key_stats = (key_stats_type *)util_malloc( sizeof * key_stats );
+  UTIL_TYPE_ID_INIT( key_stats , KEY_STATS_TYPE_ID );
+  key_stats->realizations = NULL;
+  key_stats->count = NULL;
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    key_stats->stats[stat] = NULL;
+  return key_stats;
+}
+
+
+static key_stats_type * key_stats_alloc( const int_vector_type * realizations , int num_steps ) {
+  key_stats_type * key_stats = key_stats_alloc_empty( );
+  key_stats->realizations = int_vector_alloc_copy( realizations );
+  key_stats->count = int_vector_alloc( num_steps , 0 );
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    key_stats->stats[stat] = double_vector_alloc( num_steps , 0 );
+  return key_stats;
+}
+
+
+key_stats_type * key_stats_alloc_copy( const key_stats_type * src ) {
+  key_stats_type * key_stats = key_stats_alloc_empty( );
+  key_stats->realizations = int_vector_alloc_copy( src->realizations );
+  key_stats->count = int_vector_alloc_copy( src->count );
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    key_stats->stats[stat] = double_vector_alloc_copy( src->stats[stat] );
+  return key_stats;
+}
+
+
+void key_stats_free( key_stats_type * key_stats ) {
+  int_vector_free( key_stats->realizations );
+  int_vector_free( key_stats->count );
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    double_vector_free( key_stats->stats[stat] );
+  free( key_stats );
+}
+
+
+static void key_stats_free__( void * arg ) {
+  key_stats_free( key_stats_safe_cast( arg ));
+}
+
+
+int key_stats_get_num_steps( const key_stats_type * key_stats ) {
+  return int_vector_size( key_stats->count );
+}
+
+
+double key_stats_iget( const key_stats_type * key_stats , ensemble_stat_enum stat , int step ) {
+  if ((stat < 0) || (stat >= ENSEMBLE_STAT_COUNT))
+    util_abort("%s: invalid statistic:%d \n",__func__ , stat);
+
+  return double_vector_iget( key_stats->stats[stat] , step );
+}
+
+
+int key_stats_iget_count( const key_stats_type * key_stats , int step ) {
+  return int_vector_iget( key_stats->count , step );
+}
+
+
+const int_vector_type * key_stats_get_realizations( const key_stats_type * key_stats ) {
+  return key_stats->realizations;
+}
+
+
+static bool key_stats_is_current( const key_stats_type * key_stats , const int_vector_type * realizations , int num_steps ) {
+  return (key_stats_get_num_steps( key_stats ) == num_steps) &&
+         int_vector_equal( key_stats->realizations , realizations );
+}
+
+
+static void key_stats_fwrite( const key_stats_type * key_stats , FILE * stream ) {
+  int_vector_fwrite( key_stats->realizations , stream );
+  int_vector_fwrite( key_stats->count , stream );
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    double_vector_fwrite( key_stats->stats[stat] , stream );
+}
+
+
+static key_stats_type * key_stats_fread_alloc( FILE * stream ) {
+  key_stats_type * key_stats = key_stats_alloc_empty( );
+  key_stats->realizations = int_vector_fread_alloc( stream );
+  key_stats->count = int_vector_fread_alloc( stream );
+  for (int stat = 0; stat < ENSEMBLE_STAT_COUNT; stat++)
+    key_stats->stats[stat] = double_vector_fread_alloc( stream );
+  return key_stats;
+}
+
+
+/*
+  Computes the statistics for one key from the ens_size x num_steps
+  data and active matrices of an enkf_plot_batch.
+*/
+
+static key_stats_type * key_stats_alloc_from_batch( const enkf_plot_batch_type * batch , int key_index , const int_vector_type * realizations ) {
+  int num_steps = enkf_plot_batch_get_num_steps( batch );
+  const double * data = enkf_plot_batch_iget_data( batch , key_index );
+  const bool * active = enkf_plot_batch_iget_active( batch , key_index );
+  key_stats_type * key_stats = key_stats_alloc( realizations , num_steps );
+  double_vector_type * values = double_vector_alloc( 0 , 0 );
+
+  for (int step = 0; step < num_steps; step++) {
+    double_vector_reset( values );
+    for (int i = 0; i < int_vector_size( realizations ); i++) {
+      size_t index = (size_t) int_vector_iget( realizations , i ) * num_steps + step;
+      if (active[index])
+        double_vector_append( values , data[index] );
+    }
+
+    if (double_vector_size( values ) > 0) {
+      double_vector_sort( values );
+      int_vector_iset( key_stats->count , step , double_vector_size( values ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_MEAN] , step , statistics_mean( values ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_STD]  , step , statistics_std( values ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_MIN]  , step , double_vector_get_first( values ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_MAX]  , step , double_vector_get_last( values ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_P10]  , step , statistics_empirical_quantile__( values , 0.10 ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_P50]  , step , statistics_empirical_quantile__( values , 0.50 ));
+      double_vector_iset( key_stats->stats[ENSEMBLE_STAT_P90]  , step , statistics_empirical_quantile__( values , 0.90 ));
+    }
+  }
+
+  double_vector_free( values );
+  return key_stats;
+}
+
+
+/*****************************************************************/
+
+
+UTIL_IS_INSTANCE_FUNCTION( ensemble_stats , ENSEMBLE_STATS_TYPE_ID )
+
+
+ensemble_stats_type * ensemble_stats_alloc( ) {
+  ensemble_stats_type * ensemble_stats = (ensemble_stats_type *)util_malloc( sizeof * ensemble_stats );
+  UTIL_TYPE_ID_INIT( ensemble_stats , ENSEMBLE_STATS_TYPE_ID );
+  pthread_mutex_init( &ensemble_stats->mutex , NULL );
+  ensemble_stats->nodes = hash_alloc( );
+  ensemble_stats->generation = 0;
+  ensemble_stats->dirty = false;
+  return ensemble_stats;
+}
+
+
+void ensemble_stats_free( ensemble_stats_type * ensemble_stats ) {
+  hash_free( ensemble_stats->nodes );
+  pthread_mutex_destroy( &ensemble_stats->mutex );
+  free( ensemble_stats );
+}
+
+
+static const char * ensemble_stats_index_key( const char * index_key ) {
+  return index_key ? index_key : "";
+}
+
+
+static key_stats_type * ensemble_stats_get_key_stats__( const ensemble_stats_type * ensemble_stats , const char * node_key , const char * index_key ) {
+  hash_type * index_hash = (hash_type *) hash_safe_get( ensemble_stats->nodes , node_key );
+  if (index_hash)
+    return (key_stats_type *) hash_safe_get( index_hash , ensemble_stats_index_key( index_key ));
+
+  return NULL;
+}
+
+
+static void ensemble_stats_insert__( ensemble_stats_type * ensemble_stats , const char * node_key , const char * index_key , key_stats_type * key_stats ) {
+  if (!hash_has_key( ensemble_stats->nodes , node_key ))
+    hash_insert_hash_owned_ref( ensemble_stats->nodes , node_key , hash_alloc( ) , hash_free__ );
+  {
+    hash_type * index_hash = (hash_type *) hash_get( ensemble_stats->nodes , node_key );
+    hash_insert_hash_owned_ref( index_hash , ensemble_stats_index_key( index_key ) , key_stats , key_stats_free__ );
+  }
+  ensemble_stats->dirty = true;
+}
+
+
+static void ensemble_stats_invalidate__( ensemble_stats_type * ensemble_stats , const char * node_key ) {
+  if (hash_has_key( ensemble_stats->nodes , node_key )) {
+    hash_del( ensemble_stats->nodes , node_key );
+    ensemble_stats->dirty = true;
+  }
+  ensemble_stats->generation++;
+}
+
+
+void ensemble_stats_clear( ensemble_stats_type * ensemble_stats ) {
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  if (hash_get_size( ensemble_stats->nodes ) > 0) {
+    hash_clear( ensemble_stats->nodes );
+    ensemble_stats->dirty = true;
+  }
+  ensemble_stats->generation++;
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+}
+
+
+void ensemble_stats_invalidate( ensemble_stats_type * ensemble_stats , const char * node_key ) {
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  ensemble_stats_invalidate__( ensemble_stats , node_key );
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+}
+
+
+void ensemble_stats_invalidate_keys( ensemble_stats_type * ensemble_stats , const stringlist_type * node_keys ) {
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  for (int i = 0; i < stringlist_get_size( node_keys ); i++)
+    ensemble_stats_invalidate__( ensemble_stats , stringlist_iget( node_keys , i ));
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+}
+
+
+int ensemble_stats_get_size( const ensemble_stats_type * ensemble_stats ) {
+  int size = 0;
+  pthread_mutex_lock( (pthread_mutex_t *) &ensemble_stats->mutex );
+  {
+    hash_iter_type * iter = hash_iter_alloc( ensemble_stats->nodes );
+    while (!hash_iter_is_complete( iter )) {
+      const hash_type * index_hash = (const hash_type *) hash_iter_get_next_value( iter );
+      size += hash_get_size( index_hash );
+    }
+    hash_iter_free( iter );
+  }
+  pthread_mutex_unlock( (pthread_mutex_t *) &ensemble_stats->mutex );
+  return size;
+}
+
+
+bool ensemble_stats_is_dirty( const ensemble_stats_type * ensemble_stats ) {
+  return ensemble_stats->dirty;
+}
+
+
+void ensemble_stats_fwrite( ensemble_stats_type * ensemble_stats , FILE * stream ) {
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  {
+    stringlist_type * node_keys = hash_alloc_stringlist( ensemble_stats->nodes );
+    util_fwrite_int( stringlist_get_size( node_keys ) , stream );
+    for (int i = 0; i < stringlist_get_size( node_keys ); i++) {
+      const char * node_key = stringlist_iget( node_keys , i );
+      const hash_type * index_hash = (const hash_type *) hash_get( ensemble_stats->nodes , node_key );
+      stringlist_type * index_keys = hash_alloc_stringlist( index_hash );
+
+      util_fwrite_string( node_key , stream );
+      util_fwrite_int( stringlist_get_size( index_keys ) , stream );
+      for (int j = 0; j < stringlist_get_size( index_keys ); j++) {
+        const char * index_key = stringlist_iget( index_keys , j );
+        util_fwrite_string( index_key , stream );
+        key_stats_fwrite( (const key_stats_type *) hash_get( index_hash , index_key ) , stream );
+      }
+      stringlist_free( index_keys );
+    }
+    stringlist_free( node_keys );
+    ensemble_stats->dirty = false;
+  }
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+}
+
+
+void ensemble_stats_fread( ensemble_stats_type * ensemble_stats , FILE * stream ) {
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  hash_clear( ensemble_stats->nodes );
+  {
+    int num_nodes = util_fread_int( stream );
+    for (int i = 0; i < num_nodes; i++) {
+      char * node_key = util_fread_alloc_string( stream );
+      int num_index = util_fread_int( stream );
+
+      for (int j = 0; j < num_index; j++) {
+        char * index_key = util_fread_alloc_string( stream );
+        ensemble_stats_insert__( ensemble_stats , node_key , index_key , key_stats_fread_alloc( stream ));
+        free( index_key );
+      }
+      free( node_key );
+    }
+  }
+  ensemble_stats->dirty = false;
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+}
+
+
+/*
+  The realizations the statistics are based on: all realizations with
+  data according to the state map. This is the same selection as
+  enkf_plot_batch_load() uses when called without a mask.
+*/
+
+static int_vector_type * ensemble_stats_alloc_realizations( enkf_fs_type * fs ) {
+  state_map_type * state_map = enkf_fs_get_state_map( fs );
+  int ens_size = state_map_get_size( state_map );
+  bool_vector_type * mask = bool_vector_alloc( ens_size , false );
+  int_vector_type * realizations = int_vector_alloc( 0 , 0 );
+
+  state_map_select_matching( state_map , mask , STATE_HAS_DATA );
+  for (int iens = 0; iens < ens_size; iens++) {
+    if (bool_vector_iget( mask , iens ))
+      int_vector_append( realizations , iens );
+  }
+
+  bool_vector_free( mask );
+  return realizations;
+}
+
+
+/*
+  Computes the statistics for all the keys in @config_nodes /
+  @index_keys which are not already in the cache, or where the cached
+  value is stale. The computed statistics are returned in the vector
+  @result, with NULL for keys which were already current; they are
+  added to the cache unless an invalidation took place while they were
+  computed. With @force == true all the keys are computed, and @result
+  never contains NULL.
+*/
+
+static void ensemble_stats_update__( ensemble_stats_type * ensemble_stats ,
+                                     enkf_fs_type * fs ,
+                                     const vector_type * config_nodes ,
+                                     const stringlist_type * index_keys ,
+                                     bool force ,
+                                     vector_type * result ) {
+  int num_keys = vector_get_size( config_nodes );
+  int_vector_type * realizations = ensemble_stats_alloc_realizations( fs );
+  int num_steps = time_map_get_size( enkf_fs_get_time_map( fs ));
+  int_vector_type * batch_index = int_vector_alloc( num_keys , -1 );
+  enkf_plot_batch_type * batch = enkf_plot_batch_alloc( );
+  long generation;
+
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  generation = ensemble_stats->generation;
+  for (int i = 0; i < num_keys; i++) {
+    const enkf_config_node_type * config_node = (const enkf_config_node_type *) vector_iget_const( config_nodes , i );
+    const char * index_key = index_keys ? stringlist_iget( index_keys , i ) : NULL;
+    const key_stats_type * key_stats = ensemble_stats_get_key_stats__( ensemble_stats , enkf_config_node_get_key( config_node ) , index_key );
+
+    if (force || !key_stats || !key_stats_is_current( key_stats , realizations , num_steps ))
+      int_vector_iset( batch_index , i , enkf_plot_batch_add_key( batch , config_node , index_key ));
+  }
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+
+  vector_clear( result );
+  if (enkf_plot_batch_get_num_keys( batch ) > 0)
+    enkf_plot_batch_load( batch , fs , NULL );
+
+  for (int i = 0; i < num_keys; i++) {
+    if (int_vector_iget( batch_index , i ) >= 0) {
+      key_stats_type * key_stats = key_stats_alloc_from_batch( batch , int_vector_iget( batch_index , i ) , realizations );
+      vector_append_owned_ref( result , key_stats , key_stats_free__ );
+    } else
+      vector_append_ref( result , NULL );
+  }
+
+  pthread_mutex_lock( &ensemble_stats->mutex );
+  if (ensemble_stats->generation == generation) {
+    for (int i = 0; i < num_keys; i++) {
+      const key_stats_type * key_stats = (const key_stats_type *) vector_iget_const( result , i );
+      if (key_stats) {
+        const enkf_config_node_type * config_node = (const enkf_config_node_type *) vector_iget_const( config_nodes , i );
+        const char * index_key = index_keys ? stringlist_iget( index_keys , i ) : NULL;
+        ensemble_stats_insert__( ensemble_stats , enkf_config_node_get_key( config_node ) , index_key , key_stats_alloc_copy( key_stats ));
+      }
+    }
+  }
+  pthread_mutex_unlock( &ensemble_stats->mutex );
+
+  enkf_plot_batch_free( batch );
+  int_vector_free( batch_index );
+  int_vector_free( realizations );
+}
+
+
+/*
+  Precomputes the statistics for many keys with one load of the
+  ensemble. @index_keys can be NULL, otherwise it must have one element
+  for each element in @config_nodes.
+*/
+
+void ensemble_stats_update( ensemble_stats_type * ensemble_stats ,
+                            enkf_fs_type * fs ,
+                            const vector_type * config_nodes ,
+                            const stringlist_type * index_keys ) {
+  vector_type * result = vector_alloc_new( );
+
+  if (index_keys && (stringlist_get_size( index_keys ) != vector_get_size( config_nodes )))
+    util_abort("%s: size mismatch between config nodes and index keys.\n",__func__);
+
+  ensemble_stats_update__( ensemble_stats , fs , config_nodes , index_keys , false , result );
+  vector_free( result );
+}
+
+
+/*
+  Returns a copy of the statistics for one key, which the caller must
+  free with key_stats_free().
+*/
+
+key_stats_type * ensemble_stats_alloc_key_stats( ensemble_stats_type * ensemble_stats ,
+                                                 enkf_fs_type * fs ,
+                                                 const enkf_config_node_type * config_node ,
+                                                 const char * index_key ) {
+  key_stats_type * key_stats = NULL;
+  {
+    int_vector_type * realizations = ensemble_stats_alloc_realizations( fs );
+    int num_steps = time_map_get_size( enkf_fs_get_time_map( fs ));
+
+    pthread_mutex_lock( &ensemble_stats->mutex );
+    {
+      const key_stats_type * cached = ensemble_stats_get_key_stats__( ensemble_stats , enkf_config_node_get_key( config_node ) , index_key );
+      if (cached && key_stats_is_current( cached , realizations , num_steps ))
+        key_stats = key_stats_alloc_copy( cached );
+    }
+    pthread_mutex_unlock( &ensemble_stats->mutex );
+    int_vector_free( realizations );
+  }
+
+  if (!key_stats) {
+    vector_type * config_nodes = vector_alloc_new( );
+    stringlist_type * index_keys = stringlist_alloc_new( );
+    vector_type * result = vector_alloc_new( );
+
+    vector_append_ref( config_nodes , config_node );
+    stringlist_append_copy( index_keys , index_key );
+    /*
+      The cache lookup above and the update are not atomic; another
+      thread may have refreshed the key in between. The update is
+      therefore forced, so that it always returns the statistics
+      instead of NULL, and no second lookup is needed.
+    */
+    ensemble_stats_update__( ensemble_stats , fs , config_nodes , index_keys , true , result );
+    key_stats = key_stats_alloc_copy( (const key_stats_type *) vector_iget_const( result , 0 ));
+
+    vector_free( result );
+    stringlist_free( index_keys );
+    vector_free( config_nodes );
+  }
+
+  return key_stats;
+}
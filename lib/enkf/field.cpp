@@ -123,16 +123,10 @@ void field_export3D(const field_type * field ,
   ecl_data_type data_type = field_config_get_ecl_data_type( config );
   int   sizeof_ctype_target = ecl_type_get_sizeof_ctype(target_data_type);
 
-  field_type * initial_field               = NULL;
-  field_config_type * initial_field_config = NULL;
-  if (init_file) {
-    ecl_grid_type * grid        = field_config_get_grid(config);
-    bool global_size            = true;
-    initial_field_config        = field_config_alloc_empty(field_config_get_key(config), grid, NULL, global_size);
-    initial_field               = field_alloc(initial_field_config);
+  const field_type * initial_field = NULL;
+  if (init_file)
+    initial_field = field_config_get_init_baseline(config, init_file);
 
-    field_fload_keep_inactive(initial_field, init_file);
-  }
   switch(ecl_type_get_type(data_type)) {
   case(ECL_DOUBLE_TYPE):
     {
@@ -190,11 +184,6 @@ void field_export3D(const field_type * field ,
     fprintf(stderr,"%s: Sorry field has unexportable type ... \n",__func__);
     break;
   }
-
-  if (initial_field) {
-    field_config_free(initial_field_config);
-    field_free(initial_field);
-  }
 }
 #undef EXPORT_MACRO
 
@@ -597,63 +586,111 @@ static void field_apply(field_type * field , field_func_type * func) {
 }
 
 
-static bool field_check_finite( const field_type * field) {
+
+/*
+  The truncation mode is tested once per block of data, and not for
+  every element; the two loops are kept separate (and not combined
+  into one min/max) to get the same result as before when min > max.
+*/
+
+#define TRUNCATE_MACRO(s , d , t , min , max)  \
+{                                              \
+  if ( t & TRUNCATE_MIN )                      \
+    for (int i=0; i < s; i++)                  \
+      d[i] = (d[i] < min) ? min : d[i];        \
+  if ( t & TRUNCATE_MAX )                      \
+    for (int i=0; i < s; i++)                  \
+      d[i] = (d[i] > max) ? max : d[i];        \
+}
+
+
+#define FINITE_MACRO(s , d , ok)               \
+{                                              \
+  int not_finite = 0;                          \
+  for (int i=0; i < s; i++)                    \
+    not_finite |= !std::isfinite( d[i] );      \
+  if (not_finite)                              \
+    ok = false;                                \
+}
+
+
+#define FIELD_TRANSFORM_BLOCK_SIZE 4096
+
+
+/*
+  Applies the transform function, the truncation and the check for
+  finite values in one pass over the data. The data is processed in
+  blocks which are small enough to stay in the cache between the
+  three steps. For float data the vector version vfunc of the
+  transform is used when it is available; func and vfunc can both
+  be NULL for no transform.
+
+  Returns false if the data contains inf or nan after the transform
+  and truncation.
+*/
+
+static bool field_transform_truncate(field_type * field , field_func_type * func , field_vfunc_type * vfunc , int truncation , double min_value , double max_value) {
   const int data_size           = field_config_get_data_size( field->config );
   const ecl_data_type data_type = field_config_get_ecl_data_type(field->config);
-  bool  ok = true;
+  bool ok = true;
+
+  if (func != NULL)
+    field_config_assert_unary(field->config , __func__);
 
   if (ecl_type_is_float(data_type)) {
-    float * data = (float *) field->data;
-    for (int i=0; i < data_size; i++)
-      if (!std::isfinite( data[i] ))
-        ok = false;
+    const float fmin = min_value;
+    const float fmax = max_value;
+    for (int offset = 0; offset < data_size; offset += FIELD_TRANSFORM_BLOCK_SIZE) {
+      const int size = util_int_min( FIELD_TRANSFORM_BLOCK_SIZE , data_size - offset );
+      float * data = ((float *) field->data) + offset;
+
+      if (vfunc != NULL)
+        vfunc( data , size );
+      else if (func != NULL) {
+        for (int i=0; i < size; i++)
+          data[i] = func(data[i]);
+      }
+
+      TRUNCATE_MACRO(size , data , truncation , fmin , fmax);
+      FINITE_MACRO(size , data , ok);
+    }
   } else if (ecl_type_is_double(data_type)) {
-    double * data = (double *) field->data;
-    for (int i=0; i < data_size; i++)
-      if (!std::isfinite( data[i] ))
-        ok = false;
-  }
-  return ok;
-}
+    for (int offset = 0; offset < data_size; offset += FIELD_TRANSFORM_BLOCK_SIZE) {
+      const int size = util_int_min( FIELD_TRANSFORM_BLOCK_SIZE , data_size - offset );
+      double * data = ((double *) field->data) + offset;
 
+      if (func != NULL) {
+        for (int i=0; i < size; i++)
+          data[i] = func(data[i]);
+      }
 
+      TRUNCATE_MACRO(size , data , truncation , min_value , max_value);
+      FINITE_MACRO(size , data , ok);
+    }
+  } else
+    util_abort("%s: Field type not supported for transform and truncation \n",__func__);
 
-void  field_inplace_output_transform(field_type * field ) {
-  field_func_type * output_transform = field_config_get_output_transform(field->config);
-  if (output_transform != NULL)
-    field_apply(field , output_transform);
+  return ok;
 }
 
+#undef FIELD_TRANSFORM_BLOCK_SIZE
+#undef FINITE_MACRO
+#undef TRUNCATE_MACRO
 
 
-#define TRUNCATE_MACRO(s , d , t , min , max)  \
-for (int i=0; i < s; i++) {                    \
-  if ( t & TRUNCATE_MIN )                      \
-    if (d[i] < min)                            \
-      d[i] = min;                              \
-  if ( t & TRUNCATE_MAX )                      \
-    if (d[i] > max)                            \
-      d[i] = max;                              \
-}
-
 
-static void field_apply_truncation(field_type * field) {
-  int truncation = field_config_get_truncation_mode( field->config );
-  if (truncation != TRUNCATE_NONE) {
-    double min_value = field_config_get_truncation_min( field->config );
-    double max_value = field_config_get_truncation_max( field->config );
+/*
+  The output transform is applied with the scalar (libm) version of
+  the function, and not the vector version used for the init
+  transform; the exported values are then bit for bit the same as
+  before the vector versions were introduced, whereas the vector
+  versions can differ from libm in the last few bits.
+*/
 
-    const int data_size           = field_config_get_data_size(field->config );
-    const ecl_data_type data_type = field_config_get_ecl_data_type(field->config);
-    if (ecl_type_is_float(data_type)) {
-      float * data = (float *) field->data;
-      TRUNCATE_MACRO(data_size , data , truncation , min_value , max_value);
-    } else if (ecl_type_is_double(data_type)) {
-      double * data = (double *) field->data;
-      TRUNCATE_MACRO(data_size , data , truncation , min_value , max_value);
-    } else
-      util_abort("%s: Field type not supported for truncation \n",__func__);
-  }
+void  field_inplace_output_transform(field_type * field ) {
+  field_func_type * output_transform = field_config_get_output_transform(field->config);
+  if (output_transform != NULL)
+    field_transform_truncate(field , output_transform , NULL , TRUNCATE_NONE , 0 , 0);
 }
 
 
@@ -669,10 +706,12 @@ static void field_output_transform(field_type * field) {
     field->__data = field->data;  /* Storing a pointer to the original data. */
     field->data   = field->export_data;
 
-    if (output_transform != NULL)
-      field_inplace_output_transform(field);
-
-    field_apply_truncation(field);
+    field_transform_truncate(field ,
+                             output_transform ,
+                             NULL ,
+                             truncation ,
+                             field_config_get_truncation_min( field->config ) ,
+                             field_config_get_truncation_max( field->config ));
   }
 }
 
@@ -788,8 +827,8 @@ bool field_initialize(field_type *field , int iens , const char * init_file , rn
          prior to export.
       */
       if (init_transform) {
-        field_apply(field , init_transform);
-        if (!field_check_finite( field ))
+        field_vfunc_type * init_vtransform = field_config_get_init_vtransform(field->config);
+        if (!field_transform_truncate( field , init_transform , init_vtransform , TRUNCATE_NONE , 0 , 0 ))
           util_exit("Sorry: after applying the init transform field:%s contains nan/inf or similar malformed values.\n" , field_config_get_key( field->config ));
       }
       ret = true;
@@ -18,10 +18,13 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #include <cmath>
 
 #include <ert/util/util.h>
 #include <ert/util/string_util.h>
+#include <ert/util/vector.h>
 
 #include <ert/ecl/ecl_grid.h>
 #include <ert/ecl/ecl_kw.h>
@@ -37,6 +40,7 @@
 #include <ert/enkf/enkf_macros.hpp>
 #include <ert/enkf/field_trans.hpp>
 #include <ert/enkf/field_common.hpp>
+#include <ert/enkf/field.hpp>
 #include <ert/enkf/config_keys.hpp>
 #include <ert/enkf/enkf_defaults.hpp>
 
@@ -124,6 +128,19 @@ _______________/                     \___________/       |  with EnKF.
 
 #define FIELD_CONFIG_ID 78269
 
+/*
+  The field loaded from an init_file, with the name and the
+  modification time of the file it was loaded from.
+*/
+
+typedef struct {
+  char              * filename;
+  time_t              mtime;
+  field_config_type * config;
+  field_type        * field;
+} field_init_baseline_type;
+
+
 struct field_config_struct {
   UTIL_TYPE_ID_DECLARATION;
 
@@ -150,10 +167,15 @@ struct field_config_struct {
   field_func_type         * output_transform;     /* Function to apply to the data before they are exported - NULL: no transform. */
   field_func_type         * init_transform;       /* Function to apply on the data when they are loaded the first time - i.e. initialized. NULL : no transform*/
   field_func_type         * input_transform;      /* Function to apply on the data when they are loaded from the forward model - i.e. for dynamic data. */
+  field_vfunc_type        * init_vtransform;      /* Vector version of init_transform, used on float data - NULL: use the scalar function. */
 
   char * output_transform_name;
   char * init_transform_name;
   char * input_transform_name;
+
+  pthread_mutex_t           init_baseline_lock;
+  field_init_baseline_type * init_baseline;        /* The field loaded from the init_file when exporting, see field_config_get_init_baseline(). */
+  vector_type             * retired_baselines;    /* Baselines which have been replaced; they can still be in use. */
 };
 
 
@@ -338,6 +360,7 @@ field_config_type * field_config_alloc_empty( const char * ecl_kw_name , ecl_gri
   config->output_transform      = NULL;
   config->input_transform       = NULL;
   config->init_transform        = NULL;
+  config->init_vtransform       = NULL;
   config->output_transform_name = NULL;
   config->input_transform_name  = NULL;
   config->init_transform_name   = NULL;
@@ -346,6 +369,10 @@ field_config_type * field_config_alloc_empty( const char * ecl_kw_name , ecl_gri
   config->min_std          = NULL;
   config->trans_table      = trans_table;
 
+  pthread_mutex_init( &config->init_baseline_lock , NULL );
+  config->init_baseline     = NULL;
+  config->retired_baselines = vector_alloc_new();
+
   field_config_set_grid(config , ecl_grid , false);       /* The grid is (currently) set on allocation and can NOT be updated afterwards. */
   field_config_set_ecl_data_type( config , ECL_FLOAT );   /* This is the internal type - currently not exported any API to change it. */
   return config;
@@ -365,10 +392,13 @@ static void field_config_set_init_transform( field_config_type * config , const
   }
 
   config->init_transform_name = util_realloc_string_copy( config->init_transform_name , init_transform_name );
-  if (init_transform_name != NULL)
-    config->init_transform = field_trans_table_lookup( config->trans_table , init_transform_name);
-  else
-    config->init_transform = NULL;
+  if (init_transform_name != NULL) {
+    config->init_transform  = field_trans_table_lookup( config->trans_table , init_transform_name);
+    config->init_vtransform = field_trans_table_lookup_vector( config->trans_table , init_transform_name);
+  } else {
+    config->init_transform  = NULL;
+    config->init_vtransform = NULL;
+  }
 }
 
 
@@ -553,7 +583,73 @@ double field_config_get_truncation_max( const field_config_type * config ) {
 
 
 
+static field_init_baseline_type * field_init_baseline_alloc( const field_config_type * config , const char * init_file , time_t mtime) {
+  field_init_baseline_type * baseline = (field_init_baseline_type *)util_malloc( sizeof * baseline );
+  bool global_size = true;
+
+  baseline->filename = util_alloc_string_copy( init_file );
+  baseline->mtime    = mtime;
+  baseline->config   = field_config_alloc_empty( config->ecl_kw_name , config->grid , NULL , global_size );
+  baseline->field    = field_alloc( baseline->config );
+  field_fload_keep_inactive( baseline->field , init_file );
+  return baseline;
+}
+
+
+static void field_init_baseline_free( field_init_baseline_type * baseline ) {
+  field_free( baseline->field );
+  field_config_free( baseline->config );
+  free( baseline->filename );
+  free( baseline );
+}
+
+
+static void field_init_baseline_free__( void * arg ) {
+  field_init_baseline_free( (field_init_baseline_type *) arg );
+}
+
+
+/*
+  When a field is exported with an init_file, the values for the
+  inactive cells are taken from the init_file, see field_export3D().
+  The field loaded from the init_file is cached here, so that the
+  file is only read once and not once for every realization; the
+  cache is invalidated if the name or the modification time of the
+  file changes.
+
+  The returned field is shared, and must be treated as read only. It
+  stays valid until the field_config is freed; when the cache is
+  invalidated the old field is kept, since it can still be in use by
+  other threads.
+*/
+
+const field_type * field_config_get_init_baseline( const field_config_type * config , const char * init_file ) {
+  field_config_type * cache_config = (field_config_type *) config;   /* The cache does not change the logical state of the config. */
+  time_t mtime = util_file_mtime( init_file );
+  const field_type * field;
+
+  pthread_mutex_lock( &cache_config->init_baseline_lock );
+  {
+    field_init_baseline_type * baseline = cache_config->init_baseline;
+    if ((baseline == NULL) || !util_string_equal( baseline->filename , init_file ) || (baseline->mtime != mtime)) {
+      if (baseline != NULL)
+        vector_append_owned_ref( cache_config->retired_baselines , baseline , field_init_baseline_free__ );
+
+      cache_config->init_baseline = field_init_baseline_alloc( cache_config , init_file , mtime );
+    }
+    field = cache_config->init_baseline->field;
+  }
+  pthread_mutex_unlock( &cache_config->init_baseline_lock );
+  return field;
+}
+
+
 void field_config_free(field_config_type * config) {
+  if (config->init_baseline)
+    field_init_baseline_free( config->init_baseline );
+  vector_free( config->retired_baselines );
+  pthread_mutex_destroy( &config->init_baseline_lock );
+
   free(config->ecl_kw_name);
   free(config->input_transform_name);
   free(config->output_transform_name);
@@ -686,6 +782,11 @@ field_func_type * field_config_get_init_transform(const field_config_type * conf
 }
 
 
+field_vfunc_type * field_config_get_init_vtransform(const field_config_type * config) {
+  return config->init_vtransform;
+}
+
+
 /*
   This function asserts that a unary function can be applied
   to the field - i.e. that the underlying data_type is ecl_float or ecl_double.
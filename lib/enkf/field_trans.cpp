@@ -27,9 +27,26 @@
 
   Documentation on how to add a new transformation function is at the
   bottom of the file.
+
+  In addition to the scalar function a transformation can have a
+  vector version "float array in - float array out", which is used
+  when the full field is transformed with the init transform. The
+  vector versions of the standard transformations are written as
+  simple branch free loops which the compiler can vectorize, instead
+  of calling the libm function through a function pointer for every
+  cell.
+
+  The vector versions are not bit identical to libm: the relative
+  difference is at most 4 * FLT_EPSILON (a few ulp), results below
+  FLT_MIN can differ by up to FLT_MIN, and inf, nan and zero are
+  reproduced exactly. This is tested in enkf_field_trans. The output
+  transform, i.e. the values which are exported, always uses the
+  scalar libm version.
 */
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <float.h>
 #include <cmath>
 
 #include <ert/util/hash.h>
@@ -49,16 +66,18 @@ typedef struct {
   char            * key;
   char            * description;
   field_func_type * func;
+  field_vfunc_type * vfunc;     /* Vector version of func - can be NULL. */
 } field_func_node_type;
 
 /*****************************************************************/
 
-static field_func_node_type * field_func_node_alloc(const char * key , const char * description , field_func_type * func) {
+static field_func_node_type * field_func_node_alloc(const char * key , const char * description , field_func_type * func , field_vfunc_type * vfunc) {
   field_func_node_type * node = (field_func_node_type *)util_malloc( sizeof * node );
 
   node->key         = util_alloc_string_copy( key );
   node->description = util_alloc_string_copy( description );
   node->func        = func;
+  node->vfunc       = vfunc;
 
   return node;
 }
@@ -90,7 +109,7 @@ static void field_func_node_fprintf(const field_func_node_type * node , FILE * s
 
 /*****************************************************************/
 
-void field_trans_table_add(field_trans_table_type * table , const char * _key , const char * description , field_func_type * func) {
+void field_trans_table_add_vector(field_trans_table_type * table , const char * _key , const char * description , field_func_type * func , field_vfunc_type * vfunc) {
   char * key;
 
   if (table->case_sensitive)
@@ -99,13 +118,18 @@ void field_trans_table_add(field_trans_table_type * table , const char * _key ,
     key = util_alloc_strupr_copy( _key );
 
   {
-    field_func_node_type * node = field_func_node_alloc( key , description , func );
+    field_func_node_type * node = field_func_node_alloc( key , description , func , vfunc );
     hash_insert_hash_owned_ref(table->function_table , key , node , field_func_node_free__);
   }
   free(key);
 }
 
 
+void field_trans_table_add(field_trans_table_type * table , const char * key , const char * description , field_func_type * func) {
+  field_trans_table_add_vector( table , key , description , func , NULL );
+}
+
+
 void field_trans_table_fprintf(const field_trans_table_type * table , FILE * stream) {
   hash_iter_type * iter = hash_iter_alloc(table->function_table);
   const char * key = hash_iter_get_next_key(iter);
@@ -129,8 +153,8 @@ void field_trans_table_fprintf(const field_trans_table_type * table , FILE * str
 */
 
 
-field_func_type * field_trans_table_lookup(field_trans_table_type * table , const char * _key) {
-  field_func_type * func;
+static const field_func_node_type * field_trans_table_get_node(field_trans_table_type * table , const char * _key) {
+  const field_func_node_type * func_node;
   char * key;
 
   if (table->case_sensitive)
@@ -138,17 +162,32 @@ field_func_type * field_trans_table_lookup(field_trans_table_type * table , cons
   else
     key = util_alloc_strupr_copy(_key);
 
-  if (hash_has_key(table->function_table , key)) {
-    field_func_node_type * func_node = (field_func_node_type *)hash_get(table->function_table , key);
-    func = func_node->func;
-  } else {
+  if (hash_has_key(table->function_table , key))
+    func_node = (const field_func_node_type *)hash_get(table->function_table , key);
+  else {
     fprintf(stderr , "Sorry: the field transformation function:%s is not recognized \n\n",key);
     field_trans_table_fprintf(table , stderr);
     util_exit("Exiting ... \n");
-    func = NULL; /* Compiler shut up. */
+    func_node = NULL; /* Compiler shut up. */
   }
   free( key );
-  return func;
+  return func_node;
+}
+
+
+field_func_type * field_trans_table_lookup(field_trans_table_type * table , const char * key) {
+  return field_trans_table_get_node( table , key )->func;
+}
+
+
+/*
+  Will return the vector version of the function, or NULL if the
+  function has no vector version; the function will fail if the key
+  is not recognized.
+*/
+
+field_vfunc_type * field_trans_table_lookup_vector(field_trans_table_type * table , const char * key) {
+  return field_trans_table_get_node( table , key )->vfunc;
 }
 
 
@@ -188,6 +227,10 @@ void field_trans_table_free(field_trans_table_type * table ) {
 /*  1. Write the function - as a float in - float out.           */
 /*  2. Register the function in field_trans_table_alloc().       */
 /*                                                               */
+/*  Optionally a vector version can be created with the          */
+/*  FIELD_TRANS_VECTOR() macro and registered with               */
+/*  field_trans_table_add_vector().                              */
+/*                                                               */
 /*****************************************************************/
 
 /*****************************************************************/
@@ -238,6 +281,145 @@ static float denormalize_poro(float x) {
 /*****************************************************************/
 
 
+/*
+  Creates a vector version of the scalar function func; the scalar
+  function should be static inline and free of branches for the
+  loop to be vectorized.
+*/
+
+#define FIELD_TRANS_VECTOR(name , func)         \
+static void name(float * data , int size) {     \
+  for (int i=0; i < size; i++)                  \
+    data[i] = func( data[i] );                  \
+}
+
+
+static inline float field_trans_bits_to_float( int32_t bits ) {
+  float x;
+  memcpy( &x , &bits , sizeof x );
+  return x;
+}
+
+
+static inline int32_t field_trans_float_to_bits( float x ) {
+  int32_t bits;
+  memcpy( &bits , &x , sizeof bits );
+  return bits;
+}
+
+
+/*
+  Branch free select: returns a if cond is true and b otherwise. The
+  selection is done on the bit patterns, because with the default
+  -ftrapping-math the compiler will not vectorize a loop where a
+  floating point operation is only evaluated for some of the
+  elements, which is what ?: between floats often ends up as.
+*/
+
+static inline float field_trans_select( bool cond , float a , float b ) {
+  int32_t mask = -((int32_t) cond);
+  return field_trans_bits_to_float( (field_trans_float_to_bits( a ) & mask) | (field_trans_float_to_bits( b ) & ~mask) );
+}
+
+
+/*
+  exp(scale * x) for the vector transformations. The argument is
+  reduced in double precision as scale * x = n * ln(2) + r, so that
+  e.g. 10^x is computed with the same accuracy as exp(x), and exp(r)
+  is approximated with the Cephes polynomial. The result is scaled
+  with 2^n as the product of two powers of two, so that overflow
+  to inf and gradual underflow to zero come out as from expf().
+*/
+
+static inline float field_trans_vexp__( float x , double scale ) {
+  const float min_x = (float) (-104.0 / scale);    /* exp(-104) underflows to zero. */
+  const float max_x = (float) (  89.0 / scale);    /* exp(89) overflows to inf.     */
+  bool  is_nan = (x != x);
+  float xc     = field_trans_select( is_nan , 0.0f , x );
+  xc = field_trans_select( xc < min_x , min_x , xc );
+  xc = field_trans_select( xc > max_x , max_x , xc );
+  {
+    double xd = xc * scale;
+    {
+      double fn = xd * M_LOG2E;
+      int n     = (int) (fn + 1000.5) - 1000;     /* Round to nearest; fn is in [-151 , 129]. */
+      float r   = (float) (xd - n * M_LN2);
+      float p   = 1.9875691500E-4f;
+      float y;
+      p = p * r + 1.3981999507E-3f;
+      p = p * r + 8.3334519073E-3f;
+      p = p * r + 4.1665795894E-2f;
+      p = p * r + 1.6666665459E-1f;
+      p = p * r + 5.0000001201E-1f;
+      y = p * r * r + r + 1.0f;
+      {
+        int n1 = n / 2;
+        int n2 = n - n1;
+        y *= field_trans_bits_to_float( (n1 + 127) << 23 );
+        y *= field_trans_bits_to_float( (n2 + 127) << 23 );
+      }
+      return field_trans_select( is_nan , x , y );
+    }
+  }
+}
+
+
+/*
+  scale * ln(x) for the vector transformations; the mantissa is
+  approximated with the Cephes polynomial and the result is summed
+  up in double precision. Returns -inf for 0, NaN for negative
+  input, and inf for inf.
+*/
+
+static inline float field_trans_vlog__( float x , double scale ) {
+  bool    denormal = (x < FLT_MIN);
+  float   xs       = x * field_trans_select( denormal , 8388608.0f , 1.0f );      /* 2^23 */
+  int32_t bits     = field_trans_float_to_bits( xs );
+  int     e        = ((bits >> 23) & 0xff) - 126 - (denormal ? 23 : 0);
+  float   m        = field_trans_bits_to_float( (bits & 0x007fffff) | 0x3f000000 );   /* m in [0.5 , 1) */
+  float   r;
+
+  {
+    bool small = (m < 0.707106781186547524f);
+    e -= small ? 1 : 0;
+    m  = m * field_trans_select( small , 2.0f , 1.0f ) - 1.0f;
+  }
+
+  {
+    float z = m * m;
+    float y = 7.0376836292E-2f;
+    y = y * m - 1.1514610310E-1f;
+    y = y * m + 1.1676998740E-1f;
+    y = y * m - 1.2420140846E-1f;
+    y = y * m + 1.4249322787E-1f;
+    y = y * m - 1.6668057665E-1f;
+    y = y * m + 2.0000714765E-1f;
+    y = y * m - 2.4999993993E-1f;
+    y = y * m + 3.3333331174E-1f;
+    y = y * m * z - 0.5f * z;
+    r = (float) (((double) m + (double) y + e * M_LN2) * scale);
+  }
+
+  r = field_trans_select( x == 0        , -INFINITY , r );
+  r = field_trans_select( x < 0         , NAN       , r );
+  r = field_trans_select( x == INFINITY , INFINITY  , r );
+  return field_trans_select( x != x , x , r );
+}
+
+
+static inline float field_trans_vexpf( float x )    { return field_trans_vexp__( x , 1.0 ); }
+static inline float field_trans_vpow10f( float x )  { return field_trans_vexp__( x , M_LN10 ); }
+static inline float field_trans_vlogf( float x )    { return field_trans_vlog__( x , 1.0 ); }
+static inline float field_trans_vlog10f( float x )  { return field_trans_vlog__( x , M_LOG10E ); }
+
+FIELD_TRANS_VECTOR( field_trans_vector_exp   , field_trans_vexpf )
+FIELD_TRANS_VECTOR( field_trans_vector_pow10 , field_trans_vpow10f )
+FIELD_TRANS_VECTOR( field_trans_vector_log   , field_trans_vlogf )
+FIELD_TRANS_VECTOR( field_trans_vector_log10 , field_trans_vlog10f )
+
+/*****************************************************************/
+
+
 static float field_trans_pow10(float x) {
   return powf(10.0 , x);
 }
@@ -247,6 +429,11 @@ static float trunc_pow10f(float x) {
   return util_float_max(powf(10.0 , x) , 0.001);
 }
 
+static inline float trunc_vpow10f(float x) {
+  float y = field_trans_vpow10f( x );
+  return field_trans_select( y < 0.001f , 0.001f , y );
+}
+
 #define LN_SHIFT 0.0000001
 static float field_trans_ln0( float x ) {
   return logf( x + LN_SHIFT );
@@ -255,35 +442,52 @@ static float field_trans_ln0( float x ) {
 static float field_trans_exp0( float x ) {
   return expf( x ) - LN_SHIFT;
 }
+
+static inline float field_trans_vln0( float x ) {
+  return field_trans_vlogf( x + (float) LN_SHIFT );
+}
+
+static inline float field_trans_vexp0( float x ) {
+  return field_trans_vexpf( x ) - (float) LN_SHIFT;
+}
 #undef LN_SHIFT
 
+FIELD_TRANS_VECTOR( field_trans_vector_trunc_pow10 , trunc_vpow10f )
+FIELD_TRANS_VECTOR( field_trans_vector_ln0         , field_trans_vln0 )
+FIELD_TRANS_VECTOR( field_trans_vector_exp0        , field_trans_vexp0 )
+FIELD_TRANS_VECTOR( normalize_permx_vector         , normalize_permx )
+FIELD_TRANS_VECTOR( denormalize_permx_vector       , denormalize_permx )
+FIELD_TRANS_VECTOR( normalize_permz_vector         , normalize_permz )
+FIELD_TRANS_VECTOR( denormalize_permz_vector       , denormalize_permz )
+FIELD_TRANS_VECTOR( normalize_poro_vector          , normalize_poro )
+FIELD_TRANS_VECTOR( denormalize_poro_vector        , denormalize_poro )
+
 
 
 field_trans_table_type * field_trans_table_alloc() {
   field_trans_table_type * table = (field_trans_table_type *)util_malloc( sizeof * table);
   table->function_table = hash_alloc();
-  field_trans_table_add( table , "POW10"       , "This function will raise x to the power of 10: y = 10^x." ,                            field_trans_pow10);
-  field_trans_table_add( table , "TRUNC_POW10" , "This function will raise x to the power of 10 - and truncate lower values at 0.001." , trunc_pow10f);
-  field_trans_table_add( table , "LOG"         , "This function will take the NATURAL logarithm of x: y = ln(x)" , logf);
-  field_trans_table_add( table , "LN"          , "This function will take the NATURAL logarithm of x: y = ln(x)" , logf);
-  field_trans_table_add( table , "LOG10"       , "This function will take the log10 logarithm of x: y = log10(x)" , log10f);
-  field_trans_table_add( table , "EXP"         , "This function will calculate y = exp(x) " , expf);
-  field_trans_table_add( table , "LN0"         , "This function will calculate y = ln(x + 0.000001)" , field_trans_ln0);
-  field_trans_table_add( table , "EXP0"        , "This function will calculate y = exp(x) - 0.000001" , field_trans_exp0);
+  table->case_sensitive = false;
+  field_trans_table_add_vector( table , "POW10"       , "This function will raise x to the power of 10: y = 10^x." ,                            field_trans_pow10 , field_trans_vector_pow10);
+  field_trans_table_add_vector( table , "TRUNC_POW10" , "This function will raise x to the power of 10 - and truncate lower values at 0.001." , trunc_pow10f , field_trans_vector_trunc_pow10);
+  field_trans_table_add_vector( table , "LOG"         , "This function will take the NATURAL logarithm of x: y = ln(x)" , logf , field_trans_vector_log);
+  field_trans_table_add_vector( table , "LN"          , "This function will take the NATURAL logarithm of x: y = ln(x)" , logf , field_trans_vector_log);
+  field_trans_table_add_vector( table , "LOG10"       , "This function will take the log10 logarithm of x: y = log10(x)" , log10f , field_trans_vector_log10);
+  field_trans_table_add_vector( table , "EXP"         , "This function will calculate y = exp(x) " , expf , field_trans_vector_exp);
+  field_trans_table_add_vector( table , "LN0"         , "This function will calculate y = ln(x + 0.000001)" , field_trans_ln0 , field_trans_vector_ln0);
+  field_trans_table_add_vector( table , "EXP0"        , "This function will calculate y = exp(x) - 0.000001" , field_trans_exp0 , field_trans_vector_exp0);
 
   //-----------------------------------------------------------------
   // Rubakumar specials:
-  field_trans_table_add( table , "NORMALIZE_PERMX"    , "..." , normalize_permx);
-  field_trans_table_add( table , "DENORMALIZE_PERMX"  , "..." , denormalize_permx);
+  field_trans_table_add_vector( table , "NORMALIZE_PERMX"    , "..." , normalize_permx , normalize_permx_vector);
+  field_trans_table_add_vector( table , "DENORMALIZE_PERMX"  , "..." , denormalize_permx , denormalize_permx_vector);
 
-  field_trans_table_add( table , "NORMALIZE_PERMZ"    , "..." , normalize_permz);
-  field_trans_table_add( table , "DENORMALIZE_PERMZ"  , "..." , denormalize_permz);
+  field_trans_table_add_vector( table , "NORMALIZE_PERMZ"    , "..." , normalize_permz , normalize_permz_vector);
+  field_trans_table_add_vector( table , "DENORMALIZE_PERMZ"  , "..." , denormalize_permz , denormalize_permz_vector);
 
-  field_trans_table_add( table , "NORMALIZE_PORO"    , "..." , normalize_poro);
-  field_trans_table_add( table , "DENORMALIZE_PORO"  , "..." , denormalize_poro);
+  field_trans_table_add_vector( table , "NORMALIZE_PORO"    , "..." , normalize_poro , normalize_poro_vector);
+  field_trans_table_add_vector( table , "DENORMALIZE_PORO"  , "..." , denormalize_poro , denormalize_poro_vector);
   //-----------------------------------------------------------------
 
-  table->case_sensitive = false;
   return table;
 }
-
@@ -32,6 +32,7 @@ struct forward_load_context_struct {
   // Everyuthing can be NULL here ... - when created from gen_data.
 
   ecl_sum_type          * ecl_sum;
+  char                  * unified_summary_file;  // Only set when ecl_sum has been loaded from one unformatted unified file.
   ecl_file_type         * restart_file;
   const run_arg_type    * run_arg;
   const ecl_config_type * ecl_config;   // Can be NULL
@@ -45,6 +46,7 @@ struct forward_load_context_struct {
   int load_step;
   int load_result;
   bool ecl_active;
+  double store_time;                   // Seconds spent writing results to storage.
 };
 
 UTIL_IS_INSTANCE_FUNCTION( forward_load_context , FORWARD_LOAD_CONTEXT_TYPE_ID)
@@ -125,6 +127,9 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
         }
       }
     }
+    if (summary && unified_file && !fmt_file)
+      load_context->unified_summary_file = util_alloc_string_copy( unified_file );
+
     stringlist_free( data_files );
     free( header_file );
     free( unified_file );
@@ -145,10 +150,12 @@ forward_load_context_type * forward_load_context_alloc( const run_arg_type * run
 
   load_context->ecl_active = false;
   load_context->ecl_sum = NULL;
+  load_context->unified_summary_file = NULL;
   load_context->restart_file = NULL;
   load_context->run_arg = run_arg;
   load_context->load_step = -1;  // Invalid - must call forward_load_context_select_step()
   load_context->load_result = 0;
+  load_context->store_time = 0;
   load_context->messages = messages;
   load_context->ecl_config = ecl_config;
   if (ecl_config)
@@ -189,6 +196,20 @@ void forward_load_context_update_result( forward_load_context_type * load_contex
 }
 
 
+/*
+  The time spent writing to storage is accumulated separately, so
+  that the loading time can be split in internalizing and storing.
+*/
+
+void forward_load_context_add_store_time( forward_load_context_type * load_context , double seconds) {
+  load_context->store_time += seconds;
+}
+
+double forward_load_context_get_store_time( const forward_load_context_type * load_context ) {
+  return load_context->store_time;
+}
+
+
 void forward_load_context_free( forward_load_context_type * load_context ) {
   if (load_context->restart_file)
     ecl_file_close( load_context->restart_file );
@@ -196,6 +217,7 @@ void forward_load_context_free( forward_load_context_type * load_context ) {
   if (load_context->ecl_sum)
     ecl_sum_free( load_context->ecl_sum );
 
+  free( load_context->unified_summary_file );
   free( load_context );
 }
 
@@ -241,6 +263,14 @@ const ecl_sum_type * forward_load_context_get_ecl_sum( const forward_load_contex
   return load_context->ecl_sum;
 }
 
+/*
+  The unified summary file which the ecl_sum instance was loaded from;
+  NULL if the summary was loaded from non-unified or formatted files.
+*/
+const char * forward_load_context_get_unified_summary_file( const forward_load_context_type * load_context) {
+  return load_context->unified_summary_file;
+}
+
 const run_arg_type * forward_load_context_get_run_arg( const forward_load_context_type * load_context ) {
   return load_context->run_arg;
 }
@@ -0,0 +1,217 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'load_timing.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <ert/util/util.h>
+#include <ert/util/double_vector.h>
+
+#include <ert/enkf/load_timing.hpp>
+
+#define LOAD_TIMING_TYPE_ID 661093402
+
+/*
+  The load timing object holds the time, in seconds, every realization
+  has spent in the different stages of loading results from the
+  forward model, along with the wall clock time of the complete
+  load. The stages run in different threads, so the updates are
+  protected with a mutex. A realization which has not been loaded has
+  no record; the time of a stage which has not run is zero.
+*/
+
+struct load_timing_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  pthread_mutex_t      mutex;
+  double_vector_type * stage_time[LOAD_NUM_STAGES];   /* Indexed by iens; -1 for realizations without a record. */
+  double               wall_time;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( load_timing , LOAD_TIMING_TYPE_ID )
+
+
+load_timing_type * load_timing_alloc( ) {
+  load_timing_type * timing = (load_timing_type *)util_malloc( sizeof * timing );
+  UTIL_TYPE_ID_INIT( timing , LOAD_TIMING_TYPE_ID );
+  pthread_mutex_init( &timing->mutex , NULL );
+  for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+    timing->stage_time[stage] = double_vector_alloc( 0 , -1 );
+  timing->wall_time = 0;
+  return timing;
+}
+
+
+void load_timing_free( load_timing_type * timing ) {
+  for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+    double_vector_free( timing->stage_time[stage] );
+  pthread_mutex_destroy( &timing->mutex );
+  free( timing );
+}
+
+
+void load_timing_clear( load_timing_type * timing ) {
+  pthread_mutex_lock( &timing->mutex );
+  for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+    double_vector_reset( timing->stage_time[stage] );
+  timing->wall_time = 0;
+  pthread_mutex_unlock( &timing->mutex );
+}
+
+
+/*
+  Wall clock time in seconds, with microsecond resolution.
+*/
+
+double load_timing_now( ) {
+  struct timeval now;
+  gettimeofday( &now , NULL );
+  return now.tv_sec + 1e-6 * now.tv_usec;
+}
+
+
+const char * load_timing_get_stage_name( load_stage_type stage ) {
+  switch (stage) {
+  case LOAD_STAGE_READ:
+    return "READ";
+  case LOAD_STAGE_PARSE:
+    return "PARSE";
+  case LOAD_STAGE_STORE:
+    return "STORE";
+  default:
+    util_abort("%s: invalid stage:%d \n",__func__ , stage);
+    return NULL;
+  }
+}
+
+
+static void load_timing_assert_stage( load_stage_type stage ) {
+  if (stage < 0 || stage >= LOAD_NUM_STAGES)
+    util_abort("%s: invalid stage:%d \n",__func__ , stage);
+}
+
+
+/*
+  Setting the time of one stage creates the record of the
+  realization; the other stages of the record start at zero.
+*/
+
+void load_timing_iset( load_timing_type * timing , int iens , load_stage_type stage , double seconds) {
+  load_timing_assert_stage( stage );
+  pthread_mutex_lock( &timing->mutex );
+  for (int s = 0; s < LOAD_NUM_STAGES; s++) {
+    if (double_vector_safe_iget( timing->stage_time[s] , iens ) < 0)
+      double_vector_iset( timing->stage_time[s] , iens , 0 );
+  }
+  double_vector_iset( timing->stage_time[stage] , iens , seconds );
+  pthread_mutex_unlock( &timing->mutex );
+}
+
+
+bool load_timing_has_realization( const load_timing_type * timing , int iens ) {
+  return (double_vector_safe_iget( timing->stage_time[LOAD_STAGE_READ] , iens ) >= 0);
+}
+
+
+double load_timing_iget( const load_timing_type * timing , int iens , load_stage_type stage ) {
+  load_timing_assert_stage( stage );
+  if (!load_timing_has_realization( timing , iens ))
+    util_abort("%s: no timing recorded for realization:%d \n",__func__ , iens);
+
+  return double_vector_iget( timing->stage_time[stage] , iens );
+}
+
+
+/*
+  One more than the largest realization number with a record.
+*/
+
+int load_timing_get_size( const load_timing_type * timing ) {
+  return double_vector_size( timing->stage_time[LOAD_STAGE_READ] );
+}
+
+
+double load_timing_get_total( const load_timing_type * timing , load_stage_type stage ) {
+  const double_vector_type * stage_time;
+  double total = 0;
+
+  load_timing_assert_stage( stage );
+  stage_time = timing->stage_time[stage];
+  for (int iens = 0; iens < double_vector_size( stage_time ); iens++) {
+    double seconds = double_vector_iget( stage_time , iens );
+    if (seconds > 0)
+      total += seconds;
+  }
+  return total;
+}
+
+
+/*
+  The realization which spent the longest time in the stage; -1 if
+  there are no records.
+*/
+
+int load_timing_get_slowest( const load_timing_type * timing , load_stage_type stage ) {
+  const double_vector_type * stage_time;
+  int slowest = -1;
+  double max_time = -1;
+
+  load_timing_assert_stage( stage );
+  stage_time = timing->stage_time[stage];
+  for (int iens = 0; iens < double_vector_size( stage_time ); iens++) {
+    double seconds = double_vector_iget( stage_time , iens );
+    if (seconds > max_time) {
+      max_time = seconds;
+      slowest = iens;
+    }
+  }
+  return slowest;
+}
+
+
+void load_timing_set_wall_time( load_timing_type * timing , double seconds ) {
+  timing->wall_time = seconds;
+}
+
+
+double load_timing_get_wall_time( const load_timing_type * timing ) {
+  return timing->wall_time;
+}
+
+
+void load_timing_fprintf( const load_timing_type * timing , FILE * stream ) {
+  fprintf( stream , "%6s" , "iens" );
+  for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+    fprintf( stream , " %10s" , load_timing_get_stage_name( (load_stage_type) stage ));
+  fprintf( stream , "\n" );
+
+  for (int iens = 0; iens < load_timing_get_size( timing ); iens++) {
+    if (load_timing_has_realization( timing , iens )) {
+      fprintf( stream , "%6d" , iens );
+      for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+        fprintf( stream , " %10.3f" , load_timing_iget( timing , iens , (load_stage_type) stage ));
+      fprintf( stream , "\n" );
+    }
+  }
+
+  fprintf( stream , "%6s" , "total" );
+  for (int stage = 0; stage < LOAD_NUM_STAGES; stage++)
+    fprintf( stream , " %10.3f" , load_timing_get_total( timing , (load_stage_type) stage ));
+  fprintf( stream , "\nWall clock time: %.3f seconds\n" , timing->wall_time );
+}
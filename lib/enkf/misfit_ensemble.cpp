@@ -20,19 +20,33 @@
 #include <stdio.h>
 #include <cmath>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <thread>
 
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/vector.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/bool_vector.h>
 #include <ert/util/buffer.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
 
 #include <ert/enkf/enkf_obs.hpp>
+#include <ert/enkf/obs_data.hpp>
+#include <ert/enkf/active_list.hpp>
 #include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_node.hpp>
 #include <ert/enkf/enkf_util.hpp>
 #include <ert/enkf/misfit_ensemble.hpp>
 #include <ert/enkf/misfit_member.hpp>
 #include <ert/enkf/misfit_ts.hpp>
+#include <ert/enkf/state_map.hpp>
 
 
 /**
@@ -44,6 +58,21 @@
    misfit_member which is the misfit for one ensemble member, and
    misfit_ts which is the misfit for one ensemble member / one
    observation key.
+
+   When the table has been computed it is kept up to date
+   incrementally: the misfit_ensemble keeps a snapshot of the
+   state_map change counters, and realizations which have changed
+   state since the snapshot - typically because they have been rerun
+   and loaded again - are marked dirty. A subsequent call to
+   misfit_ensemble_initialize() will only recompute the dirty members.
+   The dirty flags are stored together with the table, so a table
+   which is written before it is brought up to date is still patched
+   correctly after the case has been mounted again.
+
+   The state_map does not know about the observations, so the table
+   also stores a fingerprint of the observation keys, values and
+   standard deviations it was computed from; if the observations have
+   changed the whole table is recomputed.
 */
 
 
@@ -57,6 +86,14 @@ struct misfit_ensemble_struct {
   bool                  initialized;
   int                   history_length;
   vector_type         * ensemble;           /* Vector of misfit_member_type instances - one for each ensemble member. */
+  int_vector_type     * change_count;       /* Snapshot of the state_map change counters. */
+  bool_vector_type    * dirty;              /* Members which must be recomputed. */
+  uint64_t              obs_fingerprint;    /* Fingerprint of the observations the table was computed from. */
+  const enkf_obs_type * cache_obs;          /* The enkf_obs, revision and history length the cached fingerprint was computed for. */
+  long                  cache_revision;
+  int                   cache_history_length;
+  uint64_t              cache_fingerprint;
+  int                   num_threads;        /* Threads used to compute the table; 0: one per cpu core. */
 };
 
 
@@ -76,6 +113,315 @@ static void  __2d_free(double ** d , int rows) {
 }
 
 
+/*
+  The misfit table is calculated with one pass over the responses:
+  the observations are grouped by the response they observe, and for
+  each realization the response is loaded once and evaluated against
+  all the observations of that response. For responses with vector
+  storage (i.e. summary) that means one load of the vector per
+  realization, instead of one load per observation and report step.
+
+  The realizations are split in contiguous ranges which are handled
+  by separate threads; each thread only updates the misfit_member
+  instances of its own realizations.
+
+  Only the realizations in the list passed to
+  misfit_ensemble_update_realizations() are recomputed; the
+  misfit_member instances of these realizations are replaced with
+  empty instances before the computation starts.
+*/
+
+static void misfit_ensemble_update_node_chi2__( const vector_type * obs_group ,
+                                                enkf_node_type * enkf_node ,
+                                                enkf_fs_type * fs ,
+                                                int iens ,
+                                                int history_length ,
+                                                double ** chi2 ,
+                                                bool * valid) {
+  int num_obs = vector_get_size( obs_group );
+
+  if (enkf_node_vector_storage( enkf_node )) {
+    bool has_vector = enkf_node_try_load_vector( enkf_node , fs , iens );
+    for (int iobs = 0; iobs < num_obs; iobs++) {
+      const obs_vector_type * obs_vector = (const obs_vector_type *) vector_iget_const( obs_group , iobs );
+      valid[iobs] = obs_vector_vector_chi2( obs_vector , has_vector ? enkf_node : NULL , iens , 0 , history_length , chi2[iobs] );
+    }
+  } else {
+    for (int iobs = 0; iobs < num_obs; iobs++)
+      valid[iobs] = true;
+
+    for (int step = 0; step <= history_length; step++) {
+      node_id_type node_id = {.report_step = step , .iens = iens };
+      bool loaded = false;
+      bool load_tried = false;
+
+      for (int iobs = 0; iobs < num_obs; iobs++) {
+        const obs_vector_type * obs_vector = (const obs_vector_type *) vector_iget_const( obs_group , iobs );
+        chi2[iobs][step] = 0;
+        if (obs_vector_iget_node( obs_vector , step ) != NULL) {
+          if (!load_tried) {
+            loaded = enkf_node_try_load( enkf_node , fs , node_id );
+            load_tried = true;
+          }
+
+          if (loaded)
+            chi2[iobs][step] = obs_vector_iget_chi2( obs_vector , step , enkf_node , node_id );
+          else
+            // Missing data - this member will be marked as invalid in the misfit calculations.
+            valid[iobs] = false;
+        }
+      }
+    }
+  }
+}
+
+
+static void * misfit_ensemble_initialize_range__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  misfit_ensemble_type * misfit_ensemble = (misfit_ensemble_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  const vector_type * obs_groups = (const vector_type *) arg_pack_iget_const_ptr( arg_pack , 1 );
+  enkf_fs_type * fs = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 2 );
+  const int_vector_type * realizations = (const int_vector_type *) arg_pack_iget_const_ptr( arg_pack , 3 );
+  int index1 = arg_pack_iget_int( arg_pack , 4 );
+  int index2 = arg_pack_iget_int( arg_pack , 5 );
+  int history_length = misfit_ensemble->history_length;
+
+  for (int igroup = 0; igroup < vector_get_size( obs_groups ); igroup++) {
+    const vector_type * obs_group = (const vector_type *) vector_iget_const( obs_groups , igroup );
+    int num_obs = vector_get_size( obs_group );
+    const obs_vector_type * first_obs = (const obs_vector_type *) vector_iget_const( obs_group , 0 );
+    enkf_node_type * enkf_node = enkf_node_alloc( obs_vector_get_config_node( first_obs ));
+    double ** chi2 = __2d_malloc( num_obs , history_length + 1 );
+    bool * valid = (bool *) util_calloc( num_obs , sizeof * valid );
+
+    for (int index = index1; index < index2; index++) {
+      int iens = int_vector_iget( realizations , index );
+      misfit_member_type * member = misfit_ensemble_iget_member( misfit_ensemble , iens );
+      misfit_ensemble_update_node_chi2__( obs_group , enkf_node , fs , iens , history_length , chi2 , valid );
+
+      for (int iobs = 0; iobs < num_obs; iobs++) {
+        if (valid[iobs]) {
+          const obs_vector_type * obs_vector = (const obs_vector_type *) vector_iget_const( obs_group , iobs );
+          misfit_member_update_ts( member , obs_vector_get_obs_key( obs_vector ) , history_length , chi2[iobs] );
+        }
+      }
+    }
+
+    free( valid );
+    __2d_free( chi2 , num_obs );
+    enkf_node_free( enkf_node );
+  }
+  return NULL;
+}
+
+
+/*
+  Returns a vector of vectors; the observations in each of the inner
+  vectors all observe the same response.
+*/
+
+static vector_type * misfit_ensemble_alloc_obs_groups( const enkf_obs_type * enkf_obs ) {
+  vector_type * obs_groups = vector_alloc_new( );
+  hash_type * group_index = hash_alloc( );
+  hash_iter_type * obs_iter = enkf_obs_alloc_iter( enkf_obs );
+  const char * obs_key = hash_iter_get_next_key( obs_iter );
+
+  while (obs_key != NULL) {
+    obs_vector_type * obs_vector = enkf_obs_get_vector( enkf_obs , obs_key );
+    const char * node_key = enkf_config_node_get_key( obs_vector_get_config_node( obs_vector ));
+
+    if (!hash_has_key( group_index , node_key )) {
+      vector_type * obs_group = vector_alloc_new( );
+      vector_append_owned_ref( obs_groups , obs_group , vector_free__ );
+      hash_insert_ref( group_index , node_key , obs_group );
+    }
+    vector_append_ref( (vector_type *) hash_get( group_index , node_key ) , obs_vector );
+    obs_key = hash_iter_get_next_key( obs_iter );
+  }
+
+  hash_iter_free( obs_iter );
+  hash_free( group_index );
+  return obs_groups;
+}
+
+
+static uint64_t misfit_ensemble_hash_bytes( uint64_t hash , const void * data , size_t size ) {
+  const unsigned char * bytes = (const unsigned char *) data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+
+/*
+  FNV-1a hash of the observation keys and the value and standard
+  deviation of all the observations up to @history_length. The keys
+  are sorted, so the fingerprint does not depend on the order of the
+  observations in the enkf_obs hash table.
+*/
+
+static uint64_t misfit_ensemble_obs_fingerprint( const enkf_obs_type * enkf_obs , enkf_fs_type * fs , int history_length ) {
+  uint64_t hash = 14695981039346656037ULL;
+  stringlist_type * obs_keys = stringlist_alloc_new( );
+  active_list_type * active_list = active_list_alloc( );
+  obs_data_type * obs_data = obs_data_alloc( 1.0 );
+
+  {
+    hash_iter_type * obs_iter = enkf_obs_alloc_iter( enkf_obs );
+    const char * obs_key = hash_iter_get_next_key( obs_iter );
+    while (obs_key != NULL) {
+      stringlist_append_copy( obs_keys , obs_key );
+      obs_key = hash_iter_get_next_key( obs_iter );
+    }
+    hash_iter_free( obs_iter );
+    stringlist_sort( obs_keys , NULL );
+  }
+
+  for (int ikey = 0; ikey < stringlist_get_size( obs_keys ); ikey++) {
+    const char * obs_key = stringlist_iget( obs_keys , ikey );
+    const obs_vector_type * obs_vector = enkf_obs_get_vector( enkf_obs , obs_key );
+    const char * node_key = enkf_config_node_get_key( obs_vector_get_config_node( obs_vector ));
+
+    hash = misfit_ensemble_hash_bytes( hash , obs_key , strlen( obs_key ) + 1 );
+    hash = misfit_ensemble_hash_bytes( hash , node_key , strlen( node_key ) + 1 );
+    for (int step = 0; step <= history_length; step++) {
+      if (obs_vector_iget_node( obs_vector , step ) == NULL)
+        continue;
+
+      obs_data_reset( obs_data );
+      obs_vector_iget_observations( obs_vector , step , obs_data , active_list , fs );
+      hash = misfit_ensemble_hash_bytes( hash , &step , sizeof step );
+      for (int block_nr = 0; block_nr < obs_data_get_num_blocks( obs_data ); block_nr++) {
+        const obs_block_type * obs_block = obs_data_iget_block_const( obs_data , block_nr );
+        for (int iobs = 0; iobs < obs_block_get_size( obs_block ); iobs++) {
+          double value = obs_block_iget_value( obs_block , iobs );
+          double std   = obs_block_iget_std( obs_block , iobs );
+          hash = misfit_ensemble_hash_bytes( hash , &value , sizeof value );
+          hash = misfit_ensemble_hash_bytes( hash , &std , sizeof std );
+        }
+      }
+    }
+  }
+
+  obs_data_free( obs_data );
+  active_list_free( active_list );
+  stringlist_free( obs_keys );
+  return hash;
+}
+
+
+/*
+  Computing the fingerprint loads all the observations, so it is
+  cached, and only recomputed when the revision of enkf_obs has
+  changed - i.e. when observations have been added or removed or the
+  standard deviations have been scaled, e.g. by the localized
+  correlated std scaling in the update. Changes made directly on the
+  observation nodes do not change the revision; they are picked up
+  when the table is initialized with @force_init.
+*/
+
+static uint64_t misfit_ensemble_get_obs_fingerprint( misfit_ensemble_type * misfit_ensemble ,
+                                                     const enkf_obs_type * enkf_obs ,
+                                                     enkf_fs_type * fs ,
+                                                     int history_length ,
+                                                     bool force ) {
+  if (force ||
+      (misfit_ensemble->cache_obs != enkf_obs) ||
+      (misfit_ensemble->cache_revision != enkf_obs_get_revision( enkf_obs )) ||
+      (misfit_ensemble->cache_history_length != history_length)) {
+
+    misfit_ensemble->cache_fingerprint    = misfit_ensemble_obs_fingerprint( enkf_obs , fs , history_length );
+    misfit_ensemble->cache_obs            = enkf_obs;
+    misfit_ensemble->cache_revision       = enkf_obs_get_revision( enkf_obs );
+    misfit_ensemble->cache_history_length = history_length;
+  }
+  return misfit_ensemble->cache_fingerprint;
+}
+
+
+static void misfit_ensemble_update_realizations( misfit_ensemble_type * misfit_ensemble ,
+                                                 const enkf_obs_type * enkf_obs ,
+                                                 enkf_fs_type * fs ,
+                                                 const int_vector_type * realizations) {
+  int num_realizations = int_vector_size( realizations );
+
+  for (int index = 0; index < num_realizations; index++) {
+    int iens = int_vector_iget( realizations , index );
+    vector_iset_owned_ref( misfit_ensemble->ensemble , iens , misfit_member_alloc( iens ) , misfit_member_free__);
+  }
+
+  {
+    vector_type * obs_groups = misfit_ensemble_alloc_obs_groups( enkf_obs );
+
+    if ((vector_get_size( obs_groups ) > 0) && (num_realizations > 0)) {
+      int max_threads = misfit_ensemble->num_threads > 0 ? misfit_ensemble->num_threads : (int) std::thread::hardware_concurrency();
+      int num_threads = util_int_max( 1 , util_int_min( max_threads , num_realizations ));
+      thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+      arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( num_threads , sizeof * arg_list );
+
+      for (int ithread = 0; ithread < num_threads; ithread++) {
+        int index1 = (ithread * num_realizations) / num_threads;
+        int index2 = ((ithread + 1) * num_realizations) / num_threads;
+
+        arg_list[ithread] = arg_pack_alloc( );
+        arg_pack_append_ptr( arg_list[ithread] , misfit_ensemble );
+        arg_pack_append_const_ptr( arg_list[ithread] , obs_groups );
+        arg_pack_append_ptr( arg_list[ithread] , fs );
+        arg_pack_append_const_ptr( arg_list[ithread] , realizations );
+        arg_pack_append_int( arg_list[ithread] , index1 );
+        arg_pack_append_int( arg_list[ithread] , index2 );
+
+        thread_pool_add_job( tp , misfit_ensemble_initialize_range__ , arg_list[ithread] );
+      }
+      thread_pool_join( tp );
+      thread_pool_free( tp );
+
+      for (int ithread = 0; ithread < num_threads; ithread++)
+        arg_pack_free( arg_list[ithread] );
+      free( arg_list );
+    }
+
+    vector_free( obs_groups );
+  }
+}
+
+
+/*
+  Compares the state_map change counters with the snapshot, and marks
+  the members which have changed since the snapshot was taken as
+  dirty. The snapshot is updated afterwards.
+*/
+
+void misfit_ensemble_mark_changed( misfit_ensemble_type * misfit_ensemble , const state_map_type * state_map ) {
+  int ens_size = misfit_ensemble_get_ens_size( misfit_ensemble );
+  for (int iens = 0; iens < ens_size; iens++) {
+    int change_count = state_map_iget_change_count( state_map , iens );
+    if (change_count != int_vector_safe_iget( misfit_ensemble->change_count , iens )) {
+      bool_vector_iset( misfit_ensemble->dirty , iens , true );
+      int_vector_iset( misfit_ensemble->change_count , iens , change_count );
+    }
+  }
+}
+
+
+int misfit_ensemble_get_num_dirty( const misfit_ensemble_type * misfit_ensemble ) {
+  int num_dirty = 0;
+  for (int iens = 0; iens < bool_vector_size( misfit_ensemble->dirty ); iens++)
+    if (bool_vector_iget( misfit_ensemble->dirty , iens ))
+      num_dirty++;
+  return num_dirty;
+}
+
+
+/*
+  The table is computed from scratch if it has not been computed
+  before, if the ensemble size, history length or observations have
+  changed, or if @force_init is true. Otherwise only the members which have changed
+  according to the state_map of @fs are recomputed.
+*/
+
 void misfit_ensemble_initialize( misfit_ensemble_type * misfit_ensemble ,
                                  const ensemble_config_type * ensemble_config ,
                                  const enkf_obs_type * enkf_obs ,
@@ -84,49 +430,40 @@ void misfit_ensemble_initialize( misfit_ensemble_type * misfit_ensemble ,
                                  int history_length,
                                  bool force_init) {
 
-  if (force_init || !misfit_ensemble->initialized) {
-    misfit_ensemble_clear( misfit_ensemble );
-
-    double ** chi2_work            = __2d_malloc( history_length + 1 , ens_size );
-    bool_vector_type * iens_valid  = bool_vector_alloc( ens_size , true );
+  const state_map_type * state_map = enkf_fs_get_state_map( fs );
+  int_vector_type * realizations = int_vector_alloc( 0 , 0 );
+  uint64_t obs_fingerprint = misfit_ensemble_get_obs_fingerprint( misfit_ensemble , enkf_obs , fs , history_length , force_init );
 
-    hash_iter_type * obs_iter = enkf_obs_alloc_iter( enkf_obs );
-    const char * obs_key      = hash_iter_get_next_key( obs_iter );
+  if (force_init ||
+      !misfit_ensemble->initialized ||
+      (misfit_ensemble->obs_fingerprint != obs_fingerprint) ||
+      (misfit_ensemble->history_length != history_length) ||
+      (misfit_ensemble_get_ens_size( misfit_ensemble ) != ens_size)) {
 
+    misfit_ensemble_clear( misfit_ensemble );
     misfit_ensemble->history_length = history_length;
     misfit_ensemble_set_ens_size( misfit_ensemble , ens_size );
+    for (int iens = 0; iens < ens_size; iens++)
+      int_vector_append( realizations , iens );
 
-    while (obs_key != NULL) {
-      obs_vector_type * obs_vector = enkf_obs_get_vector( enkf_obs , obs_key );
-
-      bool_vector_reset( iens_valid );
-      bool_vector_iset( iens_valid , ens_size - 1 , true );
-      obs_vector_ensemble_chi2( obs_vector ,
-                                fs ,
-                                iens_valid ,
-                                0 ,
-                                misfit_ensemble->history_length,
-                                0 ,
-                                ens_size ,
-                                chi2_work);
-
-      /**
-          Internalizing the results from the chi2_work table into the misfit structure.
-      */
-      for (int iens = 0; iens < ens_size; iens++) {
-        misfit_member_type * node = misfit_ensemble_iget_member( misfit_ensemble , iens );
-        if (bool_vector_iget( iens_valid , iens))
-          misfit_member_update( node , obs_key , misfit_ensemble->history_length , iens , (const double **) chi2_work);
-      }
-      obs_key = hash_iter_get_next_key( obs_iter );
-    }
+  } else {
 
-    bool_vector_free( iens_valid );
-    hash_iter_free( obs_iter );
+    misfit_ensemble_mark_changed( misfit_ensemble , state_map );
+    for (int iens = 0; iens < ens_size; iens++)
+      if (bool_vector_safe_iget( misfit_ensemble->dirty , iens ))
+        int_vector_append( realizations , iens );
 
-    __2d_free( chi2_work , misfit_ensemble->history_length + 1);
-    misfit_ensemble->initialized = true;
   }
+
+  misfit_ensemble_update_realizations( misfit_ensemble , enkf_obs , fs , realizations );
+
+  for (int iens = 0; iens < ens_size; iens++)
+    int_vector_iset( misfit_ensemble->change_count , iens , state_map_iget_change_count( state_map , iens ));
+  bool_vector_reset( misfit_ensemble->dirty );
+  misfit_ensemble->obs_fingerprint = obs_fingerprint;
+  misfit_ensemble->initialized = true;
+
+  int_vector_free( realizations );
 }
 
 
@@ -142,6 +479,16 @@ void misfit_ensemble_fwrite( const misfit_ensemble_type * misfit_ensemble , FILE
       misfit_member_fwrite( (const misfit_member_type *) vector_iget( misfit_ensemble->ensemble , iens ) , stream );
   }
 
+  /*
+    The dirty members are written last, that way files written before
+    the dirty tracking was added can still be read.
+  */
+  util_fwrite_int( misfit_ensemble_get_num_dirty( misfit_ensemble ) , stream );
+  for (int iens = 0; iens < bool_vector_size( misfit_ensemble->dirty ); iens++)
+    if (bool_vector_iget( misfit_ensemble->dirty , iens ))
+      util_fwrite_int( iens , stream );
+
+  util_fwrite( &misfit_ensemble->obs_fingerprint , sizeof misfit_ensemble->obs_fingerprint , 1 , stream , __func__ );
 }
 
 
@@ -157,6 +504,11 @@ static misfit_ensemble_type * misfit_ensemble_alloc_empty() {
 
   table->initialized     = false;
   table->ensemble        = vector_alloc_new();
+  table->change_count    = int_vector_alloc( 0 , 0 );
+  table->dirty           = bool_vector_alloc( 0 , false );
+  table->obs_fingerprint = 0;
+  table->cache_obs       = NULL;
+  table->num_threads     = 0;
 
   return table;
 }
@@ -170,6 +522,11 @@ static misfit_ensemble_type * misfit_ensemble_alloc_empty() {
    last elements of the misfit table are discarded (NOT exactly battle-tested).
 
 */
+void misfit_ensemble_set_num_threads( misfit_ensemble_type * misfit_ensemble , int num_threads) {
+  misfit_ensemble->num_threads = num_threads;
+}
+
+
 void misfit_ensemble_set_ens_size( misfit_ensemble_type * misfit_ensemble , int ens_size) {
   int iens;
   if (ens_size > vector_get_size( misfit_ensemble->ensemble )) {
@@ -200,6 +557,27 @@ void misfit_ensemble_fread( misfit_ensemble_type * misfit_ensemble , FILE * stre
       }
     }
 
+    {
+      int num_dirty;
+      if (fread( &num_dirty , sizeof num_dirty , 1 , stream ) == 1) {
+        for (int i = 0; i < num_dirty; i++)
+          bool_vector_iset( misfit_ensemble->dirty , util_fread_int( stream ) , true );
+      }
+    }
+
+    /*
+      Files written without the fingerprint keep the zero fingerprint
+      from misfit_ensemble_clear(), and are recomputed on first use.
+    */
+    if (fread( &misfit_ensemble->obs_fingerprint , sizeof misfit_ensemble->obs_fingerprint , 1 , stream ) != 1)
+      misfit_ensemble->obs_fingerprint = 0;
+
+    /*
+      The change counters of the state_map start at zero when the
+      state_map is read from disk; i.e. the all zero snapshot left by
+      misfit_ensemble_clear() is the correct starting point.
+    */
+    misfit_ensemble->initialized = true;
   }
 }
 
@@ -221,12 +599,17 @@ misfit_member_type * misfit_ensemble_iget_member( const misfit_ensemble_type * t
 
 void misfit_ensemble_clear( misfit_ensemble_type * table) {
   vector_clear( table->ensemble );
+  int_vector_reset( table->change_count );
+  bool_vector_reset( table->dirty );
+  table->obs_fingerprint = 0;
   table->initialized = false;
 }
 
 
 void misfit_ensemble_free(misfit_ensemble_type * table ) {
   vector_free( table->ensemble );
+  int_vector_free( table->change_count );
+  bool_vector_free( table->dirty );
   free( table );
 }
 
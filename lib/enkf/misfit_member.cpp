@@ -88,6 +88,17 @@ void misfit_member_update( misfit_member_type * node , const char * obs_key , in
 }
 
 
+/*
+  Same as misfit_member_update(), but with the chi2 values of this
+  member only, indexed by report step.
+*/
+void misfit_member_update_ts( misfit_member_type * node , const char * obs_key , int history_length , const double * chi2) {
+  misfit_ts_type * vector = misfit_member_safe_get_vector( node , obs_key , history_length );
+  for (int step = 0; step <= history_length; step++)
+    misfit_ts_iset( vector , step , chi2[step]);
+}
+
+
 void misfit_member_fwrite( const misfit_member_type * node , FILE * stream) {
   util_fwrite_int( node->my_iens , stream);
   util_fwrite_int( hash_get_size( node->obs ) , stream);
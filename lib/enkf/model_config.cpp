@@ -97,6 +97,10 @@ struct model_config_struct {
 
   fs_driver_impl         dbase_type;
   int                    max_internal_submit;        /* How many times to retry if the load fails. */
+  bool                   lazy_summary_load;          /* Only store a reference to the summary files for the vectors which are not observed. */
+  bool                   columnar_summary_storage;   /* Store the summary vectors in blocks of keys, see summary_block.cpp. */
+  int                    load_read_threads;          /* Threads reading the result files when loading; 0 means one per core. */
+  int                    load_store_threads;         /* Threads internalizing and storing the results when loading; 0 means one per core. */
   const ecl_sum_type   * refcase;                    /* A pointer to the refcase - can be NULL. Observe that this ONLY a pointer
                                                         to the ecl_sum instance owned and held by the ecl_config object. */
   char                 * gen_kw_export_name;
@@ -256,6 +260,65 @@ void model_config_set_max_internal_submit( model_config_type * model_config , in
 }
 
 
+/*
+  With lazy summary load the summary vectors which are not observed
+  are not copied into the storage when the results are loaded; only a
+  reference to the unified summary file in the runpath is stored, and
+  the vectors are read from that file when they are needed. The
+  runpath must then be kept as long as the case is in use.
+*/
+
+void model_config_set_lazy_summary_load( model_config_type * model_config , bool lazy_summary_load) {
+  model_config->lazy_summary_load = lazy_summary_load;
+}
+
+bool model_config_get_lazy_summary_load( const model_config_type * model_config ) {
+  return model_config->lazy_summary_load;
+}
+
+
+/*
+  With columnar summary storage the summary vectors of a realization
+  are stored as time x key matrices of up to SUMMARY_BLOCK_CHUNK_SIZE
+  keys, instead of one blob for every vector. The cases can still be
+  read when the setting is changed.
+*/
+
+void model_config_set_columnar_summary_storage( model_config_type * model_config , bool columnar_summary_storage) {
+  model_config->columnar_summary_storage = columnar_summary_storage;
+}
+
+bool model_config_get_columnar_summary_storage( const model_config_type * model_config ) {
+  return model_config->columnar_summary_storage;
+}
+
+
+/*
+  The loading of results is split in a read stage, which opens and
+  parses the ECLIPSE files in the runpath, and a stage which
+  internalizes the results and writes them to storage. The two stages
+  run concurrently with separate thread counts; on a network file
+  system it typically pays to have more reading threads than there
+  are cores. A value of zero means one thread per core.
+*/
+
+void model_config_set_load_read_threads( model_config_type * model_config , int load_read_threads) {
+  model_config->load_read_threads = util_int_max( 0 , load_read_threads );
+}
+
+int model_config_get_load_read_threads( const model_config_type * model_config ) {
+  return model_config->load_read_threads;
+}
+
+void model_config_set_load_store_threads( model_config_type * model_config , int load_store_threads) {
+  model_config->load_store_threads = util_int_max( 0 , load_store_threads );
+}
+
+int model_config_get_load_store_threads( const model_config_type * model_config ) {
+  return model_config->load_store_threads;
+}
+
+
 UTIL_IS_INSTANCE_FUNCTION( model_config , MODEL_CONFIG_TYPE_ID)
 
 model_config_type * model_config_alloc_empty() {
@@ -287,6 +350,10 @@ model_config_type * model_config_alloc_empty() {
   model_config->refcase                   = NULL;
   model_config->num_realizations          = 0;
   model_config->obs_config_file           = NULL;
+  model_config->lazy_summary_load         = DEFAULT_LAZY_SUMMARY_LOAD;
+  model_config->columnar_summary_storage  = DEFAULT_COLUMNAR_SUMMARY_STORAGE;
+  model_config->load_read_threads         = DEFAULT_LOAD_READ_THREADS;
+  model_config->load_store_threads        = DEFAULT_LOAD_STORE_THREADS;
 
   model_config_set_enspath( model_config        , DEFAULT_ENSPATH );
   model_config_set_rftpath( model_config        , DEFAULT_RFTPATH );
@@ -524,6 +591,18 @@ void model_config_init(model_config_type * model_config ,
   if (config_content_has_item( config , MAX_RESAMPLE_KEY))
     model_config_set_max_internal_submit( model_config , config_content_get_value_as_int( config , MAX_RESAMPLE_KEY ));
 
+  if (config_content_has_item( config , LAZY_SUMMARY_LOAD_KEY))
+    model_config_set_lazy_summary_load( model_config , config_content_get_value_as_bool( config , LAZY_SUMMARY_LOAD_KEY ));
+
+  if (config_content_has_item( config , COLUMNAR_SUMMARY_STORAGE_KEY))
+    model_config_set_columnar_summary_storage( model_config , config_content_get_value_as_bool( config , COLUMNAR_SUMMARY_STORAGE_KEY ));
+
+  if (config_content_has_item( config , LOAD_READ_THREADS_KEY))
+    model_config_set_load_read_threads( model_config , config_content_get_value_as_int( config , LOAD_READ_THREADS_KEY ));
+
+  if (config_content_has_item( config , LOAD_STORE_THREADS_KEY))
+    model_config_set_load_store_threads( model_config , config_content_get_value_as_int( config , LOAD_STORE_THREADS_KEY ));
+
 
   {
     if (config_content_has_item( config , GEN_KW_EXPORT_NAME_KEY)) {
@@ -760,6 +839,11 @@ static void model_config_init_user_config(config_parser_type * config ) {
   item = config_add_schema_item(config, GEN_KW_EXPORT_NAME_KEY, false);
   config_schema_item_set_argc_minmax(item, 1, 1);
 
+  config_add_key_value(config, LAZY_SUMMARY_LOAD_KEY, false, CONFIG_BOOL);
+  config_add_key_value(config, COLUMNAR_SUMMARY_STORAGE_KEY, false, CONFIG_BOOL);
+  config_add_key_value(config, LOAD_READ_THREADS_KEY, false, CONFIG_INT);
+  config_add_key_value(config, LOAD_STORE_THREADS_KEY, false, CONFIG_INT);
+
   item = config_add_schema_item(config, GEN_KW_EXPORT_FILE_KEY, false);
   config_schema_item_set_argc_minmax(item, 1, 1);
   {
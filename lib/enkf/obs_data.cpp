@@ -65,12 +65,19 @@ Matrices: S, D, E and various internal variables.
 #include <cmath>
 #include <stdio.h>
 #include <pthread.h>
+#include <stdint.h>
+
+#include <thread>
 
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/res_util/matrix.hpp>
 #include <ert/util/rng.h>
 #include <ert/util/bool_vector.h>
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
+#include <ert/res_util/counter_rng.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 
 #include <ert/enkf/obs_data.hpp>
 #include <ert/enkf/meas_data.hpp>
@@ -251,35 +258,47 @@ static void obs_block_initdObs( const obs_block_type * obs_block , matrix_type *
 
 
 
-static void obs_block_initR( const obs_block_type * obs_block , matrix_type * R, int * __obs_offset) {
-  int obs_offset = *__obs_offset;
-  if (obs_block->error_covar == NULL) {
-    int iobs;
-    int iactive = 0;
-    for (iobs =0; iobs < obs_block->size; iobs++) {
-      if (obs_block->active_mode[iobs] == ACTIVE) {
-        double var = obs_block_iget_std(obs_block, iobs) * obs_block_iget_std(obs_block, iobs);
-        matrix_iset_safe(R , obs_offset + iactive, obs_offset + iactive, var);
-        iactive++;
+/*
+  Blocks without an error_covar matrix contribute a diagonal block to
+  R, blocks with error_covar a dense block restricted to the active
+  observations. Blocks where all the observations have been
+  deactivated do not contribute to R at all.
+*/
+
+static void obs_block_initR( const obs_block_type * obs_block , block_diag_matrix_type * R) {
+  if (obs_block->active_size > 0) {
+    if (obs_block->error_covar == NULL) {
+      double * var = (double *)util_calloc( obs_block->active_size , sizeof * var );
+      int iobs;
+      int iactive = 0;
+      for (iobs =0; iobs < obs_block->size; iobs++) {
+        if (obs_block->active_mode[iobs] == ACTIVE) {
+          var[iactive] = obs_block_iget_std(obs_block, iobs) * obs_block_iget_std(obs_block, iobs);
+          iactive++;
+        }
       }
-    }
-  } else {
-    int row_active = 0;   /* We have a covar matrix */
-    for (int row = 0; row < obs_block->size; row++) {
-      if (obs_block->active_mode[row] == ACTIVE) {
-        int col_active = 0;
-        for (int col = 0; col < obs_block->size; col++) {
-          if (obs_block->active_mode[col] == ACTIVE) {
-            matrix_iset_safe(R , obs_offset + row_active , obs_offset + col_active , matrix_iget( obs_block->error_covar , row , col ));
-            col_active++;
+      block_diag_matrix_append_diag( R , iactive , var );
+      free( var );
+    } else {
+      matrix_type * block = matrix_alloc( obs_block->active_size , obs_block->active_size );
+      int row_active = 0;   /* We have a covar matrix */
+      for (int row = 0; row < obs_block->size; row++) {
+        if (obs_block->active_mode[row] == ACTIVE) {
+          int col_active = 0;
+          for (int col = 0; col < obs_block->size; col++) {
+            if (obs_block->active_mode[col] == ACTIVE) {
+              matrix_iset_safe(block , row_active , col_active , matrix_iget( obs_block->error_covar , row , col ));
+              col_active++;
+            }
           }
+          row_active++;
         }
-        row_active++;
       }
+      block_diag_matrix_append_dense( R , block );
+      matrix_free( block );
     }
   }
 
-  *__obs_offset = obs_offset + obs_block->active_size;
   if ((obs_block->error_covar_owner) && (obs_block->error_covar != NULL))
     matrix_free( obs_block->error_covar );
 }
@@ -395,6 +414,80 @@ void obs_data_free(obs_data_type * obs_data) {
 
 
 
+/*
+  The perturbations are drawn from counter based random streams, one
+  stream for each (obs block, realization) pair. Only the seed is
+  drawn from the rng passed to obs_data_allocE(); every element of E
+  is then a function of its position alone, so the columns can be
+  filled by any number of threads with bitwise identical results.
+*/
+
+static void obs_data_fillE_columns( const obs_data_type * obs_data , matrix_type * E , uint64_t seed , int col1 , int col2) {
+  int rows , columns , row_stride , column_stride;
+  double * data = matrix_get_data( E );
+
+  matrix_get_dims( E , &rows , &columns , &row_stride , &column_stride );
+  if (row_stride != 1)
+    util_abort("%s: E must be stored with contiguous columns\n",__func__);
+
+  for (int j = col1; j < col2; j++) {
+    double * column = &data[ (size_t) j * column_stride ];
+    int obs_offset = 0;
+
+    for (int block_nr = 0; block_nr < vector_get_size( obs_data->data ); block_nr++) {
+      const obs_block_type * obs_block = (const obs_block_type *)vector_iget_const( obs_data->data , block_nr);
+      int active_size = obs_block_get_active_size( obs_block );
+      uint64_t stream = ((uint64_t) block_nr << 32) | (uint32_t) j;
+
+      counter_rng_fill_normal( seed , stream , 0 , active_size , &column[obs_offset] );
+      obs_offset += active_size;
+    }
+  }
+}
+
+
+static void * obs_data_fillE_mt( void * arg ) {
+  arg_pack_type * arg_pack          = arg_pack_safe_cast( arg );
+  const obs_data_type * obs_data    = (const obs_data_type *) arg_pack_iget_const_ptr( arg_pack , 0 );
+  matrix_type * E                   = (matrix_type *) arg_pack_iget_ptr( arg_pack , 1 );
+  const uint64_t * seed             = (const uint64_t *) arg_pack_iget_const_ptr( arg_pack , 2 );
+  int col1                          = arg_pack_iget_int( arg_pack , 3 );
+  int col2                          = arg_pack_iget_int( arg_pack , 4 );
+
+  obs_data_fillE_columns( obs_data , E , *seed , col1 , col2 );
+  return NULL;
+}
+
+
+static void obs_data_fillE( const obs_data_type * obs_data , matrix_type * E , uint64_t seed) {
+  int ens_size    = matrix_get_columns( E );
+  int num_threads = util_int_max( 1 , util_int_min( (int) std::thread::hardware_concurrency() , ens_size ));
+
+  if (num_threads == 1 || matrix_get_rows( E ) == 0)
+    obs_data_fillE_columns( obs_data , E , seed , 0 , ens_size );
+  else {
+    thread_pool_type * tp     = thread_pool_alloc( num_threads , true );
+    arg_pack_type ** arg_list = (arg_pack_type **) util_calloc( num_threads , sizeof * arg_list );
+
+    for (int i = 0; i < num_threads; i++) {
+      arg_list[i] = arg_pack_alloc();
+      arg_pack_append_const_ptr( arg_list[i] , obs_data );
+      arg_pack_append_ptr( arg_list[i] , E );
+      arg_pack_append_const_ptr( arg_list[i] , &seed );
+      arg_pack_append_int( arg_list[i] , (int) ((int64_t) ens_size * i / num_threads ));
+      arg_pack_append_int( arg_list[i] , (int) ((int64_t) ens_size * (i + 1) / num_threads ));
+      thread_pool_add_job( tp , obs_data_fillE_mt , arg_list[i] );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+
+    for (int i = 0; i < num_threads; i++)
+      arg_pack_free( arg_list[i] );
+    free( arg_list );
+  }
+}
+
+
 matrix_type * obs_data_allocE(const obs_data_type * obs_data , rng_type * rng , int active_ens_size ) {
   double *pert_mean , *pert_var;
   matrix_type * E;
@@ -405,14 +498,7 @@ matrix_type * obs_data_allocE(const obs_data_type * obs_data , rng_type * rng ,
 
   pert_mean = (double *) util_calloc(active_obs_size , sizeof * pert_mean );
   pert_var  = (double *) util_calloc(active_obs_size , sizeof * pert_var  );
-  {
-
-    for (int j=0; j < active_ens_size; j++) {
-      for (int i=0; i < active_obs_size; i++) {
-        matrix_iset( E , i , j , enkf_util_rand_normal(0, 1, rng));
-      }
-    }
-  }
+  obs_data_fillE( obs_data , E , counter_rng_draw_seed( rng ));
 
   for (iobs_active = 0; iobs_active < active_obs_size; iobs_active++) {
     pert_mean[iobs_active] = 0;
@@ -476,17 +562,32 @@ matrix_type * obs_data_allocD(const obs_data_type * obs_data , const matrix_type
 
 
 
-matrix_type * obs_data_allocR(const obs_data_type * obs_data) {
-  int active_size = obs_data_get_active_size( obs_data );
-  matrix_type * R = matrix_alloc( active_size , active_size );
-  {
-    int obs_offset = 0;
-    for (int block_nr = 0; block_nr < vector_get_size( obs_data->data ); block_nr++) {
-      const obs_block_type * obs_block = (const obs_block_type *)vector_iget_const( obs_data->data , block_nr);
-      obs_block_initR( obs_block , R , &obs_offset);
-    }
+/*
+  The observation error covariance in block diagonal form; the memory
+  is O(active_size) when no observations have a full error_covar,
+  which is the common case. Observe that the error_covar of a block
+  with error_covar_owner == true is discarded after this, i.e. R can
+  only be assembled once - with either obs_data_alloc_block_R() or
+  obs_data_allocR().
+*/
+
+block_diag_matrix_type * obs_data_alloc_block_R(const obs_data_type * obs_data) {
+  block_diag_matrix_type * R = block_diag_matrix_alloc( );
+
+  for (int block_nr = 0; block_nr < vector_get_size( obs_data->data ); block_nr++) {
+    const obs_block_type * obs_block = (const obs_block_type *)vector_iget_const( obs_data->data , block_nr);
+    obs_block_initR( obs_block , R );
   }
 
+  return R;
+}
+
+
+matrix_type * obs_data_allocR(const obs_data_type * obs_data) {
+  block_diag_matrix_type * block_R = obs_data_alloc_block_R( obs_data );
+  matrix_type * R = block_diag_matrix_alloc_dense( block_R );
+
+  block_diag_matrix_free( block_R );
   matrix_set_name( R , "R");
   matrix_assert_finite( R );
   return R;
@@ -574,6 +675,13 @@ void obs_data_scale_Rmatrix(const obs_data_type * obs_data , matrix_type * R) {
 }
 
 
+void obs_data_scale_block_R(const obs_data_type * obs_data , block_diag_matrix_type * R) {
+  double * scale_factor  = obs_data_alloc_scale_factor( obs_data );
+  block_diag_matrix_scale( R , scale_factor );
+  free( scale_factor );
+}
+
+
 void obs_data_scale(const obs_data_type * obs_data , matrix_type *S , matrix_type *E , matrix_type *D , matrix_type *R , matrix_type * dObs) {
   double * scale_factor  = obs_data_alloc_scale_factor( obs_data );
 
@@ -893,6 +893,50 @@ static double obs_vector_chi2__(const obs_vector_type * obs_vector , int report_
 }
 
 
+double obs_vector_iget_chi2(const obs_vector_type * obs_vector , int report_step , const enkf_node_type * node, node_id_type node_id) {
+  return obs_vector_chi2__( obs_vector , report_step , node , node_id );
+}
+
+
+/**
+   This function will evaluate the chi2 for realization @iens and the
+   report steps [step1,step2] into chi2[step]. The @enkf_node argument
+   must have vector storage and already contain the vector loaded for
+   realization @iens, that way several observations of the same
+   summary key can share one load of the vector. If the vector could
+   not be loaded at all @enkf_node should be NULL.
+
+   Observe that the chi2 pointer is indexed with the report step,
+   i.e. it must have room for at least step2 + 1 elements.
+
+   The return value is false if data is missing for one of the report
+   steps where the observation is active.
+*/
+
+bool obs_vector_vector_chi2(const obs_vector_type * obs_vector ,
+                            const enkf_node_type * enkf_node ,
+                            int iens ,
+                            int step1 ,
+                            int step2 ,
+                            double * chi2) {
+  bool valid = true;
+  node_id_type node_id = {.report_step = 0 , .iens = iens };
+
+  for (int step = step1; step <= step2; step++) {
+    chi2[step] = 0;
+    if (vector_safe_iget( obs_vector->nodes , step ) != NULL) {
+      if (enkf_node && enkf_node_vector_has_data( enkf_node , step )) {
+        node_id.report_step = step;
+        chi2[step] = obs_vector_chi2__( obs_vector , step , enkf_node , node_id );
+      } else
+        valid = false;
+    }
+  }
+
+  return valid;
+}
+
+
 /**
    This function will evaluate the chi2 for the ensemble members
    [iens1,iens2) and report steps [step1,step2).
@@ -900,6 +944,10 @@ static double obs_vector_chi2__(const obs_vector_type * obs_vector , int report_
    Observe that the chi2 pointer is assumed to be allocated for the
    complete ensemble, altough this function only operates on part of
    it.
+
+   For nodes with vector storage the loop runs over realizations, and
+   the vector is loaded only once per realization; for the other node
+   types the node must be loaded for each report step anyway.
 */
 
 
@@ -917,24 +965,39 @@ void obs_vector_ensemble_chi2(const obs_vector_type * obs_vector ,
   int step;
   enkf_node_type * enkf_node = enkf_node_alloc( obs_vector->config_node );
   node_id_type node_id;
-  for (step = step1; step <= step2; step++) {
-    int iens;
-    node_id.report_step = step;
-    {
-      void * obs_node = (void *)vector_iget( obs_vector->nodes , step);
 
-      if (obs_node == NULL) {
-        for (iens = iens1; iens < iens2; iens++)
-          chi2[step][iens] = 0;
-      } else {
-        for (iens = iens1; iens < iens2; iens++) {
-          node_id.iens = iens;
-          if (enkf_node_try_load( enkf_node , fs , node_id))
-            chi2[step][iens] = obs_vector_chi2__(obs_vector , step , enkf_node , node_id);
-          else {
+  if (enkf_node_vector_storage( enkf_node )) {
+    double * member_chi2 = (double *) util_calloc( step2 + 1 , sizeof * member_chi2 );
+    for (int iens = iens1; iens < iens2; iens++) {
+      bool has_vector = enkf_node_try_load_vector( enkf_node , fs , iens );
+      if (!obs_vector_vector_chi2( obs_vector , has_vector ? enkf_node : NULL , iens , step1 , step2 , member_chi2 ))
+        // Missing data - this member will be marked as invalid in the misfit calculations.
+        bool_vector_iset( valid , iens , false );
+
+      for (step = step1; step <= step2; step++)
+        chi2[step][iens] = member_chi2[step];
+    }
+    free( member_chi2 );
+  } else {
+    for (step = step1; step <= step2; step++) {
+      int iens;
+      node_id.report_step = step;
+      {
+        void * obs_node = (void *)vector_iget( obs_vector->nodes , step);
+
+        if (obs_node == NULL) {
+          for (iens = iens1; iens < iens2; iens++)
             chi2[step][iens] = 0;
-            // Missing data - this member will be marked as invalid in the misfit calculations.
-            bool_vector_iset( valid , iens , false );
+        } else {
+          for (iens = iens1; iens < iens2; iens++) {
+            node_id.iens = iens;
+            if (enkf_node_try_load( enkf_node , fs , node_id))
+              chi2[step][iens] = obs_vector_chi2__(obs_vector , step , enkf_node , node_id);
+            else {
+              chi2[step][iens] = 0;
+              // Missing data - this member will be marked as invalid in the misfit calculations.
+              bool_vector_iset( valid , iens , false );
+            }
           }
         }
       }
@@ -955,15 +1018,27 @@ double obs_vector_total_chi2(const obs_vector_type * obs_vector , enkf_fs_type *
   double sum_chi2 = 0;
   enkf_node_type * enkf_node = enkf_node_deep_alloc( obs_vector->config_node );
   node_id_type node_id = {.report_step = 0, .iens = iens };
-
   int vec_size = vector_get_size( obs_vector->nodes );
-  for (int report_step = 0; report_step < vec_size; report_step++) {
-    if (vector_iget(obs_vector->nodes , report_step) != NULL) {
-      node_id.report_step = report_step;
 
-      if (enkf_node_try_load( enkf_node , fs , node_id))
-        sum_chi2 += obs_vector_chi2__(obs_vector , report_step , enkf_node, node_id);
+  if (enkf_node_vector_storage( enkf_node )) {
+    if (enkf_node_try_load_vector( enkf_node , fs , iens )) {
+      for (int report_step = 0; report_step < vec_size; report_step++) {
+        if (vector_iget(obs_vector->nodes , report_step) != NULL) {
+          node_id.report_step = report_step;
+          if (enkf_node_vector_has_data( enkf_node , report_step ))
+            sum_chi2 += obs_vector_chi2__(obs_vector , report_step , enkf_node, node_id);
+        }
+      }
+    }
+  } else {
+    for (int report_step = 0; report_step < vec_size; report_step++) {
+      if (vector_iget(obs_vector->nodes , report_step) != NULL) {
+        node_id.report_step = report_step;
+
+        if (enkf_node_try_load( enkf_node , fs , node_id))
+          sum_chi2 += obs_vector_chi2__(obs_vector , report_step , enkf_node, node_id);
 
+      }
     }
   }
   enkf_node_free( enkf_node );
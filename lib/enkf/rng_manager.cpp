@@ -18,6 +18,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <ert/util/rng.h>
 #include <ert/util/vector.h>
@@ -33,6 +34,7 @@ struct rng_manager_struct {
   rng_type    * internal_seed_rng;   /* This is used to seed the RNG's which are managed. */
   rng_type    * external_seed_rng;   /* This is used to seed the RNG's which are managed by external scope. */
   vector_type * rng_list;
+  pthread_mutex_t mutex;             /* Protects the growth of rng_list and the use of the seed rng's. */
 };
 
 
@@ -42,6 +44,7 @@ static rng_manager_type * rng_manager_alloc__(rng_init_mode init_mode) {
   rng_manager_type * rng_manager = (rng_manager_type *)util_malloc( sizeof * rng_manager );
   UTIL_TYPE_ID_INIT( rng_manager, RNG_MANAGER_TYPE_ID );
   rng_manager->rng_list = vector_alloc_new( );
+  pthread_mutex_init( &rng_manager->mutex , NULL );
   rng_manager->rng_alg = MZRAN;
   rng_manager->internal_seed_rng = rng_alloc( rng_manager->rng_alg, init_mode );
   rng_manager->external_seed_rng = rng_alloc( rng_manager->rng_alg, init_mode );
@@ -97,6 +100,7 @@ void rng_manager_free( rng_manager_type * rng_manager ) {
   vector_free( rng_manager->rng_list );
   rng_free( rng_manager->internal_seed_rng );
   rng_free( rng_manager->external_seed_rng );
+  pthread_mutex_destroy( &rng_manager->mutex );
   free( rng_manager );
 }
 
@@ -113,16 +117,31 @@ static void rng_manager_grow(rng_manager_type * rng_manager, int min_size) {
 
 rng_type * rng_manager_alloc_rng(rng_manager_type * rng_manager) {
   rng_type * rng = rng_alloc( rng_manager->rng_alg, INIT_DEFAULT );
+  pthread_mutex_lock( &rng_manager->mutex );
   rng_rng_init( rng, rng_manager->external_seed_rng );
+  pthread_mutex_unlock( &rng_manager->mutex );
   return rng;
 }
 
 
+/*
+  The rng instances are created in index order from the internal seed
+  rng, so the state of rng number i does not depend on the order in
+  which they are requested. The function can be called concurrently
+  from several threads; the returned rng should only be used by one
+  thread at a time.
+*/
+
 rng_type * rng_manager_iget(rng_manager_type * rng_manager, int index) {
+  rng_type * rng;
+
+  pthread_mutex_lock( &rng_manager->mutex );
   if (index >= vector_get_size( rng_manager->rng_list ))
     rng_manager_grow( rng_manager, index + 1);
 
-  return (rng_type * ) vector_iget( rng_manager->rng_list , index );
+  rng = (rng_type * ) vector_iget( rng_manager->rng_list , index );
+  pthread_mutex_unlock( &rng_manager->mutex );
+  return rng;
 }
 
 
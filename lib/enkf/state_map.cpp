@@ -31,9 +31,19 @@
 
 #define STATE_MAP_TYPE_ID 500672132
 
+/*
+  In addition to the state of each realisation the state_map counts
+  the number of updates to each realisation since the map was
+  allocated or read from disk; the counters are not persisted.
+  Consumers which cache results derived from the realisations, e.g.
+  the misfit table, can compare these counters with a snapshot to
+  find the realisations which have changed.
+*/
+
 struct state_map_struct {
   UTIL_TYPE_ID_DECLARATION;
   int_vector_type  * state;
+  int_vector_type  * change_count;
   pthread_rwlock_t mutable rw_lock;
   bool               read_only;
 };
@@ -46,6 +56,7 @@ state_map_type * state_map_alloc( ) {
   state_map_type * map = (state_map_type *)util_malloc( sizeof * map );
   UTIL_TYPE_ID_INIT( map , STATE_MAP_TYPE_ID );
   map->state = int_vector_alloc( 0 , STATE_UNDEFINED );
+  map->change_count = int_vector_alloc( 0 , 0 );
   pthread_rwlock_init( &map->rw_lock , NULL);
   map->read_only = false;
   return map;
@@ -82,6 +93,7 @@ state_map_type * state_map_alloc_copy(const state_map_type * map) {
 
 void state_map_free( state_map_type * map ) {
   int_vector_free( map->state );
+  int_vector_free( map->change_count );
   free( map );
 }
 
@@ -152,9 +164,10 @@ static void state_map_assert_writable( const state_map_type * map) {
 static void state_map_iset__( state_map_type * map , int index , realisation_state_enum new_state) {
   realisation_state_enum current_state = (realisation_state_enum ) int_vector_safe_iget( map->state , index );
 
-  if (state_map_legal_transition( current_state , new_state ))
+  if (state_map_legal_transition( current_state , new_state )) {
     int_vector_iset( map->state , index , new_state);
-  else
+    int_vector_iset( map->change_count , index , int_vector_safe_iget( map->change_count , index ) + 1);
+  } else
     util_abort("%s: illegal state transition for realisation:%d %d -> %d \n" , __func__ , index , current_state , new_state );
 }
 
@@ -211,11 +224,30 @@ bool state_map_fread( state_map_type * map , const char * filename) {
       file_exists = true;
     } else
       int_vector_reset( map->state );
+
+    int_vector_reset( map->change_count );
   }
   pthread_rwlock_unlock( &map->rw_lock );
   return file_exists;
 }
 
+
+/*
+  The number of updates of realisation @index since the state_map was
+  allocated or read from disk; see the comment at the top of the file.
+*/
+
+int state_map_iget_change_count( const state_map_type * map , int index ) {
+  int change_count;
+  pthread_rwlock_rdlock( &map->rw_lock );
+  {
+    change_count = int_vector_safe_iget( map->change_count , index );
+  }
+  pthread_rwlock_unlock( &map->rw_lock );
+  return change_count;
+}
+
+
 /*
   NB: This function does *not* resize select_target vector; i.e. realizations
   beyond the size of the select_target vector will not be selected.
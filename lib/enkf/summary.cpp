@@ -39,8 +39,6 @@
 
 /*****************************************************************/
 
-#define SUMMARY_UNDEF -9999
-
 struct summary_struct {
   int                   __type_id;   /* Only used for run_time checking. */
   summary_config_type * config;      /* Can not be NULL - var_type is set on first load. */
@@ -123,16 +121,27 @@ void summary_read_from_buffer(summary_type * summary,
 }
 
 
+/*
+  Writes a data vector in the format expected by
+  summary_read_from_buffer(); also used when the vector is read
+  directly from the summary files, see summary_ref.cpp.
+*/
+
+void summary_fwrite_data_vector(buffer_type * buffer, const double_vector_type * data_vector) {
+  buffer_fwrite_int( buffer, SUMMARY );
+  buffer_fwrite_int( buffer, double_vector_size(data_vector));
+  buffer_fwrite_double( buffer, double_vector_get_default(data_vector));
+  buffer_fwrite( buffer,
+                 double_vector_get_ptr(data_vector),
+                 double_vector_element_size(data_vector),
+                 double_vector_size(data_vector));
+}
+
+
 bool summary_write_to_buffer(const summary_type * summary,
                              buffer_type * buffer,
                              int report_step) {
-  buffer_fwrite_int( buffer, SUMMARY );
-  buffer_fwrite_int( buffer, double_vector_size(summary->data_vector));
-  buffer_fwrite_double( buffer, double_vector_get_default(summary->data_vector));
-  buffer_fwrite( buffer,
-                 double_vector_get_ptr(summary->data_vector),
-                 double_vector_element_size(summary->data_vector),
-                 double_vector_size(summary->data_vector));
+  summary_fwrite_data_vector( buffer, summary->data_vector );
   return true;
 }
 
@@ -350,6 +359,54 @@ bool summary_forward_load_vector(summary_type * summary,
 }
 
 
+/*
+  The summary_forward_load_vector() function looks up the last
+  ministep of every report step for each vector it loads. When many
+  vectors are loaded from the same ecl_sum instance that lookup can be
+  done once, with summary_alloc_ministep_index(), and the vectors can
+  then be filled with summary_forward_load_ministeps().
+*/
+
+int_vector_type * summary_alloc_ministep_index(const ecl_sum_type * ecl_sum,
+                                               const int_vector_type * time_index) {
+  int_vector_type * ministep_index = int_vector_alloc( int_vector_size( time_index ), -1 );
+
+  for (int store_index = 0; store_index < int_vector_size( time_index ); store_index++) {
+    int summary_index = int_vector_iget( time_index, store_index );
+
+    if (summary_index >= 0 && ecl_sum_has_report_step( ecl_sum, summary_index ))
+      int_vector_iset( ministep_index, store_index, ecl_sum_iget_report_end( ecl_sum, summary_index ));
+  }
+  return ministep_index;
+}
+
+
+/*
+  Returns false, without touching the data, if the ecl_sum instance
+  does not have the variable; the caller should then fall back to
+  summary_forward_load_vector() which handles the load_fail_mode.
+*/
+
+bool summary_forward_load_ministeps(summary_type * summary,
+                                    const ecl_sum_type * ecl_sum,
+                                    const int_vector_type * ministep_index) {
+  const char * var_key = summary_config_get_var(summary->config);
+  if (!ecl_sum_has_general_var(ecl_sum, var_key))
+    return false;
+
+  int key_index = ecl_sum_get_general_var_params_index( ecl_sum, var_key );
+  for (int store_index = 0; store_index < int_vector_size( ministep_index ); store_index++) {
+    int ministep = int_vector_iget( ministep_index, store_index );
+
+    if (ministep >= 0)
+      double_vector_iset( summary->data_vector,
+                          store_index,
+                          ecl_sum_iget( ecl_sum, ministep, key_index ));
+  }
+  return true;
+}
+
+
 /******************************************************************/
 /* Anonymously generated functions used by the enkf_node object   */
 /******************************************************************/
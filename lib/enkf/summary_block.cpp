@@ -0,0 +1,453 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'summary_block.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_block.hpp>
+
+/*
+  This file implements the columnar storage of summary vectors which is
+  used with COLUMNAR_SUMMARY_STORAGE. Instead of storing every summary
+  vector of a realization as a separate blob, the vectors are stored in
+  blocks of at most SUMMARY_BLOCK_CHUNK_SIZE keys; each block is a
+  time x key matrix of floats, i.e. the values for one report step are
+  contiguous. Reading one report step across all the keys of a
+  realization then touches one blob per block, and reading one key
+  reads one block.
+
+  There are three types in this file:
+
+    summary_block: One block, i.e. the matrix, the length of each
+       vector and the default value of each vector. The values are
+       stored as float, which is also the precision of the summary
+       files.
+
+    summary_block_keys: The dictionary of summary keys, shared by all
+       the realizations of a case. The key ids are assigned when a key
+       is first stored and never change.
+
+    summary_block_index: One for each realization; for each key id the
+       block and the column in that block where the vector is stored.
+       When a key is stored again the old column is dropped, and blocks
+       without any columns left are released so that the caller can
+       remove them.
+
+  The actual reading and writing of the blocks, and the caching of
+  them, is done by enkf_fs.
+*/
+
+#define SUMMARY_BLOCK_TYPE_ID        66151045
+#define SUMMARY_BLOCK_INDEX_TYPE_ID  66151046
+
+struct summary_block_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  time_t               write_time;
+  int                  num_steps;
+  int                  num_columns;
+  std::vector<int>     size;            /* The size of the vector in each column. */
+  std::vector<double>  default_value;   /* The default value of the vector in each column. */
+  std::vector<float>   data;            /* data[step * num_columns + column] */
+};
+
+
+struct summary_block_keys_struct {
+  pthread_mutex_t                         mutex;
+  std::vector<std::string>                keys;
+  std::unordered_map<std::string, int>    key_id;
+};
+
+
+struct summary_block_location {
+  int block_id;
+  int column;
+};
+
+
+struct summary_block_index_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  std::map<int, summary_block_location>   location;     /* key_id -> location */
+  std::map<int, int>                      live_count;   /* block_id -> number of keys still stored in the block. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( summary_block , SUMMARY_BLOCK_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( summary_block , SUMMARY_BLOCK_TYPE_ID )
+UTIL_IS_INSTANCE_FUNCTION( summary_block_index , SUMMARY_BLOCK_INDEX_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( summary_block_index , SUMMARY_BLOCK_INDEX_TYPE_ID )
+
+
+/*****************************************************************/
+
+static summary_block_type * summary_block_alloc_empty( int num_steps , int num_columns , time_t write_time ) {
+  summary_block_type * block = new summary_block_type();
+  UTIL_TYPE_ID_INIT( block , SUMMARY_BLOCK_TYPE_ID );
+  block->write_time  = write_time;
+  block->num_steps   = num_steps;
+  block->num_columns = num_columns;
+  block->size.resize( num_columns , 0 );
+  block->default_value.resize( num_columns , SUMMARY_UNDEF );
+  block->data.resize( (size_t) num_steps * num_columns , SUMMARY_UNDEF );
+  return block;
+}
+
+
+/*
+  Creates a block from the double_vector instances with index
+  [offset, offset + num_columns) in @data_vectors.
+*/
+
+summary_block_type * summary_block_alloc( const vector_type * data_vectors , int offset , int num_columns , time_t write_time ) {
+  int num_steps = 0;
+  for (int column = 0; column < num_columns; column++) {
+    const double_vector_type * values = (const double_vector_type *) vector_iget_const( data_vectors , offset + column );
+    num_steps = util_int_max( num_steps , double_vector_size( values ));
+  }
+
+  {
+    summary_block_type * block = summary_block_alloc_empty( num_steps , num_columns , write_time );
+    for (int column = 0; column < num_columns; column++) {
+      const double_vector_type * values = (const double_vector_type *) vector_iget_const( data_vectors , offset + column );
+      const double * values_ptr = double_vector_get_const_ptr( values );
+      int size = double_vector_size( values );
+      double default_value = double_vector_get_default( values );
+
+      block->size[column] = size;
+      block->default_value[column] = default_value;
+      for (int step = 0; step < num_steps; step++)
+        block->data[(size_t) step * num_columns + column] = (float) ((step < size) ? values_ptr[step] : default_value);
+    }
+    return block;
+  }
+}
+
+
+summary_block_type * summary_block_fread_alloc( buffer_type * buffer ) {
+  time_t write_time = buffer_fread_time_t( buffer );
+  int num_steps     = buffer_fread_int( buffer );
+  int num_columns   = buffer_fread_int( buffer );
+  summary_block_type * block = summary_block_alloc_empty( num_steps , num_columns , write_time );
+
+  buffer_fread( buffer , block->size.data() , sizeof(int) , num_columns );
+  buffer_fread( buffer , block->default_value.data() , sizeof(double) , num_columns );
+  buffer_fread( buffer , block->data.data() , sizeof(float) , block->data.size() );
+  return block;
+}
+
+
+void summary_block_fwrite( const summary_block_type * block , buffer_type * buffer ) {
+  buffer_fwrite_time_t( buffer , block->write_time );
+  buffer_fwrite_int( buffer , block->num_steps );
+  buffer_fwrite_int( buffer , block->num_columns );
+  buffer_fwrite( buffer , block->size.data() , sizeof(int) , block->num_columns );
+  buffer_fwrite( buffer , block->default_value.data() , sizeof(double) , block->num_columns );
+  buffer_fwrite( buffer , block->data.data() , sizeof(float) , block->data.size() );
+}
+
+
+void summary_block_free( summary_block_type * block ) {
+  delete block;
+}
+
+
+void summary_block_free__( void * arg ) {
+  summary_block_free( summary_block_safe_cast( arg ));
+}
+
+
+int summary_block_get_num_steps( const summary_block_type * block ) {
+  return block->num_steps;
+}
+
+
+int summary_block_get_num_columns( const summary_block_type * block ) {
+  return block->num_columns;
+}
+
+
+double summary_block_iget( const summary_block_type * block , int step , int column ) {
+  if (step < block->size[column])
+    return block->data[(size_t) step * block->num_columns + column];
+  else
+    return block->default_value[column];
+}
+
+
+void summary_block_iget_column( const summary_block_type * block , int column , double_vector_type * values ) {
+  int size = block->size[column];
+  double_vector_set_default( values , block->default_value[column] );
+  double_vector_resize( values , size , block->default_value[column] );
+  {
+    double * values_ptr = double_vector_get_ptr( values );
+    for (int step = 0; step < size; step++)
+      values_ptr[step] = block->data[(size_t) step * block->num_columns + column];
+  }
+}
+
+
+/*
+  Writes one column to @buffer in the same format as a summary vector
+  which has been stored on its own, i.e. it can be read with
+  summary_read_from_buffer().
+*/
+
+void summary_block_fwrite_column( const summary_block_type * block , int column , buffer_type * buffer ) {
+  double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+  summary_block_iget_column( block , column , values );
+
+  buffer_clear( buffer );
+  buffer_fwrite_time_t( buffer , block->write_time );
+  summary_fwrite_data_vector( buffer , values );
+  buffer_rewind( buffer );
+
+  double_vector_free( values );
+}
+
+
+/*****************************************************************/
+
+summary_block_keys_type * summary_block_keys_alloc( ) {
+  summary_block_keys_type * keys = new summary_block_keys_type();
+  pthread_mutex_init( &keys->mutex , NULL );
+  return keys;
+}
+
+
+void summary_block_keys_free( summary_block_keys_type * keys ) {
+  pthread_mutex_destroy( &keys->mutex );
+  delete keys;
+}
+
+
+void summary_block_keys_fread( summary_block_keys_type * keys , FILE * stream ) {
+  int size = util_fread_int( stream );
+  pthread_mutex_lock( &keys->mutex );
+  keys->keys.clear();
+  keys->key_id.clear();
+  for (int id = 0; id < size; id++) {
+    char * key = util_fread_alloc_string( stream );
+    keys->keys.push_back( key );
+    keys->key_id[ key ] = id;
+    free( key );
+  }
+  pthread_mutex_unlock( &keys->mutex );
+}
+
+
+void summary_block_keys_fwrite( const summary_block_keys_type * keys , FILE * stream ) {
+  pthread_mutex_lock( (pthread_mutex_t *) &keys->mutex );
+  util_fwrite_int( keys->keys.size() , stream );
+  for (const auto& key : keys->keys)
+    util_fwrite_string( key.c_str() , stream );
+  pthread_mutex_unlock( (pthread_mutex_t *) &keys->mutex );
+}
+
+
+int summary_block_keys_get_size( const summary_block_keys_type * keys ) {
+  int size;
+  pthread_mutex_lock( (pthread_mutex_t *) &keys->mutex );
+  size = keys->keys.size();
+  pthread_mutex_unlock( (pthread_mutex_t *) &keys->mutex );
+  return size;
+}
+
+
+/*
+  Returns the id of @key, or -1 if the key has never been stored.
+*/
+
+int summary_block_keys_get_id( const summary_block_keys_type * keys , const char * key ) {
+  int id = -1;
+  pthread_mutex_lock( (pthread_mutex_t *) &keys->mutex );
+  {
+    const auto iter = keys->key_id.find( key );
+    if (iter != keys->key_id.end())
+      id = iter->second;
+  }
+  pthread_mutex_unlock( (pthread_mutex_t *) &keys->mutex );
+  return id;
+}
+
+
+/*
+  Returns the id of @key, the key is added to the dictionary if it is
+  not already there.
+*/
+
+int summary_block_keys_add_key( summary_block_keys_type * keys , const char * key ) {
+  int id;
+  pthread_mutex_lock( &keys->mutex );
+  {
+    const auto iter = keys->key_id.find( key );
+    if (iter != keys->key_id.end())
+      id = iter->second;
+    else {
+      id = keys->keys.size();
+      keys->keys.push_back( key );
+      keys->key_id[ key ] = id;
+    }
+  }
+  pthread_mutex_unlock( &keys->mutex );
+  return id;
+}
+
+
+/*****************************************************************/
+
+summary_block_index_type * summary_block_index_alloc( ) {
+  summary_block_index_type * index = new summary_block_index_type();
+  UTIL_TYPE_ID_INIT( index , SUMMARY_BLOCK_INDEX_TYPE_ID );
+  return index;
+}
+
+
+summary_block_index_type * summary_block_index_fread_alloc( buffer_type * buffer ) {
+  summary_block_index_type * index = summary_block_index_alloc( );
+  int size = buffer_fread_int( buffer );
+  for (int i = 0; i < size; i++) {
+    int key_id = buffer_fread_int( buffer );
+    summary_block_location location;
+    location.block_id = buffer_fread_int( buffer );
+    location.column   = buffer_fread_int( buffer );
+
+    index->location[key_id] = location;
+    index->live_count[location.block_id] += 1;
+  }
+  return index;
+}
+
+
+void summary_block_index_fwrite( const summary_block_index_type * index , buffer_type * buffer ) {
+  buffer_fwrite_int( buffer , index->location.size() );
+  for (const auto& iter : index->location) {
+    buffer_fwrite_int( buffer , iter.first );
+    buffer_fwrite_int( buffer , iter.second.block_id );
+    buffer_fwrite_int( buffer , iter.second.column );
+  }
+}
+
+
+void summary_block_index_free( summary_block_index_type * index ) {
+  delete index;
+}
+
+
+void summary_block_index_free__( void * arg ) {
+  summary_block_index_free( summary_block_index_safe_cast( arg ));
+}
+
+
+int summary_block_index_get_size( const summary_block_index_type * index ) {
+  return index->location.size();
+}
+
+
+int summary_block_index_get_num_blocks( const summary_block_index_type * index ) {
+  return index->live_count.size();
+}
+
+
+bool summary_block_index_get( const summary_block_index_type * index , int key_id , int * block_id , int * column ) {
+  const auto iter = index->location.find( key_id );
+  if (iter == index->location.end())
+    return false;
+
+  *block_id = iter->second.block_id;
+  *column   = iter->second.column;
+  return true;
+}
+
+
+/*
+  Returns the smallest block id which is not in use and not in
+  @exclude, that way the ids of released blocks are reused and the
+  number of blobs does not grow when the realization is loaded again.
+  The caller should exclude the blocks released since the index was
+  last stored; until the index has been stored those blocks must keep
+  their content.
+*/
+
+int summary_block_index_alloc_block_id( const summary_block_index_type * index , const int_vector_type * exclude ) {
+  int block_id = 0;
+  while ((index->live_count.count( block_id ) > 0) || (int_vector_contains( exclude , block_id )))
+    block_id++;
+  return block_id;
+}
+
+
+static void summary_block_index_drop_location( summary_block_index_type * index , int block_id , int_vector_type * released ) {
+  auto iter = index->live_count.find( block_id );
+  iter->second -= 1;
+  if (iter->second == 0) {
+    index->live_count.erase( iter );
+    int_vector_append( released , block_id );
+  }
+}
+
+
+/*
+  Registers that the keys in @key_ids are stored in the columns of
+  block @block_id. Blocks which no longer hold any keys are appended
+  to @released.
+*/
+
+void summary_block_index_add_block( summary_block_index_type * index , int block_id , const int_vector_type * key_ids , int_vector_type * released ) {
+  if (index->live_count.count( block_id ) > 0)
+    util_abort("%s: block:%d is already in use\n",__func__ , block_id );
+
+  {
+    int live_count = 0;
+    for (int column = 0; column < int_vector_size( key_ids ); column++) {
+      int key_id = int_vector_iget( key_ids , column );
+      auto iter = index->location.find( key_id );
+
+      if (iter != index->location.end()) {
+        if (iter->second.block_id == block_id)
+          live_count--;    /* The same key twice in one block; the last column wins. */
+        else
+          summary_block_index_drop_location( index , iter->second.block_id , released );
+      }
+
+      index->location[key_id] = { block_id , column };
+      live_count++;
+    }
+
+    if (live_count > 0)
+      index->live_count[block_id] = live_count;
+  }
+}
+
+
+bool summary_block_index_remove_key( summary_block_index_type * index , int key_id , int_vector_type * released ) {
+  auto iter = index->location.find( key_id );
+  if (iter == index->location.end())
+    return false;
+
+  summary_block_index_drop_location( index , iter->second.block_id , released );
+  index->location.erase( iter );
+  return true;
+}
@@ -2,36 +2,104 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
 
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/type_macros.h>
 
+#include <ert/ecl/ecl_smspec.hpp>
+
 #include <ert/enkf/enkf_types.hpp>
 
 
 
 #define SUMMARY_KEY_MATCHER_TYPE_ID 700672137
 
+/*
+  The matcher is consulted for every node in the SMSPEC file of every
+  realization when the summary results are loaded. To make that
+  cheap:
+
+    1. Keys without wildcard characters are matched with a hash
+       lookup, and only the wildcard patterns are passed to
+       util_fnmatch(). Each pattern is stored with the length of its
+       literal prefix, so most keys are rejected with a strncmp().
+
+    2. The list of matching node indices is cached per SMSPEC layout;
+       since all the realizations normally share the same layout, the
+       patterns are only evaluated when loading the first realization.
+       The layout is identified by the number of nodes and a 64 bit
+       FNV-1a hash of the gen_key1 values, so a lookup does not compare
+       or store the keys. The smspec pointer can not be used as key;
+       every realization has its own smspec instance, and the address
+       of a freed instance is reused for a new one.
+
+  The compiled patterns and the cache are rebuilt / cleared when a
+  new key is added.
+*/
+
+#define SUMMARY_KEY_MATCHER_MAX_LAYOUTS 8
+
+typedef struct {
+  std::string   pattern;
+  size_t        prefix_length;
+} summary_key_pattern_type;
+
+typedef struct {
+  uint64_t                  layout_hash;   /* Hash of the gen_key1 values of the SMSPEC nodes, in node index order. */
+  int                       num_nodes;
+  std::vector<int>          matches;       /* The node indices which matched. */
+} summary_key_layout_match_type;
+
+typedef struct {
+  pthread_mutex_t                              mutex;
+  std::vector<summary_key_layout_match_type>   layouts;
+  size_t                                       next_replace;
+} summary_key_match_cache_type;
+
+
 struct summary_key_matcher_struct {
   UTIL_TYPE_ID_DECLARATION;
-  hash_type        * key_set;
+  hash_type                              * key_set;
+  hash_type                              * exact_keys;
+  std::vector<summary_key_pattern_type>  * patterns;
+  summary_key_match_cache_type           * cache;
 };
 
 
 UTIL_IS_INSTANCE_FUNCTION( summary_key_matcher , SUMMARY_KEY_MATCHER_TYPE_ID )
 
 
+static size_t summary_key_matcher_literal_prefix( const char * pattern ) {
+  return strcspn( pattern , "*?[\\" );
+}
+
+
 summary_key_matcher_type * summary_key_matcher_alloc() {
   summary_key_matcher_type * matcher = (summary_key_matcher_type *)util_malloc(sizeof * matcher);
   UTIL_TYPE_ID_INIT( matcher , SUMMARY_KEY_MATCHER_TYPE_ID);
   matcher->key_set = hash_alloc();
+  matcher->exact_keys = hash_alloc();
+  matcher->patterns = new std::vector<summary_key_pattern_type>();
+  matcher->cache = new summary_key_match_cache_type();
+  matcher->cache->next_replace = 0;
+  pthread_mutex_init( &matcher->cache->mutex , NULL );
   return matcher;
 }
 
 void summary_key_matcher_free(summary_key_matcher_type * matcher) {
     hash_free(matcher->key_set);
+    hash_free(matcher->exact_keys);
+    delete matcher->patterns;
+    pthread_mutex_destroy( &matcher->cache->mutex );
+    delete matcher->cache;
     free(matcher);
 }
 
@@ -41,26 +109,138 @@ int summary_key_matcher_get_size(const summary_key_matcher_type * matcher) {
 
 void summary_key_matcher_add_summary_key(summary_key_matcher_type * matcher, const char * summary_key) {
     if(!hash_has_key(matcher->key_set, summary_key)) {
+        size_t prefix_length = summary_key_matcher_literal_prefix( summary_key );
+
         hash_insert_int(matcher->key_set, summary_key, !util_string_has_wildcard(summary_key));
+        if (prefix_length == strlen(summary_key))
+            hash_insert_int(matcher->exact_keys, summary_key, 1);
+        else {
+            summary_key_pattern_type pattern;
+            pattern.pattern = summary_key;
+            pattern.prefix_length = prefix_length;
+            matcher->patterns->push_back( pattern );
+        }
+
+        pthread_mutex_lock( &matcher->cache->mutex );
+        matcher->cache->layouts.clear();
+        matcher->cache->next_replace = 0;
+        pthread_mutex_unlock( &matcher->cache->mutex );
     }
 }
 
 bool summary_key_matcher_match_summary_key(const summary_key_matcher_type * matcher, const char * summary_key) {
-    stringlist_type * keys = hash_alloc_stringlist(matcher->key_set);
-    bool has_key = false;
-
-    for (int i = 0; i < stringlist_get_size(keys); i++) {
-        const char * pattern = stringlist_iget(keys, i);
-        if (summary_key)
-            if(util_fnmatch(pattern, summary_key) == 0) {
-               has_key = true;
-               break;
+    if (!summary_key)
+        return false;
+
+    if (hash_has_key(matcher->exact_keys, summary_key))
+        return true;
+
+    for (const auto& pattern : *matcher->patterns) {
+        if (strncmp(pattern.pattern.c_str(), summary_key, pattern.prefix_length) != 0)
+            continue;
+
+        if (util_fnmatch(pattern.pattern.c_str(), summary_key) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+
+static uint64_t summary_key_matcher_layout_hash( const ecl_smspec_type * smspec ) {
+  uint64_t hash = 14695981039346656037ULL;
+  int num_nodes = ecl_smspec_num_nodes( smspec );
+
+  for (int i = 0; i < num_nodes; i++) {
+    const char * key = ecl_smspec_iget_node_w_node_index( smspec , i ).get_gen_key1();
+    if (key) {
+      for (const char * c = key; *c; c++) {
+        hash ^= (unsigned char) *c;
+        hash *= 1099511628211ULL;
+      }
+    }
+    /* The terminating '\0' is included, so that e.g. "AB","C" and "A","BC" differ. */
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+
+/* Must hold the cache mutex. */
+static const summary_key_layout_match_type * summary_key_matcher_find_layout( const summary_key_match_cache_type * cache , uint64_t layout_hash , int num_nodes) {
+  for (const auto& layout_match : cache->layouts) {
+    if (layout_match.layout_hash == layout_hash && layout_match.num_nodes == num_nodes)
+      return &layout_match;
+  }
+  return NULL;
+}
+
+
+/*
+  Returns a newly allocated list of the node indices in @smspec whose
+  gen_key1 is matched by the matcher. The result is cached on the
+  layout of @smspec, so the patterns are only evaluated the first time
+  a layout is seen; it is safe to call this function concurrently.
+*/
+
+int_vector_type * summary_key_matcher_alloc_smspec_matches(const summary_key_matcher_type * matcher, const ecl_smspec_type * smspec) {
+    summary_key_match_cache_type * cache = matcher->cache;
+    int_vector_type * matches = int_vector_alloc(0, 0);
+    uint64_t layout_hash = summary_key_matcher_layout_hash( smspec );
+    int num_nodes = ecl_smspec_num_nodes( smspec );
+
+    pthread_mutex_lock( &cache->mutex );
+    {
+        const summary_key_layout_match_type * layout_match = summary_key_matcher_find_layout( cache , layout_hash , num_nodes );
+        if (layout_match) {
+            for (int index : layout_match->matches)
+                int_vector_append( matches , index );
+            pthread_mutex_unlock( &cache->mutex );
+            return matches;
         }
     }
+    pthread_mutex_unlock( &cache->mutex );
+
+    {
+        summary_key_layout_match_type layout_match;
+
+        layout_match.layout_hash = layout_hash;
+        layout_match.num_nodes = num_nodes;
+        for (int i = 0; i < num_nodes; i++) {
+            const char * key = ecl_smspec_iget_node_w_node_index( smspec , i ).get_gen_key1();
+
+            if (summary_key_matcher_match_summary_key( matcher , key )) {
+                layout_match.matches.push_back( i );
+                int_vector_append( matches , i );
+            }
+        }
+
+        pthread_mutex_lock( &cache->mutex );
+        if (!summary_key_matcher_find_layout( cache , layout_hash , num_nodes )) {
+            if (cache->layouts.size() < SUMMARY_KEY_MATCHER_MAX_LAYOUTS)
+                cache->layouts.push_back( layout_match );
+            else {
+                cache->layouts[ cache->next_replace ] = layout_match;
+                cache->next_replace = (cache->next_replace + 1) % SUMMARY_KEY_MATCHER_MAX_LAYOUTS;
+            }
+        }
+        pthread_mutex_unlock( &cache->mutex );
+    }
+
+    return matches;
+}
+
+
+bool summary_key_matcher_has_cached_layout(const summary_key_matcher_type * matcher, const ecl_smspec_type * smspec) {
+    summary_key_match_cache_type * cache = matcher->cache;
+    uint64_t layout_hash = summary_key_matcher_layout_hash( smspec );
+    bool cached;
 
-    stringlist_free(keys);
+    pthread_mutex_lock( &cache->mutex );
+    cached = (summary_key_matcher_find_layout( cache , layout_hash , ecl_smspec_num_nodes( smspec )) != NULL);
+    pthread_mutex_unlock( &cache->mutex );
 
-    return has_key;
+    return cached;
 }
 
 stringlist_type * summary_key_matcher_get_keys(const summary_key_matcher_type * matcher) {
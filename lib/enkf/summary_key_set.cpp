@@ -97,6 +97,45 @@ bool summary_key_set_add_summary_key(summary_key_set_type * set, const char * su
     return writable_and_non_existent;
 }
 
+/*
+  Adds all the keys in @summary_keys and returns the number of new
+  keys. The set is first checked with the read lock, so the write lock
+  is only taken when there actually is something new to add.
+*/
+
+int summary_key_set_add_summary_keys(summary_key_set_type * set, const stringlist_type * summary_keys) {
+    int new_keys = 0;
+
+    if (set->read_only)
+        return 0;
+
+    pthread_rwlock_rdlock( &set->rw_lock );
+    {
+        for (int i = 0; i < stringlist_get_size(summary_keys); i++) {
+            if (!hash_has_key(set->key_set, stringlist_iget(summary_keys, i)))
+                new_keys++;
+        }
+    }
+    pthread_rwlock_unlock( &set->rw_lock );
+
+    if (new_keys > 0) {
+        new_keys = 0;
+        pthread_rwlock_wrlock( &set->rw_lock );
+        {
+            for (int i = 0; i < stringlist_get_size(summary_keys); i++) {
+                const char * summary_key = stringlist_iget(summary_keys, i);
+                if (!hash_has_key(set->key_set, summary_key)) {
+                    hash_insert_int(set->key_set, summary_key, 1);
+                    new_keys++;
+                }
+            }
+        }
+        pthread_rwlock_unlock( &set->rw_lock );
+    }
+
+    return new_keys;
+}
+
 bool summary_key_set_has_summary_key(summary_key_set_type * set, const char * summary_key) {
     bool has_key = false;
 
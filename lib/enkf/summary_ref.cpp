@@ -0,0 +1,450 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'summary_ref.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_endian_flip.h>
+
+#include <ert/res_util/res_log.hpp>
+
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_ref.hpp>
+
+/*
+  The summary_ref object is used when the results are loaded with
+  LAZY_SUMMARY_LOAD; instead of copying the summary vectors into the
+  storage we record where the vectors can be found in the unified
+  summary file (.UNSMRY) of the realization, and read the values
+  directly from a memory map of that file when they are requested.
+
+  The unified summary file is a sequence of binary fortran keywords;
+  for every ministep there is a PARAMS keyword with one float for every
+  variable in the SMSPEC file. Each keyword is a 16 byte header
+  record followed by the data, which for numeric types is written in
+  records of at most 1000 elements, and everything is big endian. When
+  the reference is created the file is scanned once, and for every
+  report step we store the file offset of the PARAMS data of the last
+  ministep of that report step; a value can then be found with a
+  little arithmetic on the params_index of the variable.
+
+  The size and modification time of the file are recorded, and the
+  reference is considered invalid if the file has been changed or
+  removed afterwards.
+*/
+
+#define SUMMARY_REF_TYPE_ID     66151032
+#define SUMMARY_REF_BLOCK_SIZE  1000        /* Numeric keywords are written in records of 1000 elements. */
+#define SUMMARY_REF_HEADER_SIZE 16
+
+struct summary_ref_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  char                                 * unsmry_file;
+  long                                   file_size;
+  time_t                                 mtime;
+  int                                    params_size;
+  std::vector<long>                      offsets;       /* File offset of the PARAMS data for each report step; -1 if no data. */
+  std::unordered_map<std::string, int>   key_index;     /* key -> params_index. */
+
+  pthread_mutex_t                        map_mutex;
+  bool                                   map_checked;
+  const char                           * map;
+  size_t                                 map_size;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( summary_ref , SUMMARY_REF_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( summary_ref , SUMMARY_REF_TYPE_ID )
+
+
+static summary_ref_type * summary_ref_alloc_empty(const char * unsmry_file) {
+  summary_ref_type * summary_ref = new summary_ref_type();
+  UTIL_TYPE_ID_INIT( summary_ref , SUMMARY_REF_TYPE_ID );
+  summary_ref->unsmry_file = util_alloc_string_copy( unsmry_file );
+  summary_ref->file_size   = 0;
+  summary_ref->mtime       = 0;
+  summary_ref->params_size = 0;
+  summary_ref->map_checked = false;
+  summary_ref->map         = NULL;
+  summary_ref->map_size    = 0;
+  pthread_mutex_init( &summary_ref->map_mutex , NULL );
+  return summary_ref;
+}
+
+
+static void summary_ref_unmap(summary_ref_type * summary_ref) {
+  if (summary_ref->map)
+    munmap( (void *) summary_ref->map , summary_ref->map_size );
+
+  summary_ref->map      = NULL;
+  summary_ref->map_size = 0;
+}
+
+
+/*
+  Maps the file; when @record_stat is true the current size and mtime
+  of the file are recorded, otherwise the file must still have the
+  recorded size and mtime.
+*/
+
+static bool summary_ref_map(summary_ref_type * summary_ref, bool record_stat) {
+  int fd = open( summary_ref->unsmry_file , O_RDONLY );
+  if (fd == -1)
+    return false;
+
+  {
+    struct stat stat_buffer;
+    bool ok = (fstat( fd , &stat_buffer ) == 0) && (stat_buffer.st_size > 0);
+
+    if (ok) {
+      if (record_stat) {
+        summary_ref->file_size = stat_buffer.st_size;
+        summary_ref->mtime     = stat_buffer.st_mtime;
+      } else
+        ok = (summary_ref->file_size == stat_buffer.st_size) && (summary_ref->mtime == stat_buffer.st_mtime);
+    }
+
+    if (ok) {
+      void * map = mmap( NULL , stat_buffer.st_size , PROT_READ , MAP_SHARED , fd , 0 );
+      if (map == MAP_FAILED)
+        ok = false;
+      else {
+        summary_ref->map      = (const char *) map;
+        summary_ref->map_size = stat_buffer.st_size;
+      }
+    }
+
+    close( fd );
+    return ok;
+  }
+}
+
+
+static int summary_ref_iget_int(const char * ptr) {
+  int32_t value;
+  memcpy( &value , ptr , sizeof value );
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( &value , sizeof value , 1 );
+  return value;
+}
+
+
+static float summary_ref_iget_float(const char * ptr) {
+  float value;
+  memcpy( &value , ptr , sizeof value );
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( &value , sizeof value , 1 );
+  return value;
+}
+
+
+static int summary_ref_element_size(const char * type) {
+  if ((strncmp(type , "INTE" , 4) == 0) || (strncmp(type , "REAL" , 4) == 0) || (strncmp(type , "LOGI" , 4) == 0))
+    return 4;
+
+  if ((strncmp(type , "DOUB" , 4) == 0) || (strncmp(type , "CHAR" , 4) == 0))
+    return 8;
+
+  if (strncmp(type , "MESS" , 4) == 0)
+    return 0;
+
+  if (type[0] == 'C' && isdigit(type[1]) && isdigit(type[2]) && isdigit(type[3]))
+    return 100 * (type[1] - '0') + 10 * (type[2] - '0') + (type[3] - '0');
+
+  return -1;
+}
+
+
+/*
+  Scans the memory mapped unified summary file and appends the offset
+  of the data of each PARAMS keyword to @params_offsets. Returns false
+  if the file does not look like an unformatted unified summary file
+  with @params_size variables.
+*/
+
+static bool summary_ref_scan(const summary_ref_type * summary_ref, int params_size, std::vector<long>& params_offsets) {
+  const char * map = summary_ref->map;
+  size_t size = summary_ref->map_size;
+  size_t pos = 0;
+
+  while (pos < size) {
+    if (pos + SUMMARY_REF_HEADER_SIZE + 8 > size)
+      return false;
+
+    if (summary_ref_iget_int( &map[pos] ) != SUMMARY_REF_HEADER_SIZE)
+      return false;
+
+    if (summary_ref_iget_int( &map[pos + 4 + SUMMARY_REF_HEADER_SIZE] ) != SUMMARY_REF_HEADER_SIZE)
+      return false;
+
+    {
+      const char * header = &map[pos + 4];
+      int num_elements = summary_ref_iget_int( &header[8] );
+      int element_size = summary_ref_element_size( &header[12] );
+      bool params = (strncmp( header , "PARAMS  " , 8 ) == 0);
+      long remaining;
+
+      if (element_size < 0 || num_elements < 0)
+        return false;
+
+      pos += SUMMARY_REF_HEADER_SIZE + 8;
+      remaining = (long) num_elements * element_size;
+
+      if (params) {
+        int first_record = 4 * util_int_min( num_elements , SUMMARY_REF_BLOCK_SIZE );
+        if (num_elements != params_size || element_size != 4)
+          return false;
+
+        if (num_elements > 0 && (pos + 4 > size || summary_ref_iget_int( &map[pos] ) != first_record))
+          return false;
+
+        params_offsets.push_back( pos );
+      }
+
+      while (remaining > 0) {
+        int record_size;
+        if (pos + 4 > size)
+          return false;
+
+        record_size = summary_ref_iget_int( &map[pos] );
+        if (record_size <= 0 || pos + record_size + 8 > size)
+          return false;
+
+        if (summary_ref_iget_int( &map[pos + 4 + record_size] ) != record_size)
+          return false;
+
+        remaining -= record_size;
+        pos += record_size + 8;
+      }
+    }
+  }
+  return true;
+}
+
+
+/*
+  Will return NULL if @unsmry_file can not be used; i.e. if it is not
+  an unformatted unified summary file, or if it does not contain
+  exactly @num_ministeps ministeps with @params_size variables. The
+  @ministep_index vector maps from report step to ministep, as created
+  by summary_alloc_ministep_index().
+*/
+
+summary_ref_type * summary_ref_alloc(const char * unsmry_file, int params_size, int num_ministeps, const int_vector_type * ministep_index) {
+  summary_ref_type * summary_ref = summary_ref_alloc_empty( unsmry_file );
+  std::vector<long> params_offsets;
+  bool ok = summary_ref_map( summary_ref , true );
+
+  if (ok)
+    ok = summary_ref_scan( summary_ref , params_size , params_offsets );
+
+  if (ok)
+    ok = (params_offsets.size() == (size_t) num_ministeps);
+
+  summary_ref_unmap( summary_ref );
+  if (!ok) {
+    summary_ref_free( summary_ref );
+    return NULL;
+  }
+
+  summary_ref->params_size = params_size;
+  for (int report_step = 0; report_step < int_vector_size( ministep_index ); report_step++) {
+    int ministep = int_vector_iget( ministep_index , report_step );
+
+    if (ministep >= 0 && ministep < num_ministeps)
+      summary_ref->offsets.push_back( params_offsets[ministep] );
+    else
+      summary_ref->offsets.push_back( -1 );
+  }
+
+  return summary_ref;
+}
+
+
+summary_ref_type * summary_ref_fread_alloc(const char * filename) {
+  FILE * stream = util_fopen( filename , "r" );
+  char * unsmry_file = util_fread_alloc_string( stream );
+  summary_ref_type * summary_ref = summary_ref_alloc_empty( unsmry_file );
+
+  summary_ref->file_size   = util_fread_long( stream );
+  summary_ref->mtime       = util_fread_time_t( stream );
+  summary_ref->params_size = util_fread_int( stream );
+  {
+    int num_offsets = util_fread_int( stream );
+    summary_ref->offsets.resize( num_offsets );
+    for (int i = 0; i < num_offsets; i++)
+      summary_ref->offsets[i] = util_fread_long( stream );
+  }
+  {
+    int num_keys = util_fread_int( stream );
+    for (int i = 0; i < num_keys; i++) {
+      char * key = util_fread_alloc_string( stream );
+      summary_ref->key_index[key] = util_fread_int( stream );
+      free( key );
+    }
+  }
+
+  fclose( stream );
+  free( unsmry_file );
+  return summary_ref;
+}
+
+
+void summary_ref_fwrite(const summary_ref_type * summary_ref, const char * filename) {
+  FILE * stream = util_mkdir_fopen( filename , "w" );
+  if (!stream)
+    util_abort("%s: failed to open: %s for writing \n", __func__, filename);
+
+  util_fwrite_string( summary_ref->unsmry_file , stream );
+  util_fwrite_long( summary_ref->file_size , stream );
+  util_fwrite_time_t( summary_ref->mtime , stream );
+  util_fwrite_int( summary_ref->params_size , stream );
+
+  util_fwrite_int( summary_ref->offsets.size() , stream );
+  for (long offset : summary_ref->offsets)
+    util_fwrite_long( offset , stream );
+
+  util_fwrite_int( summary_ref->key_index.size() , stream );
+  for (const auto& key_pair : summary_ref->key_index) {
+    util_fwrite_string( key_pair.first.c_str() , stream );
+    util_fwrite_int( key_pair.second , stream );
+  }
+
+  fclose( stream );
+}
+
+
+void summary_ref_free(summary_ref_type * summary_ref) {
+  summary_ref_unmap( summary_ref );
+  pthread_mutex_destroy( &summary_ref->map_mutex );
+  free( summary_ref->unsmry_file );
+  delete summary_ref;
+}
+
+
+void summary_ref_free__(void * arg) {
+  summary_ref_type * summary_ref = summary_ref_safe_cast( arg );
+  summary_ref_free( summary_ref );
+}
+
+
+void summary_ref_add_key(summary_ref_type * summary_ref, const char * key, int params_index) {
+  if (params_index < 0 || params_index >= summary_ref->params_size)
+    util_abort("%s: invalid params_index:%d for key:%s \n",__func__ , params_index , key);
+
+  summary_ref->key_index[key] = params_index;
+}
+
+
+bool summary_ref_has_key(const summary_ref_type * summary_ref, const char * key) {
+  return summary_ref->key_index.count( key ) > 0;
+}
+
+
+int summary_ref_get_size(const summary_ref_type * summary_ref) {
+  return summary_ref->key_index.size();
+}
+
+
+const char * summary_ref_get_unsmry_file(const summary_ref_type * summary_ref) {
+  return summary_ref->unsmry_file;
+}
+
+
+/*
+  The file is mapped on first use; if it has been changed since the
+  reference was created the reference is permanently invalid.
+*/
+
+bool summary_ref_is_valid(summary_ref_type * summary_ref) {
+  bool valid;
+  pthread_mutex_lock( &summary_ref->map_mutex );
+  if (!summary_ref->map_checked) {
+    summary_ref->map_checked = true;
+    if (!summary_ref_map( summary_ref , false ))
+      res_log_fwarning("The summary file %s has been changed or removed - the summary results can not be loaded.",
+                       summary_ref->unsmry_file);
+  }
+  valid = (summary_ref->map != NULL);
+  pthread_mutex_unlock( &summary_ref->map_mutex );
+  return valid;
+}
+
+
+/*
+  Fills @values with the value of @key at every report step; report
+  steps without data are left untouched.
+*/
+
+bool summary_ref_load_values(summary_ref_type * summary_ref, const char * key, double_vector_type * values) {
+  const auto key_it = summary_ref->key_index.find( key );
+  if (key_it == summary_ref->key_index.end())
+    return false;
+
+  if (!summary_ref_is_valid( summary_ref ))
+    return false;
+
+  {
+    int params_index = key_it->second;
+    long element_offset = (long) (params_index / SUMMARY_REF_BLOCK_SIZE) * (SUMMARY_REF_BLOCK_SIZE * 4 + 8)
+                        + 4 + (params_index % SUMMARY_REF_BLOCK_SIZE) * 4;
+
+    for (size_t report_step = 0; report_step < summary_ref->offsets.size(); report_step++) {
+      long offset = summary_ref->offsets[report_step];
+      if (offset >= 0)
+        double_vector_iset( values , report_step , summary_ref_iget_float( &summary_ref->map[offset + element_offset] ));
+    }
+  }
+  return true;
+}
+
+
+/*
+  Fills @buffer with the vector of @key exactly as it would have been
+  stored by enkf_node_store_vector(); i.e. the buffer can be passed on
+  to enkf_node_load_vector().
+*/
+
+bool summary_ref_fread_buffer(summary_ref_type * summary_ref, const char * key, buffer_type * buffer) {
+  double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+  bool loaded = summary_ref_load_values( summary_ref , key , values );
+
+  if (loaded) {
+    buffer_clear( buffer );
+    buffer_fwrite_time_t( buffer , summary_ref->mtime );
+    summary_fwrite_data_vector( buffer , values );
+    buffer_rewind( buffer );
+  }
+
+  double_vector_free( values );
+  return loaded;
+}
@@ -24,6 +24,12 @@
 #include <unistd.h>
 
 #include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
 
 #include <ert/enkf/ensemble_config.hpp>
 
@@ -44,7 +50,65 @@ void test_abort_on_add_NULL() {
 }
 
 
+void * create_summary_nodes( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  ensemble_config_type * ensemble_config = ensemble_config_safe_cast( arg_pack_iget_ptr( arg_pack , 0 ));
+  const stringlist_type * keys = (const stringlist_type *) arg_pack_iget_const_ptr( arg_pack , 1 );
+  vector_type * config_nodes = (vector_type *) arg_pack_iget_ptr( arg_pack , 2 );
+
+  for (int i = 0; i < 10; i++) {
+    vector_clear( config_nodes );
+    ensemble_config_get_or_create_summary_nodes( ensemble_config , keys , config_nodes );
+  }
+  arg_pack_free( arg_pack );
+  return NULL;
+}
+
+
+void test_create_summary_nodes_parallel() {
+  const int num_threads = 8;
+  ensemble_config_type * ensemble_config = ensemble_config_alloc(NULL, NULL, NULL);
+  stringlist_type * keys = stringlist_alloc_new();
+  vector_type * config_nodes[num_threads];
+  thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+
+  for (int i = 0; i < 1000; i++) {
+    char * key = util_alloc_sprintf("WOPR:OP_%d" , i);
+    stringlist_append_copy( keys , key );
+    free( key );
+  }
+  ensemble_config_add_summary( ensemble_config , "WOPR:OP_0" , LOAD_FAIL_WARN );
+
+  for (int t = 0; t < num_threads; t++) {
+    arg_pack_type * arg_pack = arg_pack_alloc();
+    config_nodes[t] = vector_alloc_new();
+
+    arg_pack_append_ptr( arg_pack , ensemble_config );
+    arg_pack_append_const_ptr( arg_pack , keys );
+    arg_pack_append_ptr( arg_pack , config_nodes[t] );
+    thread_pool_add_job( tp , create_summary_nodes , arg_pack );
+  }
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  test_assert_int_equal( ensemble_config_get_size( ensemble_config ) , stringlist_get_size( keys ));
+  for (int t = 0; t < num_threads; t++) {
+    test_assert_int_equal( vector_get_size( config_nodes[t] ) , stringlist_get_size( keys ));
+    for (int i = 0; i < stringlist_get_size( keys ); i++) {
+      const enkf_config_node_type * config_node = (const enkf_config_node_type *) vector_iget_const( config_nodes[t] , i );
+      test_assert_ptr_equal( config_node , ensemble_config_get_node( ensemble_config , stringlist_iget( keys , i )));
+      test_assert_string_equal( enkf_config_node_get_key( config_node ) , stringlist_iget( keys , i ));
+    }
+    vector_free( config_nodes[t] );
+  }
+
+  stringlist_free( keys );
+  ensemble_config_free( ensemble_config );
+}
+
+
 int main( int argc , char ** argv) {
   test_abort_on_add_NULL();
+  test_create_summary_nodes_parallel();
   exit(0);
 }
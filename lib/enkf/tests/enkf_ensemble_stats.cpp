@@ -0,0 +1,143 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_ensemble_stats.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/double_vector.h>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/ensemble_stats.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_config.hpp>
+#include <ert/enkf/time_map.hpp>
+
+#define NUM_STEPS 5
+#define ENS_SIZE  5
+
+
+static void store_vector( enkf_fs_type * fs , const char * key , int iens , double offset) {
+  double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+  buffer_type * buffer = buffer_alloc( 100 );
+
+  double_vector_iset( values , 0 , SUMMARY_UNDEF );
+  for (int step = 1; step < NUM_STEPS; step++)
+    double_vector_iset( values , step , offset + iens * 10 + step );
+
+  buffer_fwrite_time_t( buffer , time( NULL ));
+  summary_fwrite_data_vector( buffer , values );
+  enkf_fs_fwrite_vector( fs , buffer , key , DYNAMIC_RESULT , iens );
+
+  buffer_free( buffer );
+  double_vector_free( values );
+}
+
+
+static void init_fs( enkf_fs_type * fs ) {
+  time_map_type * time_map = enkf_fs_get_time_map( fs );
+  state_map_type * state_map = enkf_fs_get_state_map( fs );
+
+  for (int step = 0; step < NUM_STEPS; step++)
+    time_map_update( time_map , step , 86400 * (step + 1));
+
+  for (int iens = 0; iens < ENS_SIZE + 1; iens++) {
+    store_vector( fs , "FOPT" , iens , 0 );
+    state_map_iset( state_map , iens , STATE_INITIALIZED );
+    state_map_iset( state_map , iens , (iens < ENS_SIZE) ? STATE_HAS_DATA : STATE_LOAD_FAILURE );
+  }
+}
+
+
+void test_empty() {
+  ensemble_stats_type * ensemble_stats = ensemble_stats_alloc( );
+  test_assert_true( ensemble_stats_is_instance( ensemble_stats ));
+  test_assert_int_equal( 0 , ensemble_stats_get_size( ensemble_stats ));
+  test_assert_false( ensemble_stats_is_dirty( ensemble_stats ));
+
+  ensemble_stats_invalidate( ensemble_stats , "FOPT" );
+  test_assert_false( ensemble_stats_is_dirty( ensemble_stats ));
+  ensemble_stats_free( ensemble_stats );
+}
+
+
+void test_compute() {
+  ecl::util::TestArea ta("ensemble_stats");
+  enkf_config_node_type * config_node = enkf_config_node_alloc_summary( "FOPT" , LOAD_FAIL_SILENT );
+  {
+    enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+    ensemble_stats_type * ensemble_stats = enkf_fs_get_ensemble_stats( fs );
+    init_fs( fs );
+    {
+      key_stats_type * key_stats = ensemble_stats_alloc_key_stats( ensemble_stats , fs , config_node , NULL );
+      test_assert_int_equal( NUM_STEPS , key_stats_get_num_steps( key_stats ));
+      test_assert_int_equal( ENS_SIZE , int_vector_size( key_stats_get_realizations( key_stats )));
+      test_assert_int_equal( 0 , key_stats_iget_count( key_stats , 0 ));
+      test_assert_int_equal( ENS_SIZE , key_stats_iget_count( key_stats , 2 ));
+
+      /* The values at step 2 are 2, 12, 22, 32 and 42. */
+      test_assert_double_equal( 22 , key_stats_iget( key_stats , ENSEMBLE_STAT_MEAN , 2 ));
+      test_assert_double_equal(  2 , key_stats_iget( key_stats , ENSEMBLE_STAT_MIN , 2 ));
+      test_assert_double_equal( 42 , key_stats_iget( key_stats , ENSEMBLE_STAT_MAX , 2 ));
+      test_assert_double_equal(  6 , key_stats_iget( key_stats , ENSEMBLE_STAT_P10 , 2 ));
+      test_assert_double_equal( 22 , key_stats_iget( key_stats , ENSEMBLE_STAT_P50 , 2 ));
+      test_assert_double_equal( 38 , key_stats_iget( key_stats , ENSEMBLE_STAT_P90 , 2 ));
+      key_stats_free( key_stats );
+    }
+    test_assert_int_equal( 1 , ensemble_stats_get_size( ensemble_stats ));
+    test_assert_true( ensemble_stats_is_dirty( ensemble_stats ));
+
+    store_vector( fs , "FOPT" , 0 , 100 );
+    test_assert_int_equal( 0 , ensemble_stats_get_size( ensemble_stats ));
+    {
+      key_stats_type * key_stats = ensemble_stats_alloc_key_stats( ensemble_stats , fs , config_node , NULL );
+      test_assert_double_equal( 102 , key_stats_iget( key_stats , ENSEMBLE_STAT_MAX , 2 ));
+      key_stats_free( key_stats );
+    }
+    enkf_fs_decref( fs );
+  }
+  {
+    enkf_fs_type * fs = enkf_fs_mount( "mnt" );
+    ensemble_stats_type * ensemble_stats = enkf_fs_get_ensemble_stats( fs );
+    test_assert_int_equal( 1 , ensemble_stats_get_size( ensemble_stats ));
+    test_assert_false( ensemble_stats_is_dirty( ensemble_stats ));
+
+    state_map_iset( enkf_fs_get_state_map( fs ) , ENS_SIZE - 1 , STATE_LOAD_FAILURE );
+    {
+      key_stats_type * key_stats = ensemble_stats_alloc_key_stats( ensemble_stats , fs , config_node , NULL );
+      test_assert_int_equal( ENS_SIZE - 1 , key_stats_iget_count( key_stats , 2 ));
+      test_assert_double_equal( 102 , key_stats_iget( key_stats , ENSEMBLE_STAT_MAX , 2 ));
+      test_assert_double_equal( 12 , key_stats_iget( key_stats , ENSEMBLE_STAT_MIN , 2 ));
+      key_stats_free( key_stats );
+    }
+    enkf_fs_decref( fs );
+  }
+  enkf_config_node_free( config_node );
+}
+
+
+int main(int argc , char ** argv) {
+  test_empty();
+  test_compute();
+  exit(0);
+}
@@ -0,0 +1,127 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_field_init_baseline.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <utime.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+
+#include <ert/enkf/field.hpp>
+#include <ert/enkf/field_config.hpp>
+
+#define NX 4
+#define NY 3
+#define NZ 2
+#define GLOBAL_SIZE (NX * NY * NZ)
+
+/*
+  The cells 0, 7 and 13 are inactive; when exporting with an init_file
+  the values of these cells are taken from the init_file.
+*/
+
+static bool cell_active( int global_index ) {
+  return (global_index != 0) && (global_index != 7) && (global_index != 13);
+}
+
+
+static void write_grdecl( const char * filename , double offset ) {
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( "PORO" , GLOBAL_SIZE , ECL_FLOAT );
+  FILE * stream = util_fopen( filename , "w" );
+
+  for (int i = 0; i < GLOBAL_SIZE; i++)
+    ecl_kw_iset_float( ecl_kw , i , offset + i );
+  ecl_kw_fprintf_grdecl( ecl_kw , stream );
+
+  fclose( stream );
+  ecl_kw_free( ecl_kw );
+}
+
+
+static void set_mtime( const char * filename , time_t mtime ) {
+  struct utimbuf times = { mtime , mtime };
+  test_assert_int_equal( 0 , utime( filename , &times ));
+}
+
+
+static void assert_export( const field_type * field , const char * init_file , double init_offset ) {
+  field_export( field , "export.grdecl" , NULL , ECL_GRDECL_FILE , false , init_file );
+  {
+    FILE * stream = util_fopen( "export.grdecl" , "r" );
+    ecl_kw_type * ecl_kw;
+
+    test_assert_true( ecl_kw_grdecl_fseek_kw( "PORO" , false , stream ));
+    ecl_kw = ecl_kw_fscanf_alloc_grdecl_data( stream , GLOBAL_SIZE , ECL_FLOAT );
+    for (int i = 0; i < GLOBAL_SIZE; i++) {
+      double expected = cell_active( i ) ? 1.0 + i : init_offset + i;
+      test_assert_double_equal( expected , ecl_kw_iget_as_double( ecl_kw , i ));
+    }
+
+    ecl_kw_free( ecl_kw );
+    fclose( stream );
+  }
+}
+
+
+void test_init_baseline( ) {
+  ecl::util::TestArea ta("field_init_baseline");
+  int actnum[GLOBAL_SIZE];
+  time_t mtime = time( NULL ) - 100;
+
+  for (int i = 0; i < GLOBAL_SIZE; i++)
+    actnum[i] = cell_active( i ) ? 1 : 0;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1.0 , 1.0 , 1.0 , actnum );
+    field_config_type * config = field_config_alloc_empty( "PORO" , grid , NULL , false );
+    field_type * field = field_alloc( config );
+    const field_type * baseline;
+
+    write_grdecl( "field.grdecl" , 1.0 );
+    test_assert_true( field_fload( field , "field.grdecl" ));
+
+    write_grdecl( "init.grdecl" , 100.0 );
+    set_mtime( "init.grdecl" , mtime );
+
+    /* The init_file is loaded by the first export, and reused by the second. */
+    assert_export( field , "init.grdecl" , 100.0 );
+    baseline = field_config_get_init_baseline( config , "init.grdecl" );
+    assert_export( field , "init.grdecl" , 100.0 );
+    test_assert_ptr_equal( baseline , field_config_get_init_baseline( config , "init.grdecl" ));
+
+    /* A new modification time invalidates the cached baseline. */
+    write_grdecl( "init.grdecl" , 200.0 );
+    set_mtime( "init.grdecl" , mtime + 10 );
+    assert_export( field , "init.grdecl" , 200.0 );
+    test_assert_ptr_not_equal( baseline , field_config_get_init_baseline( config , "init.grdecl" ));
+
+    field_free( field );
+    field_config_free( config );
+    ecl_grid_free( grid );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_init_baseline( );
+  exit(0);
+}
@@ -0,0 +1,153 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_field_trans.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <float.h>
+#include <cmath>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+
+#include <ert/enkf/field.hpp>
+#include <ert/enkf/field_config.hpp>
+#include <ert/enkf/field_trans.hpp>
+
+
+/*
+  The documented tolerance of the vector versions, see field_trans.cpp:
+  a relative difference of 4 * FLT_EPSILON, an absolute difference of
+  FLT_MIN for denormal results and exact inf / nan / zero.
+*/
+
+static bool float_approx_equal( float expected , float value ) {
+  if (std::isnan( expected ))
+    return std::isnan( value );
+
+  if (std::isinf( expected ) || (expected == 0))
+    return (value == expected);
+
+  return (fabs( value - expected ) <= 4 * FLT_EPSILON * fabs( expected )) || (fabs( value - expected ) <= FLT_MIN);
+}
+
+
+static void test_vector_func( field_trans_table_type * table , const char * key , float min_value , float max_value) {
+  field_func_type  * func  = field_trans_table_lookup( table , key );
+  field_vfunc_type * vfunc = field_trans_table_lookup_vector( table , key );
+  const int size = 100001;
+  float * data = (float *) util_calloc( size , sizeof * data );
+
+  test_assert_true( vfunc != NULL );
+  for (int i=0; i < size; i++)
+    data[i] = min_value + (max_value - min_value) * i / (size - 1);
+
+  vfunc( data , size );
+  for (int i=0; i < size; i++) {
+    float x = min_value + (max_value - min_value) * i / (size - 1);
+    if (!float_approx_equal( func(x) , data[i] )) {
+      fprintf(stderr,"%s(%g): expected %.9g got %.9g \n", key , x , func(x) , data[i]);
+      test_assert_true( false );
+    }
+  }
+  free( data );
+}
+
+
+static void test_special_values( field_trans_table_type * table , const char * key ) {
+  const float values[] = { 0.0f , -0.0f , 1.0f , -1.0f , FLT_MIN , FLT_MIN / 1024 , FLT_MAX , -FLT_MAX ,
+                           88.7f , 88.8f , -87.5f , -104.0f , -200.0f , 38.5f , 39.0f , -45.0f ,
+                           INFINITY , -INFINITY , NAN };
+  const int size = sizeof values / sizeof values[0];
+  field_func_type  * func  = field_trans_table_lookup( table , key );
+  field_vfunc_type * vfunc = field_trans_table_lookup_vector( table , key );
+  float data[sizeof values / sizeof values[0]];
+
+  for (int i=0; i < size; i++)
+    data[i] = values[i];
+
+  vfunc( data , size );
+  for (int i=0; i < size; i++) {
+    if (!float_approx_equal( func( values[i] ) , data[i] )) {
+      fprintf(stderr,"%s(%g): expected %.9g got %.9g \n", key , values[i] , func( values[i] ) , data[i]);
+      test_assert_true( false );
+    }
+  }
+}
+
+
+/*
+  The exported values must be exactly the libm values, i.e. the output
+  transform does not use the vector version of the function.
+*/
+
+static void test_output_transform_libm( field_trans_table_type * table ) {
+  const int nx = 10 , ny = 10 , nz = 10;
+  const int size = nx * ny * nz;
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1.0 , 1.0 , 1.0 , NULL );
+  field_config_type * config = field_config_alloc_empty( "PERMX" , grid , table , false );
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( "PERMX" , size , ECL_FLOAT );
+  field_type * field;
+
+  field_config_update_parameter_field( config , TRUNCATE_NONE , 0 , 0 , ECL_GRDECL_FILE , NULL , "EXP" );
+  field = field_alloc( config );
+  for (int i=0; i < size; i++)
+    ecl_kw_iset_float( ecl_kw , i , -20.0f + 40.0f * i / size );
+  field_copy_ecl_kw_data( field , ecl_kw );
+
+  field_inplace_output_transform( field );
+  for (int i=0; i < size; i++) {
+    float expected = field_trans_table_lookup( table , "EXP" )( ecl_kw_iget_float( ecl_kw , i ));
+    test_assert_true( field_iget_float( field , i ) == expected );
+  }
+
+  field_free( field );
+  ecl_kw_free( ecl_kw );
+  field_config_free( config );
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  field_trans_table_type * table = field_trans_table_alloc();
+
+  test_vector_func( table , "EXP"   , -120 , 100 );
+  test_vector_func( table , "EXP0"  , -10 , 20 );
+  test_vector_func( table , "POW10" , -46 , 40 );
+  test_vector_func( table , "TRUNC_POW10" , -5 , 5 );
+  test_vector_func( table , "LOG"   , 1e-30 , 1e5 );
+  test_vector_func( table , "LN0"   , 0 , 10 );
+  test_vector_func( table , "LOG10" , 1e-30 , 1e5 );
+  test_vector_func( table , "LN"    , 1e-3 , 3 );
+  test_vector_func( table , "NORMALIZE_PORO" , -1 , 1 );
+
+  test_special_values( table , "EXP" );
+  test_special_values( table , "POW10" );
+  test_special_values( table , "LOG" );
+  test_special_values( table , "LOG10" );
+
+  test_output_transform_libm( table );
+
+  field_trans_table_add( table , "SQRT" , "Square root" , sqrtf );
+  test_assert_true( field_trans_table_lookup_vector( table , "SQRT" ) == NULL );
+
+  field_trans_table_free( table );
+  exit(0);
+}
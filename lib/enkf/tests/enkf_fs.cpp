@@ -29,6 +29,7 @@
 
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.hpp>
+#include <ert/util/buffer.h>
 #include <ert/enkf/enkf_fs.hpp>
 
 
@@ -144,8 +145,34 @@ void test_read_only2() {
   munmap(data, sizeof(data));
 }
 
+void test_copy_node() {
+  ecl::util::TestArea ta("copy_node");
+  enkf_fs_type * src_fs = enkf_fs_create_fs( "src" , BLOCK_FS_DRIVER_ID , NULL , true);
+  enkf_fs_type * target_fs = enkf_fs_create_fs( "target" , BLOCK_FS_DRIVER_ID , NULL , true);
+  buffer_type * buffer = buffer_alloc( 100 );
+
+  for (int i = 0; i < 1000; i++)
+    buffer_fwrite_int( buffer , i );
+  enkf_fs_fwrite_node( src_fs , buffer , "PARAM" , PARAMETER , 0 , 3 );
+
+  enkf_fs_copy_node( src_fs , target_fs , buffer , "PARAM" , PARAMETER , 0 , 3 , 0 , 7 );
+  test_assert_true( enkf_fs_has_node( target_fs , "PARAM" , PARAMETER , 0 , 7 ));
+  test_assert_false( enkf_fs_has_node( target_fs , "PARAM" , PARAMETER , 0 , 3 ));
+
+  enkf_fs_fread_node( target_fs , buffer , "PARAM" , PARAMETER , 0 , 7 );
+  test_assert_int_equal( 1000 * sizeof(int) , buffer_get_size( buffer ));
+  for (int i = 0; i < 1000; i++)
+    test_assert_int_equal( i , buffer_fread_int( buffer ));
+
+  buffer_free( buffer );
+  enkf_fs_decref( target_fs );
+  enkf_fs_decref( src_fs );
+}
+
+
 int main(int argc, char ** argv) {
   test_mount();
+  test_copy_node();
   test_refcount();
   test_read_only2();
   exit(0);
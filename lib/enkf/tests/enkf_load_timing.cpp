@@ -0,0 +1,69 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_load_timing.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+
+#include <ert/enkf/load_timing.hpp>
+
+
+void test_empty() {
+  load_timing_type * timing = load_timing_alloc( );
+  test_assert_true( load_timing_is_instance( timing ));
+  test_assert_int_equal( 0 , load_timing_get_size( timing ));
+  test_assert_int_equal( -1 , load_timing_get_slowest( timing , LOAD_STAGE_READ ));
+  test_assert_double_equal( 0 , load_timing_get_total( timing , LOAD_STAGE_STORE ));
+  test_assert_false( load_timing_has_realization( timing , 0 ));
+  load_timing_free( timing );
+}
+
+
+void test_records() {
+  load_timing_type * timing = load_timing_alloc( );
+
+  load_timing_iset( timing , 1 , LOAD_STAGE_READ , 2.0 );
+  load_timing_iset( timing , 1 , LOAD_STAGE_STORE , 0.5 );
+  load_timing_iset( timing , 3 , LOAD_STAGE_READ , 4.0 );
+  load_timing_iset( timing , 3 , LOAD_STAGE_PARSE , 1.0 );
+
+  test_assert_int_equal( 4 , load_timing_get_size( timing ));
+  test_assert_true( load_timing_has_realization( timing , 1 ));
+  test_assert_false( load_timing_has_realization( timing , 2 ));
+  test_assert_double_equal( 0 , load_timing_iget( timing , 1 , LOAD_STAGE_PARSE ));
+  test_assert_double_equal( 0.5 , load_timing_iget( timing , 1 , LOAD_STAGE_STORE ));
+
+  test_assert_double_equal( 6.0 , load_timing_get_total( timing , LOAD_STAGE_READ ));
+  test_assert_int_equal( 3 , load_timing_get_slowest( timing , LOAD_STAGE_READ ));
+  test_assert_int_equal( 1 , load_timing_get_slowest( timing , LOAD_STAGE_STORE ));
+
+  load_timing_set_wall_time( timing , 5.0 );
+  test_assert_double_equal( 5.0 , load_timing_get_wall_time( timing ));
+
+  load_timing_clear( timing );
+  test_assert_int_equal( 0 , load_timing_get_size( timing ));
+  test_assert_double_equal( 0 , load_timing_get_wall_time( timing ));
+  load_timing_free( timing );
+}
+
+
+int main(int argc , char ** argv) {
+  test_empty();
+  test_records();
+  exit(0);
+}
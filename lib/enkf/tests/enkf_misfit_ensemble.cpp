@@ -0,0 +1,301 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_misfit_ensemble.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/bool_vector.h>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_obs.hpp>
+#include <ert/enkf/enkf_config_node.hpp>
+#include <ert/enkf/obs_vector.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_obs.hpp>
+#include <ert/enkf/gen_obs.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/misfit_ensemble.hpp>
+#include <ert/enkf/misfit_ts.hpp>
+
+#define ENS_SIZE        6
+#define HISTORY_LENGTH  3
+#define OBS_VALUE       10.0
+#define GEN_DATA_SIZE   3
+#define MISSING_IENS    3
+
+
+/*
+  All realizations have the constant value @value at all report
+  steps, so the misfit of one observation at one step is
+  ((value - OBS_VALUE) / std)^2.
+*/
+
+static void store_response( enkf_fs_type * fs , int iens , double value ) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  double_vector_type * data = double_vector_alloc( 0 , SUMMARY_UNDEF );
+
+  for (int step = 0; step <= HISTORY_LENGTH; step++)
+    double_vector_iset( data , step , value );
+
+  buffer_fwrite_time_t( buffer , time( NULL ));
+  summary_fwrite_data_vector( buffer , data );
+  enkf_fs_fwrite_vector( fs , buffer , "FOPR" , DYNAMIC_RESULT , iens );
+
+  double_vector_free( data );
+  buffer_free( buffer );
+}
+
+
+static double response_value( int iens , int version ) {
+  return OBS_VALUE + iens + 0.5 * version;
+}
+
+
+static obs_vector_type * alloc_obs_vector( enkf_config_node_type * config_node , const char * obs_key , double std ) {
+  obs_vector_type * obs_vector = obs_vector_alloc( SUMMARY_OBS , obs_key , config_node , HISTORY_LENGTH + 1 );
+  for (int step = 1; step <= HISTORY_LENGTH; step++)
+    obs_vector_install_node( obs_vector , step , summary_obs_alloc( "FOPR" , obs_key , OBS_VALUE , std ));
+  return obs_vector;
+}
+
+
+static double member_misfit( const misfit_ensemble_type * misfit_ensemble , int iens , const char * obs_key ) {
+  const misfit_member_type * member = misfit_ensemble_iget_member( misfit_ensemble , iens );
+  int_vector_type * steps = int_vector_alloc( 0 , 0 );
+  double misfit;
+
+  for (int step = 1; step <= HISTORY_LENGTH; step++)
+    int_vector_append( steps , step );
+  misfit = misfit_ts_eval( misfit_member_get_ts( member , obs_key ) , steps );
+
+  int_vector_free( steps );
+  return misfit;
+}
+
+
+static double expected_misfit( int iens , int version , double std ) {
+  double x = (response_value( iens , version ) - OBS_VALUE) / std;
+  return HISTORY_LENGTH * x * x;
+}
+
+
+static void store_ensemble( enkf_fs_type * fs , int version ) {
+  for (int iens = 0; iens < ENS_SIZE; iens++)
+    store_response( fs , iens , response_value( iens , version ));
+}
+
+
+void test_incremental( ) {
+  ecl::util::TestArea ta("misfit_ensemble");
+  enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+  state_map_type * state_map = enkf_fs_get_state_map( fs );
+  enkf_config_node_type * config_node = enkf_config_node_alloc_summary( "FOPR" , LOAD_FAIL_SILENT );
+  enkf_obs_type * enkf_obs = enkf_obs_alloc( NULL , NULL , NULL , NULL , NULL );
+  misfit_ensemble_type * misfit_ensemble = misfit_ensemble_alloc( );
+
+  enkf_obs_add_obs_vector( enkf_obs , alloc_obs_vector( config_node , "OBS1" , 2.0 ));
+  store_ensemble( fs , 0 );
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    state_map_iset( state_map , iens , STATE_INITIALIZED );
+    state_map_iset( state_map , iens , STATE_HAS_DATA );
+  }
+
+  misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+  test_assert_true( misfit_ensemble_initialized( misfit_ensemble ));
+  for (int iens = 0; iens < ENS_SIZE; iens++)
+    test_assert_double_equal( expected_misfit( iens , 0 , 2.0 ) , member_misfit( misfit_ensemble , iens , "OBS1" ));
+
+  /*
+    New results are stored for all realizations, but only realizations
+    1 and 4 are registered as rerun in the state_map; only those rows
+    are recomputed.
+  */
+  store_ensemble( fs , 1 );
+  state_map_iset( state_map , 1 , STATE_HAS_DATA );
+  state_map_iset( state_map , 4 , STATE_HAS_DATA );
+
+  misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    int version = (iens == 1 || iens == 4) ? 1 : 0;
+    test_assert_double_equal( expected_misfit( iens , version , 2.0 ) , member_misfit( misfit_ensemble , iens , "OBS1" ));
+  }
+
+  /*
+    Write and read the table and the state_map as when the case is
+    mounted again; the change counters start at zero, and with the
+    stored fingerprint the table is used as it is.
+  */
+  {
+    FILE * stream = util_fopen( "misfit" , "w");
+    misfit_ensemble_fwrite( misfit_ensemble , stream );
+    fclose( stream );
+    state_map_fwrite( state_map , "state_map" );
+
+    misfit_ensemble_clear( misfit_ensemble );
+    stream = util_fopen( "misfit" , "r");
+    misfit_ensemble_fread( misfit_ensemble , stream );
+    fclose( stream );
+    state_map_fread( state_map , "state_map" );
+  }
+  misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+  test_assert_double_equal( expected_misfit( 0 , 0 , 2.0 ) , member_misfit( misfit_ensemble , 0 , "OBS1" ));
+  test_assert_double_equal( expected_misfit( 1 , 1 , 2.0 ) , member_misfit( misfit_ensemble , 1 , "OBS1" ));
+
+  /*
+    A new observation changes the observation fingerprint, and the
+    whole table is recomputed even though the state_map is unchanged.
+  */
+  enkf_obs_add_obs_vector( enkf_obs , alloc_obs_vector( config_node , "OBS2" , 4.0 ));
+  misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    test_assert_double_equal( expected_misfit( iens , 1 , 2.0 ) , member_misfit( misfit_ensemble , iens , "OBS1" ));
+    test_assert_double_equal( expected_misfit( iens , 1 , 4.0 ) , member_misfit( misfit_ensemble , iens , "OBS2" ));
+  }
+
+  /*
+    New results which are not registered in the state_map are not
+    picked up as long as the observations are unchanged. Scaling the
+    std through enkf_obs changes the revision of enkf_obs, the cached
+    fingerprint is recomputed and the whole table is recomputed.
+  */
+  {
+    long revision = enkf_obs_get_revision( enkf_obs );
+
+    store_ensemble( fs , 2 );
+    misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+    test_assert_double_equal( expected_misfit( 0 , 1 , 2.0 ) , member_misfit( misfit_ensemble , 0 , "OBS1" ));
+    test_assert_true( revision == enkf_obs_get_revision( enkf_obs ));
+
+    enkf_obs_scale_std( enkf_obs , 2.0 );
+    test_assert_true( revision != enkf_obs_get_revision( enkf_obs ));
+    misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+    for (int iens = 0; iens < ENS_SIZE; iens++)
+      test_assert_double_equal( expected_misfit( iens , 2 , 2.0 ) , member_misfit( misfit_ensemble , iens , "OBS1" ));
+  }
+
+  misfit_ensemble_free( misfit_ensemble );
+  enkf_obs_free( enkf_obs );
+  enkf_config_node_free( config_node );
+  enkf_fs_decref( fs );
+}
+
+
+static void store_gen_data( enkf_fs_type * fs , int iens , int step , double value ) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  double data[GEN_DATA_SIZE];
+
+  for (int i = 0; i < GEN_DATA_SIZE; i++)
+    data[i] = value + i;
+
+  buffer_fwrite_int( buffer , GEN_DATA );
+  buffer_fwrite_int( buffer , GEN_DATA_SIZE );
+  buffer_fwrite_int( buffer , step );
+  buffer_fwrite_compressed( buffer , data , sizeof data );
+  enkf_fs_fwrite_node( fs , buffer , "GEN" , DYNAMIC_RESULT , step , iens );
+
+  buffer_free( buffer );
+}
+
+
+/*
+  Checks the misfit table against obs_vector_ensemble_chi2(), which
+  evaluates one observation at a time; members without data for the
+  observation have no misfit_ts for it.
+*/
+
+static void assert_ensemble_chi2( const misfit_ensemble_type * misfit_ensemble , const obs_vector_type * obs_vector , enkf_fs_type * fs ) {
+  const char * obs_key = obs_vector_get_obs_key( obs_vector );
+  bool_vector_type * valid = bool_vector_alloc( ENS_SIZE , true );
+  int_vector_type * steps = int_vector_alloc( 1 , 0 );
+  double ** chi2 = (double **) util_calloc( HISTORY_LENGTH + 1 , sizeof * chi2 );
+
+  for (int step = 0; step <= HISTORY_LENGTH; step++)
+    chi2[step] = (double *) util_calloc( ENS_SIZE , sizeof * chi2[step] );
+
+  obs_vector_ensemble_chi2( obs_vector , fs , valid , 0 , HISTORY_LENGTH , 0 , ENS_SIZE , chi2 );
+  test_assert_false( bool_vector_iget( valid , MISSING_IENS ));
+
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    const misfit_member_type * member = misfit_ensemble_iget_member( misfit_ensemble , iens );
+
+    test_assert_bool_equal( bool_vector_iget( valid , iens ) , misfit_member_has_ts( member , obs_key ));
+    if (bool_vector_iget( valid , iens )) {
+      const misfit_ts_type * ts = misfit_member_get_ts( member , obs_key );
+      for (int step = 0; step <= HISTORY_LENGTH; step++) {
+        int_vector_iset( steps , 0 , step );
+        test_assert_double_equal( chi2[step][iens] , misfit_ts_eval( ts , steps ));
+      }
+    }
+  }
+
+  for (int step = 0; step <= HISTORY_LENGTH; step++)
+    free( chi2[step] );
+  free( chi2 );
+  int_vector_free( steps );
+  bool_vector_free( valid );
+}
+
+
+void test_compare_chi2( ) {
+  ecl::util::TestArea ta("misfit_chi2");
+  enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+  enkf_config_node_type * summary_node = enkf_config_node_alloc_summary( "FOPR" , LOAD_FAIL_SILENT );
+  enkf_config_node_type * gen_node = enkf_config_node_alloc_GEN_DATA_result( "GEN" , ASCII , "gen%d" );
+  enkf_obs_type * enkf_obs = enkf_obs_alloc( NULL , NULL , NULL , NULL , NULL );
+  misfit_ensemble_type * misfit_ensemble = misfit_ensemble_alloc( );
+  obs_vector_type * gen_obs_vector = obs_vector_alloc( GEN_OBS , "GEN_OBS" , gen_node , HISTORY_LENGTH + 1 );
+
+  for (int step = 1; step <= HISTORY_LENGTH; step += 2) {
+    gen_obs_type * gen_obs = gen_obs_alloc( (const gen_data_config_type *) enkf_config_node_get_ref( gen_node ) , "GEN_OBS" , NULL , OBS_VALUE , 1.5 , NULL , "1" , NULL );
+    obs_vector_install_node( gen_obs_vector , step , gen_obs );
+  }
+  enkf_obs_add_obs_vector( enkf_obs , gen_obs_vector );
+  enkf_obs_add_obs_vector( enkf_obs , alloc_obs_vector( summary_node , "OBS1" , 2.0 ));
+
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    if (iens == MISSING_IENS)
+      continue;
+
+    store_response( fs , iens , response_value( iens , 0 ));
+    for (int step = 1; step <= HISTORY_LENGTH; step += 2)
+      store_gen_data( fs , iens , step , OBS_VALUE + iens + 0.25 * step );
+  }
+
+  misfit_ensemble_set_num_threads( misfit_ensemble , 4 );
+  misfit_ensemble_initialize( misfit_ensemble , NULL , enkf_obs , fs , ENS_SIZE , HISTORY_LENGTH , false );
+  assert_ensemble_chi2( misfit_ensemble , enkf_obs_get_vector( enkf_obs , "OBS1" ) , fs );
+  assert_ensemble_chi2( misfit_ensemble , enkf_obs_get_vector( enkf_obs , "GEN_OBS" ) , fs );
+
+  misfit_ensemble_free( misfit_ensemble );
+  enkf_obs_free( enkf_obs );
+  enkf_config_node_free( gen_node );
+  enkf_config_node_free( summary_node );
+  enkf_fs_decref( fs );
+}
+
+
+int main(int argc , char ** argv) {
+  test_incremental( );
+  test_compare_chi2( );
+  exit(0);
+}
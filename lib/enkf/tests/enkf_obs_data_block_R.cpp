@@ -0,0 +1,81 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_obs_data_block_R.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+
+#include <ert/util/test_util.hpp>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
+#include <ert/enkf/obs_data.hpp>
+
+
+static matrix_type * alloc_covar( int size , double diag , double offdiag ) {
+  matrix_type * covar = matrix_alloc( size , size );
+  for (int i = 0; i < size; i++)
+    for (int j = 0; j < size; j++)
+      matrix_iset( covar , i , j , (i == j) ? diag : offdiag );
+  return covar;
+}
+
+
+/*
+  The second block has an error_covar matrix, but all its observations
+  have been deactivated; it should not contribute to R.
+*/
+
+void test_inactive_covar_block() {
+  obs_data_type * obs_data = obs_data_alloc( 1.0 );
+  obs_block_type * diag_block     = obs_data_add_block( obs_data , "DIAG"     , 2 , NULL , false );
+  obs_block_type * inactive_block = obs_data_add_block( obs_data , "INACTIVE" , 2 , alloc_covar( 2 , 9 , 1 ) , true );
+  obs_block_type * covar_block    = obs_data_add_block( obs_data , "COVAR"    , 2 , alloc_covar( 2 , 4 , 2 ) , true );
+
+  obs_block_iset( diag_block , 0 , 1.0 , 1.0 );
+  obs_block_iset( diag_block , 1 , 1.0 , 2.0 );
+
+  obs_block_iset( inactive_block , 0 , 1.0 , 3.0 );
+  obs_block_iset( inactive_block , 1 , 1.0 , 3.0 );
+  obs_block_deactivate( inactive_block , 0 , false , "Test" );
+  obs_block_deactivate( inactive_block , 1 , false , "Test" );
+  test_assert_int_equal( 0 , obs_block_get_active_size( inactive_block ));
+
+  obs_block_iset( covar_block , 0 , 1.0 , 2.0 );
+  obs_block_iset( covar_block , 1 , 1.0 , 2.0 );
+
+  {
+    block_diag_matrix_type * R = obs_data_alloc_block_R( obs_data );
+
+    test_assert_int_equal( 4 , block_diag_matrix_get_size( R ));
+    test_assert_false( block_diag_matrix_is_diagonal( R ));
+
+    test_assert_double_equal( 1 , block_diag_matrix_iget( R , 0 , 0 ));
+    test_assert_double_equal( 4 , block_diag_matrix_iget( R , 1 , 1 ));
+    test_assert_double_equal( 4 , block_diag_matrix_iget( R , 2 , 2 ));
+    test_assert_double_equal( 2 , block_diag_matrix_iget( R , 2 , 3 ));
+    test_assert_double_equal( 0 , block_diag_matrix_iget( R , 1 , 2 ));
+
+    block_diag_matrix_free( R );
+  }
+
+  obs_data_free( obs_data );
+}
+
+
+int main(int argc , char ** argv) {
+  test_inactive_covar_block();
+  exit(0);
+}
@@ -0,0 +1,68 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_plot_batch.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/enkf/enkf_plot_batch.hpp>
+#include <ert/enkf/summary_config.hpp>
+
+
+
+void test_create() {
+  enkf_plot_batch_type * batch = enkf_plot_batch_alloc( );
+  test_assert_true( enkf_plot_batch_is_instance( batch ));
+  test_assert_int_equal( 0 , enkf_plot_batch_get_num_keys( batch ));
+  test_assert_int_equal( 0 , enkf_plot_batch_get_ens_size( batch ));
+  test_assert_int_equal( 0 , enkf_plot_batch_get_num_steps( batch ));
+  enkf_plot_batch_free( batch );
+}
+
+
+
+void iget_unloaded( void * arg ) {
+  enkf_plot_batch_type * batch = (enkf_plot_batch_type *) arg;
+  enkf_plot_batch_iget_data( batch , 0 );
+}
+
+
+void test_add_key() {
+  enkf_config_node_type * fopt = enkf_config_node_alloc_summary("FOPT" , LOAD_FAIL_SILENT);
+  enkf_config_node_type * fopr = enkf_config_node_alloc_summary("FOPR" , LOAD_FAIL_SILENT);
+  enkf_plot_batch_type * batch = enkf_plot_batch_alloc( );
+
+  test_assert_int_equal( 0 , enkf_plot_batch_add_key( batch , fopt , NULL ));
+  test_assert_int_equal( 1 , enkf_plot_batch_add_key( batch , fopr , NULL ));
+  test_assert_int_equal( 2 , enkf_plot_batch_get_num_keys( batch ));
+  test_assert_util_abort( "enkf_plot_batch_iget_loaded_key" , iget_unloaded , batch );
+
+  enkf_plot_batch_free( batch );
+  enkf_config_node_free( fopr );
+  enkf_config_node_free( fopt );
+}
+
+
+
+int main(int argc , char ** argv) {
+  test_create();
+  test_add_key();
+  exit(0);
+}
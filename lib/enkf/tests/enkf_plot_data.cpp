@@ -20,14 +20,26 @@
 #include <stdio.h>
 #include <unistd.h>
 
-#include <ert/util/test_work_area.h>
+#include <time.h>
+
+#include <ert/util/test_work_area.hpp>
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
 #include <ert/util/bool_vector.h>
+#include <ert/util/buffer.h>
+#include <ert/util/double_vector.h>
 #include <ert/res_util/arg_pack.hpp>
 
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_config_node.hpp>
 #include <ert/enkf/enkf_plot_tvector.hpp>
 #include <ert/enkf/enkf_plot_data.hpp>
+#include <ert/enkf/state_map.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/time_map.hpp>
+
+#define ENS_SIZE   3
+#define NUM_STEPS  4
 
 
 
@@ -40,6 +52,85 @@ void test_create() {
 
 
 
+/*
+  Step 2 is a hole in the summary vector of every realization.
+*/
+
+static void store_ensemble( enkf_fs_type * fs , double offset ) {
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    buffer_type * buffer = buffer_alloc( 100 );
+    double_vector_type * data = double_vector_alloc( 0 , SUMMARY_UNDEF );
+
+    for (int step = 0; step < NUM_STEPS; step++)
+      if (step != 2)
+        double_vector_iset( data , step , offset + iens * NUM_STEPS + step );
+
+    buffer_fwrite_time_t( buffer , time( NULL ));
+    summary_fwrite_data_vector( buffer , data );
+    enkf_fs_fwrite_vector( fs , buffer , "FOPR" , DYNAMIC_RESULT , iens );
+
+    double_vector_free( data );
+    buffer_free( buffer );
+  }
+}
+
+
+static void assert_plot_vector( const enkf_plot_tvector_type * plot_vector , int iens , double offset ) {
+  test_assert_int_equal( NUM_STEPS , enkf_plot_tvector_size( plot_vector ));
+  for (int step = 0; step < NUM_STEPS; step++) {
+    if (step == 2) {
+      test_assert_false( enkf_plot_tvector_iget_active( plot_vector , step ));
+      test_assert_double_equal( SUMMARY_UNDEF , enkf_plot_tvector_iget_value( plot_vector , step ));
+    } else {
+      test_assert_true( enkf_plot_tvector_iget_active( plot_vector , step ));
+      test_assert_double_equal( offset + iens * NUM_STEPS + step , enkf_plot_tvector_iget_value( plot_vector , step ));
+    }
+  }
+}
+
+
+/*
+  Loading the same key again updates the plot vectors which have
+  already been handed out.
+*/
+
+void test_reload() {
+  ecl::util::TestArea ta("plot_data_reload");
+  enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+  enkf_config_node_type * config_node = enkf_config_node_alloc_summary( "FOPR" , LOAD_FAIL_SILENT );
+  enkf_plot_data_type * plot_data = enkf_plot_data_alloc( config_node );
+  state_map_type * state_map = enkf_fs_get_state_map( fs );
+  time_map_type * time_map = enkf_fs_get_time_map( fs );
+  enkf_plot_tvector_type * plot_vectors[ENS_SIZE];
+
+  for (int step = 0; step < NUM_STEPS; step++)
+    time_map_update( time_map , step , 86400 * (step + 1));
+  for (int iens = 0; iens < ENS_SIZE; iens++)
+    state_map_iset( state_map , iens , STATE_HAS_DATA );
+
+  store_ensemble( fs , 0 );
+  enkf_plot_data_load( plot_data , fs , NULL , NULL );
+  test_assert_int_equal( ENS_SIZE , enkf_plot_data_get_size( plot_data ));
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    plot_vectors[iens] = enkf_plot_data_iget( plot_data , iens );
+    assert_plot_vector( plot_vectors[iens] , iens , 0 );
+  }
+
+  store_ensemble( fs , 100 );
+  enkf_plot_data_load( plot_data , fs , NULL , NULL );
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    test_assert_ptr_equal( plot_vectors[iens] , enkf_plot_data_iget( plot_data , iens ));
+    assert_plot_vector( plot_vectors[iens] , iens , 100 );
+  }
+
+  enkf_plot_data_free( plot_data );
+  enkf_config_node_free( config_node );
+  enkf_fs_decref( fs );
+}
+
+
+
 int main(int argc , char ** argv) {
   test_create();
+  test_reload();
 }
@@ -102,11 +102,34 @@ void test_iget() {
 
 
 
+void test_view() {
+  enkf_config_node_type * config_node = enkf_config_node_alloc_summary("KEY" , LOAD_FAIL_SILENT);
+  time_t time[4]   = { 0 , 100 , 200 , 300 };
+  double data[4]   = { 0 , 10 , 20 , 30 };
+  bool   mask[4]   = { true , true , false , true };
+  enkf_plot_tvector_type * tvector = enkf_plot_tvector_alloc_view( config_node , 3 , 4 , time , data , mask );
+
+  test_assert_true( enkf_plot_tvector_is_instance( tvector ));
+  test_assert_true( enkf_plot_tvector_is_view( tvector ));
+  test_assert_int_equal( 4 , enkf_plot_tvector_size( tvector ));
+  test_assert_false( enkf_plot_tvector_all_active( tvector ));
+  test_assert_false( enkf_plot_tvector_iget_active( tvector , 2 ));
+  test_assert_time_t_equal( 300 , enkf_plot_tvector_iget_time( tvector , 3 ));
+  test_assert_double_equal( 30 , enkf_plot_tvector_iget_value( tvector , 3 ));
+
+  data[3] = 99;
+  test_assert_double_equal( 99 , enkf_plot_tvector_iget_value( tvector , 3 ));
+  enkf_plot_tvector_free( tvector );
+}
+
+
+
 int main(int argc , char ** argv) {
   create_test();
   test_iset();
   test_all_active();
   test_iget();
+  test_view();
 
   exit(0);
 }
@@ -347,6 +347,29 @@ void test_readonly() {
 }
 
 
+void test_change_count() {
+  ecl::util::TestArea ta("state_map_change_count");
+  state_map_type * state_map = state_map_alloc();
+  test_assert_int_equal( 0 , state_map_iget_change_count( state_map , 5 ));
+
+  state_map_iset( state_map , 5 , STATE_INITIALIZED );
+  state_map_iset( state_map , 5 , STATE_HAS_DATA );
+  state_map_update_matching( state_map , 5 , STATE_LOAD_FAILURE , STATE_INITIALIZED );
+  test_assert_int_equal( 2 , state_map_iget_change_count( state_map , 5 ));
+  test_assert_int_equal( 0 , state_map_iget_change_count( state_map , 4 ));
+
+  state_map_iset( state_map , 5 , STATE_HAS_DATA );
+  test_assert_int_equal( 3 , state_map_iget_change_count( state_map , 5 ));
+
+  state_map_fwrite( state_map , "map" );
+  state_map_fread( state_map , "map" );
+  test_assert_int_equal( 0 , state_map_iget_change_count( state_map , 5 ));
+  test_assert_int_equal( STATE_HAS_DATA , state_map_iget( state_map , 5 ));
+
+  state_map_free( state_map );
+}
+
+
 int main(int argc , char ** argv) {
   create_test();
   get_test();
@@ -360,6 +383,7 @@ int main(int argc , char ** argv) {
   test_count_matching();
   test_transitions();
   test_readonly();
+  test_change_count();
   exit(0);
 }
 
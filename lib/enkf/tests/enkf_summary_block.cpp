@@ -0,0 +1,320 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_summary_block.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+
+#include <ert/res_util/arg_pack.hpp>
+#include <ert/res_util/thread_pool.hpp>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_block.hpp>
+
+#define NUM_KEYS   (SUMMARY_BLOCK_CHUNK_SIZE + 10)
+#define NUM_STEPS  6
+#define NUM_REAL   16
+#define REAL_KEYS  20
+
+
+static double test_value( int key , int step , double offset ) {
+  return offset + key * 100 + step;
+}
+
+
+static void alloc_vectors( stringlist_type * keys , vector_type * data_vectors , double offset ) {
+  for (int key = 0; key < NUM_KEYS; key++) {
+    double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+    int size = (key == 1) ? NUM_STEPS - 2 : NUM_STEPS;
+
+    for (int step = 0; step < size; step++)
+      double_vector_iset( values , step , test_value( key , step , offset ));
+
+    stringlist_append_owned_ref( keys , util_alloc_sprintf( "KEY:%d" , key ));
+    vector_append_owned_ref( data_vectors , values , double_vector_free__ );
+  }
+}
+
+
+static void read_vector( enkf_fs_type * fs , const char * key , int iens , double_vector_type * values ) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  enkf_fs_fread_vector( fs , buffer , key , DYNAMIC_RESULT , iens );
+  buffer_fskip_time_t( buffer );
+  test_assert_int_equal( SUMMARY , buffer_fread_int( buffer ));
+  {
+    int size = buffer_fread_int( buffer );
+    double default_value = buffer_fread_double( buffer );
+    double_vector_reset( values );
+    double_vector_set_default( values , default_value );
+    for (int step = 0; step < size; step++)
+      double_vector_iset( values , step , buffer_fread_double( buffer ));
+  }
+  buffer_free( buffer );
+}
+
+
+void test_block() {
+  stringlist_type * keys = stringlist_alloc_new( );
+  vector_type * data_vectors = vector_alloc_new( );
+  alloc_vectors( keys , data_vectors , 0 );
+  {
+    summary_block_type * block = summary_block_alloc( data_vectors , 0 , 3 , 0 );
+    buffer_type * buffer = buffer_alloc( 100 );
+    summary_block_type * copy;
+
+    summary_block_fwrite( block , buffer );
+    buffer_rewind( buffer );
+    copy = summary_block_fread_alloc( buffer );
+
+    test_assert_int_equal( NUM_STEPS , summary_block_get_num_steps( copy ));
+    test_assert_int_equal( 3 , summary_block_get_num_columns( copy ));
+    test_assert_double_equal( test_value( 2 , 4 , 0 ) , summary_block_iget( copy , 4 , 2 ));
+    test_assert_double_equal( SUMMARY_UNDEF , summary_block_iget( copy , NUM_STEPS - 1 , 1 ));
+    {
+      double_vector_type * values = double_vector_alloc( 0 , 0 );
+      summary_block_iget_column( copy , 1 , values );
+      test_assert_int_equal( NUM_STEPS - 2 , double_vector_size( values ));
+      test_assert_double_equal( SUMMARY_UNDEF , double_vector_get_default( values ));
+      test_assert_double_equal( test_value( 1 , 3 , 0 ) , double_vector_iget( values , 3 ));
+      double_vector_free( values );
+    }
+
+    summary_block_free( copy );
+    buffer_free( buffer );
+    summary_block_free( block );
+  }
+  vector_free( data_vectors );
+  stringlist_free( keys );
+}
+
+
+void test_index() {
+  summary_block_index_type * index = summary_block_index_alloc( );
+  int_vector_type * key_ids = int_vector_alloc( 0 , 0 );
+  int_vector_type * released = int_vector_alloc( 0 , 0 );
+  int block_id , column;
+
+  int_vector_append( key_ids , 10 );
+  int_vector_append( key_ids , 11 );
+  test_assert_int_equal( 0 , summary_block_index_alloc_block_id( index , released ));
+  summary_block_index_add_block( index , 0 , key_ids , released );
+
+  int_vector_iset( key_ids , 0 , 12 );
+  summary_block_index_add_block( index , 1 , key_ids , released );
+  test_assert_int_equal( 0 , int_vector_size( released ));
+  test_assert_int_equal( 3 , summary_block_index_get_size( index ));
+  test_assert_int_equal( 2 , summary_block_index_get_num_blocks( index ));
+
+  test_assert_true( summary_block_index_get( index , 11 , &block_id , &column ));
+  test_assert_int_equal( 1 , block_id );
+  test_assert_int_equal( 1 , column );
+
+  /* Block 0 now only holds key 10; removing it releases the block. */
+  test_assert_true( summary_block_index_remove_key( index , 10 , released ));
+  test_assert_false( summary_block_index_remove_key( index , 10 , released ));
+  test_assert_int_equal( 1 , int_vector_size( released ));
+  test_assert_int_equal( 0 , int_vector_iget( released , 0 ));
+  test_assert_int_equal( 2 , summary_block_index_alloc_block_id( index , released ));
+  int_vector_reset( released );
+  test_assert_int_equal( 0 , summary_block_index_alloc_block_id( index , released ));
+
+  {
+    buffer_type * buffer = buffer_alloc( 100 );
+    summary_block_index_type * copy;
+    summary_block_index_fwrite( index , buffer );
+    buffer_rewind( buffer );
+    copy = summary_block_index_fread_alloc( buffer );
+
+    test_assert_int_equal( 2 , summary_block_index_get_size( copy ));
+    test_assert_int_equal( 1 , summary_block_index_get_num_blocks( copy ));
+    test_assert_true( summary_block_index_get( copy , 12 , &block_id , &column ));
+    test_assert_int_equal( 1 , block_id );
+    test_assert_int_equal( 0 , column );
+
+    summary_block_index_free( copy );
+    buffer_free( buffer );
+  }
+
+  int_vector_free( released );
+  int_vector_free( key_ids );
+  summary_block_index_free( index );
+}
+
+
+void test_fs() {
+  ecl::util::TestArea ta("summary_block");
+  double_vector_type * values = double_vector_alloc( 0 , 0 );
+  {
+    enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+    stringlist_type * keys = stringlist_alloc_new( );
+    vector_type * data_vectors = vector_alloc_new( );
+
+    alloc_vectors( keys , data_vectors , 0 );
+    enkf_fs_fwrite_summary_block( fs , keys , data_vectors , 0 );
+
+    test_assert_true( enkf_fs_has_vector( fs , "KEY:1" , DYNAMIC_RESULT , 0 ));
+    test_assert_false( enkf_fs_has_vector( fs , "KEY:1" , DYNAMIC_RESULT , 1 ));
+    test_assert_false( enkf_fs_has_vector( fs , "UNKNOWN" , DYNAMIC_RESULT , 0 ));
+
+    read_vector( fs , "KEY:1" , 0 , values );
+    test_assert_int_equal( NUM_STEPS - 2 , double_vector_size( values ));
+    test_assert_double_equal( test_value( 1 , 2 , 0 ) , double_vector_iget( values , 2 ));
+
+    read_vector( fs , "KEY:130" , 0 , values );
+    test_assert_double_equal( test_value( 130 , 5 , 0 ) , double_vector_iget( values , 5 ));
+
+    /* Storing the vectors again replaces the values. */
+    vector_clear( data_vectors );
+    stringlist_clear( keys );
+    alloc_vectors( keys , data_vectors , 0.5 );
+    enkf_fs_fwrite_summary_block( fs , keys , data_vectors , 0 );
+    read_vector( fs , "KEY:130" , 0 , values );
+    test_assert_double_equal( test_value( 130 , 5 , 0.5 ) , double_vector_iget( values , 5 ));
+
+    /* A vector stored on its own is not shadowed by the block. */
+    {
+      buffer_type * buffer = buffer_alloc( 100 );
+      double_vector_type * single = double_vector_alloc( 0 , SUMMARY_UNDEF );
+      double_vector_iset( single , 3 , 77 );
+      buffer_fwrite_time_t( buffer , time( NULL ));
+      summary_fwrite_data_vector( buffer , single );
+      enkf_fs_fwrite_vector( fs , buffer , "KEY:2" , DYNAMIC_RESULT , 0 );
+      double_vector_free( single );
+      buffer_free( buffer );
+    }
+    read_vector( fs , "KEY:2" , 0 , values );
+    test_assert_double_equal( 77 , double_vector_iget( values , 3 ));
+
+    {
+      stringlist_type * step_keys = stringlist_alloc_new( );
+      stringlist_append_copy( step_keys , "KEY:2" );
+      stringlist_append_copy( step_keys , "KEY:135" );
+      stringlist_append_copy( step_keys , "KEY:1" );
+      test_assert_true( enkf_fs_fread_summary_step( fs , step_keys , 0 , NUM_STEPS - 1 , values ));
+      test_assert_double_equal( SUMMARY_UNDEF , double_vector_iget( values , 0 ));
+      test_assert_double_equal( test_value( 135 , NUM_STEPS - 1 , 0.5 ) , double_vector_iget( values , 1 ));
+      test_assert_double_equal( SUMMARY_UNDEF , double_vector_iget( values , 2 ));
+
+      stringlist_append_copy( step_keys , "UNKNOWN" );
+      test_assert_false( enkf_fs_fread_summary_step( fs , step_keys , 0 , 1 , values ));
+      stringlist_free( step_keys );
+    }
+
+    vector_free( data_vectors );
+    stringlist_free( keys );
+    enkf_fs_decref( fs );
+  }
+  {
+    enkf_fs_type * fs = enkf_fs_mount( "mnt" );
+    read_vector( fs , "KEY:0" , 0 , values );
+    test_assert_double_equal( test_value( 0 , 1 , 0.5 ) , double_vector_iget( values , 1 ));
+    read_vector( fs , "KEY:2" , 0 , values );
+    test_assert_double_equal( 77 , double_vector_iget( values , 3 ));
+    enkf_fs_decref( fs );
+  }
+  double_vector_free( values );
+}
+
+
+/*
+  Each realization stores the common keys and REAL_KEYS keys of its
+  own, so all the store threads add keys to the dictionary.
+*/
+
+static void alloc_real_vectors( stringlist_type * keys , vector_type * data_vectors , int iens ) {
+  alloc_vectors( keys , data_vectors , iens );
+  for (int key = 0; key < REAL_KEYS; key++) {
+    double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+    for (int step = 0; step < NUM_STEPS; step++)
+      double_vector_iset( values , step , test_value( key , step , 1000 * iens ));
+
+    stringlist_append_owned_ref( keys , util_alloc_sprintf( "REAL%d:%d" , iens , key ));
+    vector_append_owned_ref( data_vectors , values , double_vector_free__ );
+  }
+}
+
+
+static void * store_real( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  enkf_fs_type * fs = (enkf_fs_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  int iens = arg_pack_iget_int( arg_pack , 1 );
+  stringlist_type * keys = stringlist_alloc_new( );
+  vector_type * data_vectors = vector_alloc_new( );
+
+  alloc_real_vectors( keys , data_vectors , iens );
+  enkf_fs_fwrite_summary_block( fs , keys , data_vectors , iens );
+
+  vector_free( data_vectors );
+  stringlist_free( keys );
+  arg_pack_free( arg_pack );
+  return NULL;
+}
+
+
+void test_concurrent_store() {
+  ecl::util::TestArea ta("summary_block_mt");
+  double_vector_type * values = double_vector_alloc( 0 , 0 );
+  {
+    enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+    thread_pool_type * tp = thread_pool_alloc( 8 , true );
+
+    for (int iens = 0; iens < NUM_REAL; iens++) {
+      arg_pack_type * arg_pack = arg_pack_alloc( );
+      arg_pack_append_ptr( arg_pack , fs );
+      arg_pack_append_int( arg_pack , iens );
+      thread_pool_add_job( tp , store_real , arg_pack );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+    enkf_fs_decref( fs );
+  }
+  {
+    enkf_fs_type * fs = enkf_fs_mount( "mnt" );
+    for (int iens = 0; iens < NUM_REAL; iens++) {
+      char * key = util_alloc_sprintf( "REAL%d:%d" , iens , REAL_KEYS - 1 );
+
+      test_assert_true( enkf_fs_has_vector( fs , key , DYNAMIC_RESULT , iens ));
+      read_vector( fs , key , iens , values );
+      test_assert_double_equal( test_value( REAL_KEYS - 1 , 2 , 1000 * iens ) , double_vector_iget( values , 2 ));
+
+      read_vector( fs , "KEY:130" , iens , values );
+      test_assert_double_equal( test_value( 130 , 5 , iens ) , double_vector_iget( values , 5 ));
+      free( key );
+    }
+    enkf_fs_decref( fs );
+  }
+  double_vector_free( values );
+}
+
+
+int main(int argc , char ** argv) {
+  test_block();
+  test_index();
+  test_fs();
+  test_concurrent_store();
+  exit(0);
+}
@@ -0,0 +1,111 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_summary_key_matcher.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_sum.hpp>
+#include <ert/ecl/ecl_smspec.hpp>
+
+#include <ert/enkf/summary_key_matcher.hpp>
+
+
+#define NUM_LAYOUTS 9
+
+/*
+  Each layout has the field vectors and one well WOPR vector, the well
+  name differs between the layouts.
+*/
+
+static ecl_sum_type * alloc_layout( int layout_nr ) {
+  char * case_name = util_alloc_sprintf( "CASE_%d" , layout_nr );
+  char * well = util_alloc_sprintf( "OP_%d" , layout_nr );
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( case_name , false , true , ":" , util_make_date_utc( 1 , 1 , 2010 ) , true , 10 , 10 , 10 );
+
+  ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "Barrels" , 0 );
+  ecl_sum_add_var( ecl_sum , "FOPR" , NULL , 0 , "Barrels" , 0 );
+  ecl_sum_add_var( ecl_sum , "WOPR" , well , 0 , "Barrels" , 0 );
+
+  free( well );
+  free( case_name );
+  return ecl_sum;
+}
+
+
+static int count_matches( const summary_key_matcher_type * matcher , const ecl_sum_type * ecl_sum ) {
+  int_vector_type * matches = summary_key_matcher_alloc_smspec_matches( matcher , ecl_sum_get_smspec( ecl_sum ));
+  int count = int_vector_size( matches );
+  int_vector_free( matches );
+  return count;
+}
+
+
+void test_cache() {
+  ecl::util::TestArea ta("summary_key_matcher");
+  summary_key_matcher_type * matcher = summary_key_matcher_alloc( );
+  ecl_sum_type * layouts[NUM_LAYOUTS];
+
+  for (int i = 0; i < NUM_LAYOUTS; i++)
+    layouts[i] = alloc_layout( i );
+
+  summary_key_matcher_add_summary_key( matcher , "FOP*" );
+  summary_key_matcher_add_summary_key( matcher , "WOPR:OP_0" );
+
+  /* Cache hit: the second lookup of a layout gives the same result. */
+  test_assert_false( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( layouts[0] )));
+  test_assert_int_equal( 3 , count_matches( matcher , layouts[0] ));
+  test_assert_true( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( layouts[0] )));
+  test_assert_int_equal( 3 , count_matches( matcher , layouts[0] ));
+
+  /* Layouts with the same keys share one cache entry. */
+  {
+    ecl_sum_type * copy = alloc_layout( 0 );
+    test_assert_true( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( copy )));
+    test_assert_int_equal( 3 , count_matches( matcher , copy ));
+    ecl_sum_free( copy );
+  }
+
+  /* Eviction: the ninth layout replaces the first one. */
+  for (int i = 1; i < NUM_LAYOUTS; i++)
+    test_assert_int_equal( 2 , count_matches( matcher , layouts[i] ));
+
+  test_assert_false( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( layouts[0] )));
+  for (int i = 1; i < NUM_LAYOUTS; i++)
+    test_assert_true( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( layouts[i] )));
+  test_assert_int_equal( 3 , count_matches( matcher , layouts[0] ));
+
+  /* Adding a key clears the cache, and the new key is used. */
+  summary_key_matcher_add_summary_key( matcher , "WOPR:*" );
+  for (int i = 0; i < NUM_LAYOUTS; i++)
+    test_assert_false( summary_key_matcher_has_cached_layout( matcher , ecl_sum_get_smspec( layouts[i] )));
+  test_assert_int_equal( 3 , count_matches( matcher , layouts[1] ));
+
+  for (int i = 0; i < NUM_LAYOUTS; i++)
+    ecl_sum_free( layouts[i] );
+  summary_key_matcher_free( matcher );
+}
+
+
+int main(int argc , char ** argv) {
+  test_cache();
+  exit(0);
+}
@@ -0,0 +1,227 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_summary_ref.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/buffer.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.h>
+
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/summary.hpp>
+#include <ert/enkf/summary_ref.hpp>
+
+#define PARAMS_SIZE   2500
+#define NUM_MINISTEPS 5
+
+
+static float test_value(int ministep, int params_index) {
+  return ministep * 10000 + params_index;
+}
+
+
+static void write_unsmry(const char * filename, int num_ministeps) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * seqhdr = ecl_kw_alloc( "SEQHDR" , 1 , ECL_INT );
+  ecl_kw_type * ministep_kw = ecl_kw_alloc( "MINISTEP" , 1 , ECL_INT );
+  ecl_kw_type * params = ecl_kw_alloc( "PARAMS" , PARAMS_SIZE , ECL_FLOAT );
+
+  ecl_kw_iset_int( seqhdr , 0 , 0 );
+  ecl_kw_fwrite( seqhdr , fortio );
+  for (int ministep = 0; ministep < num_ministeps; ministep++) {
+    ecl_kw_iset_int( ministep_kw , 0 , ministep );
+    ecl_kw_fwrite( ministep_kw , fortio );
+
+    for (int i = 0; i < PARAMS_SIZE; i++)
+      ecl_kw_iset_float( params , i , test_value( ministep , i ));
+    ecl_kw_fwrite( params , fortio );
+  }
+
+  ecl_kw_free( params );
+  ecl_kw_free( ministep_kw );
+  ecl_kw_free( seqhdr );
+  fortio_fclose( fortio );
+}
+
+
+/*
+  Report step 0 has no data; report step 1 ends with ministep 1, report
+  step 2 with ministep 3 and report step 3 with ministep 4.
+*/
+
+static int_vector_type * alloc_ministep_index() {
+  int_vector_type * ministep_index = int_vector_alloc( 4 , -1 );
+  int_vector_iset( ministep_index , 1 , 1 );
+  int_vector_iset( ministep_index , 2 , 3 );
+  int_vector_iset( ministep_index , 3 , 4 );
+  return ministep_index;
+}
+
+
+static void assert_values(summary_ref_type * summary_ref, const char * key, int params_index) {
+  double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+  test_assert_true( summary_ref_load_values( summary_ref , key , values ));
+  test_assert_int_equal( double_vector_size( values ) , 4 );
+  test_assert_double_equal( double_vector_iget( values , 0 ) , SUMMARY_UNDEF );
+  test_assert_double_equal( double_vector_iget( values , 1 ) , test_value( 1 , params_index ));
+  test_assert_double_equal( double_vector_iget( values , 2 ) , test_value( 3 , params_index ));
+  test_assert_double_equal( double_vector_iget( values , 3 ) , test_value( 4 , params_index ));
+  double_vector_free( values );
+}
+
+
+void test_load() {
+  ecl::util::TestArea ta("summary_ref_load");
+  int_vector_type * ministep_index = alloc_ministep_index();
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS );
+
+  test_assert_NULL( summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE + 1 , NUM_MINISTEPS , ministep_index ));
+  test_assert_NULL( summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS + 1 , ministep_index ));
+  test_assert_NULL( summary_ref_alloc( "DOES_NOT_EXIST.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS , ministep_index ));
+  {
+    summary_ref_type * summary_ref = summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS , ministep_index );
+    test_assert_true( summary_ref_is_instance( summary_ref ));
+
+    summary_ref_add_key( summary_ref , "FOPT" , 0 );
+    summary_ref_add_key( summary_ref , "WOPR:OP_1" , 1500 );
+    summary_ref_add_key( summary_ref , "WOPR:OP_2" , PARAMS_SIZE - 1 );
+    test_assert_int_equal( summary_ref_get_size( summary_ref ) , 3 );
+    test_assert_true( summary_ref_has_key( summary_ref , "FOPT" ));
+    test_assert_false( summary_ref_has_key( summary_ref , "FOPR" ));
+    test_assert_true( summary_ref_is_valid( summary_ref ));
+
+    assert_values( summary_ref , "FOPT" , 0 );
+    assert_values( summary_ref , "WOPR:OP_1" , 1500 );
+    assert_values( summary_ref , "WOPR:OP_2" , PARAMS_SIZE - 1 );
+    {
+      double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+      test_assert_false( summary_ref_load_values( summary_ref , "FOPR" , values ));
+      double_vector_free( values );
+    }
+
+    summary_ref_fwrite( summary_ref , "summary-ref" );
+    summary_ref_free( summary_ref );
+  }
+  {
+    summary_ref_type * summary_ref = summary_ref_fread_alloc( "summary-ref" );
+    test_assert_int_equal( summary_ref_get_size( summary_ref ) , 3 );
+    assert_values( summary_ref , "WOPR:OP_1" , 1500 );
+    summary_ref_free( summary_ref );
+  }
+  int_vector_free( ministep_index );
+}
+
+
+void test_buffer() {
+  ecl::util::TestArea ta("summary_ref_buffer");
+  int_vector_type * ministep_index = alloc_ministep_index();
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS );
+  {
+    summary_ref_type * summary_ref = summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS , ministep_index );
+    buffer_type * buffer = buffer_alloc( 100 );
+
+    summary_ref_add_key( summary_ref , "FOPT" , 7 );
+    test_assert_true( summary_ref_fread_buffer( summary_ref , "FOPT" , buffer ));
+
+    buffer_fskip_time_t( buffer );
+    test_assert_int_equal( buffer_fread_int( buffer ) , SUMMARY );
+    test_assert_int_equal( buffer_fread_int( buffer ) , 4 );
+    test_assert_double_equal( buffer_fread_double( buffer ) , SUMMARY_UNDEF );
+    test_assert_double_equal( buffer_fread_double( buffer ) , SUMMARY_UNDEF );
+    test_assert_double_equal( buffer_fread_double( buffer ) , test_value( 1 , 7 ));
+
+    buffer_free( buffer );
+    summary_ref_free( summary_ref );
+  }
+  int_vector_free( ministep_index );
+}
+
+
+void test_invalid_after_change() {
+  ecl::util::TestArea ta("summary_ref_change");
+  int_vector_type * ministep_index = alloc_ministep_index();
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS );
+  {
+    summary_ref_type * summary_ref = summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS , ministep_index );
+    summary_ref_add_key( summary_ref , "FOPT" , 0 );
+    summary_ref_fwrite( summary_ref , "summary-ref" );
+    summary_ref_free( summary_ref );
+  }
+
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS + 1 );
+  {
+    summary_ref_type * summary_ref = summary_ref_fread_alloc( "summary-ref" );
+    double_vector_type * values = double_vector_alloc( 0 , SUMMARY_UNDEF );
+
+    test_assert_false( summary_ref_is_valid( summary_ref ));
+    test_assert_false( summary_ref_load_values( summary_ref , "FOPT" , values ));
+
+    double_vector_free( values );
+    summary_ref_free( summary_ref );
+  }
+  int_vector_free( ministep_index );
+}
+
+
+/*
+  When the UNSMRY file is rewritten after the reference was stored the
+  vector is reported as missing by the filesystem; reading it returns
+  false instead of aborting.
+*/
+
+void test_fs_invalid_after_change() {
+  ecl::util::TestArea ta("summary_ref_fs");
+  int_vector_type * ministep_index = alloc_ministep_index();
+  buffer_type * buffer = buffer_alloc( 100 );
+  enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS );
+  {
+    summary_ref_type * summary_ref = summary_ref_alloc( "CASE.UNSMRY" , PARAMS_SIZE , NUM_MINISTEPS , ministep_index );
+    summary_ref_add_key( summary_ref , "FOPT" , 0 );
+    enkf_fs_set_summary_ref( fs , 0 , summary_ref );
+  }
+
+  test_assert_true( enkf_fs_has_vector( fs , "FOPT" , DYNAMIC_RESULT , 0 ));
+  test_assert_true( enkf_fs_fread_vector( fs , buffer , "FOPT" , DYNAMIC_RESULT , 0 ));
+
+  write_unsmry( "CASE.UNSMRY" , NUM_MINISTEPS + 1 );
+  test_assert_false( enkf_fs_has_vector( fs , "FOPT" , DYNAMIC_RESULT , 0 ));
+  test_assert_false( enkf_fs_fread_vector( fs , buffer , "FOPT" , DYNAMIC_RESULT , 0 ));
+
+  enkf_fs_decref( fs );
+  buffer_free( buffer );
+  int_vector_free( ministep_index );
+}
+
+
+int main(int argc , char ** argv) {
+  test_load();
+  test_buffer();
+  test_invalid_after_change();
+  test_fs_invalid_after_change();
+  exit(0);
+}
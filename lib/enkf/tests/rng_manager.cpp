@@ -23,6 +23,8 @@
 #include <ert/util/test_util.h>
 #include <ert/util/rng.h>
 #include <ert/util/test_work_area.h>
+#include <ert/res_util/thread_pool.hpp>
+#include <ert/res_util/arg_pack.hpp>
 #include <ert/enkf/rng_manager.hpp>
 
 #define MAX_INT 999999
@@ -175,8 +177,60 @@ static void test_alloc() {
 }
 
 
+/*
+  The rng instances must not depend on the order, or the threads, in
+  which they are first requested.
+*/
+
+#define NUM_THREADS 4
+#define NUM_RNG     200
+
+static void * iget_rng( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  rng_manager_type * rng_manager = (rng_manager_type *) arg_pack_iget_ptr( arg_pack , 0 );
+  rng_type ** rng_list = (rng_type **) arg_pack_iget_ptr( arg_pack , 1 );
+  int offset = arg_pack_iget_int( arg_pack , 2 );
+
+  for (int i = NUM_RNG - 1 - offset; i >= 0; i -= NUM_THREADS)
+    rng_list[i] = rng_manager_iget( rng_manager , i );
+
+  return NULL;
+}
+
+
+static void test_concurrent_iget() {
+  rng_manager_type * rng_manager1 = rng_manager_alloc_default( );
+  rng_manager_type * rng_manager2 = rng_manager_alloc_default( );
+  rng_type * rng_list[NUM_RNG];
+  arg_pack_type * arg_list[NUM_THREADS];
+  {
+    thread_pool_type * tp = thread_pool_alloc( NUM_THREADS , true );
+    for (int t = 0; t < NUM_THREADS; t++) {
+      arg_list[t] = arg_pack_alloc();
+      arg_pack_append_ptr( arg_list[t] , rng_manager2 );
+      arg_pack_append_ptr( arg_list[t] , rng_list );
+      arg_pack_append_int( arg_list[t] , t );
+      thread_pool_add_job( tp , iget_rng , arg_list[t] );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+    for (int t = 0; t < NUM_THREADS; t++)
+      arg_pack_free( arg_list[t] );
+  }
+
+  for (int i = 0; i < NUM_RNG; i++) {
+    test_assert_true( rng_list[i] == rng_manager_iget( rng_manager2 , i ));
+    test_assert_int_equal( rng_get_int( rng_manager_iget( rng_manager1 , i ), MAX_INT ), rng_get_int( rng_list[i] , MAX_INT ));
+  }
+
+  rng_manager_free( rng_manager2 );
+  rng_manager_free( rng_manager1 );
+}
+
+
 int main(int argc , char ** argv) {
   test_alloc();
+  test_concurrent_iget();
   test_create();
   test_default();
   test_state();
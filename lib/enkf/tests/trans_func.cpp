@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <cmath>
 
 #include <ert/util/test_util.h>
 #include <ert/util/stringlist.h>
@@ -90,9 +91,67 @@ void test_create() {
   }
 }
 
+
+static trans_func_type * alloc_trans_func(const char * name , const char * arg1 , const char * arg2 , const char * arg3 , const char * arg4) {
+  stringlist_type * args = stringlist_alloc_new();
+  trans_func_type * trans_func;
+  const char * arg_list[] = {arg1 , arg2 , arg3 , arg4};
+
+  stringlist_append_copy(args , name);
+  for (int i=0; i < 4; i++)
+    if (arg_list[i])
+      stringlist_append_copy(args , arg_list[i]);
+
+  trans_func = trans_func_alloc(args);
+  stringlist_free(args);
+  test_assert_not_NULL( trans_func );
+  return trans_func;
+}
+
+
+void test_vector() {
+  const int size = 101;
+  double x[101];
+  double y[101];
+  trans_func_type * trans_funcs[] = { alloc_trans_func("ERRF" , "1" , "5" , "0.1" , "2") ,
+                                      alloc_trans_func("LOGNORMAL" , "1" , "0.5" , NULL , NULL) ,
+                                      alloc_trans_func("TRUNCATED_NORMAL" , "1" , "2" , "0" , "2.5") ,
+                                      alloc_trans_func("DUNIF" , "5" , "1" , "3" , NULL) ,
+                                      alloc_trans_func("LOGUNIF" , "0.01" , "100" , NULL , NULL) ,
+                                      alloc_trans_func("TRIANGULAR" , "0" , "1" , "4" , NULL) ,
+                                      alloc_trans_func("CONST" , "7" , NULL , NULL , NULL) };
+  const int num_funcs = sizeof trans_funcs / sizeof trans_funcs[0];
+
+  for (int i=0; i < size; i++)
+    x[i] = -4 + 8.0 * i / (size - 1);
+
+  for (int j=0; j < num_funcs; j++) {
+    trans_func_eval_vector( trans_funcs[j] , size , x , y );
+    for (int i=0; i < size; i++)
+      test_assert_double_equal( trans_func_eval( trans_funcs[j] , x[i] ) , y[i] );
+  }
+
+  trans_func_eval_vector( trans_funcs[1] , size , x , y );
+  test_assert_double_equal( exp( x[17] * 0.5 + 1 ) , y[17] );
+
+  trans_func_eval_vector( trans_funcs[2] , size , x , y );
+  test_assert_double_equal( 0.0 , y[0] );
+  test_assert_double_equal( 2.5 , y[size - 1] );
+  test_assert_double_equal( x[50] * 2 + 1 , y[50] );
+
+  /* In place */
+  trans_func_eval_vector( trans_funcs[6] , size , x , x );
+  test_assert_double_equal( 7 , x[33] );
+
+  for (int j=0; j < num_funcs; j++)
+    trans_func_free( trans_funcs[j] );
+}
+
+
 int main(int argc , char ** argv) {
   test_create();
   test_triangular();
   test_triangular_assymetric();
+  test_vector();
 }
 
@@ -32,10 +32,55 @@
 
 
 
+typedef enum {
+  TRANS_UNKNOWN = 0,
+  TRANS_NORMAL,
+  TRANS_LOGNORMAL,
+  TRANS_TRUNCATED_NORMAL,
+  TRANS_TRIANGULAR,
+  TRANS_UNIFORM,
+  TRANS_DUNIF,
+  TRANS_ERRF,
+  TRANS_DERRF,
+  TRANS_LOGUNIF,
+  TRANS_CONST,
+  TRANS_RAW
+} trans_kernel_id_type;
+
+
+/*
+  The parameters of the transformation unpacked to typed fields, and
+  the quantities which only depend on the parameters evaluated once;
+  this is filled in by trans_func_compile() when the function has been
+  allocated. Only the fields used by the actual function are set.
+*/
+
+typedef struct {
+  int    steps;
+  double min;
+  double max;
+  double range;            /* max - min */
+  double mu;
+  double std;
+  double skewness;
+  double width_sqrt2;      /* width * sqrt(2) */
+  double log_min;
+  double log_range;        /* log(max) - log(min) */
+  double xmin;
+  double xmax;
+  double inv_norm_left;
+  double inv_norm_right;
+  double ymode;
+  double value;
+} trans_kernel_type;
+
+
+
 struct trans_func_struct {
   char               * name;               /* The name this function is registered as. */
   double_vector_type * params;             /* The parameter values registered for this function. */
-  transform_ftype    * func;               /* A pointer to the actual transformation function. */
+  trans_kernel_id_type kernel_id;          /* Which of the transformation kernels below to use. */
+  trans_kernel_type    kernel;             /* The parameters in the form used by the kernel. */
   validate_ftype     * validate;           /* A pointer to a a function which can be used to validate the parameters - can be NULL. */
   stringlist_type    * param_names;        /* A list of the parameter names. */
   bool                 use_log;
@@ -59,102 +104,74 @@ struct trans_func_struct {
    The width is a relavant scale for the value of skewness.
 */
 
-static double trans_errf(double x, const double_vector_type * arg) {
-  double min      = double_vector_iget(arg , 0);
-  double max      = double_vector_iget(arg , 1);
-  double skewness = double_vector_iget(arg , 2);
-  double width    = double_vector_iget(arg , 3);
+static inline double trans_errf(double x, const trans_kernel_type * k) {
   double y;
 
-  y = 0.5*(1 + erf((x + skewness)/(width * sqrt(2.0))));
-  return min + y * (max - min);
+  y = 0.5*(1 + erf((x + k->skewness)/k->width_sqrt2));
+  return k->min + y * k->range;
 }
 
 
 
 
-static double trans_const(double x , const double_vector_type * arg) {
-  return double_vector_iget(arg , 0);
+static inline double trans_const(double x , const trans_kernel_type * k) {
+  return k->value;
 }
 
 
-static double trans_raw(double x , const double_vector_type * arg) {
+static inline double trans_raw(double x , const trans_kernel_type * k) {
   return x;
 }
 
 
 
 /* Observe that the argument of the shift should be "+" */
-static double trans_derrf(double x , const double_vector_type * arg) {
-  int    steps    = double_vector_iget(arg , 0);
-  double min      = double_vector_iget(arg , 1);
-  double max      = double_vector_iget(arg , 2);
-  double skewness = double_vector_iget(arg , 3);
-  double width    = double_vector_iget(arg , 4);
+static inline double trans_derrf(double x , const trans_kernel_type * k) {
   double y;
 
-  y = floor( steps * 0.5*(1 + erf((x + skewness)/(width * sqrt(2.0)))) / (steps - 1) );
-  return min + y * (max - min);
+  y = floor( k->steps * 0.5*(1 + erf((x + k->skewness)/k->width_sqrt2)) / (k->steps - 1) );
+  return k->min + y * k->range;
 }
 
 
 
 
 
-static double trans_unif(double x , const double_vector_type * arg) {
+static inline double trans_unif(double x , const trans_kernel_type * k) {
   double y;
-  double min   = double_vector_iget(arg , 0);
-  double max   = double_vector_iget(arg , 1);
   y = 0.5*(1 + erf(x/sqrt(2.0))); /* 0 - 1 */
-  return y * (max - min) + min;
+  return y * k->range + k->min;
 }
 
 
 
-static double trans_dunif(double x , const double_vector_type * arg) {
+static inline double trans_dunif(double x , const trans_kernel_type * k) {
   double y;
-  int    steps = double_vector_iget(arg , 0);
-  double min   = double_vector_iget(arg , 1);
-  double max   = double_vector_iget(arg , 2);
 
   y = 0.5*(1 + erf(x/sqrt(2.0))); /* 0 - 1 */
-  return (floor( y * steps) / (steps - 1)) * (max - min) + min;
+  return (floor( y * k->steps) / (k->steps - 1)) * k->range + k->min;
 }
 
 
 
 
-static double trans_normal(double x , const double_vector_type * arg) {
-  double mu , std;
-  mu  = double_vector_iget(arg , 0 );
-  std = double_vector_iget(arg , 1 );
-  return x * std + mu;
+static inline double trans_normal(double x , const trans_kernel_type * k) {
+  return x * k->std + k->mu;
 }
 
 
-static double trans_truncated_normal(double x , const double_vector_type * arg) {
-  double mu , std , min , max;
-
-  mu  = double_vector_iget(arg , 0 );
-  std = double_vector_iget(arg , 1 );
-  min = double_vector_iget(arg , 2 );
-  max = double_vector_iget(arg , 3 );
-
-  {
-    double y = x * std + mu;
-    util_clamp_double( &y , min , max );
-    return y;
-  }
+static inline double trans_truncated_normal(double x , const trans_kernel_type * k) {
+  double y = x * k->std + k->mu;
+  util_clamp_double( &y , k->min , k->max );
+  return y;
 }
 
 
 
 
-static double trans_lognormal(double x, const double_vector_type * arg) {
-  double mu, std;
-  mu  = double_vector_iget(arg , 0 );   /* The expectation of log( y ) */
-  std = double_vector_iget(arg , 1 );
-  return exp(x * std + mu);
+static inline double trans_lognormal(double x, const trans_kernel_type * k) {
+  /* mu is the expectation of log( y ) */
+  return exp(x * k->std + k->mu);
 }
 
 
@@ -165,32 +182,97 @@ static double trans_lognormal(double x, const double_vector_type * arg) {
    distribution in the same manner as the lognormal distribution
    relates to the normal distribution.
 */
-static double trans_logunif(double x , const double_vector_type * arg) {
-  double log_min = log(double_vector_iget(arg , 0));
-  double log_max = log(double_vector_iget(arg , 1));
+static inline double trans_logunif(double x , const trans_kernel_type * k) {
   double log_y;
   {
     double tmp = 0.5*(1 + erf(x/sqrt(2.0)));           /* 0 - 1 */
-    log_y      = log_min + tmp * (log_max - log_min);  /* Shift according to max / min */
+    log_y      = k->log_min + tmp * k->log_range;      /* Shift according to max / min */
   }
   return exp(log_y);
 }
 
 
-static double trans_triangular(double x, const double_vector_type * arg) {
-  double xmin = double_vector_iget(arg, 0);
-  double xmode = double_vector_iget(arg, 1);
-  double xmax = double_vector_iget(arg,2);
-
-  double inv_norm_left = (xmax - xmin) * (xmode - xmin);
-  double inv_norm_right = (xmax - xmin) * (xmax - xmode);
-  double ymode = (xmode - xmin) / (xmax - xmin);
+static inline double trans_triangular(double x, const trans_kernel_type * k) {
   double y = 0.5*(1 + erf(x/sqrt(2.0)));           /* 0 - 1 */
 
-  if (y < ymode)
-    return xmin + sqrt(y * inv_norm_left);
+  if (y < k->ymode)
+    return k->xmin + sqrt(y * k->inv_norm_left);
   else
-    return xmax - sqrt((1 - y)*inv_norm_right);
+    return k->xmax - sqrt((1 - y)*k->inv_norm_right);
+}
+
+
+/*
+  Unpacks the parameter values to the typed kernel parameters; must
+  be called when all the parameters have been parsed.
+*/
+
+static void trans_func_compile( trans_func_type * trans_func ) {
+  const double_vector_type * arg = trans_func->params;
+  trans_kernel_type * k = &trans_func->kernel;
+
+  memset( k , 0 , sizeof * k );
+  switch (trans_func->kernel_id) {
+  case TRANS_NORMAL:
+  case TRANS_LOGNORMAL:
+    k->mu  = double_vector_iget(arg , 0);
+    k->std = double_vector_iget(arg , 1);
+    break;
+  case TRANS_TRUNCATED_NORMAL:
+    k->mu  = double_vector_iget(arg , 0);
+    k->std = double_vector_iget(arg , 1);
+    k->min = double_vector_iget(arg , 2);
+    k->max = double_vector_iget(arg , 3);
+    break;
+  case TRANS_TRIANGULAR:
+    {
+      double xmin  = double_vector_iget(arg, 0);
+      double xmode = double_vector_iget(arg, 1);
+      double xmax  = double_vector_iget(arg, 2);
+
+      k->xmin           = xmin;
+      k->xmax           = xmax;
+      k->inv_norm_left  = (xmax - xmin) * (xmode - xmin);
+      k->inv_norm_right = (xmax - xmin) * (xmax - xmode);
+      k->ymode          = (xmode - xmin) / (xmax - xmin);
+    }
+    break;
+  case TRANS_UNIFORM:
+    k->min   = double_vector_iget(arg , 0);
+    k->max   = double_vector_iget(arg , 1);
+    k->range = k->max - k->min;
+    break;
+  case TRANS_DUNIF:
+    k->steps = double_vector_iget(arg , 0);
+    k->min   = double_vector_iget(arg , 1);
+    k->max   = double_vector_iget(arg , 2);
+    k->range = k->max - k->min;
+    break;
+  case TRANS_ERRF:
+    k->min         = double_vector_iget(arg , 0);
+    k->max         = double_vector_iget(arg , 1);
+    k->skewness    = double_vector_iget(arg , 2);
+    k->width_sqrt2 = double_vector_iget(arg , 3) * sqrt(2.0);
+    k->range       = k->max - k->min;
+    break;
+  case TRANS_DERRF:
+    k->steps       = double_vector_iget(arg , 0);
+    k->min         = double_vector_iget(arg , 1);
+    k->max         = double_vector_iget(arg , 2);
+    k->skewness    = double_vector_iget(arg , 3);
+    k->width_sqrt2 = double_vector_iget(arg , 4) * sqrt(2.0);
+    k->range       = k->max - k->min;
+    break;
+  case TRANS_LOGUNIF:
+    k->log_min   = log(double_vector_iget(arg , 0));
+    k->log_range = log(double_vector_iget(arg , 1)) - k->log_min;
+    break;
+  case TRANS_CONST:
+    k->value = double_vector_iget(arg , 0);
+    break;
+  default:
+    break;
+  }
 }
 
 
@@ -210,7 +292,7 @@ static trans_func_type * trans_func_alloc_empty( const char * func_name) {
 
 
   trans_func->params      = double_vector_alloc(0,0);
-  trans_func->func        = NULL;
+  trans_func->kernel_id   = TRANS_UNKNOWN;
   trans_func->validate    = NULL;
   trans_func->name        = util_alloc_string_copy( func_name );
   trans_func->param_names = stringlist_alloc_new();
@@ -228,13 +310,13 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
   if (util_string_equal(func_name , "NORMAL")) {
     stringlist_append_copy( trans_func->param_names , "MEAN");
     stringlist_append_copy( trans_func->param_names , "STD" );
-    trans_func->func = trans_normal;
+    trans_func->kernel_id = TRANS_NORMAL;
   }
 
   if (util_string_equal( func_name , "LOGNORMAL")) {
     stringlist_append_copy( trans_func->param_names , "MEAN");
     stringlist_append_copy( trans_func->param_names , "STD" );
-    trans_func->func = trans_lognormal;
+    trans_func->kernel_id = TRANS_LOGNORMAL;
     trans_func->use_log = true;
   }
 
@@ -244,7 +326,7 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names , "MIN");
     stringlist_append_copy( trans_func->param_names , "MAX" );
 
-    trans_func->func = trans_truncated_normal;
+    trans_func->kernel_id = TRANS_TRUNCATED_NORMAL;
   }
 
   if (util_string_equal(func_name, "TRIANGULAR")) {
@@ -252,13 +334,13 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names, "XMODE");
     stringlist_append_copy( trans_func->param_names, "XMAX");
 
-    trans_func->func = trans_triangular;
+    trans_func->kernel_id = TRANS_TRIANGULAR;
   }
 
   if (util_string_equal( func_name , "UNIFORM")) {
     stringlist_append_copy( trans_func->param_names , "MIN");
     stringlist_append_copy( trans_func->param_names , "MAX" );
-    trans_func->func = trans_unif;
+    trans_func->kernel_id = TRANS_UNIFORM;
   }
 
 
@@ -267,7 +349,7 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names , "MIN");
     stringlist_append_copy( trans_func->param_names , "MAX" );
 
-    trans_func->func = trans_dunif;
+    trans_func->kernel_id = TRANS_DUNIF;
   }
 
 
@@ -277,7 +359,7 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names , "SKEWNESS");
     stringlist_append_copy( trans_func->param_names , "WIDTH" );
 
-    trans_func->func = trans_errf;
+    trans_func->kernel_id = TRANS_ERRF;
   }
 
 
@@ -288,7 +370,7 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names , "SKEWNESS");
     stringlist_append_copy( trans_func->param_names , "WIDTH" );
 
-    trans_func->func = trans_derrf;
+    trans_func->kernel_id = TRANS_DERRF;
   }
 
 
@@ -296,24 +378,24 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     stringlist_append_copy( trans_func->param_names , "MIN");
     stringlist_append_copy( trans_func->param_names , "MAX" );
 
-    trans_func->func = trans_logunif;
+    trans_func->kernel_id = TRANS_LOGUNIF;
     trans_func->use_log = true;
   }
 
 
   if (util_string_equal( func_name , "CONST")) {
     stringlist_append_copy( trans_func->param_names , "VALUE");
-    trans_func->func = trans_const;
+    trans_func->kernel_id = TRANS_CONST;
   }
 
 
   if (util_string_equal( func_name , "RAW"))
-    trans_func->func = trans_raw;
+    trans_func->kernel_id = TRANS_RAW;
 
 
   /* Parsing parameter values. */
 
-  if (!trans_func->func) {
+  if (trans_func->kernel_id == TRANS_UNKNOWN) {
     trans_func_free( trans_func );
     return NULL;
   }
@@ -335,13 +417,71 @@ trans_func_type * trans_func_alloc( const stringlist_type * args ) {
     }
   }
 
+  trans_func_compile( trans_func );
   return trans_func;
 }
 
 
+#define TRANS_KERNEL_LOOP(kernel)       \
+for (int i=0; i < size; i++)            \
+  y[i] = kernel( x[i] , k );
+
+
+/*
+  Transforms the size values in x and stores the result in y; x and
+  y can be the same array. The choice of transformation is made once,
+  and the loop runs on the typed kernel without any function pointer
+  or parameter lookup per value.
+*/
+
+void trans_func_eval_vector( const trans_func_type * trans_func , int size , const double * x , double * y) {
+  const trans_kernel_type * k = &trans_func->kernel;
+
+  switch (trans_func->kernel_id) {
+  case TRANS_NORMAL:
+    TRANS_KERNEL_LOOP( trans_normal );
+    break;
+  case TRANS_LOGNORMAL:
+    TRANS_KERNEL_LOOP( trans_lognormal );
+    break;
+  case TRANS_TRUNCATED_NORMAL:
+    TRANS_KERNEL_LOOP( trans_truncated_normal );
+    break;
+  case TRANS_TRIANGULAR:
+    TRANS_KERNEL_LOOP( trans_triangular );
+    break;
+  case TRANS_UNIFORM:
+    TRANS_KERNEL_LOOP( trans_unif );
+    break;
+  case TRANS_DUNIF:
+    TRANS_KERNEL_LOOP( trans_dunif );
+    break;
+  case TRANS_ERRF:
+    TRANS_KERNEL_LOOP( trans_errf );
+    break;
+  case TRANS_DERRF:
+    TRANS_KERNEL_LOOP( trans_derrf );
+    break;
+  case TRANS_LOGUNIF:
+    TRANS_KERNEL_LOOP( trans_logunif );
+    break;
+  case TRANS_CONST:
+    TRANS_KERNEL_LOOP( trans_const );
+    break;
+  case TRANS_RAW:
+    TRANS_KERNEL_LOOP( trans_raw );
+    break;
+  default:
+    util_abort("%s: internal error - transformation:%s has no kernel \n",__func__ , trans_func->name);
+  }
+}
+
+#undef TRANS_KERNEL_LOOP
+
 
 double trans_func_eval( const trans_func_type * trans_func , double x) {
-  double y = trans_func->func( x , trans_func->params );
+  double y;
+  trans_func_eval_vector( trans_func , 1 , &x , &y );
   return y;
 }
 
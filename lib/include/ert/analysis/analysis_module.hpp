@@ -24,6 +24,7 @@ extern "C" {
 
 #include <ert/util/type_macros.hpp>
 #include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 #include <ert/util/bool_vector.hpp>
 
 #include <ert/analysis/module_info.hpp>
@@ -46,16 +47,18 @@ typedef enum {
     ANALYSIS_USE_A      = 4,       // The module will read the content of A - but not modify it.
     ANALYSIS_UPDATE_A   = 8,       // The update will be based on modifying A directly, and not on an X matrix.
     ANALYSIS_SCALE_DATA = 16,
-    ANALYSIS_ITERABLE   = 32       // The module can bu used as an iterative smoother.
+    ANALYSIS_ITERABLE   = 32,      // The module can bu used as an iterative smoother.
+    ANALYSIS_BLOCK_R    = 64       // The X matrix is created with initX_block() from a block diagonal R; no dense R is assembled.
 } analysis_module_flag_enum;
 
 
-#define ANALYSIS_MODULE_FLAG_ENUM_SIZE 5
+#define ANALYSIS_MODULE_FLAG_ENUM_SIZE 6
 #define ANALYSIS_MODULE_FLAG_ENUM_DEFS {.value = ANALYSIS_NEED_ED     , .name = "ANALYSIS_NEED_ED"},\
                                        {.value = ANALYSIS_USE_A       , .name = "ANALYSIS_USE_A"},\
                                        {.value = ANALYSIS_UPDATE_A    , .name = "ANALYSIS_UPDATE_A"},\
                                        {.value = ANALYSIS_SCALE_DATA  , .name = "ANALYSIS_SCALE_DATA"},\
-                                       {.value = ANALYSIS_ITERABLE    , .name = "ANALYSIS_ITERABLE"}
+                                       {.value = ANALYSIS_ITERABLE    , .name = "ANALYSIS_ITERABLE"},\
+                                       {.value = ANALYSIS_BLOCK_R     , .name = "ANALYSIS_BLOCK_R"}
 
 
 #define EXTERNAL_MODULE_NAME "analysis_table"
@@ -89,6 +92,16 @@ typedef enum {
                              rng_type * rng);
 
 
+  void analysis_module_initX_block(analysis_module_type * module ,
+                                   matrix_type * X ,
+                                   const matrix_type * S ,
+                                   const block_diag_matrix_type * R ,
+                                   const matrix_type * dObs ,
+                                   const matrix_type * E ,
+                                   const matrix_type * D,
+                                   rng_type * rng);
+
+
   void analysis_module_updateA(analysis_module_type * module ,
                                matrix_type * A ,
                                const matrix_type * S ,
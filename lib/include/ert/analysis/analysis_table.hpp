@@ -7,6 +7,7 @@ extern "C" {
 
 
 #include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 #include <ert/util/rng.hpp>
 #include <ert/util/bool_vector.hpp>
 
@@ -35,6 +36,20 @@ extern "C" {
                                              rng_type * rng);
 
 
+  /*
+    As initX, but with R in block diagonal form; only called for
+    modules which set the ANALYSIS_BLOCK_R option.
+  */
+  typedef void (analysis_initX_block_ftype) (void * module_data ,
+                                             matrix_type * X ,
+                                             const matrix_type * S ,
+                                             const block_diag_matrix_type * R ,
+                                             const matrix_type * dObs ,
+                                             const matrix_type * E ,
+                                             const matrix_type * D,
+                                             rng_type * rng);
+
+
   typedef bool (analysis_set_int_ftype)       (void * module_data , const char * flag , int value);
   typedef bool (analysis_set_bool_ftype)      (void * module_data , const char * flag , bool value);
   typedef bool (analysis_set_double_ftype)    (void * module_data , const char * var , double value);
@@ -87,6 +102,13 @@ typedef struct {
   analysis_get_double_ftype      * get_double;
   analysis_get_bool_ftype        * get_bool;
   analysis_get_ptr_ftype         * get_ptr;
+
+  /*
+    Members added after the original table go here, at the end, so
+    that external modules compiled against the older layout still find
+    the other members at the same offsets.
+  */
+  analysis_initX_block_ftype     * initX_block;
 } analysis_table_type;
 
 
@@ -5,6 +5,7 @@
 
 #include <ert/res_util/matrix_lapack.hpp>
 #include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +41,7 @@ void enkf_linalg_init_sqrtX(matrix_type * X5      ,
 
 
 void enkf_linalg_Cee(matrix_type * B, int nrens , const matrix_type * R , const matrix_type * U0 , const double * inv_sig0);
+void enkf_linalg_Cee_block(matrix_type * B, int nrens , const block_diag_matrix_type * R , const matrix_type * U0 , const double * inv_sig0);
 
 
 int enkf_linalg_svd_truncation(const matrix_type * S ,
@@ -61,6 +63,16 @@ int enkf_linalg_svdS(const matrix_type * S ,
 
 
 
+int enkf_linalg_rsvdS(const matrix_type * S ,
+                      double truncation ,
+                      int ncomp ,
+                      dgesvd_vector_enum store_V0T ,
+                      double * inv_sig0,
+                      matrix_type * U0 ,
+                      matrix_type * V0T ,
+                      int oversampling ,
+                      int power_iterations);
+
 matrix_type * enkf_linalg_alloc_innov( const matrix_type * dObs , const matrix_type * S);
 
 void enkf_linalg_lowrankCinv__(const matrix_type * S ,
@@ -88,6 +100,31 @@ void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
                           double truncation     ,
                           int    ncomp);
 
+void enkf_linalg_lowrankCinv_block(const matrix_type * S ,
+                                   const block_diag_matrix_type * R ,
+                                   matrix_type * W       ,
+                                   double * eig          ,
+                                   double truncation     ,
+                                   int    ncomp);
+
+void enkf_linalg_lowrankCinv_rsvd(const matrix_type * S ,
+                                  const matrix_type * R ,
+                                  matrix_type * W       ,
+                                  double * eig          ,
+                                  double truncation     ,
+                                  int    ncomp          ,
+                                  int    oversampling   ,
+                                  int    power_iterations);
+
+void enkf_linalg_lowrankE_rsvd(const matrix_type * S ,
+                               const matrix_type * E ,
+                               matrix_type * W       ,
+                               double * eig          ,
+                               double truncation     ,
+                               int    ncomp          ,
+                               int    oversampling   ,
+                               int    power_iterations);
+
 void enkf_linalg_genX2(matrix_type * X2 , const matrix_type * S , const matrix_type * W , const double * eig);
 void enkf_linalg_genX3(matrix_type * X3 , const matrix_type * W , const matrix_type * D , const double * eig);
 
@@ -8,6 +8,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 #include <ert/util/rng.hpp>
 
 #define  DEFAULT_ENKF_TRUNCATION_  0.98
@@ -16,6 +17,9 @@ extern "C" {
 #define  USE_EE_KEY_               "USE_EE"
 #define  USE_GE_KEY_               "USE_GE"
 #define  ANALYSIS_SCALE_DATA_KEY_  "ANALYSIS_SCALE_DATA"
+#define  USE_RSVD_KEY_             "USE_RSVD"
+#define  RSVD_OVERSAMPLING_KEY_    "RSVD_OVERSAMPLING"
+#define  RSVD_POWER_ITER_KEY_      "RSVD_POWER_ITER"
 
   typedef struct std_enkf_data_struct std_enkf_data_type;
 
@@ -49,6 +53,14 @@ extern "C" {
                         const matrix_type * E ,
                         const matrix_type * D,
                         rng_type * rng);
+  void   std_enkf_initX_block(void * module_data ,
+                              matrix_type * X ,
+                              const matrix_type * S ,
+                              const block_diag_matrix_type * R ,
+                              const matrix_type * dObs ,
+                              const matrix_type * E ,
+                              const matrix_type * D,
+                              rng_type * rng);
 
 #ifdef __cplusplus
 }
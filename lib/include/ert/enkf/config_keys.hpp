@@ -95,6 +95,10 @@ extern "C" {
 #define  INSTALL_JOB_DIRECTORY_KEY         "INSTALL_JOB_DIRECTORY"
 #define  JOB_SCRIPT_KEY                    "JOB_SCRIPT"
 #define  JOBNAME_KEY                       "JOBNAME"
+#define  LAZY_SUMMARY_LOAD_KEY             "LAZY_SUMMARY_LOAD"
+#define  COLUMNAR_SUMMARY_STORAGE_KEY      "COLUMNAR_SUMMARY_STORAGE"
+#define  LOAD_READ_THREADS_KEY             "LOAD_READ_THREADS"
+#define  LOAD_STORE_THREADS_KEY            "LOAD_STORE_THREADS"
 #define  LICENSE_PATH_KEY                  "LICENSE_PATH"
 #define  LOAD_SEED_KEY                     "LOAD_SEED"
 #define  LOCAL_CONFIG_KEY                  "LOCAL_CONFIG"
@@ -260,6 +264,10 @@ extern "C" {
   const char * config_keys_get_data_root_key();
   const char * config_keys_get_rftpath_key();
   const char * config_keys_get_gen_kw_export_name_key();
+  const char * config_keys_get_lazy_summary_load_key();
+  const char * config_keys_get_columnar_summary_storage_key();
+  const char * config_keys_get_load_read_threads_key();
+  const char * config_keys_get_load_store_threads_key();
   /* ************* Model config  ************* */
 
   /* ************* Ensemble config  ************* */
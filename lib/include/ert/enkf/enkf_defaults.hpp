@@ -99,6 +99,10 @@ const char * enkf_defaults_get_default_gen_kw_export_name();
 
 #define DEFAULT_MAX_SUBMIT           2        /* The number of times to resubmit - default value for config item: MAX_SUBMIT */
 #define DEFAULT_MAX_INTERNAL_SUBMIT  1        /** Attached to keyword : MAX_RETRY */
+#define DEFAULT_LAZY_SUMMARY_LOAD    false    /* Attached to keyword : LAZY_SUMMARY_LOAD */
+#define DEFAULT_COLUMNAR_SUMMARY_STORAGE false /* Attached to keyword : COLUMNAR_SUMMARY_STORAGE */
+#define DEFAULT_LOAD_READ_THREADS    0        /* Attached to keyword : LOAD_READ_THREADS; 0 means one per core. */
+#define DEFAULT_LOAD_STORE_THREADS   0        /* Attached to keyword : LOAD_STORE_THREADS; 0 means one per core. */
 
 
 
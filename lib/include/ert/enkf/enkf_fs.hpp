@@ -24,6 +24,8 @@
 #include <ert/util/type_macros.h>
 #include <ert/util/buffer.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+#include <ert/util/double_vector.h>
 
 #include <ert/enkf/fs_driver.hpp>
 #include <ert/enkf/enkf_types.hpp>
@@ -33,7 +35,9 @@
 #include <ert/enkf/cases_config.hpp>
 #include <ert/enkf/state_map.hpp>
 #include <ert/enkf/misfit_ensemble_typedef.hpp>
+#include <ert/enkf/ensemble_stats_typedef.hpp>
 #include <ert/enkf/summary_key_set.hpp>
+#include <ert/enkf/summary_ref.hpp>
 #include <ert/enkf/custom_kw_config_set.hpp>
 
 #ifdef __cplusplus
@@ -56,6 +60,8 @@ extern "C" {
   int               enkf_fs_get_version104( const char * path );
   void              enkf_fs_fwrite_node(enkf_fs_type * enkf_fs , buffer_type * buffer , const char * node_key, enkf_var_type var_type,
                                         int report_step , int iens);
+  void              enkf_fs_copy_node(enkf_fs_type * src_fs , enkf_fs_type * target_fs , buffer_type * buffer , const char * node_key , enkf_var_type var_type,
+                                      int src_step , int src_iens , int target_step , int target_iens );
 
   void              enkf_fs_fwrite_vector(enkf_fs_type * enkf_fs ,
                                           buffer_type * buffer ,
@@ -63,19 +69,37 @@ extern "C" {
                                           enkf_var_type var_type,
                                           int iens);
 
+  void              enkf_fs_fwrite_vectors(enkf_fs_type * enkf_fs ,
+                                           const vector_type * buffers ,
+                                           const stringlist_type * node_keys,
+                                           enkf_var_type var_type,
+                                           int iens);
+
+  void              enkf_fs_fwrite_summary_block(enkf_fs_type * fs ,
+                                                 const stringlist_type * node_keys ,
+                                                 const vector_type * data_vectors ,
+                                                 int iens);
+
+  bool              enkf_fs_fread_summary_step(enkf_fs_type * fs ,
+                                               const stringlist_type * node_keys ,
+                                               int iens ,
+                                               int report_step ,
+                                               double_vector_type * values);
+
   bool              enkf_fs_exists( const char * mount_point );
 
   void              enkf_fs_fread_node(enkf_fs_type * enkf_fs , buffer_type * buffer ,
                                        const char * node_key , enkf_var_type var_type ,
                                        int report_step , int iens);
 
-  void              enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
+  bool              enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
                                          const char * node_key ,
                                          enkf_var_type var_type ,
                                          int iens);
 
 
   bool              enkf_fs_has_vector(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int iens);
+  void              enkf_fs_set_summary_ref( enkf_fs_type * fs , int iens , summary_ref_type * summary_ref );
   bool              enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens);
 
   enkf_fs_type *    enkf_fs_create_fs( const char * mount_point , fs_driver_impl driver_id , void * arg, bool mount);
@@ -97,6 +121,7 @@ extern "C" {
   time_map_type             * enkf_fs_get_time_map( const enkf_fs_type * fs );
   cases_config_type         * enkf_fs_get_cases_config( const enkf_fs_type * fs);
   misfit_ensemble_type      * enkf_fs_get_misfit_ensemble( const enkf_fs_type * fs );
+  ensemble_stats_type       * enkf_fs_get_ensemble_stats( const enkf_fs_type * fs );
   summary_key_set_type      * enkf_fs_get_summary_key_set( const enkf_fs_type * fs );
   custom_kw_config_set_type * enkf_fs_get_custom_kw_config_set( const enkf_fs_type * fs );
 
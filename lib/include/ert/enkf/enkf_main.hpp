@@ -58,6 +58,7 @@
 #include <ert/enkf/pca_plot_data.hpp>
 #include <ert/enkf/field_config.hpp>
 #include <ert/enkf/ert_run_context.hpp>
+#include <ert/enkf/load_timing.hpp>
 
 #ifdef __cplusplus
 extern "C" {
@@ -201,6 +202,7 @@ extern "C" {
   int enkf_main_load_from_forward_model_from_gui(enkf_main_type * enkf_main, int iter , bool_vector_type * iactive, enkf_fs_type * fs);
   int enkf_main_load_from_run_context(enkf_main_type* enkf_main, ert_run_context_type* run_context, stringlist_type** realizations_msg_list, enkf_fs_type* fs);
   int enkf_main_load_from_run_context_from_gui(enkf_main_type* enkf_main, ert_run_context_type* run_context, enkf_fs_type* fs);
+  const load_timing_type * enkf_main_get_load_timing( const enkf_main_type * enkf_main );
 
   void enkf_main_rank_on_observations(enkf_main_type * enkf_main,
                                       const char * ranking_key,
@@ -26,6 +26,7 @@
 #include <ert/util/rng.h>
 #include <ert/util/hash.h>
 #include <ert/util/int_vector.h>
+#include <ert/util/vector.h>
 #include <ert/util/type_macros.h>
 
 #include <ert/ecl/ecl_kw.h>
@@ -152,12 +153,14 @@ extern "C" {
                       node_id_type target_id );
   enkf_node_type *  enkf_node_load_alloc( const enkf_config_node_type * config_node , enkf_fs_type * fs , node_id_type node_id);
   bool              enkf_node_fload( enkf_node_type * enkf_node , const char * filename );
-  void              enkf_node_load(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id );
-  void              enkf_node_load_vector( enkf_node_type * enkf_node , enkf_fs_type * fs , int iens);
+  bool              enkf_node_load(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id );
+  bool              enkf_node_load_vector( enkf_node_type * enkf_node , enkf_fs_type * fs , int iens);
   bool              enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force_vectors , node_id_type node_id);
   bool              enkf_node_store_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens );
+  bool              enkf_node_store_vectors(const vector_type * node_list , enkf_fs_type * fs , int iens );
   bool              enkf_node_try_load(enkf_node_type *enkf_node , enkf_fs_type * fs , node_id_type node_id);
   bool              enkf_node_try_load_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens );
+  bool              enkf_node_vector_has_data( const enkf_node_type * enkf_node , int report_step );
   bool              enkf_node_exists( enkf_node_type *enkf_node , enkf_fs_type * fs , int report_step , int iens);
   bool              enkf_node_vector_storage( const enkf_node_type * node );
   enkf_node_type  * enkf_node_alloc_shared_container(const enkf_config_node_type * config, hash_type * node_hash);
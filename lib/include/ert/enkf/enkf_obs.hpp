@@ -92,9 +92,10 @@ extern "C" {
   stringlist_type * enkf_obs_alloc_matching_keylist(const enkf_obs_type * enkf_obs , const char * input_string);
   time_t            enkf_obs_iget_obs_time(const enkf_obs_type * enkf_obs , int report_step);
   void              enkf_obs_scale_std(enkf_obs_type * enkf_obs, double scale_factor);
-  void enkf_obs_local_scale_std( const enkf_obs_type * enkf_obs , const local_obsdata_type * local_obsdata, double scale_factor);
+  long              enkf_obs_get_revision( const enkf_obs_type * enkf_obs );
+  void enkf_obs_local_scale_std( enkf_obs_type * enkf_obs , const local_obsdata_type * local_obsdata, double scale_factor);
   void              enkf_obs_add_local_nodes_with_data(const enkf_obs_type * enkf_obs , local_obsdata_type * local_obs , enkf_fs_type *fs , const bool_vector_type * ens_mask);
-  double            enkf_obs_scale_correlated_std(const enkf_obs_type * enkf_obs ,
+  double            enkf_obs_scale_correlated_std(enkf_obs_type * enkf_obs ,
                                                   enkf_fs_type * fs ,
                                                   const int_vector_type * ens_active_list ,
                                                   const local_obsdata_type * local_obsdata,
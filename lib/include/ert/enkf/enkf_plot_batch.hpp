@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'enkf_plot_batch.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ENKF_PLOT_BATCH_H
+#define ERT_ENKF_PLOT_BATCH_H
+
+#include <time.h>
+#include <stdbool.h>
+
+#include <ert/util/bool_vector.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/enkf/enkf_config_node.hpp>
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/enkf_plot_tvector.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  typedef struct enkf_plot_batch_struct enkf_plot_batch_type;
+
+  enkf_plot_batch_type   * enkf_plot_batch_alloc( );
+  void                     enkf_plot_batch_free( enkf_plot_batch_type * batch );
+  int                      enkf_plot_batch_add_key( enkf_plot_batch_type * batch , const enkf_config_node_type * config_node , const char * index_key);
+  void                     enkf_plot_batch_iset_index_key( enkf_plot_batch_type * batch , int key_index , const char * index_key);
+  int                      enkf_plot_batch_get_num_keys( const enkf_plot_batch_type * batch );
+  void                     enkf_plot_batch_load( enkf_plot_batch_type * batch , enkf_fs_type * fs , const bool_vector_type * input_mask);
+  int                      enkf_plot_batch_get_ens_size( const enkf_plot_batch_type * batch );
+  int                      enkf_plot_batch_get_num_steps( const enkf_plot_batch_type * batch );
+  const time_t           * enkf_plot_batch_get_time( const enkf_plot_batch_type * batch );
+  const double           * enkf_plot_batch_iget_data( const enkf_plot_batch_type * batch , int key_index );
+  const bool             * enkf_plot_batch_iget_active( const enkf_plot_batch_type * batch , int key_index );
+  enkf_plot_tvector_type * enkf_plot_batch_iget( const enkf_plot_batch_type * batch , int key_index , int iens);
+
+  UTIL_IS_INSTANCE_HEADER( enkf_plot_batch );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
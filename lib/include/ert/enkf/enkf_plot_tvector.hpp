@@ -42,6 +42,18 @@ extern "C" {
 
   void                     enkf_plot_tvector_reset( enkf_plot_tvector_type * plot_tvector );
   enkf_plot_tvector_type * enkf_plot_tvector_alloc( const enkf_config_node_type * config_node , int iens);
+  enkf_plot_tvector_type * enkf_plot_tvector_alloc_view( const enkf_config_node_type * config_node ,
+                                                         int iens ,
+                                                         int size ,
+                                                         const time_t * time ,
+                                                         const double * data ,
+                                                         const bool * mask);
+  void                     enkf_plot_tvector_set_view( enkf_plot_tvector_type * plot_tvector ,
+                                                       int size ,
+                                                       const time_t * time ,
+                                                       const double * data ,
+                                                       const bool * mask);
+  bool                     enkf_plot_tvector_is_view( const enkf_plot_tvector_type * plot_tvector );
   void                     enkf_plot_tvector_load( enkf_plot_tvector_type * plot_tvector , enkf_fs_type * fs , const char * user_key );
   void *                   enkf_plot_tvector_load__( void * arg );
   void                     enkf_plot_tvector_free( enkf_plot_tvector_type * plot_tvector );
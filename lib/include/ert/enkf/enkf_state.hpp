@@ -49,6 +49,7 @@
 #include <ert/enkf/enkf_util.hpp>
 #include <ert/enkf/enkf_serialize.hpp>
 #include <ert/enkf/run_arg.hpp>
+#include <ert/enkf/forward_load_context.hpp>
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,6 +60,7 @@ typedef struct enkf_state_struct    enkf_state_type;
   //void             * enkf_state_complete_forward_model__(void * arg );
   void *             enkf_state_load_from_forward_model_mt( void * arg );
   void               enkf_state_initialize(enkf_state_type * enkf_state , rng_type * rng, enkf_fs_type * fs, const stringlist_type * param_list , init_mode_type init_mode);
+  bool               enkf_state_initialize_nodes(enkf_state_type * enkf_state , rng_type * rng, enkf_fs_type * fs, const stringlist_type * param_list , init_mode_type init_mode);
   void               enkf_state_swapout_node(const enkf_state_type * , const char *);
   void               enkf_state_swapin_node(const enkf_state_type *  , const char *);
   void               enkf_state_iset_eclpath(enkf_state_type * , int , const char *);
@@ -71,6 +73,14 @@ typedef struct enkf_state_struct    enkf_state_type;
                                                         run_arg_type * run_arg ,
                                                         stringlist_type * msg_list);
 
+  forward_load_context_type * enkf_state_open_forward_model(enkf_state_type * enkf_state ,
+                                                            run_arg_type * run_arg ,
+                                                            stringlist_type * msg_list ,
+                                                            bool manual_load);
+
+  int                enkf_state_internalize_forward_model(enkf_state_type * enkf_state ,
+                                                          forward_load_context_type * load_context);
+
   int enkf_state_forward_init(const ensemble_config_type * ens_config,
 			      run_arg_type * run_arg);
 
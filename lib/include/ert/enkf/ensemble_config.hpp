@@ -22,6 +22,7 @@
 
 #include <ert/util/stringlist.hpp>
 #include <ert/util/hash.hpp>
+#include <ert/util/vector.hpp>
 
 #include <ert/ecl/ecl_grid.hpp>
 #include <ert/ecl/ecl_sum.hpp>
@@ -74,6 +75,7 @@ typedef struct ensemble_config_struct ensemble_config_type;
   field_trans_table_type         * ensemble_config_get_trans_table( const ensemble_config_type * ensemble_config );
   enkf_config_node_type          * ensemble_config_get_node(const ensemble_config_type * , const char * );
   enkf_config_node_type          * ensemble_config_get_or_create_summary_node(ensemble_config_type * ensemble_config, const char * key);
+  void                             ensemble_config_get_or_create_summary_nodes(ensemble_config_type * ensemble_config, const stringlist_type * keys, vector_type * config_nodes);
   stringlist_type                * ensemble_config_alloc_keylist(const ensemble_config_type *);
   stringlist_type                * ensemble_config_alloc_keylist_from_var_type(const ensemble_config_type *  , int var_mask);
   stringlist_type                * ensemble_config_alloc_keylist_from_impl_type(const ensemble_config_type *, ert_impl_type);
@@ -0,0 +1,82 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'ensemble_stats.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ENSEMBLE_STATS_H
+#define ERT_ENSEMBLE_STATS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/vector.h>
+
+#include <ert/enkf/enkf_config_node.hpp>
+#include <ert/enkf/enkf_fs.hpp>
+#include <ert/enkf/ensemble_stats_typedef.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  ENSEMBLE_STAT_MEAN = 0,
+  ENSEMBLE_STAT_STD  = 1,
+  ENSEMBLE_STAT_MIN  = 2,
+  ENSEMBLE_STAT_MAX  = 3,
+  ENSEMBLE_STAT_P10  = 4,
+  ENSEMBLE_STAT_P50  = 5,
+  ENSEMBLE_STAT_P90  = 6
+} ensemble_stat_enum;
+
+#define ENSEMBLE_STAT_COUNT 7
+
+  typedef struct key_stats_struct key_stats_type;
+
+  key_stats_type      * key_stats_alloc_copy( const key_stats_type * src );
+  void                  key_stats_free( key_stats_type * key_stats );
+  int                   key_stats_get_num_steps( const key_stats_type * key_stats );
+  double                key_stats_iget( const key_stats_type * key_stats , ensemble_stat_enum stat , int step );
+  int                   key_stats_iget_count( const key_stats_type * key_stats , int step );
+  const int_vector_type * key_stats_get_realizations( const key_stats_type * key_stats );
+
+  ensemble_stats_type * ensemble_stats_alloc( );
+  void                  ensemble_stats_free( ensemble_stats_type * ensemble_stats );
+  void                  ensemble_stats_clear( ensemble_stats_type * ensemble_stats );
+  int                   ensemble_stats_get_size( const ensemble_stats_type * ensemble_stats );
+  bool                  ensemble_stats_is_dirty( const ensemble_stats_type * ensemble_stats );
+  void                  ensemble_stats_fwrite( ensemble_stats_type * ensemble_stats , FILE * stream );
+  void                  ensemble_stats_fread( ensemble_stats_type * ensemble_stats , FILE * stream );
+  void                  ensemble_stats_invalidate( ensemble_stats_type * ensemble_stats , const char * node_key );
+  void                  ensemble_stats_invalidate_keys( ensemble_stats_type * ensemble_stats , const stringlist_type * node_keys );
+  void                  ensemble_stats_update( ensemble_stats_type * ensemble_stats ,
+                                               enkf_fs_type * fs ,
+                                               const vector_type * config_nodes ,
+                                               const stringlist_type * index_keys );
+  key_stats_type      * ensemble_stats_alloc_key_stats( ensemble_stats_type * ensemble_stats ,
+                                                        enkf_fs_type * fs ,
+                                                        const enkf_config_node_type * config_node ,
+                                                        const char * index_key );
+
+  UTIL_IS_INSTANCE_HEADER( ensemble_stats );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,6 @@
+#ifndef ERT_ENSEMBLE_STATS_TYPEDEF_H
+#define ERT_ENSEMBLE_STATS_TYPEDEF_H
+
+typedef struct ensemble_stats_struct ensemble_stats_type;
+
+#endif
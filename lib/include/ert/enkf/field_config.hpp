@@ -124,6 +124,7 @@ int                     field_config_get_nx(const field_config_type * config );
 int                     field_config_get_ny(const field_config_type * config );
 int                     field_config_get_nz(const field_config_type * config );
 void                    field_config_free(field_config_type *);
+const field_type      * field_config_get_init_baseline( const field_config_type * config , const char * init_file );
 int                     field_config_get_volume(const field_config_type * );
 int                     field_config_get_data_size_from_grid(const field_config_type * config);
 void                    field_config_set_ecl_data_type(field_config_type *  , ecl_data_type );
@@ -147,6 +148,7 @@ const char            * field_config_get_key(const field_config_type * );
 bool                    field_config_keep_inactive_cells(const field_config_type *);
 field_func_type       * field_config_get_init_transform(const field_config_type * );
 field_func_type       * field_config_get_output_transform(const field_config_type * );
+field_vfunc_type      * field_config_get_init_vtransform(const field_config_type * );
 bool                    field_config_is_valid( const field_config_type * field_config );
 void                    field_config_assert_binary( const field_config_type *  , const field_config_type *  , const char * );
 void                    field_config_assert_unary( const field_config_type *  , const char * );
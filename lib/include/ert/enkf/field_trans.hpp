@@ -26,15 +26,18 @@ extern "C" {
 
 
 typedef  float  (field_func_type) ( float );
+typedef  void   (field_vfunc_type) ( float * , int );   /* In place vector version of field_func_type. */
 typedef  struct field_trans_table_struct field_trans_table_type;
 
 
 void                     field_trans_table_fprintf(const field_trans_table_type * , FILE * );
 void                     field_trans_table_free(field_trans_table_type * );
 void                     field_trans_table_add(field_trans_table_type * , const char * , const char *  , field_func_type * );
+void                     field_trans_table_add_vector(field_trans_table_type * , const char * , const char *  , field_func_type * , field_vfunc_type * );
 field_trans_table_type * field_trans_table_alloc();
 bool                     field_trans_table_has_key(field_trans_table_type *  , const char * );
 field_func_type        * field_trans_table_lookup(field_trans_table_type *  , const char * );
+field_vfunc_type       * field_trans_table_lookup_vector(field_trans_table_type *  , const char * );
 
 
 
@@ -20,6 +20,7 @@
 #define ERT_FS_DRIVER_H
 #include <ert/util/buffer.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
 
 #include <ert/enkf/enkf_node.hpp>
 #include <ert/enkf/fs_types.hpp>
@@ -173,6 +174,7 @@ extern "C" {
   typedef void (save_vector_ftype)    (void * driver, const char * , int , buffer_type * );
   typedef void (unlink_vector_ftype)  (void * driver, const char * , int );
   typedef bool (has_vector_ftype)     (void * driver, const char * , int );
+  typedef void (save_vectors_ftype)   (void * driver, const stringlist_type * , int , const vector_type * );  /* Optional: store many vectors for one realization. */
 
   typedef void (fsync_driver_ftype) (void * driver);
   typedef void (free_driver_ftype)  (void * driver);
@@ -208,6 +210,7 @@ load_vector_ftype         * load_vector;   \
 save_vector_ftype         * save_vector;   \
 has_vector_ftype          * has_vector;    \
 unlink_vector_ftype       * unlink_vector; \
+save_vectors_ftype        * save_vectors;  \
 free_driver_ftype         * free_driver;   \
 fsync_driver_ftype        * fsync_driver;  \
 int                         type_id
@@ -0,0 +1,61 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'load_timing.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_LOAD_TIMING_H
+#define ERT_LOAD_TIMING_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  typedef enum {
+    LOAD_STAGE_READ   = 0,    /* Forward init and opening / parsing the ECLIPSE files.          */
+    LOAD_STAGE_PARSE  = 1,    /* Internalizing summary, GEN_DATA and CUSTOM_KW into enkf_nodes. */
+    LOAD_STAGE_STORE  = 2     /* Writing the results to storage.                                */
+  } load_stage_type;
+
+#define LOAD_NUM_STAGES 3
+
+  typedef struct load_timing_struct load_timing_type;
+
+  load_timing_type * load_timing_alloc( );
+  void               load_timing_free( load_timing_type * timing );
+  void               load_timing_clear( load_timing_type * timing );
+  double             load_timing_now( );
+  const char       * load_timing_get_stage_name( load_stage_type stage );
+  void               load_timing_iset( load_timing_type * timing , int iens , load_stage_type stage , double seconds);
+  double             load_timing_iget( const load_timing_type * timing , int iens , load_stage_type stage );
+  bool               load_timing_has_realization( const load_timing_type * timing , int iens );
+  int                load_timing_get_size( const load_timing_type * timing );
+  double             load_timing_get_total( const load_timing_type * timing , load_stage_type stage );
+  int                load_timing_get_slowest( const load_timing_type * timing , load_stage_type stage );
+  void               load_timing_set_wall_time( load_timing_type * timing , double seconds );
+  double             load_timing_get_wall_time( const load_timing_type * timing );
+  void               load_timing_fprintf( const load_timing_type * timing , FILE * stream );
+
+  UTIL_IS_INSTANCE_HEADER( load_timing );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
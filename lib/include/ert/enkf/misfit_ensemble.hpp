@@ -30,6 +30,7 @@ extern "C" {
 #include <ert/enkf/ensemble_config.hpp>
 #include <ert/enkf/enkf_fs.hpp>
 #include <ert/enkf/misfit_member.hpp>
+#include <ert/enkf/state_map.hpp>
 
 #define MISFIT_DEFAULT_RANKING_KEY "DEFAULT"
 #include <ert/enkf/misfit_ensemble_typedef.hpp>
@@ -51,7 +52,10 @@ extern "C" {
                                                   int history_length,
                                                   bool force_init);
 
+  void                misfit_ensemble_mark_changed( misfit_ensemble_type * misfit_ensemble , const state_map_type * state_map );
+  int                 misfit_ensemble_get_num_dirty( const misfit_ensemble_type * misfit_ensemble );
   void                misfit_ensemble_set_ens_size( misfit_ensemble_type * misfit_ensemble , int ens_size);
+  void                misfit_ensemble_set_num_threads( misfit_ensemble_type * misfit_ensemble , int num_threads);
   int                 misfit_ensemble_get_ens_size( const misfit_ensemble_type * misfit_ensemble );
 
   misfit_member_type * misfit_ensemble_iget_member( const misfit_ensemble_type * table , int iens);
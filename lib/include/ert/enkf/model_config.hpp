@@ -80,6 +80,14 @@ extern "C" {
   const char           * model_config_iget_casename( const model_config_type * model_config , int index);
   void                   model_config_set_max_internal_submit(model_config_type * config, int max_resample);
   int                    model_config_get_max_internal_submit( const model_config_type * config );
+  void                   model_config_set_lazy_summary_load( model_config_type * model_config , bool lazy_summary_load);
+  bool                   model_config_get_lazy_summary_load( const model_config_type * model_config );
+  void                   model_config_set_columnar_summary_storage( model_config_type * model_config , bool columnar_summary_storage);
+  bool                   model_config_get_columnar_summary_storage( const model_config_type * model_config );
+  void                   model_config_set_load_read_threads( model_config_type * model_config , int load_read_threads);
+  int                    model_config_get_load_read_threads( const model_config_type * model_config );
+  void                   model_config_set_load_store_threads( model_config_type * model_config , int load_store_threads);
+  int                    model_config_get_load_store_threads( const model_config_type * model_config );
   bool                   model_config_select_runpath( model_config_type * model_config , const char * path_key);
   void                   model_config_add_runpath( model_config_type * model_config , const char * path_key , const char * fmt );
   const char           * model_config_get_runpath_as_char( const model_config_type * model_config );
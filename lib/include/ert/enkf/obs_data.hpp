@@ -28,6 +28,7 @@ extern "C" {
 #include <ert/util/rng.h>
 
 #include <ert/res_util/matrix.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
 #include <ert/enkf/enkf_types.hpp>
 #include <ert/enkf/meas_data.hpp>
 
@@ -57,12 +58,14 @@ obs_block_type *     obs_data_get_block( obs_data_type * obs_data , const char *
 obs_block_type *     obs_data_add_block( obs_data_type * obs_data , const char * obs_key , int obs_size , matrix_type * error_covar , bool error_covar_owner);
 void obs_data_scale_matrix(const obs_data_type * obs_data , matrix_type * matrix);
 void obs_data_scale_Rmatrix(const obs_data_type * obs_data , matrix_type * matrix);
+void obs_data_scale_block_R(const obs_data_type * obs_data , block_diag_matrix_type * R);
 
 obs_data_type      * obs_data_alloc(double global_std_scaling);
 void                 obs_data_free(obs_data_type *);
 void                 obs_data_reset(obs_data_type * obs_data);
 matrix_type        * obs_data_allocD(const obs_data_type * obs_data , const matrix_type * E  , const matrix_type * S);
 matrix_type        * obs_data_allocR(const obs_data_type * obs_data );
+block_diag_matrix_type * obs_data_alloc_block_R(const obs_data_type * obs_data );
 matrix_type        * obs_data_allocdObs(const obs_data_type * obs_data );
 matrix_type        * obs_data_allocE(const obs_data_type * obs_data , rng_type * rng , int active_ens_size);
   void                 obs_data_scale(const obs_data_type * obs_data , matrix_type *S , matrix_type *E , matrix_type *D , matrix_type *R , matrix_type * O);
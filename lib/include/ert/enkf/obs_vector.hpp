@@ -89,6 +89,12 @@ extern "C" {
                                                    int iens1 , int iens2 ,
                                                    double ** chi2);
 
+  bool                    obs_vector_vector_chi2(const obs_vector_type * obs_vector ,
+                                                 const enkf_node_type * enkf_node ,
+                                                 int iens ,
+                                                 int step1 , int step2 ,
+                                                 double * chi2);
+  double                  obs_vector_iget_chi2(const obs_vector_type * obs_vector , int report_step , const enkf_node_type * node , node_id_type node_id);
   double                  obs_vector_total_chi2(const obs_vector_type * , enkf_fs_type * , int );
   enkf_config_node_type * obs_vector_get_config_node(const obs_vector_type * );
   const char            * obs_vector_get_obs_key( const obs_vector_type * obs_vector);
@@ -50,6 +50,7 @@ extern "C" {
   void                     state_map_set_from_mask(state_map_type * map, const bool_vector_type *mask , realisation_state_enum state);
   int                      state_map_count_matching(const state_map_type * state_map , int mask);
   bool                     state_map_legal_transition( realisation_state_enum state1 , realisation_state_enum state2);
+  int                      state_map_iget_change_count( const state_map_type * map , int index );
 
   UTIL_IS_INSTANCE_HEADER( state_map );
 
@@ -19,6 +19,8 @@
 #ifndef ERT_SUMMARY_H
 #define ERT_SUMMARY_H
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/ecl_sum.h>
 #include <ert/ecl/ecl_file.h>
@@ -31,6 +33,7 @@
 extern "C" {
 #endif
 
+#define SUMMARY_UNDEF -9999
 
 
 summary_type * summary_alloc(const summary_config_type * summary_config);
@@ -38,6 +41,10 @@ void           summary_free(summary_type *summary);
 double         summary_get(const summary_type * summary, int report_step );
 bool           summary_active_value( double value );
 int            summary_length(const summary_type * summary);
+int_vector_type * summary_alloc_ministep_index(const ecl_sum_type * ecl_sum, const int_vector_type * time_index);
+bool           summary_forward_load_ministeps(summary_type * summary, const ecl_sum_type * ecl_sum, const int_vector_type * ministep_index);
+void           summary_fwrite_data_vector(buffer_type * buffer, const double_vector_type * data_vector);
+void           summary_user_get_vector(const summary_type * summary, const char * index_key, double_vector_type * value);
 
 VOID_HAS_DATA_HEADER(summary);
 UTIL_SAFE_CAST_HEADER(summary);
@@ -0,0 +1,81 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'summary_block.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_SUMMARY_BLOCK_H
+#define ERT_SUMMARY_BLOCK_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/buffer.h>
+#include <ert/util/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUMMARY_BLOCK_CHUNK_SIZE  128    /* Maximum number of keys stored in one block. */
+
+  typedef struct summary_block_struct       summary_block_type;
+  typedef struct summary_block_keys_struct  summary_block_keys_type;
+  typedef struct summary_block_index_struct summary_block_index_type;
+
+  summary_block_type       * summary_block_alloc( const vector_type * data_vectors , int offset , int num_columns , time_t write_time );
+  summary_block_type       * summary_block_fread_alloc( buffer_type * buffer );
+  void                       summary_block_fwrite( const summary_block_type * block , buffer_type * buffer );
+  void                       summary_block_free( summary_block_type * block );
+  void                       summary_block_free__( void * arg );
+  int                        summary_block_get_num_steps( const summary_block_type * block );
+  int                        summary_block_get_num_columns( const summary_block_type * block );
+  double                     summary_block_iget( const summary_block_type * block , int step , int column );
+  void                       summary_block_iget_column( const summary_block_type * block , int column , double_vector_type * values );
+  void                       summary_block_fwrite_column( const summary_block_type * block , int column , buffer_type * buffer );
+
+  summary_block_keys_type  * summary_block_keys_alloc( );
+  void                       summary_block_keys_free( summary_block_keys_type * keys );
+  void                       summary_block_keys_fread( summary_block_keys_type * keys , FILE * stream );
+  void                       summary_block_keys_fwrite( const summary_block_keys_type * keys , FILE * stream );
+  int                        summary_block_keys_get_size( const summary_block_keys_type * keys );
+  int                        summary_block_keys_get_id( const summary_block_keys_type * keys , const char * key );
+  int                        summary_block_keys_add_key( summary_block_keys_type * keys , const char * key );
+
+  summary_block_index_type * summary_block_index_alloc( );
+  summary_block_index_type * summary_block_index_fread_alloc( buffer_type * buffer );
+  void                       summary_block_index_fwrite( const summary_block_index_type * index , buffer_type * buffer );
+  void                       summary_block_index_free( summary_block_index_type * index );
+  void                       summary_block_index_free__( void * arg );
+  int                        summary_block_index_get_size( const summary_block_index_type * index );
+  int                        summary_block_index_get_num_blocks( const summary_block_index_type * index );
+  bool                       summary_block_index_get( const summary_block_index_type * index , int key_id , int * block_id , int * column );
+  int                        summary_block_index_alloc_block_id( const summary_block_index_type * index , const int_vector_type * exclude );
+  void                       summary_block_index_add_block( summary_block_index_type * index , int block_id , const int_vector_type * key_ids , int_vector_type * released );
+  bool                       summary_block_index_remove_key( summary_block_index_type * index , int key_id , int_vector_type * released );
+
+  UTIL_IS_INSTANCE_HEADER( summary_block );
+  UTIL_SAFE_CAST_HEADER( summary_block );
+  UTIL_IS_INSTANCE_HEADER( summary_block_index );
+  UTIL_SAFE_CAST_HEADER( summary_block_index );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,54 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'summary_ref.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_SUMMARY_REF_H
+#define ERT_SUMMARY_REF_H
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/buffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  typedef struct summary_ref_struct summary_ref_type;
+
+  summary_ref_type * summary_ref_alloc(const char * unsmry_file, int params_size, int num_ministeps, const int_vector_type * ministep_index);
+  summary_ref_type * summary_ref_fread_alloc(const char * filename);
+  void               summary_ref_free(summary_ref_type * summary_ref);
+  void               summary_ref_free__(void * arg);
+  void               summary_ref_fwrite(const summary_ref_type * summary_ref, const char * filename);
+  void               summary_ref_add_key(summary_ref_type * summary_ref, const char * key, int params_index);
+  bool               summary_ref_has_key(const summary_ref_type * summary_ref, const char * key);
+  int                summary_ref_get_size(const summary_ref_type * summary_ref);
+  const char       * summary_ref_get_unsmry_file(const summary_ref_type * summary_ref);
+  bool               summary_ref_is_valid(summary_ref_type * summary_ref);
+  bool               summary_ref_load_values(summary_ref_type * summary_ref, const char * key, double_vector_type * values);
+  bool               summary_ref_fread_buffer(summary_ref_type * summary_ref, const char * key, buffer_type * buffer);
+
+  UTIL_IS_INSTANCE_HEADER( summary_ref );
+  UTIL_SAFE_CAST_HEADER( summary_ref );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -35,6 +35,7 @@ typedef bool   (validate_ftype)  (const trans_func_type * );
 
 trans_func_type  * trans_func_alloc(const stringlist_type * args);
 double             trans_func_eval( const trans_func_type * trans_func , double x);
+void               trans_func_eval_vector( const trans_func_type * trans_func , int size , const double * x , double * y);
 
 void               trans_func_free( trans_func_type * trans_func );
 void               trans_func_iset_double_param(trans_func_type  * trans_func , int param_index , double value );
@@ -25,6 +25,7 @@ extern "C" {
 #endif
 
 #include <ert/util/type_macros.hpp>
+#include <ert/util/int_vector.hpp>
 
 #include <ert/job_queue/queue_driver.hpp>
 #include <ert/job_queue/job_node.hpp>
@@ -42,6 +43,8 @@ typedef struct job_list_struct job_list_type;
   void job_list_get_rdlock( job_list_type * list);
   void job_list_reader_wait( job_list_type * list, int usleep_time1, int usleep_time2);
   void job_list_unlock( job_list_type * list);
+  void job_list_update_status( job_list_type * job_list , int queue_index , job_status_type old_status , job_status_type new_status);
+  void job_list_select_status( job_list_type * job_list , int status_mask , int_vector_type * index_list);
 
   UTIL_SAFE_CAST_HEADER( job_list );
   UTIL_IS_INSTANCE_HEADER( job_list );
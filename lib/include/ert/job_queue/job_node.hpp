@@ -48,6 +48,8 @@ extern "C" {
 
 typedef bool (job_callback_ftype)   (void *);
 typedef struct job_queue_node_struct job_queue_node_type;
+typedef struct job_list_struct job_list_type;
+typedef struct job_queue_metrics_struct job_queue_metrics_type;
 
 
   time_t job_queue_node_get_timestamp(const job_queue_node_type * node);
@@ -108,8 +110,13 @@ typedef struct job_queue_node_struct job_queue_node_type;
   const char * job_queue_node_get_stderr_capture( const job_queue_node_type * node);
   const char * job_queue_node_get_stderr_file( const job_queue_node_type * node);
 
+  const char * job_queue_node_get_job_name( const job_queue_node_type * node );
   time_t job_queue_node_get_sim_start( const job_queue_node_type * node );
   time_t job_queue_node_get_sim_end( const job_queue_node_type * node );
+  time_t job_queue_node_get_done_time( const job_queue_node_type * node );
+  bool job_queue_node_start_status_check( job_queue_node_type * node );
+  void job_queue_node_end_status_check( job_queue_node_type * node );
+  double job_queue_node_get_status_time( const job_queue_node_type * node , job_status_type status);
   time_t job_queue_node_get_submit_time( const job_queue_node_type * node );
   double job_queue_node_time_since_sim_start( const job_queue_node_type * node ) ;
   void job_queue_node_set_max_confirmation_wait_time( job_queue_node_type * node, time_t time );
@@ -122,6 +129,8 @@ typedef struct job_queue_node_struct job_queue_node_type;
   void job_queue_node_run_EXIT_callback( job_queue_node_type * node );
   int job_queue_node_get_queue_index( const job_queue_node_type * node );
   void job_queue_node_set_queue_index( job_queue_node_type * node , int queue_index);
+  void job_queue_node_set_job_list( job_queue_node_type * node , job_list_type * job_list);
+  void job_queue_node_set_metrics( job_queue_node_type * node , job_queue_metrics_type * metrics);
 
   void * job_queue_node_get_driver_data( job_queue_node_type * node );
   void job_queue_node_set_status(job_queue_node_type * node , job_status_type new_status);
@@ -29,6 +29,7 @@ extern "C" {
 
 #include <ert/job_queue/queue_driver.hpp>
 #include <ert/job_queue/job_node.hpp>
+#include <ert/job_queue/job_queue_metrics.hpp>
 
   typedef struct job_queue_struct      job_queue_type;
   time_t              job_queue_get_progress_timestamp(const job_queue_type * queue);
@@ -77,6 +78,12 @@ extern "C" {
   bool                job_queue_kill_job( job_queue_type * queue , int job_index);
   bool                job_queue_is_running( const job_queue_type * queue );
   void                job_queue_set_max_submit( job_queue_type * job_queue , int max_submit );
+  void                job_queue_set_num_callback_threads( job_queue_type * job_queue , int num_threads );
+  int                 job_queue_get_num_callback_threads( const job_queue_type * job_queue );
+  void                job_queue_set_max_ok_wait_time( job_queue_type * job_queue , int max_ok_wait_time );
+  void                job_queue_set_max_submit_batch( job_queue_type * job_queue , int max_submit_batch );
+  int                 job_queue_get_submit_batch_size( const job_queue_type * job_queue );
+  job_queue_metrics_type * job_queue_get_metrics( job_queue_type * job_queue );
   int                 job_queue_get_max_submit(const job_queue_type * job_queue );
   bool                job_queue_get_open(const job_queue_type * job_queue);
   bool                job_queue_get_pause( const job_queue_type * job_queue );
@@ -0,0 +1,77 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_queue_metrics.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_JOB_QUEUE_METRICS_H
+#define ERT_JOB_QUEUE_METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+
+#include <ert/util/type_macros.hpp>
+#include <ert/job_queue/job_status.hpp>
+
+  typedef enum {
+    JOB_QUEUE_METRIC_SUBMIT         = 0,   /* Driver submit call.                        */
+    JOB_QUEUE_METRIC_STATUS         = 1,   /* Driver status call for one job.            */
+    JOB_QUEUE_METRIC_KILL           = 2,   /* Driver kill call.                          */
+    JOB_QUEUE_METRIC_LOOP           = 3,   /* One iteration of the queue main loop.      */
+    JOB_QUEUE_METRIC_DONE_CALLBACK  = 4,
+    JOB_QUEUE_METRIC_RETRY_CALLBACK = 5,
+    JOB_QUEUE_METRIC_EXIT_CALLBACK  = 6
+  } job_queue_metric_type;
+
+#define JOB_QUEUE_NUM_METRICS 7
+
+  typedef struct {
+    int     count;
+    double  total_time;       /* Seconds. */
+    double  max_time;         /* Seconds. */
+  } job_queue_timing_type;
+
+  /*
+    A consistent copy of the accumulated metrics. The status_time
+    element i holds the time jobs have spent in the status with value
+    (1 << i); it is updated when a job leaves the status.
+  */
+  typedef struct {
+    job_queue_timing_type  timing[JOB_QUEUE_NUM_METRICS];
+    job_queue_timing_type  status_time[JOB_QUEUE_MAX_STATE];
+  } job_queue_metrics_snapshot_type;
+
+  typedef struct job_queue_metrics_struct job_queue_metrics_type;
+
+  job_queue_metrics_type * job_queue_metrics_alloc();
+  void                     job_queue_metrics_free( job_queue_metrics_type * metrics );
+  void                     job_queue_metrics_clear( job_queue_metrics_type * metrics );
+  double                   job_queue_metrics_now( );
+  const char             * job_queue_metrics_get_name( job_queue_metric_type metric );
+  void                     job_queue_metrics_add_timing( job_queue_metrics_type * metrics , job_queue_metric_type metric , const char * job_name , double elapsed);
+  void                     job_queue_metrics_add_transition( job_queue_metrics_type * metrics , const char * job_name , int queue_index ,
+                                                             job_status_type old_status , job_status_type new_status , double time_in_old_status);
+  void                     job_queue_metrics_get_snapshot( job_queue_metrics_type * metrics , job_queue_metrics_snapshot_type * snapshot);
+  bool                     job_queue_metrics_open_trace( job_queue_metrics_type * metrics , const char * filename );
+  void                     job_queue_metrics_close_trace( job_queue_metrics_type * metrics );
+
+  UTIL_IS_INSTANCE_HEADER( job_queue_metrics );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
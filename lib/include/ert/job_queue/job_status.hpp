@@ -134,6 +134,7 @@ typedef enum {
 
 
 const char * job_status_get_name(job_status_type status);
+int          job_status_get_index(job_status_type status);
 
 #ifdef __cplusplus
 }
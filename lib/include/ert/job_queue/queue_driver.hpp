@@ -39,6 +39,7 @@ extern "C" {
     The options supported by the base queue_driver.
    */
 #define MAX_RUNNING          "MAX_RUNNING"
+#define SUBMIT_THREADS       "SUBMIT_THREADS"
 
 
   typedef struct queue_driver_struct queue_driver_type;
@@ -79,6 +80,8 @@ extern "C" {
 
   void queue_driver_set_max_running(queue_driver_type * driver, int max_running);
   int  queue_driver_get_max_running(const queue_driver_type * driver);
+  void queue_driver_set_submit_threads(queue_driver_type * driver, int submit_threads);
+  int  queue_driver_get_submit_threads(const queue_driver_type * driver);
 
   typedef enum {SUBMIT_OK           = 0 ,
                 SUBMIT_JOB_FAIL     = 1 , /* Typically no more attempts. */
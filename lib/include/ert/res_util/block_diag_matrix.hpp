@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'block_diag_matrix.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#ifndef ERT_BLOCK_DIAG_MATRIX_H
+#define ERT_BLOCK_DIAG_MATRIX_H
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.hpp>
+
+#include <ert/res_util/matrix.hpp>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /*
+    Square block diagonal matrix, built by appending blocks along the
+    diagonal. A block is either diagonal - stored as a vector - or
+    dense. Consecutive diagonal blocks are merged, so a purely diagonal
+    matrix is one vector of size elements.
+  */
+
+  typedef struct block_diag_matrix_struct block_diag_matrix_type;
+
+  block_diag_matrix_type * block_diag_matrix_alloc( );
+  void                     block_diag_matrix_free( block_diag_matrix_type * matrix );
+  void                     block_diag_matrix_append_diag( block_diag_matrix_type * matrix , int size , const double * diag );
+  void                     block_diag_matrix_append_dense( block_diag_matrix_type * matrix , const matrix_type * block );
+  int                      block_diag_matrix_get_size( const block_diag_matrix_type * matrix );
+  bool                     block_diag_matrix_is_diagonal( const block_diag_matrix_type * matrix );
+  double                   block_diag_matrix_iget( const block_diag_matrix_type * matrix , int i , int j );
+  matrix_type            * block_diag_matrix_alloc_dense( const block_diag_matrix_type * matrix );
+  void                     block_diag_matrix_scale( block_diag_matrix_type * matrix , const double * scale_factor );
+  void                     block_diag_matrix_matmul( matrix_type * C , const block_diag_matrix_type * matrix , const matrix_type * A );
+
+  UTIL_IS_INSTANCE_HEADER( block_diag_matrix );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -20,6 +20,7 @@
 #define ERT_BLOCK_FS
 #include <ert/util/buffer.hpp>
 #include <ert/util/vector.hpp>
+#include <ert/util/stringlist.hpp>
 #include <ert/util/type_macros.hpp>
 
 #ifdef __cplusplus
@@ -52,6 +53,7 @@ extern "C" {
   void            block_fs_close( block_fs_type * block_fs , bool unlink_empty);
   void            block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , const void * ptr , size_t byte_size);
   void            block_fs_fwrite_buffer(block_fs_type * block_fs , const char * filename , const buffer_type * buffer);
+  void            block_fs_fwrite_buffers(block_fs_type * block_fs , const stringlist_type * filenames , const vector_type * buffers);
   void            block_fs_fread_file( block_fs_type * block_fs , const char * filename , void * ptr);
   int             block_fs_get_filesize( block_fs_type * block_fs , const char * filename);
   void            block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * filename , buffer_type * buffer);
@@ -0,0 +1,44 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'counter_rng.hpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#ifndef ERT_COUNTER_RNG_H
+#define ERT_COUNTER_RNG_H
+
+#include <stdint.h>
+
+#include <ert/util/rng.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /*
+    Counter based random numbers (Philox4x32-10). A number is a pure
+    function of (seed, stream, offset), so any element of a stream can
+    be generated directly and different streams can be filled from
+    different threads with bitwise reproducible results.
+  */
+
+  void     counter_rng_philox4x32( uint64_t seed , const uint32_t * counter , uint32_t * output);
+  uint64_t counter_rng_draw_seed( rng_type * rng );
+  void     counter_rng_fill_uniform( uint64_t seed , uint64_t stream , uint64_t offset , int size , double * data);
+  void     counter_rng_fill_normal( uint64_t seed , uint64_t stream , uint64_t offset , int size , double * data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -17,6 +17,7 @@
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -24,6 +25,7 @@
 #include <unistd.h>
 
 #include <ert/util/util.hpp>
+#include <ert/util/int_vector.hpp>
 #include <ert/res_util/arg_pack.hpp>
 
 #include <ert/job_queue/job_node.hpp>
@@ -31,6 +33,22 @@
 
 
 #define JOB_LIST_TYPE_ID 8154222
+#define STATUS_WORD_BITS 64
+
+/*
+  In addition to the plain array of nodes the job_list maintains one
+  bitset per job status, where bit 'queue_index' is set if the node
+  currently has that status. The bitsets are updated by the nodes
+  themselves through job_list_update_status() whenever the status
+  changes, and are used by the queue manager to only visit the nodes
+  in the status(es) relevant for the current phase, instead of
+  scanning the full list several times per loop iteration.
+
+  The status bits are protected by the separate status_mutex, and not
+  by the rwlock, because status changes happen in parallel from
+  several threads holding the read lock, and also from the *_simple()
+  node functions used from Python which do not take the rwlock at all.
+*/
 
 struct job_list_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -38,9 +56,16 @@ struct job_list_struct {
   int alloc_size;
   job_queue_node_type ** jobs;
   pthread_rwlock_t       lock;
+  pthread_mutex_t        status_mutex;
+  uint64_t             * status_bits[JOB_QUEUE_MAX_STATE];
 };
 
 
+static int job_list_status_words( int size ) {
+  return (size + STATUS_WORD_BITS - 1) / STATUS_WORD_BITS;
+}
+
+
 UTIL_IS_INSTANCE_FUNCTION( job_list , JOB_LIST_TYPE_ID )
 UTIL_SAFE_CAST_FUNCTION( job_list , JOB_LIST_TYPE_ID )
 
@@ -50,7 +75,10 @@ job_list_type * job_list_alloc() {
   job_list->active_size = 0;
   job_list->alloc_size = 0;
   job_list->jobs = NULL;
+  for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++)
+    job_list->status_bits[index] = NULL;
   pthread_rwlock_init( &job_list->lock , NULL);
+  pthread_mutex_init( &job_list->status_mutex , NULL);
   return job_list;
 }
 
@@ -62,10 +90,34 @@ void job_list_reset( job_list_type * job_list ) {
     job_queue_node_free( node );
     job_list->jobs[queue_index] = NULL;
   }
+
+  pthread_mutex_lock( &job_list->status_mutex );
+  {
+    int num_words = job_list_status_words( job_list->alloc_size );
+    for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++)
+      if (job_list->status_bits[index])
+        memset( job_list->status_bits[index] , 0 , num_words * sizeof(uint64_t));
+  }
+  pthread_mutex_unlock( &job_list->status_mutex );
   job_list->active_size = 0;
 }
 
 
+static void job_list_resize_status_bits( job_list_type * job_list , int old_alloc_size , int new_alloc_size) {
+  int old_words = job_list_status_words( old_alloc_size );
+  int new_words = job_list_status_words( new_alloc_size );
+  if (new_words == old_words)
+    return;
+
+  pthread_mutex_lock( &job_list->status_mutex );
+  for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++) {
+    job_list->status_bits[index] = (uint64_t*)util_realloc( job_list->status_bits[index] , new_words * sizeof(uint64_t));
+    memset( &job_list->status_bits[index][old_words] , 0 , (new_words - old_words) * sizeof(uint64_t));
+  }
+  pthread_mutex_unlock( &job_list->status_mutex );
+}
+
+
 int job_list_get_size( const job_list_type * job_list ) {
   return job_list->active_size;
 }
@@ -88,6 +140,7 @@ void job_list_add_job( job_list_type * job_list , job_queue_node_type * job_node
     job_list->jobs = (job_queue_node_type**)util_realloc( job_list->jobs , sizeof * job_list->jobs * new_alloc_size );
 #endif
 
+    job_list_resize_status_bits( job_list , job_list->alloc_size , new_alloc_size );
     job_list->alloc_size = new_alloc_size;
   }
 
@@ -95,12 +148,62 @@ void job_list_add_job( job_list_type * job_list , job_queue_node_type * job_node
     int queue_index = job_list_get_size( job_list );
     job_queue_node_set_queue_index(job_node, queue_index );
     job_list->jobs[queue_index] = job_node;
+    job_list_update_status( job_list , queue_index , JOB_QUEUE_NOT_ACTIVE , job_queue_node_get_status( job_node ));
+    job_queue_node_set_job_list( job_node , job_list );
   }
   job_list->active_size++;
 
 }
 
 
+/*
+  Called by the job node itself every time the status changes; the
+  node must already have been added to the list.
+*/
+void job_list_update_status( job_list_type * job_list , int queue_index , job_status_type old_status , job_status_type new_status) {
+  int word = queue_index / STATUS_WORD_BITS;
+  uint64_t bit = UINT64_C(1) << (queue_index % STATUS_WORD_BITS);
+  int old_index = job_status_get_index( old_status );
+  int new_index = job_status_get_index( new_status );
+
+  pthread_mutex_lock( &job_list->status_mutex );
+  job_list->status_bits[old_index][word] &= ~bit;
+  job_list->status_bits[new_index][word] |= bit;
+  pthread_mutex_unlock( &job_list->status_mutex );
+}
+
+
+/*
+  Will fill the @index_list with the queue_index of all the nodes
+  which currently have a status in the @status_mask, in increasing
+  order. The list is a snapshot; the status of the nodes can change
+  while the calling scope iterates through it, so the status should be
+  checked again before acting on a node.
+
+  Must hold on to the read lock.
+*/
+void job_list_select_status( job_list_type * job_list , int status_mask , int_vector_type * index_list) {
+  int num_words = job_list_status_words( job_list->active_size );
+  int_vector_reset( index_list );
+
+  pthread_mutex_lock( &job_list->status_mutex );
+  for (int word = 0; word < num_words; word++) {
+    uint64_t bits = 0;
+    for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++) {
+      if (status_mask & (1 << index))
+        bits |= job_list->status_bits[index][word];
+    }
+
+    while (bits) {
+      int bit = __builtin_ctzll( bits );
+      int_vector_append( index_list , word * STATUS_WORD_BITS + bit );
+      bits &= bits - 1;
+    }
+  }
+  pthread_mutex_unlock( &job_list->status_mutex );
+}
+
+
 job_queue_node_type * job_list_iget_job( const job_list_type * job_list , int queue_index) {
   if (queue_index >= 0 && queue_index < job_list->active_size)
     return job_list->jobs[queue_index];
@@ -116,6 +219,8 @@ void job_list_free( job_list_type * job_list ) {
     job_list_reset( job_list );
     free( job_list->jobs );
   }
+  for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++)
+    free( job_list->status_bits[index] );
   free( job_list );
 }
 
@@ -32,6 +32,8 @@
 #include <ert/res_util/res_log.hpp>
 
 #include <ert/job_queue/job_node.hpp>
+#include <ert/job_queue/job_list.hpp>
+#include <ert/job_queue/job_queue_metrics.hpp>
 
 #define JOB_QUEUE_NODE_TYPE_ID 3315299
 #define INVALID_QUEUE_INDEX    -999
@@ -52,6 +54,9 @@ struct job_queue_node_struct {
   int                    argc;            /* The number of commandline arguments to pass when starting the job. */
   char                 **argv;            /* The commandline arguments. */
   int                    queue_index;
+  job_list_type         *job_list;        /* The list this node has been added to - kept informed about status changes. Can be NULL. */
+  job_queue_metrics_type *metrics;        /* Receives the status transitions of this node. Can be NULL. */
+  double                 status_time[JOB_QUEUE_MAX_STATE]; /* When did the job enter the different states - the LAST TIME; 0 if never. */
 
   /*-----------------------------------------------------------------*/
   char                  *failed_job;      /* Name of the job (in the chain) which has failed. */
@@ -68,6 +73,8 @@ struct job_queue_node_struct {
   time_t                 submit_time;     /* When was the job added to job_queue - the FIRST TIME. */
   time_t                 sim_start;       /* When did the job change status -> RUNNING - the LAST TIME. */
   time_t                 sim_end ;        /* When did the job finish successfully */
+  time_t                 done_time;       /* When did the driver report the job as DONE - the LAST TIME. */
+  bool                   status_check_pending; /* A check of the OK / EXIT files has been started and not completed. */
   time_t                 max_confirm_wait;/* Max waiting between sim_start and confirmed_running is 2 minutes */
   time_t                 progress_timestamp; /* Timestamp of the status update update file. */
 };
@@ -183,6 +190,14 @@ void job_queue_node_set_queue_index( job_queue_node_type * node , int queue_inde
     util_abort("%s: internal error: attempt to reset queue_index \n", __func__);
 }
 
+void job_queue_node_set_job_list( job_queue_node_type * node , job_list_type * job_list) {
+  node->job_list = job_list;
+}
+
+void job_queue_node_set_metrics( job_queue_node_type * node , job_queue_metrics_type * metrics) {
+  node->metrics = metrics;
+}
+
 
 /*
  The error information is retained even after the job has completed
@@ -337,10 +352,16 @@ job_queue_node_type * job_queue_node_alloc( const char * job_name ,
 
   node->job_status     = JOB_QUEUE_NOT_ACTIVE;
   node->queue_index    = INVALID_QUEUE_INDEX;
+  node->job_list       = NULL;
+  node->metrics        = NULL;
+  for (int i=0; i < JOB_QUEUE_MAX_STATE; i++)
+    node->status_time[i] = 0;
   node->submit_attempt = 0;
   node->job_data       = NULL; // assume allocation is run in single thread mode
   node->sim_start      = 0;
   node->sim_end        = 0;
+  node->done_time      = 0;
+  node->status_check_pending = false;
   node->submit_time    = time( NULL );
   node->max_confirm_wait= 60*2; // 2 minutes before we consider job dead.
 
@@ -386,10 +407,52 @@ time_t job_queue_node_get_sim_start( const job_queue_node_type * node ) {
 }
 
 
+const char * job_queue_node_get_job_name( const job_queue_node_type * node ) {
+  return node->job_name;
+}
+
 time_t job_queue_node_get_sim_end( const job_queue_node_type * node ) {
   return node->sim_end;
 }
 
+time_t job_queue_node_get_done_time( const job_queue_node_type * node ) {
+  return node->done_time;
+}
+
+
+/*
+  The OK / EXIT files of a DONE node are checked by the threads in the
+  work_pool of the queue; these functions ensure that only one check
+  is running at the time. Returns false if a check is already running.
+*/
+
+bool job_queue_node_start_status_check( job_queue_node_type * node ) {
+  bool started = false;
+  pthread_mutex_lock( &node->data_mutex );
+  if (!node->status_check_pending) {
+    node->status_check_pending = true;
+    started = true;
+  }
+  pthread_mutex_unlock( &node->data_mutex );
+  return started;
+}
+
+
+void job_queue_node_end_status_check( job_queue_node_type * node ) {
+  pthread_mutex_lock( &node->data_mutex );
+  node->status_check_pending = false;
+  pthread_mutex_unlock( &node->data_mutex );
+}
+
+/*
+  Wall clock time, in seconds with microsecond resolution, when the
+  node last entered @status; 0 if it has never been in that status.
+*/
+
+double job_queue_node_get_status_time( const job_queue_node_type * node , job_status_type status) {
+  return node->status_time[ job_status_get_index( status ) ];
+}
+
 time_t job_queue_node_get_submit_time( const job_queue_node_type * node ) {
   return node->submit_time;
 }
@@ -429,6 +492,19 @@ void job_queue_node_set_status(job_queue_node_type * node , job_status_type new_
                  node->job_name,
                  node->queue_index,
                  job_status_get_name(new_status));
+  if (node->job_list)
+    job_list_update_status( node->job_list , node->queue_index , node->job_status , new_status );
+
+  {
+    double now = job_queue_metrics_now();
+    double old_time = node->status_time[ job_status_get_index( node->job_status ) ];
+
+    if (node->metrics)
+      job_queue_metrics_add_transition( node->metrics , node->job_name , node->queue_index ,
+                                        node->job_status , new_status ,
+                                        (old_time > 0) ? now - old_time : -1);
+    node->status_time[ job_status_get_index( new_status ) ] = now;
+  }
   node->job_status = new_status;
 
   /*
@@ -443,6 +519,9 @@ void job_queue_node_set_status(job_queue_node_type * node , job_status_type new_
   if (new_status == JOB_QUEUE_RUNNING)
     node->sim_start = time( NULL );
 
+  if (new_status == JOB_QUEUE_DONE)
+    node->done_time = time( NULL );
+
 
   if (!(new_status & JOB_QUEUE_COMPLETE_STATUS))
     return;
@@ -25,8 +25,10 @@
 #include <stdio.h>
 #include <pthread.h>
 #include <unistd.h>
+#include <sys/time.h>
 
 #include <ert/util/util.hpp>
+#include <ert/util/int_vector.hpp>
 #include <ert/res_util/arg_pack.hpp>
 #include <ert/res_util/res_log.hpp>
 #include <ert/res_util/thread_pool.hpp>
@@ -36,6 +38,7 @@
 #include <ert/job_queue/job_node.hpp>
 #include <ert/job_queue/job_list.hpp>
 #include <ert/job_queue/job_queue_status.hpp>
+#include <ert/job_queue/job_queue_metrics.hpp>
 #include <ert/job_queue/queue_driver.hpp>
 
 
@@ -180,9 +183,17 @@
 
       b) If the job has produced an OK file it has succeeded.
 
-      c) If neither EXIT nor OK files have been produced we spin for a
-         while waiting for one of the files, if none turn up we will
-         eventually mark the job as failed.
+      c) If neither EXIT nor OK files have been produced the job is
+         left in state DONE, and checked again in the next rounds of the
+         queue loop for a while; if none of the files turn up within
+         max_ok_wait_time seconds we will eventually mark the job as
+         failed.
+
+      The files are checked by the threads in the work_pool, which
+      also run the callbacks, and not by the thread running the queue
+      loop; a slow file system does therefore not hold up the
+      loop. Every check is a single look for the files, so the waiting
+      does not block the work_pool either.
 
 */
 
@@ -216,6 +227,7 @@ struct job_queue_struct {
   UTIL_TYPE_ID_DECLARATION;
   job_list_type            * job_list;
   job_queue_status_type    * status;
+  job_queue_metrics_type   * metrics;                           /* Timing of driver calls, callbacks and status transitions. */
   char                     * exit_file;                         /* The queue will look for the occurrence of this file to detect a failure. */
   char                     * ok_file;                           /* The queue will look for this file to verify that the job was OK - can be NULL - in which case it is ignored. */
   char                     * status_file;                       /* The queue will look for this file to verify that the job is running or has run.  If not, ok_file is ignored. */
@@ -229,12 +241,19 @@ struct job_queue_struct {
 
   int                        max_submit;                        /* The maximum number of submit attempts for one job. */
   int                        max_ok_wait_time;                  /* Seconds to wait for an OK file - when the job itself has said all OK. */
+  int                        num_callback_threads;              /* The number of threads in the work_pool checking the OK / EXIT files and running the DONE / EXIT callbacks. */
+  int                        submit_batch_size;                 /* The number of jobs submitted in one round of the main loop - adapted to the measured submit latency. */
+  int                        max_submit_batch;                  /* Upper limit for submit_batch_size. */
+  double                     submit_time_budget;                /* The wall time (seconds) one round of submits should preferably not exceed. */
+  double                     submit_latency;                    /* Smoothed wall time (seconds) per submitted job; negative before the first measurement. */
   int                        max_duration;                      /* Maximum allowed time for a job to run, 0 = unlimited */
   time_t                     stop_time;                         /* A job is only allowed to run until this time. 0 = no time set, ignore stop_time */
   time_t                     progress_timestamp;                /* Global timestamp for last progress update. */
   unsigned long              usleep_time;                       /* The sleep time before checking for updates. */
   pthread_mutex_t            run_mutex;                         /* This mutex is used to ensure that ONLY one thread is executing the job_queue_run_jobs(). */
   thread_pool_type         * work_pool;
+  thread_pool_type         * submit_pool;                       /* Only allocated when the driver allows several concurrent submits. */
+  int_vector_type          * index_list;                        /* Scratch list of queue indices selected by status - only used by the thread running the queue. */
 };
 
 
@@ -277,17 +296,25 @@ static bool job_queue_change_node_status(job_queue_type * queue , job_queue_node
 /*
   Will return true if there is any status change. Must already hold
   on to joblist readlock
+
+  Only the nodes which are in a status where the driver can be queried
+  are visited. The progress timestamp of the remaining nodes is only
+  updated on status changes, and those are captured by the timestamp
+  of the status counter.
 */
 
 static bool job_queue_update_status(job_queue_type * queue ) {
   bool update = false;
-  int ijob;
 
-  for (ijob = 0; ijob < job_list_get_size( queue->job_list ); ijob++) {
-    job_queue_node_type * node = job_list_iget_job( queue->job_list , ijob );
+  job_list_select_status( queue->job_list , JOB_QUEUE_CAN_UPDATE_STATUS , queue->index_list );
+  for (int i = 0; i < int_vector_size( queue->index_list ); i++) {
+    job_queue_node_type * node = job_list_iget_job( queue->job_list , int_vector_iget( queue->index_list , i ));
+    double start_time = job_queue_metrics_now();
     update |= job_queue_node_update_status( node , queue->status , queue->driver );
+    job_queue_metrics_add_timing( queue->metrics , JOB_QUEUE_METRIC_STATUS , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
     queue->progress_timestamp = util_time_t_max(queue->progress_timestamp, job_queue_node_get_timestamp(node));
   }
+  queue->progress_timestamp = util_time_t_max(queue->progress_timestamp, job_queue_status_get_timestamp(queue->status));
   return update;
 }
 
@@ -302,7 +329,9 @@ static submit_status_type job_queue_submit_job(job_queue_type * queue , int queu
   else {
     {
       job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
+      double start_time = job_queue_metrics_now();
       submit_status = job_queue_node_submit( node , queue->status , queue->driver );
+      job_queue_metrics_add_timing( queue->metrics , JOB_QUEUE_METRIC_SUBMIT , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
     }
   }
   return submit_status;
@@ -425,7 +454,9 @@ void job_queue_set_auto_job_stop_time(job_queue_type * queue) {
 */
 
 static bool job_queue_kill_job_node( job_queue_type * queue , job_queue_node_type * node) {
+  double start_time = job_queue_metrics_now();
   bool result = job_queue_node_kill( node , queue->status , queue->driver );
+  job_queue_metrics_add_timing( queue->metrics , JOB_QUEUE_METRIC_KILL , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
   return result;
 }
 
@@ -541,9 +572,9 @@ bool job_queue_is_running( const job_queue_type * queue ) {
 
 
 static void job_queue_user_exit__( job_queue_type * queue ) {
-  int queue_index;
-  for (queue_index = 0; queue_index < job_list_get_size( queue->job_list ); queue_index++) {
-    job_queue_node_type * node = job_list_iget_job( queue->job_list , queue_index );
+  job_list_select_status( queue->job_list , JOB_QUEUE_CAN_KILL , queue->index_list );
+  for (int i = 0; i < int_vector_size( queue->index_list ); i++) {
+    job_queue_node_type * node = job_list_iget_job( queue->job_list , int_vector_iget( queue->index_list , i ));
 
     if (JOB_QUEUE_CAN_KILL & job_queue_node_get_status(node))
       job_queue_node_status_transition(node,queue->status,JOB_QUEUE_DO_KILL);
@@ -551,67 +582,105 @@ static void job_queue_user_exit__( job_queue_type * queue ) {
 }
 
 
-static bool job_queue_check_node_status_files(const job_queue_type * job_queue,
-                                              job_queue_node_type * node) {
+/*
+  Will check the OK and EXIT files of a node which the driver has
+  reported as DONE, without waiting for them. The return value is:
+
+    JOB_QUEUE_SUCCESS: The OK file is present, or no OK file has been
+       configured.
+
+    JOB_QUEUE_EXIT: The EXIT file is present, or we have waited more
+       than max_ok_wait_time seconds for the OK file.
+
+    JOB_QUEUE_DONE: Neither of the files are present yet; the node
+       should be checked again later.
+*/
+
+static job_status_type job_queue_check_node_status_files(const job_queue_type * job_queue,
+                                                         job_queue_node_type * node) {
   const char * exit_file = job_queue_node_get_exit_file( node );
   if (exit_file && util_file_exists(exit_file))
-    return false;  // job has failed
+    return JOB_QUEUE_EXIT;  // job has failed
 
   const char * ok_file = job_queue_node_get_ok_file( node );
 
-  // If the ok-file has not been set we just return true immediately.
+  // If the ok-file has not been set we just return OK immediately.
   if (!ok_file)
-    return true;
+    return JOB_QUEUE_SUCCESS;
 
-  int ok_sleep_time   = 1; // Time to wait between checks for OK|EXIT file
-  int total_wait_time = 0;
+  if (util_file_exists( ok_file ))
+    return JOB_QUEUE_SUCCESS;
 
-  /* Wait for OK file */
-  while (total_wait_time < job_queue->max_ok_wait_time) {
-    if (util_file_exists( ok_file ))
-      return true;
+  if (difftime( time(NULL) , job_queue_node_get_done_time( node )) >= job_queue->max_ok_wait_time)
+    return JOB_QUEUE_EXIT;
 
-    if (exit_file && util_file_exists(exit_file))
-      return false;  // job has failed
+  return JOB_QUEUE_DONE;
+}
 
-    sleep( ok_sleep_time );
-    total_wait_time += ok_sleep_time;
-  }
-  return false;
+
+static void job_queue_run_DONE_callback( job_queue_type * job_queue , job_queue_node_type * node ) {
+  double start_time = job_queue_metrics_now();
+  bool OK = job_queue_node_run_DONE_callback( node );
+  job_queue_metrics_add_timing( job_queue->metrics , JOB_QUEUE_METRIC_DONE_CALLBACK , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
+
+  if (OK)
+    job_queue_change_node_status( job_queue , node , JOB_QUEUE_SUCCESS );
+  else
+    job_queue_change_node_status( job_queue , node , JOB_QUEUE_EXIT );
+
+  job_queue_node_free_driver_data( node , job_queue->driver );
 }
 
 
-static void * job_queue_run_DONE_callback( void * arg ) {
+/*
+  Runs in the work_pool. When the OK file is found the DONE callback is
+  run right away by the same thread; while waiting for the OK file the
+  node stays in state DONE, and a new check is started in a later
+  round of the queue loop.
+*/
+
+static void * job_queue_check_DONE( void * arg ) {
   arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
   job_queue_type * job_queue = (job_queue_type*)arg_pack_iget_ptr( arg_pack , 0 );
   int queue_index = arg_pack_iget_int( arg_pack , 1 );
   job_list_get_rdlock( job_queue->job_list );
   {
     job_queue_node_type * node = job_list_iget_job( job_queue->job_list , queue_index );
-    bool OK = job_queue_check_node_status_files( job_queue , node );
-
-    if (OK)
-      OK = job_queue_node_run_DONE_callback( node );
 
-    if (OK)
-      job_queue_change_node_status( job_queue , node , JOB_QUEUE_SUCCESS );
-    else
-      job_queue_change_node_status( job_queue , node , JOB_QUEUE_EXIT );
+    if (job_queue_node_get_status( node ) == JOB_QUEUE_DONE) {
+      job_status_type file_status = job_queue_check_node_status_files( job_queue , node );
 
-    job_queue_node_free_driver_data( node , job_queue->driver );
+      if (file_status == JOB_QUEUE_EXIT) {
+        job_queue_change_node_status( job_queue , node , JOB_QUEUE_EXIT );
+        job_queue_node_free_driver_data( node , job_queue->driver );
+      } else if (file_status == JOB_QUEUE_SUCCESS) {
+        job_queue_change_node_status( job_queue , node , JOB_QUEUE_RUNNING_DONE_CALLBACK );
+        job_queue_run_DONE_callback( job_queue , node );
+      }
+    }
+    job_queue_node_end_status_check( node );
   }
   job_list_unlock(job_queue->job_list );
   arg_pack_free( arg_pack );
   return NULL;
 }
 
+
+/*
+  The OK / EXIT files are not checked by the thread running the queue
+  loop; a check is dispatched to the work_pool, unless the previous
+  check of the node is still running.
+*/
+
 static void job_queue_handle_DONE( job_queue_type * queue , job_queue_node_type * node) {
-  job_queue_change_node_status(queue , node , JOB_QUEUE_RUNNING_DONE_CALLBACK );
+  if (!job_queue_node_start_status_check( node ))
+    return;
+
   {
     arg_pack_type * arg_pack = arg_pack_alloc();
     arg_pack_append_ptr( arg_pack , queue );
     arg_pack_append_int( arg_pack , job_queue_node_get_queue_index(node));
-    thread_pool_add_job( queue->work_pool , job_queue_run_DONE_callback , arg_pack );
+    thread_pool_add_job( queue->work_pool , job_queue_check_DONE , arg_pack );
   }
 }
 
@@ -628,7 +697,9 @@ static void * job_queue_run_EXIT_callback( void * arg ) {
     if (job_queue_node_get_submit_attempt( node ) < job_queue->max_submit)
       job_queue_change_node_status( job_queue , node , JOB_QUEUE_WAITING );  /* The job will be picked up for antother go. */
     else {
+      double start_time = job_queue_metrics_now();
       bool retry = job_queue_node_run_RETRY_callback( node );
+      job_queue_metrics_add_timing( job_queue->metrics , JOB_QUEUE_METRIC_RETRY_CALLBACK , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
 
       if (retry) {
         /* OK - we have invoked the retry_callback() - and that has returned true;
@@ -638,7 +709,9 @@ static void * job_queue_run_EXIT_callback( void * arg ) {
       } else {
         // It's time to call it a day
 
+        start_time = job_queue_metrics_now();
         job_queue_node_run_EXIT_callback( node );
+        job_queue_metrics_add_timing( job_queue->metrics , JOB_QUEUE_METRIC_EXIT_CALLBACK , job_queue_node_get_job_name( node ) , job_queue_metrics_now() - start_time );
         job_queue_change_node_status(job_queue , node , JOB_QUEUE_FAILED);
       }
     }
@@ -687,8 +760,9 @@ static void job_queue_check_expired(job_queue_type * queue) {
   if ((job_queue_get_max_job_duration(queue) <= 0) && (job_queue_get_job_stop_time(queue) <= 0))
     return;
 
-  for (int i = 0; i < job_list_get_size( queue->job_list ); i++) {
-    job_queue_node_type * node = job_list_iget_job( queue->job_list , i );
+  job_list_select_status( queue->job_list , JOB_QUEUE_RUNNING , queue->index_list );
+  for (int i = 0; i < int_vector_size( queue->index_list ); i++) {
+    job_queue_node_type * node = job_list_iget_job( queue->job_list , int_vector_iget( queue->index_list , i ));
 
     if (job_queue_node_get_status(node) != JOB_QUEUE_RUNNING)
       continue;
@@ -734,14 +808,143 @@ bool job_queue_accept_jobs(const job_queue_type * queue) {
 }
 
 
+static void * job_queue_submit_job_mt( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  job_queue_type * queue = job_queue_safe_cast( arg_pack_iget_ptr( arg_pack , 0 ));
+  int queue_index = arg_pack_iget_int( arg_pack , 1 );
+  submit_status_type * submit_status = (submit_status_type *) arg_pack_iget_ptr( arg_pack , 2 );
+
+  *submit_status = job_queue_submit_job( queue , queue_index );
+  arg_pack_free( arg_pack );
+  return NULL;
+}
+
+
+static double job_queue_elapsed( const struct timeval * start ) {
+  struct timeval now;
+  gettimeofday( &now , NULL );
+  return (now.tv_sec - start->tv_sec) + 1e-6 * (now.tv_usec - start->tv_usec);
+}
+
+
+/*
+  The number of jobs submitted in one round of the main loop is
+  adapted to how fast the driver accepts jobs: the batch is sized so
+  that one round takes roughly submit_time_budget seconds, it is at
+  most doubled from one round to the next, and it is halved when the
+  driver rejects jobs - which typically means that the cluster is
+  saturated or the submit command is struggling.
+*/
+
+static void job_queue_adapt_submit_batch( job_queue_type * queue , int submit_count , int fail_count , double elapsed) {
+  if (fail_count > 0) {
+    queue->submit_batch_size = util_int_max( 1 , queue->submit_batch_size / 2 );
+    return;
+  }
+
+  if (submit_count == 0)
+    return;
+
+  {
+    double latency = elapsed / submit_count;
+    int batch_size;
+
+    if (queue->submit_latency < 0)
+      queue->submit_latency = latency;
+    else
+      queue->submit_latency = 0.5 * (queue->submit_latency + latency);
+
+    if (queue->submit_latency > 0)
+      batch_size = (int) util_double_min( queue->submit_time_budget / queue->submit_latency , queue->max_submit_batch );
+    else
+      batch_size = queue->max_submit_batch;
+
+    batch_size = util_int_min( batch_size , 2 * queue->submit_batch_size );
+    batch_size = util_int_min( batch_size , queue->max_submit_batch );
+    queue->submit_batch_size = util_int_max( 1 , batch_size );
+  }
+}
+
+
+/*
+  Submits the jobs in index_list one at a time; gives up the current
+  round at the first job the driver rejects. Returns the number of
+  successfully submitted jobs, and the number of failed attempts in
+  *fail_count.
+*/
+
+static int job_queue_submit_batch__( job_queue_type * queue , int num_submit_new , int * fail_count) {
+  int submit_count = 0;
+  int i = 0;
+
+  while ((i < int_vector_size(queue->index_list)) && (submit_count < num_submit_new)) {
+    int queue_index = int_vector_iget(queue->index_list, i);
+    job_queue_node_type * node = job_list_iget_job(queue->job_list, queue_index);
+    if (job_queue_node_get_status(node) == JOB_QUEUE_WAITING) {
+      submit_status_type submit_status = job_queue_submit_job(queue, queue_index);
+
+      if (submit_status == SUBMIT_OK)
+        submit_count++;
+      else if (submit_status == SUBMIT_DRIVER_FAIL) {
+        (*fail_count)++;
+        break;
+      } else if (submit_status == SUBMIT_QUEUE_CLOSED)
+        break;
+    }
+    i++;
+  }
+  return submit_count;
+}
+
+
+/*
+  Submits the jobs in index_list through the submit_pool; the pool
+  is joined before returning, so the job_list read lock held by the
+  calling thread covers all the submit calls. The jobs are counted
+  from the submit_status returned for each job - the status of the
+  node itself can have moved on, e.g. to a failed or killed state,
+  before the batch has completed.
+*/
+
+static int job_queue_submit_batch_mt( job_queue_type * queue , int num_submit_new , int * fail_count) {
+  int num_batch = util_int_min( num_submit_new , int_vector_size( queue->index_list ));
+  int submit_count = 0;
+  submit_status_type * submit_status;
+
+  if (queue->user_exit || queue->pause_on)
+    return 0;
+
+  submit_status = (submit_status_type *) util_calloc( num_batch , sizeof * submit_status );
+  for (int i=0; i < num_batch; i++) {
+    arg_pack_type * arg_pack = arg_pack_alloc();
+    arg_pack_append_ptr( arg_pack , queue );
+    arg_pack_append_int( arg_pack , int_vector_iget( queue->index_list , i ));
+    arg_pack_append_ptr( arg_pack , &submit_status[i] );
+    thread_pool_add_job( queue->submit_pool , job_queue_submit_job_mt , arg_pack );
+  }
+  thread_pool_join( queue->submit_pool );
+  thread_pool_restart( queue->submit_pool );
+
+  for (int i=0; i < num_batch; i++) {
+    if (submit_status[i] == SUBMIT_OK)
+      submit_count++;
+    else if (submit_status[i] == SUBMIT_DRIVER_FAIL)
+      (*fail_count)++;
+  }
+  free( submit_status );
+
+  return submit_count;
+}
+
+
 /* Submit new jobs and return whether we actually did.
  *
  * And we do if we have waiting jobs are allowed to submit jobs
  */
 static bool submit_new_jobs(job_queue_type * queue) {
 
-  int max_submit     = 5; /* This is the maximum number of jobs submitted in one while() { ... } below.
-                             Only to ensure that the waiting time before a status update is not too long. */
+  int max_submit     = queue->submit_batch_size; /* This is the maximum number of jobs submitted in one while() { ... } below.
+                                                    Only to ensure that the waiting time before a status update is not too long. */
   int total_active   = job_queue_status_get_count(queue->status, JOB_QUEUE_PENDING)
                      + job_queue_status_get_count(queue->status, JOB_QUEUE_RUNNING);
 
@@ -764,22 +967,18 @@ static bool submit_new_jobs(job_queue_type * queue) {
       new_jobs = true;
 
   if (new_jobs) {
-    int submit_count = 0;
-    int queue_index  = 0;
-
-    while ((queue_index < job_list_get_size(queue->job_list)) && (num_submit_new > 0)) {
-      job_queue_node_type * node = job_list_iget_job(queue->job_list, queue_index);
-      if (job_queue_node_get_status(node) == JOB_QUEUE_WAITING) {
-        submit_status_type submit_status = job_queue_submit_job(queue, queue_index);
-
-        if (submit_status == SUBMIT_OK) {
-          num_submit_new--;
-          submit_count++;
-        } else if ((submit_status == SUBMIT_DRIVER_FAIL) || (submit_status == SUBMIT_QUEUE_CLOSED))
-          break;
-      }
-      queue_index++;
-    }
+    int submit_count;
+    int fail_count = 0;
+    struct timeval start_time;
+
+    job_list_select_status(queue->job_list, JOB_QUEUE_WAITING, queue->index_list);
+    gettimeofday( &start_time , NULL );
+    if (queue->submit_pool)
+      submit_count = job_queue_submit_batch_mt(queue, num_submit_new, &fail_count);
+    else
+      submit_count = job_queue_submit_batch__(queue, num_submit_new, &fail_count);
+
+    job_queue_adapt_submit_batch(queue, submit_count, fail_count, job_queue_elapsed( &start_time ));
   }
 
   return new_jobs;
@@ -790,8 +989,11 @@ static void run_handlers(job_queue_type * queue) {
   /*
     Checking for complete / exited / overtime jobs
   */
-  for (int i = 0; i < job_list_get_size(queue->job_list); ++i) {
-    job_queue_node_type * node = job_list_iget_job(queue->job_list, i);
+  job_list_select_status(queue->job_list,
+                         JOB_QUEUE_DONE + JOB_QUEUE_EXIT + JOB_QUEUE_DO_KILL_NODE_FAILURE + JOB_QUEUE_DO_KILL,
+                         queue->index_list);
+  for (int i = 0; i < int_vector_size(queue->index_list); ++i) {
+    job_queue_node_type * node = job_list_iget_job(queue->job_list, int_vector_iget(queue->index_list, i));
 
     switch (job_queue_node_get_status(node)) {
     case(JOB_QUEUE_DONE):
@@ -841,6 +1043,7 @@ static void job_queue_loop(job_queue_type * queue, int num_total_run, bool verbo
   int phase = 0; // UI code: this is the visual spinner
 
   do { // while !complete && !exit
+    double start_time = job_queue_metrics_now();
     job_list_get_rdlock(queue->job_list);
 
     if (queue->user_exit)  {/* An external thread has called the job_queue_user_exit() function, and we should kill
@@ -889,6 +1092,7 @@ static void job_queue_loop(job_queue_type * queue, int num_total_run, bool verbo
         job_queue_print_summary(queue, true);
 
     job_list_unlock(queue->job_list);
+    job_queue_metrics_add_timing(queue->metrics, JOB_QUEUE_METRIC_LOOP, NULL, job_queue_metrics_now() - start_time);
 
     if (!exit) {
       res_yield();
@@ -914,18 +1118,24 @@ static void handle_run_jobs(job_queue_type * queue, int num_total_run, bool verb
   // Check if queue is open. Fails hard if not open
   job_queue_check_open(queue);
 
-  /*
-    The number of threads in the thread pool running callbacks. Memory consumption can
-    potentially be quite high while running the DONE callback - should therefor not use
-    too many threads.
-  */
-  const int NUM_WORKER_THREADS = 4;
-  queue->work_pool = thread_pool_alloc(NUM_WORKER_THREADS, true);
+  queue->work_pool = thread_pool_alloc(queue->num_callback_threads, true);
   res_log_debug("Allocated thread pool in job_queue_run_jobs");
 
+  {
+    int submit_threads = queue_driver_get_submit_threads(queue->driver);
+    if (submit_threads > 1)
+      queue->submit_pool = thread_pool_alloc(submit_threads, true);
+  }
+
   queue->running = true;
   job_queue_loop(queue, num_total_run, verbose);
 
+  if (queue->submit_pool) {
+    thread_pool_join(queue->submit_pool);
+    thread_pool_free(queue->submit_pool);
+    queue->submit_pool = NULL;
+  }
+
   thread_pool_join(queue->work_pool);
   thread_pool_free(queue->work_pool);
 }
@@ -1079,6 +1289,7 @@ int job_queue_add_job(job_queue_type * queue ,
       job_list_get_wrlock( queue->job_list );
       {
         job_list_add_job( queue->job_list , node );
+        job_queue_node_set_metrics( node , queue->metrics );
         queue_index = job_queue_node_get_queue_index(node);
         job_queue_change_node_status(queue , node , JOB_QUEUE_WAITING);
       }
@@ -1114,6 +1325,21 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
   UTIL_TYPE_ID_INIT( queue , JOB_QUEUE_TYPE_ID);
   queue->usleep_time      = 250000; /* 1000000 : 1 second */
   queue->max_ok_wait_time = 60;
+  /*
+    The number of threads in the thread pool running callbacks. Memory consumption can
+    potentially be quite high while running the DONE callback - should therefor not use
+    too many threads.
+  */
+  queue->num_callback_threads = 4;
+  /*
+    The queue starts out submitting at most 5 jobs per round of the
+    main loop; the batch size is then adapted to the observed submit
+    latency, see job_queue_adapt_submit_batch().
+  */
+  queue->submit_batch_size  = 5;
+  queue->max_submit_batch   = 100;
+  queue->submit_time_budget = 2.0;
+  queue->submit_latency     = -1;
   queue->max_duration     = 0;
   queue->stop_time        = 0;
   queue->max_submit       = max_submit;
@@ -1127,8 +1353,11 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
   queue->running          = false;
   queue->submit_complete  = false;
   queue->work_pool        = NULL;
+  queue->submit_pool      = NULL;
+  queue->index_list       = int_vector_alloc( 0 , 0 );
   queue->job_list         = job_list_alloc(  );
   queue->status           = job_queue_status_alloc( );
+  queue->metrics          = job_queue_metrics_alloc( );
   queue->progress_timestamp = time(NULL);
 
   pthread_mutex_init( &queue->run_mutex    , NULL );
@@ -1184,6 +1413,66 @@ int job_queue_get_max_submit(const job_queue_type * job_queue ) {
 }
 
 
+/*
+  The new value will take effect the next time job_queue_run_jobs() is
+  called.
+*/
+
+void job_queue_set_num_callback_threads( job_queue_type * job_queue , int num_threads ) {
+  if (num_threads < 1)
+    util_abort("%s: invalid number of callback threads:%d \n",__func__ , num_threads);
+  job_queue->num_callback_threads = num_threads;
+}
+
+
+int job_queue_get_num_callback_threads( const job_queue_type * job_queue ) {
+  return job_queue->num_callback_threads;
+}
+
+
+/*
+  The number of seconds to wait for the OK file after the driver has
+  reported a job as DONE; if neither the OK file nor the EXIT file has
+  turned up by then the job is considered failed.
+*/
+
+void job_queue_set_max_ok_wait_time( job_queue_type * job_queue , int max_ok_wait_time ) {
+  if (max_ok_wait_time < 0)
+    util_abort("%s: invalid wait time:%d \n",__func__ , max_ok_wait_time);
+  job_queue->max_ok_wait_time = max_ok_wait_time;
+}
+
+
+/*
+  Upper limit for the number of jobs submitted in one round of the
+  main loop; the actual number is adapted to the submit latency of
+  the driver.
+*/
+
+void job_queue_set_max_submit_batch( job_queue_type * job_queue , int max_submit_batch ) {
+  if (max_submit_batch < 1)
+    util_abort("%s: invalid submit batch size:%d \n",__func__ , max_submit_batch);
+  job_queue->max_submit_batch = max_submit_batch;
+  job_queue->submit_batch_size = util_int_min( job_queue->submit_batch_size , max_submit_batch );
+}
+
+
+int job_queue_get_submit_batch_size( const job_queue_type * job_queue ) {
+  return job_queue->submit_batch_size;
+}
+
+
+/*
+  The metrics object is owned by the queue; use the
+  job_queue_metrics_xxx() functions to take a snapshot or to start
+  writing a trace file.
+*/
+
+job_queue_metrics_type * job_queue_get_metrics( job_queue_type * job_queue ) {
+  return job_queue->metrics;
+}
+
+
 /**
    Returns true if the queue is currently paused, which means that no
    more jobs are submitted.
@@ -1243,6 +1532,8 @@ void job_queue_free(job_queue_type * queue) {
   free( queue->status_file );
   job_list_free( queue->job_list );
   job_queue_status_free( queue->status );
+  job_queue_metrics_free( queue->metrics );
+  int_vector_free( queue->index_list );
   free(queue);
 }
 
@@ -1314,6 +1605,7 @@ int job_queue_add_job_node(job_queue_type * queue, job_queue_node_type * node) {
   job_list_get_wrlock( queue->job_list );
 
   job_list_add_job( queue->job_list , node );
+  job_queue_node_set_metrics( node , queue->metrics );
   job_queue_change_node_status(queue , node , JOB_QUEUE_WAITING);
   int queue_index = job_queue_node_get_queue_index(node);
   job_list_unlock( queue->job_list );
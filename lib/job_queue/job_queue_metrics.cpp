@@ -0,0 +1,224 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_queue_metrics.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include <ert/util/type_macros.hpp>
+#include <ert/util/util.hpp>
+
+#include <ert/job_queue/job_queue_metrics.hpp>
+
+#define JOB_QUEUE_METRICS_TYPE_ID 771206413
+
+/*
+  The metrics object collects timing information from the queue
+  layer: how long the driver calls take, how long one round of the
+  queue main loop takes, how long the callbacks take and how long the
+  jobs spend in the different states. All the updates go through a
+  mutex, since they come both from the thread running the queue and
+  from the callback threads.
+
+  Optionally every event is also written as one JSON object per line
+  to a trace file, which can be analyzed offline.
+*/
+
+struct job_queue_metrics_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  pthread_mutex_t                  mutex;
+  job_queue_metrics_snapshot_type  data;
+  FILE                           * trace_stream;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( job_queue_metrics , JOB_QUEUE_METRICS_TYPE_ID )
+
+
+job_queue_metrics_type * job_queue_metrics_alloc() {
+  job_queue_metrics_type * metrics = (job_queue_metrics_type*)util_malloc( sizeof * metrics );
+  UTIL_TYPE_ID_INIT( metrics , JOB_QUEUE_METRICS_TYPE_ID );
+  pthread_mutex_init( &metrics->mutex , NULL );
+  metrics->trace_stream = NULL;
+  job_queue_metrics_clear( metrics );
+  return metrics;
+}
+
+
+void job_queue_metrics_free( job_queue_metrics_type * metrics ) {
+  job_queue_metrics_close_trace( metrics );
+  pthread_mutex_destroy( &metrics->mutex );
+  free( metrics );
+}
+
+
+void job_queue_metrics_clear( job_queue_metrics_type * metrics ) {
+  pthread_mutex_lock( &metrics->mutex );
+  memset( &metrics->data , 0 , sizeof metrics->data );
+  pthread_mutex_unlock( &metrics->mutex );
+}
+
+
+/*
+  Wall clock time in seconds, with microsecond resolution.
+*/
+
+double job_queue_metrics_now( ) {
+  struct timeval now;
+  gettimeofday( &now , NULL );
+  return now.tv_sec + 1e-6 * now.tv_usec;
+}
+
+
+const char * job_queue_metrics_get_name( job_queue_metric_type metric ) {
+  switch (metric) {
+  case JOB_QUEUE_METRIC_SUBMIT:
+    return "SUBMIT";
+  case JOB_QUEUE_METRIC_STATUS:
+    return "STATUS";
+  case JOB_QUEUE_METRIC_KILL:
+    return "KILL";
+  case JOB_QUEUE_METRIC_LOOP:
+    return "LOOP";
+  case JOB_QUEUE_METRIC_DONE_CALLBACK:
+    return "DONE_CALLBACK";
+  case JOB_QUEUE_METRIC_RETRY_CALLBACK:
+    return "RETRY_CALLBACK";
+  case JOB_QUEUE_METRIC_EXIT_CALLBACK:
+    return "EXIT_CALLBACK";
+  default:
+    util_abort("%s: invalid metric:%d \n",__func__ , metric);
+    return NULL;
+  }
+}
+
+
+static void job_queue_timing_add( job_queue_timing_type * timing , double elapsed ) {
+  timing->count++;
+  timing->total_time += elapsed;
+  if (elapsed > timing->max_time)
+    timing->max_time = elapsed;
+}
+
+
+/*
+  Job names are user input; the characters which can not go
+  verbatim in a JSON string are escaped.
+*/
+
+static void job_queue_metrics_fprintf_string( FILE * stream , const char * s ) {
+  fputc( '"' , stream );
+  for (const char * c = s; *c; c++) {
+    if (*c == '"' || *c == '\\')
+      fprintf( stream , "\\%c" , *c );
+    else if ((unsigned char) *c < 0x20)
+      fprintf( stream , "\\u%04x" , (unsigned char) *c );
+    else
+      fputc( *c , stream );
+  }
+  fputc( '"' , stream );
+}
+
+
+/* Must hold the metrics mutex. */
+static void job_queue_metrics_trace_event( job_queue_metrics_type * metrics , const char * event , const char * job_name , double elapsed) {
+  fprintf( metrics->trace_stream , "{\"time\": %.6f, \"event\": \"%s\"" , job_queue_metrics_now() , event );
+  if (job_name) {
+    fprintf( metrics->trace_stream , ", \"job\": ");
+    job_queue_metrics_fprintf_string( metrics->trace_stream , job_name );
+  }
+  fprintf( metrics->trace_stream , ", \"duration\": %.6f}\n" , elapsed );
+}
+
+
+void job_queue_metrics_add_timing( job_queue_metrics_type * metrics , job_queue_metric_type metric , const char * job_name , double elapsed) {
+  pthread_mutex_lock( &metrics->mutex );
+  {
+    job_queue_timing_add( &metrics->data.timing[ metric ] , elapsed );
+    if (metrics->trace_stream)
+      job_queue_metrics_trace_event( metrics , job_queue_metrics_get_name( metric ) , job_name , elapsed );
+  }
+  pthread_mutex_unlock( &metrics->mutex );
+}
+
+
+/*
+  The time_in_old_status argument is the number of seconds the job
+  spent in old_status; a negative value means that it is not known,
+  i.e. the job never formally entered old_status.
+*/
+
+void job_queue_metrics_add_transition( job_queue_metrics_type * metrics , const char * job_name , int queue_index ,
+                                       job_status_type old_status , job_status_type new_status , double time_in_old_status) {
+  pthread_mutex_lock( &metrics->mutex );
+  {
+    if (time_in_old_status >= 0)
+      job_queue_timing_add( &metrics->data.status_time[ job_status_get_index( old_status ) ] , time_in_old_status );
+
+    if (metrics->trace_stream) {
+      fprintf( metrics->trace_stream , "{\"time\": %.6f, \"event\": \"STATUS_CHANGE\", \"job\": " , job_queue_metrics_now());
+      job_queue_metrics_fprintf_string( metrics->trace_stream , job_name );
+      fprintf( metrics->trace_stream , ", \"index\": %d, \"from\": \"%s\", \"to\": \"%s\", \"duration\": %.6f}\n",
+               queue_index ,
+               job_status_get_name( old_status ) ,
+               job_status_get_name( new_status ) ,
+               time_in_old_status );
+    }
+  }
+  pthread_mutex_unlock( &metrics->mutex );
+}
+
+
+void job_queue_metrics_get_snapshot( job_queue_metrics_type * metrics , job_queue_metrics_snapshot_type * snapshot) {
+  pthread_mutex_lock( &metrics->mutex );
+  memcpy( snapshot , &metrics->data , sizeof * snapshot );
+  pthread_mutex_unlock( &metrics->mutex );
+}
+
+
+/*
+  Starts writing trace events to @filename; an existing trace file is
+  closed first. Returns false if the file can not be opened.
+*/
+
+bool job_queue_metrics_open_trace( job_queue_metrics_type * metrics , const char * filename ) {
+  FILE * stream = fopen( filename , "w" );
+  if (!stream)
+    return false;
+
+  pthread_mutex_lock( &metrics->mutex );
+  {
+    if (metrics->trace_stream)
+      fclose( metrics->trace_stream );
+    metrics->trace_stream = stream;
+  }
+  pthread_mutex_unlock( &metrics->mutex );
+  return true;
+}
+
+
+void job_queue_metrics_close_trace( job_queue_metrics_type * metrics ) {
+  pthread_mutex_lock( &metrics->mutex );
+  {
+    if (metrics->trace_stream) {
+      fclose( metrics->trace_stream );
+      metrics->trace_stream = NULL;
+    }
+  }
+  pthread_mutex_unlock( &metrics->mutex );
+}
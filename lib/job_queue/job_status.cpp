@@ -75,3 +75,23 @@ const char * job_status_get_name(job_status_type status) {
   util_abort("%s: internal error", __func__);
   return NULL;
 }
+
+
+/*
+  The status values are distinct powers of two; this returns the
+  exponent, i.e. a dense index in the range [0, JOB_QUEUE_MAX_STATE).
+  Values which are not one of the status values are rejected.
+*/
+
+int job_status_get_index(job_status_type status) {
+  int index = 0;
+  int mask  = 1;
+  while (index < JOB_QUEUE_MAX_STATE) {
+    if (mask == status)
+      return index;
+    index++;
+    mask <<= 1;
+  }
+  util_abort("%s: invalid job status:%d \n",__func__ , status);
+  return -1;
+}
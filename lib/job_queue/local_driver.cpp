@@ -17,6 +17,7 @@
 */
 
 #include <sys/wait.h>
+#include <sys/time.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <stdio.h>
@@ -25,20 +26,35 @@
 #include <errno.h>
 
 #include <ert/util/util.hpp>
-#include <ert/res_util/arg_pack.hpp>
+#include <ert/util/vector.hpp>
 
 #include <ert/job_queue/queue_driver.hpp>
 #include <ert/job_queue/local_driver.hpp>
 
 
+/*
+  The local driver starts the jobs as child processes of the current
+  process. All the running children are watched by one reaper thread
+  per driver, which polls the registered pids with waitpid( WNOHANG )
+  and updates the status of the job when the child process has
+  terminated. Observe that the reaper only waits for its own pids; a
+  waitpid(-1) would steal the exit status of processes spawned by
+  other parts of the program.
+
+  All the fields of the job instances which are modified after submit,
+  and the list of active jobs, are protected by the local_job_lock.
+*/
+
+#define LOCAL_DRIVER_REAP_USLEEP 100000
+
 typedef struct local_job_struct local_job_type;
 
 struct local_job_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool            active;
-  job_status_type status;
-  pthread_t       run_thread;
-  pid_t           child_process;
+  bool                  active;
+  bool                  free_on_exit;   /* The queue has freed the job while the process was running; the reaper will free it. */
+  job_status_type       status;
+  pid_t                 child_process;
 };
 
 
@@ -47,8 +63,11 @@ struct local_job_struct {
 
 struct local_driver_struct {
   UTIL_TYPE_ID_DECLARATION;
-  pthread_attr_t     thread_attr;
-  pthread_mutex_t    submit_lock;
+  pthread_cond_t     reaper_cond;
+  pthread_t          reaper_thread;
+  bool               reaper_running;
+  bool               shutdown;
+  vector_type      * active_jobs;       /* Non-owning references to the jobs which have a running child process. */
 };
 
 /*****************************************************************/
@@ -57,13 +76,22 @@ struct local_driver_struct {
 static UTIL_SAFE_CAST_FUNCTION( local_driver , LOCAL_DRIVER_TYPE_ID )
 static UTIL_SAFE_CAST_FUNCTION( local_job    , LOCAL_JOB_TYPE_ID    )
 
+/*
+  The local_driver_free_job() function is not called with the driver
+  as argument, we therefor need a global lock to coordinate between
+  freeing the job and the reaper thread.
+*/
+static pthread_mutex_t local_job_lock = PTHREAD_MUTEX_INITIALIZER;
+
 
 static local_job_type * local_job_alloc() {
   local_job_type * job;
   job = (local_job_type*)util_malloc(sizeof * job );
   UTIL_TYPE_ID_INIT( job , LOCAL_JOB_TYPE_ID );
   job->active = false;
+  job->free_on_exit = false;
   job->status = JOB_QUEUE_WAITING;
+  job->child_process = 0;
   return job;
 }
 
@@ -75,7 +103,13 @@ job_status_type local_driver_get_job_status(void * __driver, void * __job) {
     return JOB_QUEUE_NOT_ACTIVE;
   else {
     local_job_type * job = local_job_safe_cast( __job );
-    return job->status;
+    job_status_type status;
+
+    pthread_mutex_lock( &local_job_lock );
+    status = job->status;
+    pthread_mutex_unlock( &local_job_lock );
+
+    return status;
   }
 }
 
@@ -83,51 +117,96 @@ job_status_type local_driver_get_job_status(void * __driver, void * __job) {
 
 void local_driver_free_job( void * __job ) {
   local_job_type    * job    = local_job_safe_cast( __job );
-  if (!job->active)
+  bool free_job;
+
+  pthread_mutex_lock( &local_job_lock );
+  free_job = !job->active;
+  if (!free_job)
+    job->free_on_exit = true;
+  pthread_mutex_unlock( &local_job_lock );
+
+  if (free_job)
     free(job);
 }
 
 
+/*
+  The child is only signalled while it has not been reaped; after
+  waitpid() has returned the pid may already have been reused by an
+  unrelated process. The reaper updates job->active while holding the
+  local_job_lock, so the check and the kill() are done under the lock.
+*/
+
 void local_driver_kill_job( void * __driver , void * __job) {
   local_job_type    * job  = local_job_safe_cast( __job );
-  if (job->child_process > 0)
+
+  pthread_mutex_lock( &local_job_lock );
+  if (job->active && (job->child_process > 0))
     kill( job->child_process , SIGTERM );
+  pthread_mutex_unlock( &local_job_lock );
 }
 
 
-
 /*
-  This function needs to dereference the job pointer after the waitpid() call is
-  complete, it is therefor essential that no other threads have called free(job)
-  while the external process is running.
+  Must hold the local_job_lock. Returns true if the child process of
+  the job has terminated, in which case the status of the job has been
+  updated.
 */
 
-void * submit_job_thread__(void * __arg) {
-  arg_pack_type *arg_pack = arg_pack_safe_cast(__arg);
-  const char *executable = (const char*)arg_pack_iget_const_ptr(arg_pack, 0);
-  /*
-    The arg_pack contains a run_path field as the second argument,
-    it has therefore been left here as a comment:
-
-    const char * run_path    = arg_pack_iget_const_ptr(arg_pack , 1);
-  */
-  int argc = arg_pack_iget_int(arg_pack, 2);
-  char **argv = (char**)arg_pack_iget_ptr(arg_pack, 3);
-  local_job_type *job = (local_job_type*)arg_pack_iget_ptr(arg_pack, 4);
-  {
-    int wait_status;
-    job->child_process = util_spawn(executable, argc, (const char**) argv, NULL, NULL);
-    util_free_stringlist(argv, argc);
-    arg_pack_free(arg_pack);
-    waitpid(job->child_process, &wait_status, 0);
+static bool local_driver_reap_job__( local_job_type * job ) {
+  int wait_status;
+  pid_t pid = waitpid( job->child_process , &wait_status , WNOHANG );
 
-    job->active = false;
-    job->status = JOB_QUEUE_EXIT;
+  if (pid == 0)
+    return false;
+
+  if (pid < 0 && errno == EINTR)
+    return false;
+
+  job->active = false;
+  job->status = JOB_QUEUE_EXIT;
+  if (pid == job->child_process)
     if (WIFEXITED(wait_status))
       if (WEXITSTATUS(wait_status) == 0)
         job->status = JOB_QUEUE_DONE;
 
+  return true;
+}
+
+
+static void * local_driver_reaper__( void * arg ) {
+  local_driver_type * driver = local_driver_safe_cast( arg );
+
+  pthread_mutex_lock( &local_job_lock );
+  while (!driver->shutdown) {
+    int index = 0;
+    while (index < vector_get_size( driver->active_jobs )) {
+      local_job_type * job = (local_job_type*)vector_iget( driver->active_jobs , index );
+
+      if (local_driver_reap_job__( job )) {
+        int last = vector_get_size( driver->active_jobs ) - 1;
+        vector_iset_ref( driver->active_jobs , index , vector_iget( driver->active_jobs , last ));
+        vector_pop_back( driver->active_jobs );
+
+        if (job->free_on_exit)
+          free( job );
+      } else
+        index++;
+    }
+
+    if (vector_get_size( driver->active_jobs ) == 0)
+      pthread_cond_wait( &driver->reaper_cond , &local_job_lock );
+    else {
+      struct timeval  now;
+      struct timespec timeout;
+
+      gettimeofday( &now , NULL );
+      timeout.tv_sec  = now.tv_sec + (now.tv_usec + LOCAL_DRIVER_REAP_USLEEP) / 1000000;
+      timeout.tv_nsec = ((now.tv_usec + LOCAL_DRIVER_REAP_USLEEP) % 1000000) * 1000;
+      pthread_cond_timedwait( &driver->reaper_cond , &local_job_lock , &timeout );
+    }
   }
+  pthread_mutex_unlock( &local_job_lock );
   return NULL;
 }
 
@@ -141,31 +220,59 @@ void * local_driver_submit_job(void * __driver           ,
                                int           argc        ,
                                const char ** argv ) {
   local_driver_type * driver = local_driver_safe_cast( __driver );
-  {
-    local_job_type * job    = local_job_alloc();
-    arg_pack_type  * arg_pack = arg_pack_alloc();
-    arg_pack_append_const_ptr( arg_pack , submit_cmd);
-    arg_pack_append_const_ptr( arg_pack , run_path );
-    arg_pack_append_int( arg_pack , argc );
-    arg_pack_append_ptr( arg_pack , util_alloc_stringlist_copy( argv , argc ));   /* Due to conflict with threads and python GC we take a local copy. */
-    arg_pack_append_ptr( arg_pack , job );
-
-    pthread_mutex_lock( &driver->submit_lock );
-    job->active = true;
-    job->status = JOB_QUEUE_RUNNING;
-
-    if (pthread_create( &job->run_thread , &driver->thread_attr , submit_job_thread__ , arg_pack) != 0)
-      util_abort("%s: failed to create run thread - aborting \n",__func__);
-
-    pthread_mutex_unlock( &driver->submit_lock );
-    return job;
+  local_job_type * job = local_job_alloc();
+  pid_t child_process = util_spawn( submit_cmd , argc , argv , NULL , NULL);
+
+  pthread_mutex_lock( &local_job_lock );
+  if (!driver->reaper_running) {
+    if (pthread_create( &driver->reaper_thread , NULL , local_driver_reaper__ , driver) != 0)
+      util_abort("%s: failed to create reaper thread - aborting \n",__func__);
+    driver->reaper_running = true;
   }
+
+  job->child_process = child_process;
+  job->active = true;
+  job->status = JOB_QUEUE_RUNNING;
+  vector_append_ref( driver->active_jobs , job );
+  pthread_cond_signal( &driver->reaper_cond );
+  pthread_mutex_unlock( &local_job_lock );
+
+  return job;
 }
 
 
 
+/*
+  The reaper thread is stopped and joined before the remaining active
+  jobs are handled. Jobs which have terminated are reaped one last
+  time. Jobs which the queue has already released are freed here. The
+  other jobs are detached, so local_driver_free_job() frees them
+  directly. Child processes which are still running are left running;
+  their status is not updated any more.
+*/
+
 void local_driver_free(local_driver_type * driver) {
-  pthread_attr_destroy ( &driver->thread_attr );
+  pthread_mutex_lock( &local_job_lock );
+  driver->shutdown = true;
+  pthread_cond_signal( &driver->reaper_cond );
+  pthread_mutex_unlock( &local_job_lock );
+
+  if (driver->reaper_running)
+    pthread_join( driver->reaper_thread , NULL );
+
+  pthread_mutex_lock( &local_job_lock );
+  for (int index = 0; index < vector_get_size( driver->active_jobs ); index++) {
+    local_job_type * job = (local_job_type*)vector_iget( driver->active_jobs , index );
+
+    local_driver_reap_job__( job );
+    job->active = false;
+    if (job->free_on_exit)
+      free( job );
+  }
+  pthread_mutex_unlock( &local_job_lock );
+
+  vector_free( driver->active_jobs );
+  pthread_cond_destroy( &driver->reaper_cond );
   free(driver);
   driver = NULL;
 }
@@ -180,9 +287,10 @@ void local_driver_free__(void * __driver) {
 void * local_driver_alloc() {
   local_driver_type * local_driver = (local_driver_type*)util_malloc(sizeof * local_driver );
   UTIL_TYPE_ID_INIT( local_driver , LOCAL_DRIVER_TYPE_ID);
-  pthread_mutex_init( &local_driver->submit_lock , NULL );
-  pthread_attr_init( &local_driver->thread_attr );
-  pthread_attr_setdetachstate( &local_driver->thread_attr , PTHREAD_CREATE_DETACHED );
+  pthread_cond_init( &local_driver->reaper_cond , NULL );
+  local_driver->reaper_running = false;
+  local_driver->shutdown = false;
+  local_driver->active_jobs = vector_alloc_new();
 
   return local_driver;
 }
@@ -22,6 +22,7 @@
 #include <pthread.h>
 #include <dlfcn.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <vector>
 #include <string>
@@ -139,7 +140,7 @@ struct lsf_driver_struct {
   std::vector<std::string> exclude_hosts;
   char              * login_shell;
   char              * project_code;
-  pthread_mutex_t     submit_lock;
+  pthread_mutex_t     submit_lock;        /* Protects my_jobs, error_count and the lsb request used by LSF_SUBMIT_INTERNAL. */
 
   lsf_submit_method_enum submit_method;
   int                    submit_sleep;
@@ -545,6 +546,21 @@ static int lsf_driver_submit_internal_job( lsf_driver_type * driver ,
 
 
 
+/*
+  Several submit threads can run at the same time; the file is
+  created with mkstemp() so that two threads never get the same name.
+*/
+
+static char * lsf_driver_alloc_submit_tmp_file( ) {
+  char * tmp_file = util_alloc_string_copy( "/tmp/enkf-submit-XXXXXX" );
+  int fd = mkstemp( tmp_file );
+  if (fd < 0)
+    util_abort("%s: failed to create temporary file: %s \n",__func__ , strerror( errno ));
+  close( fd );
+  return tmp_file;
+}
+
+
 static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
                                        const char *  lsf_stdout ,
                                        const char *  job_name   ,
@@ -553,7 +569,7 @@ static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
                                        int           job_argc,
                                        const char ** job_argv) {
   int job_id;
-  char * tmp_file = (char*)util_alloc_tmp_file("/tmp" , "enkf-submit" , true);
+  char * tmp_file = lsf_driver_alloc_submit_tmp_file( );
 
   {
     stringlist_type * remote_argv = lsf_driver_alloc_cmd( driver , lsf_stdout , job_name , submit_cmd , num_cpu , job_argc , job_argv);
@@ -637,7 +653,13 @@ static void lsf_driver_update_bjobs_table(lsf_driver_type * driver) {
         if (sscanf(line , "%d %s %s", &job_id_int , user , status) == 3) {
           char * job_id = (char*)util_alloc_sprintf("%d" , job_id_int);
 
-          if (hash_has_key( driver->my_jobs , job_id ))   /* Consider only jobs submitted by this ERT instance - not old jobs lying around from the same user. */
+          bool my_job;
+
+          pthread_mutex_lock( &driver->submit_lock );
+          my_job = hash_has_key( driver->my_jobs , job_id );
+          pthread_mutex_unlock( &driver->submit_lock );
+
+          if (my_job)   /* Consider only jobs submitted by this ERT instance - not old jobs lying around from the same user. */
             hash_insert_int(driver->bjobs_cache , job_id , lsf_driver_get_status__( driver , status , job_id));
 
           free(job_id);
@@ -987,7 +1009,6 @@ void * lsf_driver_submit_job(void * __driver ,
     {
       char * lsf_stdout                    = (char*)util_alloc_filename(run_path , job_name , "LSF-stdout");
       lsf_submit_method_enum submit_method = driver->submit_method;
-      pthread_mutex_lock( &driver->submit_lock );
 
       res_log_finfo("LSF DRIVER submitting using method:%d \n", submit_method);
 
@@ -995,14 +1016,23 @@ void * lsf_driver_submit_job(void * __driver ,
         if (driver->exclude_hosts.size() > 0){
           res_log_warning("EXCLUDE_HOST is not supported with submit method LSF_SUBMIT_INTERNAL");
         }
+        /* The lsb request and reply structures are shared, so the library submits are serialized. */
+        pthread_mutex_lock( &driver->submit_lock );
         job->lsf_jobnr = lsf_driver_submit_internal_job( driver , lsf_stdout , job_name , submit_cmd , num_cpu , argc, argv);
+        pthread_mutex_unlock( &driver->submit_lock );
       } else {
+        /*
+          The bsub command is spawned without holding the lock, so with
+          SUBMIT_THREADS > 1 several submits run concurrently; only the
+          registration in my_jobs is serialized.
+        */
         job->lsf_jobnr      = lsf_driver_submit_shell_job( driver , lsf_stdout , job_name , submit_cmd , num_cpu , argc, argv);
         job->lsf_jobnr_char = util_alloc_sprintf("%ld" , job->lsf_jobnr);
+        pthread_mutex_lock( &driver->submit_lock );
         hash_insert_ref( driver->my_jobs , job->lsf_jobnr_char , NULL );
+        pthread_mutex_unlock( &driver->submit_lock );
       }
 
-      pthread_mutex_unlock( &driver->submit_lock );
       free( lsf_stdout );
     }
 
@@ -1019,9 +1049,13 @@ void * lsf_driver_submit_job(void * __driver ,
         The submit failed - the queue system shall handle
         NULL return values.
       */
-      driver->error_count++;
+      int error_count;
+
+      pthread_mutex_lock( &driver->submit_lock );
+      error_count = ++driver->error_count;
+      pthread_mutex_unlock( &driver->submit_lock );
 
-      if (driver->error_count >= driver->max_error_count)
+      if (error_count >= driver->max_error_count)
         util_exit("Maximum number of submit errors exceeded - giving up\n");
       else {
         res_log_error("** ERROR ** Failed when submitting to LSF - will try again.");
@@ -85,6 +85,10 @@ struct queue_driver_struct {
   int max_running; /* Possible to maintain different max_running values for different
                                         drivers; the value 0 is interpreted as no limit - i.e. the queue layer
                                         will (try) to send an unlimited number of jobs to the driver. */
+  char * submit_threads_string;
+  int submit_threads; /* The number of threads the queue layer will use to call the submit function
+                                        concurrently; the default value 1 means that jobs are submitted one at a time.
+                                        The submit function of every driver must therefore be thread safe. */
 
 };
 
@@ -104,6 +108,15 @@ int queue_driver_get_max_running(const queue_driver_type * driver) {
   return driver->max_running;
 }
 
+void queue_driver_set_submit_threads(queue_driver_type * driver, int submit_threads) {
+  driver->submit_threads_string = util_realloc_sprintf(driver->submit_threads_string,"%d", submit_threads);
+  driver->submit_threads = submit_threads;
+}
+
+int queue_driver_get_submit_threads(const queue_driver_type * driver) {
+  return driver->submit_threads;
+}
+
 const char * queue_driver_get_name(const queue_driver_type * driver) {
   return driver->name;
 }
@@ -121,6 +134,14 @@ static bool queue_driver_set_generic_option__(queue_driver_type * driver, const
       }
       else
         option_set = false;
+    } else if (strcmp(SUBMIT_THREADS, option_key) == 0) {
+      int submit_threads_int = 0;
+      if (util_sscanf_int(value, &submit_threads_int) && (submit_threads_int > 0)) {
+        queue_driver_set_submit_threads(driver, submit_threads_int);
+        option_set = true;
+      }
+      else
+        option_set = false;
     } else
       option_set = false;
   }
@@ -132,6 +153,9 @@ static bool queue_driver_unset_generic_option__(queue_driver_type * driver, cons
   if (strcmp(MAX_RUNNING, option_key) == 0) {
     queue_driver_set_max_running(driver, 0);
     option_unset = true;
+  } else if (strcmp(SUBMIT_THREADS, option_key) == 0) {
+    queue_driver_set_submit_threads(driver, 1);
+    option_unset = true;
   }
   return option_unset;
 }
@@ -140,6 +164,8 @@ static bool queue_driver_unset_generic_option__(queue_driver_type * driver, cons
 static void * queue_driver_get_generic_option__(queue_driver_type * driver, const char * option_key) {
   if (strcmp(MAX_RUNNING, option_key) == 0) {
     return driver->max_running_string;
+  } else if (strcmp(SUBMIT_THREADS, option_key) == 0) {
+    return driver->submit_threads_string;
   } else {
     util_abort("%s: driver:%s does not support generic option %s\n", __func__, driver->name, option_key);
     return NULL;
@@ -149,6 +175,8 @@ static void * queue_driver_get_generic_option__(queue_driver_type * driver, cons
 static bool queue_driver_has_generic_option__(queue_driver_type * driver, const char * option_key) {
   if (strcmp(MAX_RUNNING, option_key) == 0)
     return true;
+  else if (strcmp(SUBMIT_THREADS, option_key) == 0)
+    return true;
   else
     return false;
 }
@@ -213,9 +241,11 @@ static queue_driver_type * queue_driver_alloc_empty() {
   driver->name = NULL;
   driver->data = NULL;
   driver->max_running_string = NULL;
+  driver->submit_threads_string = NULL;
   driver->init_options = NULL;
 
   queue_driver_set_generic_option__(driver, MAX_RUNNING, "0");
+  queue_driver_set_generic_option__(driver, SUBMIT_THREADS, "1");
 
   return driver;
 }
@@ -315,6 +345,7 @@ const void * queue_driver_get_option(queue_driver_type * driver, const char * op
 void queue_driver_init_option_list(queue_driver_type * driver, stringlist_type * option_list) {
   //Add options common for all driver types
   stringlist_append_copy(option_list, MAX_RUNNING);
+  stringlist_append_copy(option_list, SUBMIT_THREADS);
 
   //Add options for the specific driver type
   if (driver->init_options)
@@ -392,6 +423,7 @@ void queue_driver_free(queue_driver_type * driver) {
   queue_driver_free_driver(driver);
   free(driver->name);
   free(driver->max_running_string);
+  free(driver->submit_threads_string);
   free(driver);
 }
 
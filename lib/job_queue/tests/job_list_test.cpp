@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include <ert/util/test_util.hpp>
+#include <ert/util/int_vector.hpp>
 #include <ert/res_util/arg_pack.hpp>
 
 #include <ert/job_queue/job_node.hpp>
@@ -70,8 +71,49 @@ void test_add_job() {
 }
 
 
+void test_select_status() {
+  job_list_type * list = job_list_alloc();
+  int_vector_type * index_list = int_vector_alloc(0,0);
+
+  for (int i = 0; i < 100; i++) {
+    job_queue_node_type * node = job_queue_node_alloc_simple("name" , "/tmp" , "/bin/ls" , 0 , NULL);
+    job_list_add_job( list , node );
+    job_queue_node_set_status( node , JOB_QUEUE_WAITING );
+  }
+
+  job_list_select_status( list , JOB_QUEUE_WAITING , index_list );
+  test_assert_int_equal( 100 , int_vector_size( index_list ));
+  for (int i = 0; i < 100; i++)
+    test_assert_int_equal( i , int_vector_iget( index_list , i ));
+
+  job_queue_node_set_status( job_list_iget_job( list , 3 ) , JOB_QUEUE_RUNNING );
+  job_queue_node_set_status( job_list_iget_job( list , 70 ) , JOB_QUEUE_RUNNING );
+  job_queue_node_set_status( job_list_iget_job( list , 99 ) , JOB_QUEUE_DONE );
+
+  job_list_select_status( list , JOB_QUEUE_WAITING , index_list );
+  test_assert_int_equal( 97 , int_vector_size( index_list ));
+
+  job_list_select_status( list , JOB_QUEUE_RUNNING , index_list );
+  test_assert_int_equal( 2 , int_vector_size( index_list ));
+  test_assert_int_equal( 3 , int_vector_iget( index_list , 0 ));
+  test_assert_int_equal( 70 , int_vector_iget( index_list , 1 ));
+
+  job_list_select_status( list , JOB_QUEUE_RUNNING + JOB_QUEUE_DONE , index_list );
+  test_assert_int_equal( 3 , int_vector_size( index_list ));
+  test_assert_int_equal( 99 , int_vector_iget( index_list , 2 ));
+
+  job_list_reset( list );
+  job_list_select_status( list , JOB_QUEUE_STATUS_ALL , index_list );
+  test_assert_int_equal( 0 , int_vector_size( index_list ));
+
+  int_vector_free( index_list );
+  job_list_free( list );
+}
+
+
 int main( int argc , char ** argv) {
   util_install_signals();
   test_create();
   test_add_job();
+  test_select_status();
 }
@@ -0,0 +1,91 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_local_driver_test.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/util.hpp>
+
+#include <ert/job_queue/local_driver.hpp>
+
+
+static void * submit_shell( void * driver , const char * script ) {
+  const char * argv[2] = { "-c" , script };
+  return local_driver_submit_job( driver , "/bin/sh" , 1 , NULL , "JOB" , 2 , argv );
+}
+
+
+/* Waits at most 10 seconds for the job to leave the RUNNING state. */
+static job_status_type wait_status( void * driver , void * job ) {
+  job_status_type status = local_driver_get_job_status( driver , job );
+  for (int i = 0; (i < 1000) && (status == JOB_QUEUE_RUNNING); i++) {
+    usleep( 10000 );
+    status = local_driver_get_job_status( driver , job );
+  }
+  return status;
+}
+
+
+void test_submit_kill() {
+  void * driver = local_driver_alloc( );
+  void * ok_job   = submit_shell( driver , "exit 0" );
+  void * fail_job = submit_shell( driver , "exit 1" );
+  void * kill_job = submit_shell( driver , "sleep 60" );
+
+  test_assert_int_equal( JOB_QUEUE_DONE , wait_status( driver , ok_job ));
+  test_assert_int_equal( JOB_QUEUE_EXIT , wait_status( driver , fail_job ));
+
+  /* Killing a job which has already been reaped is a no-op. */
+  local_driver_kill_job( driver , ok_job );
+  test_assert_int_equal( JOB_QUEUE_DONE , local_driver_get_job_status( driver , ok_job ));
+
+  test_assert_int_equal( JOB_QUEUE_RUNNING , local_driver_get_job_status( driver , kill_job ));
+  local_driver_kill_job( driver , kill_job );
+  test_assert_int_equal( JOB_QUEUE_EXIT , wait_status( driver , kill_job ));
+
+  local_driver_free_job( ok_job );
+  local_driver_free_job( fail_job );
+  local_driver_free_job( kill_job );
+  local_driver_free__( driver );
+}
+
+
+/*
+  One job is released by the queue while it is still running, and is
+  freed by the driver. The other job is still held by the queue when
+  the driver is freed, and is freed by the queue afterwards.
+*/
+
+void test_free_running() {
+  void * driver = local_driver_alloc( );
+  void * released_job = submit_shell( driver , "sleep 1" );
+  void * held_job     = submit_shell( driver , "sleep 1" );
+
+  test_assert_int_equal( JOB_QUEUE_RUNNING , local_driver_get_job_status( driver , released_job ));
+  local_driver_free_job( released_job );
+  local_driver_free__( driver );
+
+  local_driver_free_job( held_job );
+}
+
+
+int main(int argc , char ** argv) {
+  test_submit_kill();
+  test_free_running();
+  exit(0);
+}
@@ -64,6 +64,19 @@ void set_option_max_running_max_running_option_set() {
 
 }
 
+void set_option_submit_threads() {
+  queue_driver_type * driver_lsf = queue_driver_alloc(LSF_DRIVER);
+  test_assert_string_equal("1", (const char *) queue_driver_get_option(driver_lsf, SUBMIT_THREADS));
+  test_assert_true(queue_driver_set_option(driver_lsf, SUBMIT_THREADS, "8"));
+  test_assert_string_equal("8", (const char *) queue_driver_get_option(driver_lsf, SUBMIT_THREADS));
+  test_assert_int_equal(8, queue_driver_get_submit_threads(driver_lsf));
+  test_assert_false(queue_driver_set_option(driver_lsf, SUBMIT_THREADS, "0"));
+  test_assert_int_equal(8, queue_driver_get_submit_threads(driver_lsf));
+  test_assert_true(queue_driver_unset_option(driver_lsf, SUBMIT_THREADS));
+  test_assert_int_equal(1, queue_driver_get_submit_threads(driver_lsf));
+  queue_driver_free(driver_lsf);
+}
+
 void set_option_invalid_option_returns_false() {
   queue_driver_type * driver_torque = queue_driver_alloc(TORQUE_DRIVER);
   test_assert_false(queue_driver_set_option(driver_torque, "MAKS_RUNNING", "42"));
@@ -111,6 +124,7 @@ void get_driver_option_lists() {
     queue_driver_init_option_list(driver_local, option_list);
 
     test_assert_true(stringlist_contains(option_list, MAX_RUNNING));
+    test_assert_true(stringlist_contains(option_list, SUBMIT_THREADS));
 
     stringlist_free(option_list);
     queue_driver_free(driver_local);
@@ -161,6 +175,7 @@ int main(int argc, char ** argv) {
 
   set_option_max_running_max_running_value_set();
   set_option_max_running_max_running_option_set();
+  set_option_submit_threads();
   set_option_invalid_option_returns_false();
   set_option_invalid_value_returns_false();
 
@@ -0,0 +1,104 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_queue_metrics_test.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.hpp>
+
+#include <ert/job_queue/job_node.hpp>
+#include <ert/job_queue/job_queue_metrics.hpp>
+
+
+void test_timing() {
+  job_queue_metrics_type * metrics = job_queue_metrics_alloc();
+  job_queue_metrics_snapshot_type snapshot;
+
+  job_queue_metrics_add_timing( metrics , JOB_QUEUE_METRIC_SUBMIT , "job" , 1.0 );
+  job_queue_metrics_add_timing( metrics , JOB_QUEUE_METRIC_SUBMIT , "job" , 3.0 );
+  job_queue_metrics_add_timing( metrics , JOB_QUEUE_METRIC_LOOP , NULL , 0.5 );
+  job_queue_metrics_get_snapshot( metrics , &snapshot );
+
+  test_assert_int_equal( snapshot.timing[ JOB_QUEUE_METRIC_SUBMIT ].count , 2 );
+  test_assert_double_equal( snapshot.timing[ JOB_QUEUE_METRIC_SUBMIT ].total_time , 4.0 );
+  test_assert_double_equal( snapshot.timing[ JOB_QUEUE_METRIC_SUBMIT ].max_time , 3.0 );
+  test_assert_int_equal( snapshot.timing[ JOB_QUEUE_METRIC_LOOP ].count , 1 );
+  test_assert_int_equal( snapshot.timing[ JOB_QUEUE_METRIC_KILL ].count , 0 );
+
+  job_queue_metrics_clear( metrics );
+  job_queue_metrics_get_snapshot( metrics , &snapshot );
+  test_assert_int_equal( snapshot.timing[ JOB_QUEUE_METRIC_SUBMIT ].count , 0 );
+  job_queue_metrics_free( metrics );
+}
+
+
+void test_node_transitions() {
+  job_queue_metrics_type * metrics = job_queue_metrics_alloc();
+  job_queue_node_type * node = job_queue_node_alloc_simple( "name" , "/tmp" , "/bin/ls" , 0 , NULL );
+  job_queue_metrics_snapshot_type snapshot;
+
+  job_queue_node_set_metrics( node , metrics );
+  test_assert_double_equal( job_queue_node_get_status_time( node , JOB_QUEUE_WAITING ) , 0 );
+
+  job_queue_node_set_status( node , JOB_QUEUE_WAITING );
+  job_queue_node_set_status( node , JOB_QUEUE_PENDING );
+  job_queue_node_set_status( node , JOB_QUEUE_RUNNING );
+
+  test_assert_true( job_queue_node_get_status_time( node , JOB_QUEUE_WAITING ) > 0 );
+  test_assert_true( job_queue_node_get_status_time( node , JOB_QUEUE_PENDING ) >= job_queue_node_get_status_time( node , JOB_QUEUE_WAITING ));
+  test_assert_true( job_queue_node_get_status_time( node , JOB_QUEUE_RUNNING ) >= job_queue_node_get_status_time( node , JOB_QUEUE_PENDING ));
+
+  job_queue_metrics_get_snapshot( metrics , &snapshot );
+  test_assert_int_equal( snapshot.status_time[ job_status_get_index( JOB_QUEUE_NOT_ACTIVE ) ].count , 0 );
+  test_assert_int_equal( snapshot.status_time[ job_status_get_index( JOB_QUEUE_WAITING ) ].count , 1 );
+  test_assert_int_equal( snapshot.status_time[ job_status_get_index( JOB_QUEUE_PENDING ) ].count , 1 );
+  test_assert_int_equal( snapshot.status_time[ job_status_get_index( JOB_QUEUE_RUNNING ) ].count , 0 );
+
+  job_queue_node_free( node );
+  job_queue_metrics_free( metrics );
+}
+
+
+void test_trace() {
+  test_work_area_type * work_area = test_work_area_alloc("job_queue_metrics_trace");
+  job_queue_metrics_type * metrics = job_queue_metrics_alloc();
+
+  test_assert_false( job_queue_metrics_open_trace( metrics , "does/not/exist/trace.json" ));
+  test_assert_true( job_queue_metrics_open_trace( metrics , "trace.json" ));
+  job_queue_metrics_add_timing( metrics , JOB_QUEUE_METRIC_KILL , "job\"1" , 0.25 );
+  job_queue_metrics_add_transition( metrics , "job" , 7 , JOB_QUEUE_WAITING , JOB_QUEUE_SUBMITTED , 1.0 );
+  job_queue_metrics_close_trace( metrics );
+  {
+    char * content = util_fread_alloc_file_content( "trace.json" , NULL );
+    test_assert_not_NULL( strstr( content , "\"event\": \"KILL\", \"job\": \"job\\\"1\"" ));
+    test_assert_not_NULL( strstr( content , "\"from\": \"JOB_QUEUE_WAITING\", \"to\": \"JOB_QUEUE_SUBMITTED\"" ));
+    free( content );
+  }
+  job_queue_metrics_free( metrics );
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  util_install_signals();
+  test_timing();
+  test_node_transitions();
+  test_trace();
+}
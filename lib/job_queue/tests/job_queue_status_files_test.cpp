@@ -0,0 +1,121 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_queue_status_files_test.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.hpp>
+
+#include <ert/job_queue/job_node.hpp>
+#include <ert/job_queue/job_queue.hpp>
+#include <ert/job_queue/job_queue_manager.hpp>
+#include <ert/job_queue/queue_driver.hpp>
+
+/*
+  The jobs are run with the job_queue_stress_task, which writes the file
+  given as its third argument when it is done. All three jobs are
+  reported as DONE by the local driver, and the OK / EXIT files decide
+  the final status:
+
+    0: Writes the OK file         -> SUCCESS, the DONE callback is run.
+    1: Writes the EXIT file       -> EXIT -> FAILED.
+    2: Writes neither of them     -> EXIT -> FAILED, after max_ok_wait_time.
+*/
+
+#define NUM_JOBS         3
+#define MAX_OK_WAIT_TIME 2
+
+typedef struct {
+  int done_count;
+  int exit_count;
+} job_type;
+
+
+static bool job_done_callback( void * arg ) {
+  job_type * job = (job_type *) arg;
+  job->done_count++;
+  return true;
+}
+
+
+static bool job_exit_callback( void * arg ) {
+  job_type * job = (job_type *) arg;
+  job->exit_count++;
+  return true;
+}
+
+
+void test_status_files( const char * job_cmd ) {
+  ecl::util::TestArea ta("status_files");
+  const char * result_file[NUM_JOBS] = { "OK" , "ERROR" , "NOTHING" };
+  job_type jobs[NUM_JOBS];
+
+  /* With max_submit == 0 a failed job is not resubmitted. */
+  job_queue_type * queue = job_queue_alloc( 0 , "OK" , "STATUS" , "ERROR" );
+  queue_driver_type * driver = queue_driver_alloc_local( );
+  job_queue_manager_type * manager = job_queue_manager_alloc( queue );
+  char * cmd = util_alloc_abs_path( job_cmd );
+
+  job_queue_set_driver( queue , driver );
+  job_queue_set_max_ok_wait_time( queue , MAX_OK_WAIT_TIME );
+
+  for (int i = 0; i < NUM_JOBS; i++) {
+    char * run_path = util_alloc_sprintf( "run_%d" , i );
+    const char * argv[4] = { run_path , "STATUS" , result_file[i] , "10000" };
+
+    jobs[i].done_count = 0;
+    jobs[i].exit_count = 0;
+    util_make_path( run_path );
+    job_queue_add_job( queue , cmd , job_done_callback , NULL , job_exit_callback , &jobs[i] , 1 , run_path , run_path , 4 , argv );
+    free( run_path );
+  }
+
+  job_queue_manager_start_queue( manager , NUM_JOBS , false );
+  test_assert_true( job_queue_manager_try_wait( manager , 60 ));
+
+  test_assert_int_equal( JOB_QUEUE_SUCCESS , job_queue_iget_job_status( queue , 0 ));
+  test_assert_int_equal( 1 , jobs[0].done_count );
+  test_assert_int_equal( 0 , jobs[0].exit_count );
+
+  test_assert_int_equal( JOB_QUEUE_FAILED , job_queue_iget_job_status( queue , 1 ));
+  test_assert_int_equal( 0 , jobs[1].done_count );
+  test_assert_int_equal( 1 , jobs[1].exit_count );
+
+  test_assert_int_equal( JOB_QUEUE_FAILED , job_queue_iget_job_status( queue , 2 ));
+  test_assert_int_equal( 0 , jobs[2].done_count );
+  test_assert_int_equal( 1 , jobs[2].exit_count );
+  {
+    job_queue_node_type * node = job_queue_iget_job( queue , 2 );
+    test_assert_true( difftime( job_queue_node_get_sim_end( node ) , job_queue_node_get_done_time( node )) >= MAX_OK_WAIT_TIME );
+  }
+
+  free( cmd );
+  job_queue_manager_free( manager );
+  job_queue_free( queue );
+  queue_driver_free( driver );
+}
+
+
+int main(int argc , char ** argv) {
+  util_install_signals( );
+  test_status_files( argv[1] );
+  exit(0);
+}
@@ -0,0 +1,103 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'job_queue_submit_threads_test.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <ert/util/test_util.hpp>
+#include <ert/util/test_work_area.hpp>
+#include <ert/util/util.hpp>
+
+#include <ert/job_queue/job_queue.hpp>
+#include <ert/job_queue/job_queue_manager.hpp>
+#include <ert/job_queue/queue_driver.hpp>
+
+/*
+  Runs a number of short jobs through the LOCAL driver with
+  SUBMIT_THREADS > 1, i.e. the jobs are submitted through the submit
+  thread pool of the queue. All the jobs should complete successfully,
+  and since the local driver never rejects a job the adaptive submit
+  batch should have grown to the configured maximum.
+*/
+
+#define NUM_JOBS         40
+#define MAX_SUBMIT_BATCH 8
+
+static pthread_mutex_t done_lock = PTHREAD_MUTEX_INITIALIZER;
+static int done_count[NUM_JOBS];
+
+
+static bool job_done_callback( void * arg ) {
+  int * index = (int *) arg;
+  pthread_mutex_lock( &done_lock );
+  done_count[*index]++;
+  pthread_mutex_unlock( &done_lock );
+  return true;
+}
+
+
+void test_submit_threads( const char * job_cmd ) {
+  ecl::util::TestArea ta("submit_threads");
+  job_queue_type * queue = job_queue_alloc( 0 , "OK" , "STATUS" , "ERROR" );
+  queue_driver_type * driver = queue_driver_alloc_local( );
+  job_queue_manager_type * manager = job_queue_manager_alloc( queue );
+  char * cmd = util_alloc_abs_path( job_cmd );
+  int index[NUM_JOBS];
+  char * run_path[NUM_JOBS];
+
+  test_assert_true( queue_driver_set_option( driver , SUBMIT_THREADS , "4" ));
+  test_assert_int_equal( 4 , queue_driver_get_submit_threads( driver ));
+  job_queue_set_driver( queue , driver );
+  job_queue_set_max_submit_batch( queue , MAX_SUBMIT_BATCH );
+
+  for (int i = 0; i < NUM_JOBS; i++) {
+    const char * argv[4];
+    index[i] = i;
+    run_path[i] = util_alloc_sprintf( "run_%d" , i );
+    util_make_path( run_path[i] );
+
+    argv[0] = run_path[i];
+    argv[1] = "RUNNING";
+    argv[2] = "OK";
+    argv[3] = "50000";
+    job_queue_add_job( queue , cmd , job_done_callback , NULL , NULL , &index[i] , 1 , run_path[i] , run_path[i] , 4 , argv );
+  }
+
+  job_queue_manager_start_queue( manager , NUM_JOBS , false );
+  test_assert_true( job_queue_manager_try_wait( manager , 60 ));
+
+  for (int i = 0; i < NUM_JOBS; i++) {
+    test_assert_int_equal( JOB_QUEUE_SUCCESS , job_queue_iget_job_status( queue , i ));
+    test_assert_int_equal( 1 , done_count[i] );
+    free( run_path[i] );
+  }
+  test_assert_int_equal( MAX_SUBMIT_BATCH , job_queue_get_submit_batch_size( queue ));
+
+  free( cmd );
+  job_queue_manager_free( manager );
+  job_queue_free( queue );
+  queue_driver_free( driver );
+}
+
+
+int main(int argc , char ** argv) {
+  util_install_signals( );
+  test_submit_threads( argv[1] );
+  exit(0);
+}
@@ -22,6 +22,7 @@
 #include <pthread.h>
 
 #include <ert/job_queue/job_queue_status.hpp>
+#include <ert/job_queue/job_status.hpp>
 #include <ert/job_queue/queue_driver.hpp>
 #include <ert/util/test_util.hpp>
 
@@ -195,9 +196,28 @@ void test_index() {
   job_queue_status_free( status );
 }
 
+void call_get_index( void * arg ) {
+  int * value = (int *) arg;
+  job_status_get_index( (job_status_type) *value );
+}
+
+
+void test_get_index() {
+  for (int index = 0; index < JOB_QUEUE_MAX_STATE; index++)
+    test_assert_int_equal( index , job_status_get_index( (job_status_type) (1 << index)));
+
+  test_assert_int_equal( 4 , job_status_get_index( JOB_QUEUE_RUNNING ));
+  {
+    int invalid[] = { 0 , JOB_QUEUE_WAITING + JOB_QUEUE_PENDING , 1 << JOB_QUEUE_MAX_STATE };
+    for (int i = 0; i < 3; i++)
+      test_assert_util_abort( "job_status_get_index" , call_get_index , &invalid[i] );
+  }
+}
+
 int main( int argc , char ** argv) {
   util_install_signals();
   test_create();
   test_index();
+  test_get_index();
   test_update();
 }
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <ert/util/util.hpp>
 #include <ert/util/type_macros.hpp>
@@ -286,6 +287,7 @@ stringlist_type * torque_driver_alloc_cmd(torque_driver_type * driver,
 
 static void torque_debug(const torque_driver_type * driver , const char * fmt , ...) {
   if (driver->debug_stream) {
+    flockfile( driver->debug_stream );   /* Keep the lines from concurrent submits apart. */
     {
       va_list ap;
       va_start(ap , fmt);
@@ -294,6 +296,7 @@ static void torque_debug(const torque_driver_type * driver , const char * fmt ,
     }
     fprintf(driver->debug_stream , "\n");
     fsync( fileno(driver->debug_stream) );
+    funlockfile( driver->debug_stream );
   }
 }
 
@@ -351,6 +354,20 @@ static void torque_debug_spawn_status_info(torque_driver_type *driver, int statu
   }
 }
 
+/*
+  Several submit threads can run at the same time; the files are
+  created with mkstemp() so that two threads never get the same name.
+*/
+
+static char * torque_driver_alloc_submit_tmp_file( const char * prefix ) {
+  char * tmp_file = util_alloc_sprintf( "/tmp/%s-XXXXXX" , prefix );
+  int fd = mkstemp( tmp_file );
+  if (fd < 0)
+    util_abort("%s: failed to create temporary file: %s \n",__func__ , strerror( errno ));
+  close( fd );
+  return tmp_file;
+}
+
 static int torque_driver_submit_shell_job(torque_driver_type * driver,
                                           const char * run_path,
                                           const char * job_name,
@@ -362,8 +379,8 @@ static int torque_driver_submit_shell_job(torque_driver_type * driver,
   usleep( driver->submit_sleep );
   {
     int job_id;
-    char * tmp_std_file = (char*)util_alloc_tmp_file("/tmp", "enkf-submit-std", true);
-    char * tmp_err_file = (char*)util_alloc_tmp_file("/tmp", "enkf-submit-err", true);
+    char * tmp_std_file = torque_driver_alloc_submit_tmp_file("enkf-submit-std");
+    char * tmp_err_file = torque_driver_alloc_submit_tmp_file("enkf-submit-err");
     char * script_filename = (char*)util_alloc_filename(run_path, "qsub_script", "sh");
 
     torque_debug(driver, "Setting up submit stdout target '%s' for '%s'", tmp_std_file, script_filename);
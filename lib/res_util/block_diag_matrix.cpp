@@ -0,0 +1,235 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'block_diag_matrix.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/matrix_blas.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
+
+#define BLOCK_DIAG_MATRIX_TYPE_ID 66172096
+
+
+/*
+  Exactly one of diag and dense is non NULL.
+*/
+
+typedef struct {
+  int           offset;
+  int           size;
+  double      * diag;
+  matrix_type * dense;
+} block_diag_node_type;
+
+
+struct block_diag_matrix_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int           size;
+  vector_type * blocks;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( block_diag_matrix , BLOCK_DIAG_MATRIX_TYPE_ID )
+
+
+static void block_diag_node_free( block_diag_node_type * node ) {
+  free( node->diag );
+  if (node->dense != NULL)
+    matrix_free( node->dense );
+  free( node );
+}
+
+
+static void block_diag_node_free__( void * arg ) {
+  block_diag_node_free( (block_diag_node_type *) arg );
+}
+
+
+static block_diag_node_type * block_diag_node_alloc( int offset , int size ) {
+  block_diag_node_type * node = (block_diag_node_type *)util_malloc( sizeof * node );
+  node->offset = offset;
+  node->size   = size;
+  node->diag   = NULL;
+  node->dense  = NULL;
+  return node;
+}
+
+
+block_diag_matrix_type * block_diag_matrix_alloc( ) {
+  block_diag_matrix_type * matrix = (block_diag_matrix_type *)util_malloc( sizeof * matrix );
+  UTIL_TYPE_ID_INIT( matrix , BLOCK_DIAG_MATRIX_TYPE_ID );
+  matrix->size   = 0;
+  matrix->blocks = vector_alloc_new( );
+  return matrix;
+}
+
+
+void block_diag_matrix_free( block_diag_matrix_type * matrix ) {
+  vector_free( matrix->blocks );
+  free( matrix );
+}
+
+
+void block_diag_matrix_append_diag( block_diag_matrix_type * matrix , int size , const double * diag ) {
+  block_diag_node_type * last = NULL;
+  if (size <= 0)
+    return;
+
+  if (vector_get_size( matrix->blocks ) > 0)
+    last = (block_diag_node_type *) vector_get_last( matrix->blocks );
+
+  if (last != NULL && last->diag != NULL) {
+    last->diag = (double *)util_realloc( last->diag , (last->size + size) * sizeof * last->diag );
+    memcpy( &last->diag[last->size] , diag , size * sizeof * diag );
+    last->size += size;
+  } else {
+    block_diag_node_type * node = block_diag_node_alloc( matrix->size , size );
+    node->diag = (double *)util_alloc_copy( diag , size * sizeof * diag );
+    vector_append_owned_ref( matrix->blocks , node , block_diag_node_free__ );
+  }
+  matrix->size += size;
+}
+
+
+void block_diag_matrix_append_dense( block_diag_matrix_type * matrix , const matrix_type * block ) {
+  int size = matrix_get_rows( block );
+  if (matrix_get_columns( block ) != size)
+    util_abort("%s: the blocks must be square - got %d x %d \n",__func__ , size , matrix_get_columns( block ));
+
+  if (size > 0) {
+    block_diag_node_type * node = block_diag_node_alloc( matrix->size , size );
+    node->dense = matrix_alloc_copy( block );
+    vector_append_owned_ref( matrix->blocks , node , block_diag_node_free__ );
+    matrix->size += size;
+  }
+}
+
+
+int block_diag_matrix_get_size( const block_diag_matrix_type * matrix ) {
+  return matrix->size;
+}
+
+
+bool block_diag_matrix_is_diagonal( const block_diag_matrix_type * matrix ) {
+  for (int b = 0; b < vector_get_size( matrix->blocks ); b++) {
+    const block_diag_node_type * node = (const block_diag_node_type *) vector_iget_const( matrix->blocks , b );
+    if (node->dense != NULL)
+      return false;
+  }
+  return true;
+}
+
+
+double block_diag_matrix_iget( const block_diag_matrix_type * matrix , int i , int j ) {
+  if (i < 0 || i >= matrix->size || j < 0 || j >= matrix->size)
+    util_abort("%s: index (%d,%d) invalid for matrix of size %d \n",__func__ , i , j , matrix->size );
+
+  for (int b = 0; b < vector_get_size( matrix->blocks ); b++) {
+    const block_diag_node_type * node = (const block_diag_node_type *) vector_iget_const( matrix->blocks , b );
+    if (i < node->offset + node->size) {
+      int bi = i - node->offset;
+      int bj = j - node->offset;
+
+      if (bj < 0 || bj >= node->size)
+        return 0;
+
+      if (node->diag != NULL)
+        return (bi == bj) ? node->diag[bi] : 0;
+      else
+        return matrix_iget( node->dense , bi , bj );
+    }
+  }
+  return 0;
+}
+
+
+matrix_type * block_diag_matrix_alloc_dense( const block_diag_matrix_type * matrix ) {
+  matrix_type * dense = matrix_alloc( matrix->size , matrix->size );
+
+  for (int b = 0; b < vector_get_size( matrix->blocks ); b++) {
+    const block_diag_node_type * node = (const block_diag_node_type *) vector_iget_const( matrix->blocks , b );
+    if (node->diag != NULL) {
+      for (int i = 0; i < node->size; i++)
+        matrix_iset( dense , node->offset + i , node->offset + i , node->diag[i] );
+    } else
+      matrix_copy_block( dense , node->offset , node->offset , node->size , node->size , node->dense , 0 , 0 );
+  }
+
+  return dense;
+}
+
+
+/*
+  Elementwise R(i,j) *= scale_factor[i] * scale_factor[j]; i.e. the
+  matrix is replaced with diag(scale_factor) * R * diag(scale_factor).
+*/
+
+void block_diag_matrix_scale( block_diag_matrix_type * matrix , const double * scale_factor ) {
+  for (int b = 0; b < vector_get_size( matrix->blocks ); b++) {
+    block_diag_node_type * node = (block_diag_node_type *) vector_iget( matrix->blocks , b );
+    const double * block_scale  = &scale_factor[ node->offset ];
+
+    if (node->diag != NULL) {
+      for (int i = 0; i < node->size; i++)
+        node->diag[i] *= block_scale[i] * block_scale[i];
+    } else {
+      for (int j = 0; j < node->size; j++)
+        for (int i = 0; i < node->size; i++)
+          matrix_imul( node->dense , i , j , block_scale[i] * block_scale[j] );
+    }
+  }
+}
+
+
+/*
+  C = R * A, where R is the block diagonal matrix. The diagonal blocks
+  are a row scaling of A, the dense blocks are a dgemm() on the
+  corresponding rows of A and C.
+*/
+
+void block_diag_matrix_matmul( matrix_type * C , const block_diag_matrix_type * matrix , const matrix_type * A ) {
+  const int columns = matrix_get_columns( A );
+
+  if ((matrix_get_rows( A ) != matrix->size) || (matrix_get_rows( C ) != matrix->size) || (matrix_get_columns( C ) != columns))
+    util_abort("%s: size mismatch: R:%d x %d  A:%d x %d  C:%d x %d \n",__func__ ,
+               matrix->size , matrix->size ,
+               matrix_get_rows( A ) , columns ,
+               matrix_get_rows( C ) , matrix_get_columns( C ));
+
+  for (int b = 0; b < vector_get_size( matrix->blocks ); b++) {
+    const block_diag_node_type * node = (const block_diag_node_type *) vector_iget_const( matrix->blocks , b );
+
+    if (node->diag != NULL) {
+      for (int j = 0; j < columns; j++)
+        for (int i = 0; i < node->size; i++)
+          matrix_iset( C , node->offset + i , j , node->diag[i] * matrix_iget( A , node->offset + i , j ));
+    } else {
+      matrix_type * A_block = matrix_alloc_shared( A , node->offset , 0 , node->size , columns );
+      matrix_type * C_block = matrix_alloc_shared( C , node->offset , 0 , node->size , columns );
+
+      matrix_matmul( C_block , node->dense , A_block );
+
+      matrix_free( C_block );
+      matrix_free( A_block );
+    }
+  }
+}
@@ -31,6 +31,7 @@
 #include <ert/util/vector.hpp>
 #include <ert/util/buffer.hpp>
 #include <ert/util/long_vector.hpp>
+#include <ert/util/stringlist.hpp>
 
 #include <ert/res_util/block_fs.hpp>
 
@@ -1384,6 +1385,31 @@ void block_fs_fwrite_buffer(block_fs_type * block_fs , const char * filename , c
 }
 
 
+/**
+   Writes many files in one go; element i in @buffers (buffer_type
+   instances) is stored under filename i in @filenames. The write lock
+   is only taken once, and the check for rotation is only done after
+   all the files have been written.
+*/
+
+void block_fs_fwrite_buffers(block_fs_type * block_fs , const stringlist_type * filenames , const vector_type * buffers) {
+  if (stringlist_get_size( filenames ) != vector_get_size( buffers ))
+    util_abort("%s: size mismatch between filenames:%d and buffers:%d \n",__func__ , stringlist_get_size( filenames ) , vector_get_size( buffers ));
+
+  block_fs_aquire_wlock( block_fs );
+  {
+    for (int i=0; i < stringlist_get_size( filenames ); i++) {
+      const buffer_type * buffer = (const buffer_type *) vector_iget_const( buffers , i );
+      block_fs_fwrite_file_unlocked( block_fs , stringlist_iget( filenames , i ) , buffer_get_data( buffer ) , buffer_get_size( buffer ));
+    }
+
+    if ((block_fs->free_size * 1.0 / block_fs->data_file_size) > block_fs->fragmentation_limit)
+      block_fs_rotate__( block_fs );
+  }
+  block_fs_release_rwlock( block_fs );
+}
+
+
 /**
    Need extra locking here - because the global rwlock allows many
    concurrent readers.
@@ -0,0 +1,192 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'counter_rng.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <string.h>
+#include <cmath>
+
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+
+#include <ert/res_util/counter_rng.hpp>
+
+/*
+  Philox4x32-10 from Salmon et al., "Parallel random numbers: as easy
+  as 1, 2, 3" (SC11). The counter is (block index, stream) and the key
+  is the seed; one evaluation gives 128 random bits, which are used as
+  two 53 bit uniforms - i.e. one Box-Muller pair.
+
+  The generator functions work on batches of counter blocks: first all
+  the integer rounds for the batch, and then the floating point
+  transform for the batch. Both loops are free of branches and the
+  integer loop vectorizes with the 32x32->64 bit vector multiply.
+*/
+
+#define PHILOX_M0  0xD2511F53U
+#define PHILOX_M1  0xCD9E8D57U
+#define PHILOX_W0  0x9E3779B9U
+#define PHILOX_W1  0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+#define COUNTER_RNG_BATCH 128
+#define COUNTER_RNG_UNIT  (1.0 / 9007199254740992.0)    /* 2^-53 */
+
+
+
+static inline void counter_rng_round( uint32_t * c0 , uint32_t * c1 , uint32_t * c2 , uint32_t * c3 , uint32_t k0 , uint32_t k1) {
+  uint64_t p0 = (uint64_t) PHILOX_M0 * (*c0);
+  uint64_t p1 = (uint64_t) PHILOX_M1 * (*c2);
+  uint32_t hi0 = (uint32_t) (p0 >> 32);
+  uint32_t lo0 = (uint32_t) p0;
+  uint32_t hi1 = (uint32_t) (p1 >> 32);
+  uint32_t lo1 = (uint32_t) p1;
+
+  *c0 = hi1 ^ (*c1) ^ k0;
+  *c1 = lo1;
+  *c2 = hi0 ^ (*c3) ^ k1;
+  *c3 = lo0;
+}
+
+
+static inline void counter_rng_block( uint32_t k0 , uint32_t k1 , uint32_t * c0 , uint32_t * c1 , uint32_t * c2 , uint32_t * c3) {
+  for (int r = 0; r < PHILOX_ROUNDS; r++) {
+    counter_rng_round( c0 , c1 , c2 , c3 , k0 , k1 );
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+}
+
+
+void counter_rng_philox4x32( uint64_t seed , const uint32_t * counter , uint32_t * output) {
+  uint32_t c0 = counter[0];
+  uint32_t c1 = counter[1];
+  uint32_t c2 = counter[2];
+  uint32_t c3 = counter[3];
+
+  counter_rng_block( (uint32_t) seed , (uint32_t) (seed >> 32) , &c0 , &c1 , &c2 , &c3 );
+  output[0] = c0;
+  output[1] = c1;
+  output[2] = c2;
+  output[3] = c3;
+}
+
+
+/*
+  The seed for a counter based fill is drawn from an ordinary rng
+  instance, i.e. the random numbers are still governed by the seed of
+  the calling rng - but only two numbers are consumed from it.
+*/
+
+uint64_t counter_rng_draw_seed( rng_type * rng ) {
+  uint64_t hi = rng_forward( rng );
+  uint64_t lo = rng_forward( rng );
+  return (hi << 32) | (lo & 0xFFFFFFFFU);
+}
+
+
+/*
+  Fills u[0..2*num_blocks) with uniforms in [0,1) from the consecutive
+  counter blocks starting at first_block in the given stream.
+*/
+
+static void counter_rng_uniform_batch( uint64_t seed , uint64_t stream , uint64_t first_block , int num_blocks , double * u) {
+  uint32_t c0[COUNTER_RNG_BATCH];
+  uint32_t c1[COUNTER_RNG_BATCH];
+  uint32_t c2[COUNTER_RNG_BATCH];
+  uint32_t c3[COUNTER_RNG_BATCH];
+  const uint32_t k0 = (uint32_t) seed;
+  const uint32_t k1 = (uint32_t) (seed >> 32);
+
+  for (int b = 0; b < num_blocks; b++) {
+    uint64_t block = first_block + b;
+    c0[b] = (uint32_t) block;
+    c1[b] = (uint32_t) (block >> 32);
+    c2[b] = (uint32_t) stream;
+    c3[b] = (uint32_t) (stream >> 32);
+  }
+
+  {
+    uint32_t rk0 = k0;
+    uint32_t rk1 = k1;
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+      for (int b = 0; b < num_blocks; b++)
+        counter_rng_round( &c0[b] , &c1[b] , &c2[b] , &c3[b] , rk0 , rk1 );
+      rk0 += PHILOX_W0;
+      rk1 += PHILOX_W1;
+    }
+  }
+
+  for (int b = 0; b < num_blocks; b++) {
+    uint64_t x0 = ((uint64_t) c1[b] << 32) | c0[b];
+    uint64_t x1 = ((uint64_t) c3[b] << 32) | c2[b];
+    u[2*b]     = (double) (x0 >> 11) * COUNTER_RNG_UNIT;
+    u[2*b + 1] = (double) (x1 >> 11) * COUNTER_RNG_UNIT;
+  }
+}
+
+
+/*
+  Box-Muller on a batch of uniform pairs; 1 - u is in (0,1] so the
+  logarithm is always finite.
+*/
+
+static void counter_rng_box_muller( int num_blocks , double * z) {
+  const double two_pi = 6.283185307179586476925286766559;
+  for (int b = 0; b < num_blocks; b++) {
+    double r     = sqrt( -2.0 * log( 1.0 - z[2*b] ));
+    double theta = two_pi * z[2*b + 1];
+    z[2*b]     = r * cos( theta );
+    z[2*b + 1] = r * sin( theta );
+  }
+}
+
+
+static void counter_rng_fill( uint64_t seed , uint64_t stream , uint64_t offset , int size , double * data , bool normal) {
+  double batch[2 * COUNTER_RNG_BATCH];
+  uint64_t block = offset / 2;
+  int skip = (int) (offset % 2);
+  int pos = 0;
+
+  while (pos < size) {
+    int num_blocks = util_int_min( COUNTER_RNG_BATCH , (size - pos + skip + 1) / 2 );
+    int count = util_int_min( 2 * num_blocks - skip , size - pos );
+
+    counter_rng_uniform_batch( seed , stream , block , num_blocks , batch );
+    if (normal)
+      counter_rng_box_muller( num_blocks , batch );
+
+    memcpy( &data[pos] , &batch[skip] , count * sizeof * data );
+    pos   += count;
+    block += num_blocks;
+    skip   = 0;
+  }
+}
+
+
+/*
+  Element number i of a stream is element (offset + i) of
+  (seed, stream), independent of how the stream is split into calls.
+*/
+
+void counter_rng_fill_uniform( uint64_t seed , uint64_t stream , uint64_t offset , int size , double * data) {
+  counter_rng_fill( seed , stream , offset , size , data , false );
+}
+
+
+void counter_rng_fill_normal( uint64_t seed , uint64_t stream , uint64_t offset , int size , double * data) {
+  counter_rng_fill( seed , stream , offset , size , data , true );
+}
@@ -0,0 +1,138 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'ert_util_block_diag_matrix.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <cmath>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/res_util/matrix.hpp>
+#include <ert/res_util/matrix_blas.hpp>
+#include <ert/res_util/block_diag_matrix.hpp>
+
+
+static void assert_equal( const matrix_type * m1 , const matrix_type * m2 ) {
+  test_assert_int_equal( matrix_get_rows( m1 ) , matrix_get_rows( m2 ));
+  test_assert_int_equal( matrix_get_columns( m1 ) , matrix_get_columns( m2 ));
+  for (int j = 0; j < matrix_get_columns( m1 ); j++)
+    for (int i = 0; i < matrix_get_rows( m1 ); i++)
+      test_assert_true( fabs( matrix_iget( m1 , i , j ) - matrix_iget( m2 , i , j )) < 1e-12 );
+}
+
+
+/*
+  Diagonal blocks of size 3 and 2 - which are merged - a dense 3 x 3
+  block and a diagonal block of size 4.
+*/
+
+static block_diag_matrix_type * alloc_R( ) {
+  block_diag_matrix_type * R = block_diag_matrix_alloc( );
+  double diag1[3] = {1 , 2 , 3};
+  double diag2[2] = {4 , 5};
+  double diag3[4] = {6 , 7 , 8 , 9};
+  matrix_type * dense = matrix_alloc( 3 , 3 );
+
+  for (int j = 0; j < 3; j++)
+    for (int i = 0; i < 3; i++)
+      matrix_iset( dense , i , j , (i == j) ? 2.0 : 0.5 / (1 + i + j));
+
+  block_diag_matrix_append_diag( R , 3 , diag1 );
+  block_diag_matrix_append_diag( R , 2 , diag2 );
+  test_assert_true( block_diag_matrix_is_diagonal( R ));
+  block_diag_matrix_append_dense( R , dense );
+  block_diag_matrix_append_diag( R , 4 , diag3 );
+
+  matrix_free( dense );
+  return R;
+}
+
+
+static void test_create() {
+  block_diag_matrix_type * R = alloc_R( );
+  matrix_type * dense = block_diag_matrix_alloc_dense( R );
+
+  test_assert_true( block_diag_matrix_is_instance( R ));
+  test_assert_int_equal( 12 , block_diag_matrix_get_size( R ));
+  test_assert_false( block_diag_matrix_is_diagonal( R ));
+
+  test_assert_true( block_diag_matrix_iget( R , 4 , 4 ) == 5 );
+  test_assert_true( block_diag_matrix_iget( R , 4 , 5 ) == 0 );
+  test_assert_true( block_diag_matrix_iget( R , 5 , 6 ) == 0.25 );
+  test_assert_true( block_diag_matrix_iget( R , 11 , 11 ) == 9 );
+  for (int j = 0; j < 12; j++)
+    for (int i = 0; i < 12; i++)
+      test_assert_true( block_diag_matrix_iget( R , i , j ) == matrix_iget( dense , i , j ));
+
+  matrix_free( dense );
+  block_diag_matrix_free( R );
+}
+
+
+static void test_scale() {
+  block_diag_matrix_type * R = alloc_R( );
+  matrix_type * dense = block_diag_matrix_alloc_dense( R );
+  double scale_factor[12];
+
+  for (int i = 0; i < 12; i++)
+    scale_factor[i] = 1.0 / (i + 1);
+
+  for (int j = 0; j < 12; j++)
+    for (int i = 0; i < 12; i++)
+      matrix_imul( dense , i , j , scale_factor[i] * scale_factor[j] );
+
+  block_diag_matrix_scale( R , scale_factor );
+  {
+    matrix_type * scaled = block_diag_matrix_alloc_dense( R );
+    assert_equal( dense , scaled );
+    matrix_free( scaled );
+  }
+
+  matrix_free( dense );
+  block_diag_matrix_free( R );
+}
+
+
+static void test_matmul() {
+  block_diag_matrix_type * R = alloc_R( );
+  matrix_type * dense = block_diag_matrix_alloc_dense( R );
+  matrix_type * A  = matrix_alloc( 12 , 5 );
+  matrix_type * C0 = matrix_alloc( 12 , 5 );
+  matrix_type * C1 = matrix_alloc( 12 , 5 );
+
+  for (int j = 0; j < 5; j++)
+    for (int i = 0; i < 12; i++)
+      matrix_iset( A , i , j , sin( i + 12 * j ));
+
+  matrix_matmul( C0 , dense , A );
+  block_diag_matrix_matmul( C1 , R , A );
+  assert_equal( C0 , C1 );
+
+  matrix_free( C1 );
+  matrix_free( C0 );
+  matrix_free( A );
+  matrix_free( dense );
+  block_diag_matrix_free( R );
+}
+
+
+int main(int argc , char ** argv) {
+  test_create();
+  test_scale();
+  test_matmul();
+  exit(0);
+}
@@ -23,6 +23,9 @@
 
 #include <ert/util/test_util.hpp>
 #include <ert/util/test_work_area.hpp>
+#include <ert/util/buffer.hpp>
+#include <ert/util/stringlist.hpp>
+#include <ert/util/vector.hpp>
 #include <ert/res_util/block_fs.hpp>
 
 void test_assert_util_abort(const char * function_name , void call_func (void *) , void * arg);
@@ -43,6 +46,42 @@ void test_readonly( ) {
 }
 
 
+void test_fwrite_buffers() {
+  ecl::util::TestArea ta("fwrite_buffers");
+  block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+  stringlist_type * filenames = stringlist_alloc_new();
+  vector_type * buffers = vector_alloc_new();
+
+  for (int i=0; i < 10; i++) {
+    buffer_type * buffer = buffer_alloc( 100 );
+    for (int j=0; j <= i; j++)
+      buffer_fwrite_int( buffer , 100*i + j );
+
+    stringlist_append_owned_ref( filenames , util_alloc_sprintf("FILE_%d" , i));
+    vector_append_ref( buffers , buffer );
+  }
+  block_fs_fwrite_buffers( bfs , filenames , buffers );
+
+  {
+    buffer_type * buffer = buffer_alloc( 100 );
+    for (int i=0; i < 10; i++) {
+      test_assert_true( block_fs_has_file( bfs , stringlist_iget( filenames , i )));
+      block_fs_fread_realloc_buffer( bfs , stringlist_iget( filenames , i ) , buffer );
+      test_assert_int_equal( buffer_get_size( buffer ) , (i + 1) * sizeof(int) );
+      for (int j=0; j <= i; j++)
+        test_assert_int_equal( buffer_fread_int( buffer ) , 100*i + j );
+    }
+    buffer_free( buffer );
+  }
+
+  for (int i=0; i < vector_get_size( buffers ); i++)
+    buffer_free( (buffer_type *) vector_iget( buffers , i ));
+  vector_free( buffers );
+  stringlist_free( filenames );
+  block_fs_close( bfs , true );
+}
+
+
 void createFS1() {
   pid_t pid = fork();
 
@@ -101,6 +140,7 @@ void test_lock_conflict() {
 
 int main(int argc , char ** argv) {
   test_readonly();
+  test_fwrite_buffers();
   test_lock_conflict();
   exit(0);
 }
@@ -0,0 +1,122 @@
+/*
+   Copyright (C) 2018  Equinor ASA, Norway.
+
+   The file 'ert_util_counter_rng.cpp' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/res_util/counter_rng.hpp>
+
+
+/*
+  Known answer tests from the Random123 distribution.
+*/
+
+static void test_philox( uint64_t seed , uint32_t c0 , uint32_t c1 , uint32_t c2 , uint32_t c3,
+                         uint32_t e0 , uint32_t e1 , uint32_t e2 , uint32_t e3) {
+  uint32_t counter[4] = {c0 , c1 , c2 , c3};
+  uint32_t output[4];
+
+  counter_rng_philox4x32( seed , counter , output );
+  test_assert_true( output[0] == e0 );
+  test_assert_true( output[1] == e1 );
+  test_assert_true( output[2] == e2 );
+  test_assert_true( output[3] == e3 );
+}
+
+
+static void test_known_answer() {
+  test_philox( 0 , 0 , 0 , 0 , 0 ,
+               0x6627e8d5 , 0xe169c58d , 0xbc57ac4c , 0x9b00dbd8 );
+  test_philox( 0xffffffffffffffffULL , 0xffffffff , 0xffffffff , 0xffffffff , 0xffffffff ,
+               0x408f276d , 0x41c83b0e , 0xa20bc7c6 , 0x6d5451fd );
+  test_philox( 0x299f31d0a4093822ULL , 0x243f6a88 , 0x85a308d3 , 0x13198a2e , 0x03707344 ,
+               0xd16cfe09 , 0x94fdcceb , 0x5001e420 , 0x24126ea1 );
+}
+
+
+/*
+  The numbers must not depend on how a stream is split into calls.
+*/
+
+static void test_split() {
+  const int size = 1001;
+  uint64_t seed = 0x0123456789abcdefULL;
+  double * full = (double *) util_calloc( size , sizeof * full );
+  double * part = (double *) util_calloc( size , sizeof * part );
+
+  counter_rng_fill_normal( seed , 17 , 0 , size , full );
+  {
+    int pos = 0;
+    int step = 1;
+    while (pos < size) {
+      int count = util_int_min( step , size - pos );
+      counter_rng_fill_normal( seed , 17 , pos , count , &part[pos] );
+      pos += count;
+      step = (step * 3) % 301 + 1;
+    }
+  }
+  test_assert_int_equal( 0 , memcmp( full , part , size * sizeof * full ));
+
+  counter_rng_fill_normal( seed , 18 , 0 , size , part );
+  test_assert_true( memcmp( full , part , size * sizeof * full ) != 0 );
+
+  free( part );
+  free( full );
+}
+
+
+static void test_moments() {
+  const int size = 200000;
+  double * data = (double *) util_calloc( size , sizeof * data );
+  double mean = 0;
+  double var  = 0;
+
+  counter_rng_fill_uniform( 77 , 0 , 0 , size , data );
+  for (int i = 0; i < size; i++) {
+    test_assert_true( data[i] >= 0 && data[i] < 1 );
+    mean += data[i];
+  }
+  mean /= size;
+  test_assert_true( fabs( mean - 0.5 ) < 0.01 );
+
+  mean = 0;
+  counter_rng_fill_normal( 77 , 1 , 0 , size , data );
+  for (int i = 0; i < size; i++) {
+    test_assert_true( std::isfinite( data[i] ));
+    mean += data[i];
+  }
+  mean /= size;
+  for (int i = 0; i < size; i++)
+    var += (data[i] - mean) * (data[i] - mean);
+  var /= (size - 1);
+
+  test_assert_true( fabs( mean - 0.0 ) < 0.01 );
+  test_assert_true( fabs( var - 1.0 ) < 0.02 );
+  free( data );
+}
+
+
+int main(int argc , char ** argv) {
+  test_known_answer();
+  test_split();
+  test_moments();
+  exit(0);
+}
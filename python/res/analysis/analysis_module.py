@@ -52,6 +52,9 @@ class AnalysisModule(BaseCClass):
         "IES_DEBUG": {"type": bool, "description": "Print extensive log for IES analysis steps"},
         "IES_LOGFILE": {"type": str, "description": "IES Log File"},
         "IES_AAPROJECTION": {"type": str, "description": "Include projection Y (A^+A) for n<N-1"},
+        "IES_ROW_BLOCK_SIZE": {"type": int, "description": "Number of rows of the prior ensemble in memory in the final IES update"},
+        "IES_CHECKPOINT": {"type": str, "description": "File where the IES iteration state is stored after each update"},
+        "IES_SPILL_PATH": {"type": str, "description": "Directory for the temporary file holding the prior ensemble"},
         "LAMBDA0": {"type": float, "description": "Initial Lambda"},
         "USE_PRIOR": {"type": bool, "description": "Use both Prior and Observation Variability"},
         "LAMBDA_REDUCE": {"type": float, "description": "Lambda Reduction Factor"},
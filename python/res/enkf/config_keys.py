@@ -79,6 +79,10 @@ class ConfigKeys:
     _data_root_key        = ResPrototype("char* config_keys_get_data_root_key()", bind=False)
     _rftpath_key          = ResPrototype("char* config_keys_get_rftpath_key()", bind=False)
     _gen_kw_export_name_key = ResPrototype("char* config_keys_get_gen_kw_export_name_key()", bind=False)    
+    _lazy_summary_load_key = ResPrototype("char* config_keys_get_lazy_summary_load_key()", bind=False)
+    _columnar_summary_storage_key = ResPrototype("char* config_keys_get_columnar_summary_storage_key()", bind=False)
+    _load_read_threads_key = ResPrototype("char* config_keys_get_load_read_threads_key()", bind=False)
+    _load_store_threads_key = ResPrototype("char* config_keys_get_load_store_threads_key()", bind=False)
     _runpath              = ResPrototype("char* config_keys_get_runpath_key()", bind=False)
     # ************* Model config  *************
 
@@ -239,6 +243,10 @@ class ConfigKeys:
     DATAROOT = _data_root_key()
     RFTPATH = _rftpath_key()
     GEN_KW_EXPORT_NAME = _gen_kw_export_name_key()
+    LAZY_SUMMARY_LOAD = _lazy_summary_load_key()
+    COLUMNAR_SUMMARY_STORAGE = _columnar_summary_storage_key()
+    LOAD_READ_THREADS = _load_read_threads_key()
+    LOAD_STORE_THREADS = _load_store_threads_key()
     NUM_REALIZATIONS = _num_realizations()
     ENSPATH          = _enspath()
     HISTORY_SOURCE   = _history_source()
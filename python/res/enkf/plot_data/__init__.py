@@ -1,5 +1,6 @@
 from .ensemble_plot_data_vector import EnsemblePlotDataVector
 from .ensemble_plot_data import EnsemblePlotData
+from .ensemble_plot_batch import EnsemblePlotBatch
 from .plot_block_vector import PlotBlockVector
 from .plot_block_data import PlotBlockData
 from .plot_block_data_loader import PlotBlockDataLoader
@@ -0,0 +1,81 @@
+from cwrap import BaseCClass
+from res import ResPrototype
+from res.enkf.config import EnkfConfigNode
+from res.enkf.enkf_fs import EnkfFs
+from ecl.util.util import BoolVector
+
+
+class EnsemblePlotBatch(BaseCClass):
+    """
+    Loads the plot data for several keys in one pass over the ensemble;
+    the vectors returned by get() are views into the batch. They are
+    owned by the batch, and are updated in place by the next call to
+    load().
+    """
+    TYPE_NAME = "ensemble_plot_batch"
+
+    _alloc     = ResPrototype("void* enkf_plot_batch_alloc()", bind = False)
+    _add_key   = ResPrototype("int   enkf_plot_batch_add_key(ensemble_plot_batch, enkf_config_node, char*)")
+    _set_index_key = ResPrototype("void enkf_plot_batch_iset_index_key(ensemble_plot_batch, int, char*)")
+    _num_keys  = ResPrototype("int   enkf_plot_batch_get_num_keys(ensemble_plot_batch)")
+    _load      = ResPrototype("void  enkf_plot_batch_load(ensemble_plot_batch, enkf_fs, bool_vector)")
+    _ens_size  = ResPrototype("int   enkf_plot_batch_get_ens_size(ensemble_plot_batch)")
+    _num_steps = ResPrototype("int   enkf_plot_batch_get_num_steps(ensemble_plot_batch)")
+    _get       = ResPrototype("ensemble_plot_data_vector_ref enkf_plot_batch_iget(ensemble_plot_batch, int, int)")
+    _free      = ResPrototype("void  enkf_plot_batch_free(ensemble_plot_batch)")
+
+
+    def __init__(self):
+        c_pointer = self._alloc()
+        super(EnsemblePlotBatch, self).__init__(c_pointer)
+
+
+    def addKey(self, ensemble_config_node, user_index=None):
+        """ @rtype: int """
+        assert isinstance(ensemble_config_node, EnkfConfigNode)
+        return self._add_key(ensemble_config_node, user_index)
+
+
+    def setIndexKey(self, key_index, user_index):
+        """ The new user_index is used from the next call to load(). """
+        if not 0 <= key_index < self.numKeys():
+            raise IndexError("Invalid key index: %d" % key_index)
+
+        self._set_index_key(key_index, user_index)
+
+
+    def load(self, file_system, input_mask=None):
+        assert isinstance(file_system, EnkfFs)
+        if not input_mask is None:
+            assert isinstance(input_mask, BoolVector)
+
+        self._load(file_system, input_mask)
+
+    def numKeys(self):
+        """ @rtype: int """
+        return self._num_keys()
+
+    def ensembleSize(self):
+        """ @rtype: int """
+        return self._ens_size()
+
+    def numSteps(self):
+        """ @rtype: int """
+        return self._num_steps()
+
+    def get(self, key_index, iens):
+        """ @rtype: EnsemblePlotDataVector """
+        if not 0 <= key_index < self.numKeys():
+            raise IndexError("Invalid key index: %d" % key_index)
+
+        if not 0 <= iens < self.ensembleSize():
+            raise IndexError("Invalid realization: %d" % iens)
+
+        return self._get(key_index, iens).setParent(self)
+
+
+    def free(self):
+        self._free()
+
+    def __repr__(self):
+        return 'EnsemblePlotBatch(keys = %d, size = %d) %s' % (self.numKeys(), self.ensembleSize(), self._ad_str())
@@ -118,6 +118,7 @@ def get_excluded_files(root):
         "res/enkf/plot_data/ensemble_plot_data_vector.py",
         "res/enkf/plot_data/ensemble_plot_gen_data_vector.py",
         "res/enkf/plot_data/ensemble_plot_data.py",
+        "res/enkf/plot_data/ensemble_plot_batch.py",
         "res/enkf/plot/observation_data_fetcher.py",
         "res/enkf/plot_data/ensemble_plot_gen_data.py",
         "res/enkf/plot_data/ensemble_plot_gen_kw_vector.py",
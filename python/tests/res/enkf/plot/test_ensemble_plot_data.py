@@ -0,0 +1,47 @@
+from tests import ResTest
+from res.test import ErtTestContext
+
+from res.enkf.plot_data import EnsemblePlotData, EnsemblePlotBatch
+from ecl.util.util import BoolVector
+
+
+class EnsemblePlotDataTest(ResTest):
+    def setUp(self):
+        self.config = self.createTestPath("local/snake_oil/snake_oil.ert")
+
+    def test_reload_other_key(self):
+        with ErtTestContext(
+            "python/enkf/plot/plot_data_reload", self.config
+        ) as context:
+            ert = context.getErt()
+            fs = ert.getEnkfFsManager().getFileSystem("default_0")
+            config_node = ert.ensembleConfig()["SNAKE_OIL_PARAM"]
+            mask = BoolVector(default_value=True, initial_size=ert.getEnsembleSize())
+
+            plot_data = EnsemblePlotData(config_node, fs, "OP1_PERSISTENCE", mask)
+            vector = plot_data[0]
+            self.assertFloatEqual(vector.getValue(0), 0.047517)
+
+            plot_data.load(fs, "OP1_OFFSET", mask)
+            self.assertFloatEqual(vector.getValue(0), 0.054539)
+            self.assertFloatEqual(plot_data[12].getValue(0), 0.057807)
+
+    def test_batch_reload_other_key(self):
+        with ErtTestContext(
+            "python/enkf/plot/plot_batch_reload", self.config
+        ) as context:
+            ert = context.getErt()
+            fs = ert.getEnkfFsManager().getFileSystem("default_0")
+            config_node = ert.ensembleConfig()["SNAKE_OIL_PARAM"]
+            mask = BoolVector(default_value=True, initial_size=ert.getEnsembleSize())
+
+            batch = EnsemblePlotBatch()
+            key_index = batch.addKey(config_node, "OP1_PERSISTENCE")
+            batch.load(fs, mask)
+            vector = batch.get(key_index, 0)
+            self.assertFloatEqual(vector.getValue(0), 0.047517)
+
+            batch.setIndexKey(key_index, "OP1_OFFSET")
+            batch.load(fs, mask)
+            self.assertFloatEqual(vector.getValue(0), 0.054539)
+            self.assertFloatEqual(batch.get(key_index, 12).getValue(0), 0.057807)
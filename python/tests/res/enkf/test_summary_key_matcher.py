@@ -26,3 +26,9 @@ class SummaryKeyMatcherTest(ResTest):
         self.assertTrue(matcher.isRequired("FOPT"))
         self.assertFalse(matcher.isRequired("FGIR"))
         self.assertFalse(matcher.isRequired("TCPU"))
+
+        matcher.addSummaryKey("WOPR:O*")
+        self.assertTrue("WOPR:OP_1" in matcher)
+        self.assertFalse("WOPR:IN_1" in matcher)
+        self.assertFalse("WOP" in matcher)
+        self.assertFalse(matcher.isRequired("WOPR:OP_1"))